@@ -0,0 +1,51 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file acknowledged_bitrate_estimator.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "acknowledged_bitrate_estimator.h"
+
+namespace webrtc {
+
+AcknowledgedBitrateEstimator::AcknowledgedBitrateEstimator()
+    : _alr_ended_time_ms(-1),
+    _in_alr(false) {}
+
+AcknowledgedBitrateEstimator::~AcknowledgedBitrateEstimator() {}
+
+void AcknowledgedBitrateEstimator::IncomingPacketFeedbackVector(
+        const AcknowledgedPacket* packets, size_t num_packets) {
+    for (size_t i = 0; i < num_packets; ++i) {
+        const AcknowledgedPacket& packet = packets[i];
+        if (packet.receive_time_ms < 0)
+            continue;
+        if (_alr_ended_time_ms >= 0 && packet.send_time_ms > _alr_ended_time_ms) {
+            _bitrate_estimator.ExpectFastRateChange();
+            _alr_ended_time_ms = -1;
+        }
+        _bitrate_estimator.Update(packet.receive_time_ms, packet.size, _in_alr);
+    }
+}
+
+int AcknowledgedBitrateEstimator::bitrate_bps() const {
+    return _bitrate_estimator.bitrate_bps();
+}
+
+int AcknowledgedBitrateEstimator::PeekRate(int64_t now_ms) const {
+    return _bitrate_estimator.PeekRate(now_ms);
+}
+
+void AcknowledgedBitrateEstimator::SetAlr(bool in_alr) {
+    _in_alr = in_alr;
+}
+
+void AcknowledgedBitrateEstimator::SetAlrEndedTime(int64_t alr_ended_time_ms) {
+    _alr_ended_time_ms = alr_ended_time_ms;
+}
+
+} // namespace webrtc
@@ -0,0 +1,56 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file acknowledged_bitrate_estimator.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _ACKNOWLEDGED_BITRATE_ESTIMATOR_H
+#define _ACKNOWLEDGED_BITRATE_ESTIMATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bitrate_estimator.h"
+
+namespace webrtc {
+
+// 反馈中确认收到的一个包
+struct AcknowledgedPacket {
+    int64_t send_time_ms;
+    // -1 if the packet was lost.
+    int64_t receive_time_ms;
+    size_t size;
+};
+
+// 接收端确认的码率(acked bitrate), 作为RateControlInput::estimated_throughput_bps的来源,
+// 替代调用方直接提供的原始吞吐量。
+class AcknowledgedBitrateEstimator {
+public:
+    AcknowledgedBitrateEstimator();
+    ~AcknowledgedBitrateEstimator();
+
+    // Packets must be in receive time order. Lost packets are skipped.
+    void IncomingPacketFeedbackVector(const AcknowledgedPacket* packets, size_t num_packets);
+    // Returns -1 until enough packets have been acknowledged.
+    int bitrate_bps() const;
+    int PeekRate(int64_t now_ms) const;
+    void SetAlr(bool in_alr);
+    // The first packet sent after |alr_ended_time_ms| lets the estimate move
+    // quickly towards the rate the sender ramps up to.
+    void SetAlrEndedTime(int64_t alr_ended_time_ms);
+
+private:
+    int64_t _alr_ended_time_ms;
+    bool _in_alr;
+    BitrateEstimator _bitrate_estimator;
+};
+
+} // namespace webrtc
+
+#endif // _ACKNOWLEDGED_BITRATE_ESTIMATOR_H
+
+
@@ -0,0 +1,174 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file acknowledged_bitrate_estimator_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ acknowledged_bitrate_estimator_unittest.cpp acknowledged_bitrate_estimator.cpp bitrate_estimator.cpp rate_statistics.cpp aimd_rate_control.cpp field_trail.cpp random.cpp -std=c++11
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "acknowledged_bitrate_estimator.h"
+#include "aimd_rate_control.h"
+#include "random.h"
+
+namespace webrtc {
+
+static AcknowledgedPacket MakePacket(int64_t send_time_ms, int64_t receive_time_ms, size_t size) {
+    AcknowledgedPacket packet;
+    packet.send_time_ms = send_time_ms;
+    packet.receive_time_ms = receive_time_ms;
+    packet.size = size;
+    return packet;
+}
+
+// ConstantRate
+// 每10ms到达1250字节(1Mbps): 首个500ms窗口之前没有估计, 之后收敛到1Mbps; 丢包不计入
+void TestAcknowledgedBitrateEstimator01() {
+    AcknowledgedBitrateEstimator estimator;
+    int64_t now_ms = 1000;
+    for (int i = 0; i < 50; ++i, now_ms += 10) {
+        AcknowledgedPacket packet = MakePacket(now_ms - 50, now_ms, 1250);
+        estimator.IncomingPacketFeedbackVector(&packet, 1);
+    }
+    assert(estimator.bitrate_bps() == -1);
+
+    for (int i = 0; i < 200; ++i, now_ms += 10) {
+        AcknowledgedPacket packets[2] = {MakePacket(now_ms - 50, now_ms, 1250),
+                                         MakePacket(now_ms - 50, -1, 1250)};
+        estimator.IncomingPacketFeedbackVector(packets, 2);
+    }
+    cout << "constant 1Mbps: acked bitrate=" << estimator.bitrate_bps() << "bps" << endl;
+    assert(std::abs(estimator.bitrate_bps() - 1000000) < 20000);
+}
+
+// FastRateChangeAfterAlr
+// ALR结束后放大估计方差, 码率翻倍后更快跟上
+void TestAcknowledgedBitrateEstimator02() {
+    int64_t converged_ms[2];
+    for (int expect_fast_change = 0; expect_fast_change < 2; ++expect_fast_change) {
+        AcknowledgedBitrateEstimator estimator;
+        int64_t now_ms = 1000;
+        for (int i = 0; i < 300; ++i, now_ms += 10) {
+            AcknowledgedPacket packet = MakePacket(now_ms - 50, now_ms, 625);
+            estimator.IncomingPacketFeedbackVector(&packet, 1);
+        }
+        if (expect_fast_change)
+            estimator.SetAlrEndedTime(now_ms - 50);
+        converged_ms[expect_fast_change] = -1;
+        for (int i = 0; i < 500; ++i, now_ms += 10) {
+            AcknowledgedPacket packet = MakePacket(now_ms - 40, now_ms, 1250);
+            estimator.IncomingPacketFeedbackVector(&packet, 1);
+            if (converged_ms[expect_fast_change] < 0 && estimator.bitrate_bps() > 900000)
+                converged_ms[expect_fast_change] = i * 10;
+        }
+    }
+    cout << "500kbps -> 1Mbps: converged after " << converged_ms[0] << "ms, "
+         << converged_ms[1] << "ms after alr ended" << endl;
+    assert(converged_ms[1] >= 0);
+    assert(converged_ms[0] < 0 || converged_ms[1] < converged_ms[0]);
+}
+
+// 仿真: 1Mbps链路始终跑满, 每10ms一个包; 接收端(如wifi)把包聚合后每隔20~150ms
+// 随机批量送达。每100ms一次反馈, 吞吐量分别取该100ms内的原始送达码率和
+// AcknowledgedBitrateEstimator的输出; 每5s注入一次真实过载。
+struct ThroughputResult {
+    double avg_estimate_bps;
+    uint32_t min_estimate_bps;
+    double throughput_stddev_bps;
+};
+
+static ThroughputResult RunAggregationSimulation(bool use_acked_bitrate) {
+    constexpr int64_t kCapacityBps = 1000000;
+    constexpr int64_t kDurationMs = 60000;
+    constexpr int64_t kMeasureFromMs = 10000;
+
+    Random random(0x2468ace);
+    AimdRateControl rate_control;
+    AcknowledgedBitrateEstimator estimator;
+    rate_control.SetEstimate(kCapacityBps * 8 / 10, 0);
+
+    std::vector<AcknowledgedPacket> held;
+    std::vector<AcknowledgedPacket> feedback;
+    int64_t next_release_ms = random.Rand(20, 150);
+    int64_t raw_bytes = 0;
+    double estimate_sum = 0;
+    double throughput_sum = 0;
+    double throughput_square_sum = 0;
+    int samples = 0;
+    uint32_t min_estimate_bps = 0xffffffff;
+    for (int64_t now_ms = 10; now_ms <= kDurationMs; now_ms += 10) {
+        held.push_back(MakePacket(now_ms, -1, static_cast<size_t>(kCapacityBps * 10 / 8000)));
+        if (now_ms >= next_release_ms) {
+            for (AcknowledgedPacket& packet : held) {
+                packet.receive_time_ms = now_ms;
+                raw_bytes += packet.size;
+                feedback.push_back(packet);
+            }
+            held.clear();
+            next_release_ms = now_ms + random.Rand(20, 150);
+        }
+
+        if (now_ms % 100 == 0) {
+            estimator.IncomingPacketFeedbackVector(feedback.data(), feedback.size());
+            feedback.clear();
+            const uint32_t raw_bps = static_cast<uint32_t>(raw_bytes * 8000 / 100);
+            raw_bytes = 0;
+            uint32_t throughput_bps = raw_bps;
+            if (use_acked_bitrate && estimator.bitrate_bps() >= 0)
+                throughput_bps = estimator.bitrate_bps();
+            BandwidthUsage state = now_ms % 5000 == 0
+                ? BandwidthUsage::kBwOverusing : BandwidthUsage::kBwNormal;
+            RateControlInput input(state, throughput_bps);
+            rate_control.Update(&input, now_ms);
+
+            if (now_ms >= kMeasureFromMs) {
+                estimate_sum += rate_control.LatestEstimate();
+                min_estimate_bps = std::min(min_estimate_bps, rate_control.LatestEstimate());
+                throughput_sum += throughput_bps;
+                throughput_square_sum += static_cast<double>(throughput_bps) * throughput_bps;
+                ++samples;
+            }
+        }
+    }
+    ThroughputResult result;
+    result.avg_estimate_bps = estimate_sum / samples;
+    result.min_estimate_bps = min_estimate_bps;
+    const double mean = throughput_sum / samples;
+    result.throughput_stddev_bps = std::sqrt(throughput_square_sum / samples - mean * mean);
+    return result;
+}
+
+// AggregatedArrivals
+// 原始吞吐量在聚合下抖动很大, 过载时按抖动的低值降码率; 平滑后降码率更浅, 平均估计更高
+void TestAcknowledgedBitrateEstimator03() {
+    ThroughputResult raw;
+    ThroughputResult acked;
+    raw = RunAggregationSimulation(false);
+    acked = RunAggregationSimulation(true);
+    cout << "raw throughput: stddev=" << raw.throughput_stddev_bps << "bps avg estimate="
+         << raw.avg_estimate_bps << "bps min estimate=" << raw.min_estimate_bps << "bps" << endl;
+    cout << "acked bitrate: stddev=" << acked.throughput_stddev_bps << "bps avg estimate="
+         << acked.avg_estimate_bps << "bps min estimate=" << acked.min_estimate_bps << "bps" << endl;
+    assert(acked.throughput_stddev_bps * 3 < raw.throughput_stddev_bps);
+    assert(acked.min_estimate_bps > raw.min_estimate_bps);
+    assert(acked.avg_estimate_bps > raw.avg_estimate_bps);
+}
+
+} // namespace webrtc
+
+int main() {
+    webrtc::TestAcknowledgedBitrateEstimator01();
+    webrtc::TestAcknowledgedBitrateEstimator02();
+    webrtc::TestAcknowledgedBitrateEstimator03();
+
+    return 0;
+}
@@ -11,38 +11,105 @@
 #include "aimd_rate_control.h"
 
 #include <inttypes.h>
+#include <stdio.h>
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <string>
+
+#include "field_trail.h"
+#include "safe_minmax.h"
 
 #include <iostream>
 using namespace std;
 
 namespace webrtc {
 
-static const int64_t kDefaultRttMs = 200;
 static const int64_t kMaxFeedbackIntervalMs = 1000;
 static const float kDefaultBackoffFactor = 0.85f;
 static const int64_t kDefaultInitialBackOffIntervalMs = 200;
+static const double kDefaultFrameRateFps = 30.0;
+static const size_t kDefaultPacketSizeBytes = 1200;
+
+// 打印码率控制过程, 编译时加-DAIMD_RATE_CONTROL_DEBUG打开
+#if defined(AIMD_RATE_CONTROL_DEBUG)
+static constexpr bool kDebugLog = true;
+#else
+static constexpr bool kDebugLog = false;
+#endif
+
+static const char kBweBackOffFactorExperiment[] = "WebRTC-BweBackOffFactor";
+static const char kAdaptiveThresholdExperiment[] = "WebRTC-AdaptiveBweThreshold";
+static const char kBandwidthSmoothingExperiment[] = "WebRTC-Audio-BandwidthSmoothing";
+
+// 试验只在构造时查找一次, 参数直接从查到的表项里解析
+// Group format "Enabled-0.9", the factor must be in (0, 1).
+static float ReadBackoffFactor(const field_trial::FieldTrialEntry* trial) {
+    if (!field_trial::IsEnabled(trial))
+        return kDefaultBackoffFactor;
+    float backoff_factor;
+    if (sscanf(trial->group.c_str(), "Enabled-%f", &backoff_factor) == 1 &&
+            backoff_factor > 0.0f && backoff_factor < 1.0f) {
+        return backoff_factor;
+    }
+    // RTC_LOG(LS_WARNING) << "Failed to parse parameters for AimdRateControl "
+    //    "experiment from field trial string. Using default.";
+    return kDefaultBackoffFactor;
+}
+
+// 乘性增加系数查表: alpha[i] = 1.08^(i/1000), i为距上次更新的毫秒数
+// Table of the slow start increase factor for every integer ms delta up to
+// kMaxFeedbackIntervalMs, so the hot path is a load instead of a pow() call.
+class MultiplicativeIncreaseTable {
+public:
+    MultiplicativeIncreaseTable() {
+        for (int64_t i = 0; i <= kMaxFeedbackIntervalMs; ++i)
+            _alpha[i] = pow(1.08, i / 1000.0);
+    }
+
+    double Lookup(int64_t time_since_last_update_ms) const {
+        return _alpha[rtc::SafeClamp<int64_t>(time_since_last_update_ms, 0,
+                kMaxFeedbackIntervalMs)];
+    }
+
+private:
+    double _alpha[kMaxFeedbackIntervalMs + 1];
+};
+
+double MultiplicativeIncreaseFactor(int64_t time_since_last_update_ms) {
+    static const MultiplicativeIncreaseTable table;
+    return table.Lookup(time_since_last_update_ms);
+}
 
 namespace congestion_controller {
 
 int GetMinBitrateBps() {
     constexpr int kAudioMinBitrateBps = 5000;
     constexpr int kMinBitrateBps = 10000;
-    /*if (webrtc::field_trial::IsEnabled("WebRTC-Audio-SendSideBwe") &&
+    if (webrtc::field_trial::IsEnabled("WebRTC-Audio-SendSideBwe") &&
             !webrtc::field_trial::IsEnabled("WebRTC-Audio-SendSideBwe-For-Video")) {
         return kAudioMinBitrateBps;
-    }*/
+    }
     return kMinBitrateBps;
 }
 
 }  // namespace congestion_controller
 
+constexpr int64_t AimdRateControl::kDefaultRttMs;
+
+AimdRateControlConfig::AimdRateControlConfig()
+    : min_configured_bitrate_bps(congestion_controller::GetMinBitrateBps()),
+    max_configured_bitrate_bps(30000000),
+    beta(ReadBackoffFactor(field_trial::FindTrial(kBweBackOffFactorExperiment))),
+    // 上游默认开启(!AdaptiveThresholdExperimentIsDisabled()),这里保持默认关闭
+    in_experiment(webrtc::field_trial::IsEnabled(kAdaptiveThresholdExperiment)),
+    // 默认开启,可通过Disabled关闭
+    smoothing_experiment(!webrtc::field_trial::IsDisabled(kBandwidthSmoothingExperiment)),
+    frame_rate_fps(kDefaultFrameRateFps),
+    packet_size_bytes(kDefaultPacketSizeBytes) {}
+
 AimdRateControl::AimdRateControl()
-    : _min_configured_bitrate_bps(congestion_controller::GetMinBitrateBps()),
-    _max_configured_bitrate_bps(30000000),
-    _current_bitrate_bps(_max_configured_bitrate_bps),
+    : _current_bitrate_bps(_config.max_configured_bitrate_bps),
     _latest_estimated_throughput_bps(_current_bitrate_bps),
     _avg_max_bitrate_kbps(-1.0f),
     _var_max_bitrate_kbps(0.4f),
@@ -52,18 +119,12 @@ AimdRateControl::AimdRateControl()
     _time_last_bitrate_decrease(-1),
     _time_first_throughput_estimate(-1),
     _bitrate_is_initialized(false),
-    // _beta(webrtc::field_trial::IsEnabled(kBweBackOffFactorExperiment)
-    //        ? ReadBackoffFactor() : kDefaultBackoffFactor),
-    _beta(kDefaultBackoffFactor),
     _rtt(kDefaultRttMs),
-    // _in_experiment(!AdaptiveThresholdExperimentIsDisabled()),
-    // _in_experiment(true),
-    _in_experiment(false),
-    // _smoothing_experiment(webrtc::field_trial::IsEnabled("WebRTC-Audio-BandwidthSmoothing")),
-    _smoothing_experiment(true),
     _in_initial_backoff_interval_experiment(false),
     // _in_initial_backoff_interval_experiment(webrtc::field_trial::IsEnabled(kBweInitialBackOffIntervalExperiment)),
-    _initial_backoff_interval_ms(kDefaultInitialBackOffIntervalMs) 
+    _initial_backoff_interval_ms(kDefaultInitialBackOffIntervalMs),
+    _last_decrease(0),
+    _in_alr(false)
 {
     if (_in_initial_backoff_interval_experiment) {
         // _initial_backoff_interval_ms = ReadInitialBackoffIntervalMs();
@@ -87,20 +148,28 @@ bool AimdRateControl::TimeToReduceFurther(
     }
 
     // 为何小于当前发送码率的一半进一步降低???
-    /*
+    // 吞吐量已跌到估计值的一半以下,说明估计值严重偏离实际链路容量,不必再等一个rtt
     if (ValidEstimate()) {
         // TODO(terelius/holmer): Investigate consequences of increasing
         // the threshold to 0.95 * LatestEstimate().
         const uint32_t threshold = static_cast<uint32_t>(0.5 * LatestEstimate());
         return estimated_throughput_bps < threshold;
-    }*/
+    }
     return false;
 }
 
+bool AimdRateControl::ValidEstimate() const {
+    return _bitrate_is_initialized;
+}
+
 uint32_t AimdRateControl::LatestEstimate() const {
     return _current_bitrate_bps;
 }
 
+void AimdRateControl::SetRtt(int64_t rtt) {
+    _rtt = rtt;
+}
+
 uint32_t AimdRateControl::Update(const RateControlInput* input, int64_t now_ms) {
     /*
     if (!_bitrate_is_initialized) {
@@ -120,11 +189,16 @@ uint32_t AimdRateControl::Update(const RateControlInput* input, int64_t now_ms)
     */
 
     // cout << "[Update] " << "BandwidthUsage=" << static_cast<int>(input->bw_state) 
-    cout << "[Update] " << "bandwidth_state=normal" 
-         << " estimated_throughput_bps=" << input->estimated_throughput_bps << "bps"
-         << " current_bitrate_bps=" << _current_bitrate_bps << "bps" << endl;
+    if (kDebugLog)
+        cout << "[Update] " << "bandwidth_state=normal" 
+             << " estimated_throughput_bps=" << input->estimated_throughput_bps << "bps"
+             << " current_bitrate_bps=" << _current_bitrate_bps << "bps" << endl;
 
-    _current_bitrate_bps = ChangeBitrate(_current_bitrate_bps, *input, now_ms);
+    AimdRateControlStateRef state = {_current_bitrate_bps, _latest_estimated_throughput_bps,
+        _avg_max_bitrate_kbps, _var_max_bitrate_kbps, _rate_control_state, _rate_control_region,
+        _bitrate_is_initialized, _time_last_bitrate_change, _time_last_bitrate_decrease,
+        _last_decrease, _near_max_increase_rate, _rtt, _in_alr};
+    aimd::ChangeBitrate(_config, state, *input, now_ms);
 
     /*cout << "[Update] " << "BandwidthUsage=" << static_cast<int>(input->bw_state) 
          << " estimated_throughput_bps=" << input->estimated_throughput_bps
@@ -137,51 +211,88 @@ uint32_t AimdRateControl::Update(const RateControlInput* input, int64_t now_ms)
 void AimdRateControl::SetEstimate(int bitrate_bps, int64_t now_ms) {
     _bitrate_is_initialized = true;
     uint32_t prev_bitrate_bps = _current_bitrate_bps;
-    _current_bitrate_bps = ClampBitrate(bitrate_bps, bitrate_bps);
+    _current_bitrate_bps = aimd::ClampBitrate(_config, _current_bitrate_bps, bitrate_bps, bitrate_bps);
     _time_last_bitrate_change = now_ms;
     if (_current_bitrate_bps < prev_bitrate_bps) {
         _time_last_bitrate_decrease = now_ms;
     }
 }
 
+void AimdRateControl::SetInApplicationLimitedRegion(bool in_alr) {
+    _in_alr = in_alr;
+}
+
+void AimdRateControl::SetAssumedFrameRate(double frame_rate_fps) {
+    assert(frame_rate_fps > 0);
+    _config.frame_rate_fps = frame_rate_fps;
+    _near_max_increase_rate.rate_bps = -1;
+}
+
+void AimdRateControl::SetAssumedPacketSize(size_t packet_size_bytes) {
+    assert(packet_size_bytes > 0);
+    _config.packet_size_bytes = packet_size_bytes;
+    _near_max_increase_rate.rate_bps = -1;
+}
+
+// 结果只依赖当前码率和rtt,两者未变化时直接返回缓存值
+int AimdRateControl::GetNearMaxIncreaseRateBps() const {
+    return aimd::NearMaxIncreaseRateBps(_config, _current_bitrate_bps, _rtt, _near_max_increase_rate);
+}
+
+int AimdRateControl::GetExpectedBandwidthPeriodMs() const {
+    return aimd::ExpectedBandwidthPeriodMs(_config, _last_decrease, GetNearMaxIncreaseRateBps());
+}
+
+namespace aimd {
+
+static uint32_t MultiplicativeRateIncrease(int64_t now_ms, int64_t last_ms,
+        uint32_t current_bitrate_bps);
+static uint32_t AdditiveRateIncrease(int64_t now_ms, int64_t last_ms,
+        int near_max_increase_rate_bps);
+
 // 该函数将新的码率控制到 (min_configured_bitrate_bps_, a*estimated_throughput_bps+b) 之间，避免发送端码率增长过快。
 // pv13, Finally, it is important to notice that Ar(ti) cannot exceed 1.5R(ti).
 // 1.发送端评估的码率超过反馈码率acked bitrate 1.5倍,那么会被限制到最大码率不能继续增长
 // 2.如果acked bitrate降低(比如突然降低一半),那么发送端BWE码率不会被限制到当前acked bitrate的1.5x以内，但是也不会增长
-uint32_t AimdRateControl::ClampBitrate(uint32_t new_bitrate_bps, uint32_t estimated_throughput_bps) const {
+uint32_t ClampBitrate(const AimdRateControlConfig& config,
+        uint32_t current_bitrate_bps,
+        uint32_t new_bitrate_bps,
+        uint32_t estimated_throughput_bps) {
     // max_bitrate_bps 最大码率计算公式怎么得来的???
     // Don't change the bit rate if the send side is too far off.
     // We allow a bit more lag at very low rates to not too easily get stuck if
     // the encoder produces uneven outputs.
     const uint32_t max_bitrate_bps = static_cast<uint32_t>(1.5f * estimated_throughput_bps) + 10000;
-    if (new_bitrate_bps > _current_bitrate_bps && new_bitrate_bps > max_bitrate_bps) {
-        new_bitrate_bps = std::max(_current_bitrate_bps, max_bitrate_bps);
+    if (new_bitrate_bps > current_bitrate_bps && new_bitrate_bps > max_bitrate_bps) {
+        new_bitrate_bps = std::max(current_bitrate_bps, max_bitrate_bps);
     }
-    new_bitrate_bps = std::max(new_bitrate_bps, _min_configured_bitrate_bps);
+    new_bitrate_bps = std::max(new_bitrate_bps, config.min_configured_bitrate_bps);
     return new_bitrate_bps;
 }
 
 // 输入过载检测信号
 // 计算码率变化趋势
 // 输出调整后的码率
-uint32_t AimdRateControl::ChangeBitrate(uint32_t new_bitrate_bps,
-                                        const RateControlInput& input,
-                                        int64_t now_ms) 
+uint32_t ChangeBitrate(const AimdRateControlConfig& config,
+        const AimdRateControlStateRef& state,
+        const RateControlInput& input,
+        int64_t now_ms)
 {
+    uint32_t new_bitrate_bps = state.current_bitrate_bps;
     // uint32_t estimated_throughput_bps = input.estimated_throughput_bps.value_or(latest_estimated_throughput_bps_);
     uint32_t estimated_throughput_bps = input.estimated_throughput_bps;
     if (input.estimated_throughput_bps)
-        _latest_estimated_throughput_bps = input.estimated_throughput_bps;
+        state.latest_estimated_throughput_bps = input.estimated_throughput_bps;
 
     // An over-use should always trigger us to reduce the bitrate, even though
     // we have not yet established our first estimate. By acting on the over-use,
     // we will end up with a valid estimate.
-    if (!_bitrate_is_initialized && input.bw_state != BandwidthUsage::kBwOverusing)
-        return _current_bitrate_bps;
+    if (!state.bitrate_is_initialized && input.bw_state != BandwidthUsage::kBwOverusing)
+        return state.current_bitrate_bps;
 
     
     // 速率控制状态机
-    ChangeState(input, now_ms);
+    ChangeState(input.bw_state, now_ms, state.rate_control_state, state.time_last_bitrate_change);
 
     // Calculated here because it's used in multiple places.
     const float estimated_throughput_kbps = estimated_throughput_bps / 1000.0f;
@@ -189,14 +300,14 @@ uint32_t AimdRateControl::ChangeBitrate(uint32_t new_bitrate_bps,
     // 计算最近一段时间的码率标准差,即码率波动范围 // estimated_throughput_kbps应该在_avg_max_bitrate_kbps +/- 3 * std_max_bit_rate之间 
     // 乘以_avg_max_bitrate_kbps是因为之前计算方差用_avg_max_bitrate_kbps normalize归一化了 
     // 再乘回来
-    const float std_max_bit_rate = sqrt(_var_max_bitrate_kbps * _avg_max_bitrate_kbps);
+    const float std_max_bit_rate = sqrt(state.var_max_bitrate_kbps * state.avg_max_bitrate_kbps);
 
     /*cout << "[ChangeBitrate] estimated_throughput_kbps=" << estimated_throughput_kbps 
          << " std_max_bit_rate=" << std_max_bit_rate
          << " _var_max_bitrate_kbps=" << _var_max_bitrate_kbps
          << " _avg_max_bitrate_kbps=" << _avg_max_bitrate_kbps << endl;*/
 
-    switch (_rate_control_state) {
+    switch (state.rate_control_state) {
         // hold状态不作处理,维持码率不变
         case kRcHold:
             break;
@@ -208,128 +319,133 @@ uint32_t AimdRateControl::ChangeBitrate(uint32_t new_bitrate_bps,
             // If R_hat(i) increases above three standard deviations of the average
             // max bitrate, we assume that the current congestion level has changed,
             // at which point we reset the average max bitrate and go back to the multiplicative increase state.
-            if (_avg_max_bitrate_kbps >= 0 && estimated_throughput_kbps > _avg_max_bitrate_kbps + 3 * std_max_bit_rate) {
-                _rate_control_region = kRcMaxUnknown;
-                _avg_max_bitrate_kbps = -1.0;
+            if (state.avg_max_bitrate_kbps >= 0 && estimated_throughput_kbps > state.avg_max_bitrate_kbps + 3 * std_max_bit_rate) {
+                state.rate_control_region = kRcMaxUnknown;
+                state.avg_max_bitrate_kbps = -1.0;
             }
             // 码率已经接近最大值：增长需谨慎,加性增
             // On every update the delay-based estimate of the available bandwidth
             // is increased, either multiplicatively or additively, depending on its
             //    current state.
-            if (_rate_control_region == kRcNearMax) {
-                uint32_t additive_increase_bps = AdditiveRateIncrease(now_ms, _time_last_bitrate_change);
-                cout << "[AdditiveRateIncrease] additive_increase_bps=" << additive_increase_bps << endl;
+            // 应用受限时不增长, 但仍推进时间戳, 退出ALR后不会把冻结期间的时间一次性补回来
+            if (state.in_alr) {
+                // No increase while application limited.
+            } else if (state.rate_control_region == kRcNearMax) {
+                uint32_t additive_increase_bps = AdditiveRateIncrease(now_ms, state.time_last_bitrate_change,
+                        NearMaxIncreaseRateBps(config, state.current_bitrate_bps, state.rtt,
+                            state.near_max_increase_rate));
+                if (kDebugLog)
+                    cout << "[AdditiveRateIncrease] additive_increase_bps=" << additive_increase_bps << endl;
                 new_bitrate_bps += additive_increase_bps;
             } else { // 乘性增加, gcc草案,The subsystem starts in the increase state.
                 uint32_t multiplicative_increase_bps = MultiplicativeRateIncrease(
-                        now_ms, _time_last_bitrate_change, new_bitrate_bps);
+                        now_ms, state.time_last_bitrate_change, new_bitrate_bps);
                 // cout << "[MultiplicativeRateIncrease] multiplicative_increase_bps=" << multiplicative_increase_bps << endl;
                 new_bitrate_bps += multiplicative_increase_bps;
             }
 
-            _time_last_bitrate_change = now_ms;
+            state.time_last_bitrate_change = now_ms;
             break;
 
         case kRcDecrease:
             // Set bit rate to something slightly lower than max to get rid of any self-induced delay.
             // 码率回退系数beta=kDefaultBackoffFactor=0.85
-            new_bitrate_bps = static_cast<uint32_t>(_beta * estimated_throughput_bps + 0.5);
+            new_bitrate_bps = static_cast<uint32_t>(config.beta * estimated_throughput_bps + 0.5);
             // cout << "[MultiplicativeRateDecrease] new_bitrate_bps=" << new_bitrate_bps << endl;
-            cout << "[MultiplicativeRateDecrease] beta=" << _beta << " decrease_rate=" << estimated_throughput_bps-new_bitrate_bps << "bps" << endl;
-            if (new_bitrate_bps > _current_bitrate_bps) {
+            if (kDebugLog)
+                cout << "[MultiplicativeRateDecrease] beta=" << config.beta << " decrease_rate=" << estimated_throughput_bps-new_bitrate_bps << "bps" << endl;
+            if (new_bitrate_bps > state.current_bitrate_bps) {
                 // Avoid increasing the rate when over-using.
-                if (_rate_control_region != kRcMaxUnknown) {
-                    new_bitrate_bps = static_cast<uint32_t>(_beta * _avg_max_bitrate_kbps * 1000 + 0.5f);
+                if (state.rate_control_region != kRcMaxUnknown) {
+                    new_bitrate_bps = static_cast<uint32_t>(config.beta * state.avg_max_bitrate_kbps * 1000 + 0.5f);
                 }
-                new_bitrate_bps = std::min(new_bitrate_bps, _current_bitrate_bps);
+                new_bitrate_bps = std::min(new_bitrate_bps, state.current_bitrate_bps);
             }
             // 过载,码率处于降低状态,说明此时发送码率已经接近当前网络最大码率上界(link capacity.)
             // 速率范围设置为接近上界,此时如果要增加码率只能加性增.
-            _rate_control_region = kRcNearMax;
+            state.rate_control_region = kRcNearMax;
 
-            if (_bitrate_is_initialized && estimated_throughput_bps < _current_bitrate_bps) {
+            if (state.bitrate_is_initialized && estimated_throughput_bps < state.current_bitrate_bps) {
                 constexpr float kDegradationFactor = 0.9f;
-                if (_smoothing_experiment &&
-                        new_bitrate_bps < kDegradationFactor * _beta * _current_bitrate_bps) {
+                if (config.smoothing_experiment &&
+                        new_bitrate_bps < kDegradationFactor * config.beta * state.current_bitrate_bps) {
                     // If bitrate decreases more than a normal back off after overuse, it
                     // indicates a real network degradation. We do not let such a decrease
                     // to determine the bandwidth estimation period.
                     // _last_decrease = absl::nullopt;
                     // 如果码率降低的比正常回退多,那么可能网络退化,不用于BWE周期的计算
-                    _last_decrease = 0;
+                    state.last_decrease = 0;
                 } else {
-                    _last_decrease = _current_bitrate_bps - new_bitrate_bps;
+                    state.last_decrease = state.current_bitrate_bps - new_bitrate_bps;
                 }
             }
 
             // 如果评估的网络吞吐量小于平均吞吐三个标准差, 认为均值不可靠, 复位
-            if (estimated_throughput_kbps < _avg_max_bitrate_kbps - 3 * std_max_bit_rate) {
-                _avg_max_bitrate_kbps = -1.0f;
+            if (estimated_throughput_kbps < state.avg_max_bitrate_kbps - 3 * std_max_bit_rate) {
+                state.avg_max_bitrate_kbps = -1.0f;
             }
 
-            _bitrate_is_initialized = true;
+            state.bitrate_is_initialized = true;
             // 更新链路容量方差, 为什么码率降低时才更新?
             // 降低说明过载，过载说明可能达到了网络链路最大吐吞量,此时的吞吐量评估值才能作为链路容量值进行方差的计算
-            UpdateMaxThroughputEstimate(estimated_throughput_kbps);
+            UpdateMaxThroughputEstimate(estimated_throughput_kbps, state.avg_max_bitrate_kbps,
+                    state.var_max_bitrate_kbps);
             // Stay on hold until the pipes are cleared.
             // 参考有限状态机图：降低码率后回到HOLD状态，如果网络状态仍然不好，在Overuse仍然会进入Dec状态。
             // 如果恢复，则不会是Overuse，会保持或增长。
             // dec 只能向 hold 变化
-            _rate_control_state = kRcHold;
-            _time_last_bitrate_change = now_ms;
-            _time_last_bitrate_decrease = now_ms;
+            state.rate_control_state = kRcHold;
+            state.time_last_bitrate_change = now_ms;
+            state.time_last_bitrate_decrease = now_ms;
             break;
 
         default:
             assert(false);
     }
 
-    cout << "[ChangeBitrate] new_bitrate_bps=" << ClampBitrate(new_bitrate_bps, estimated_throughput_bps) << "bps"<< endl;
-    return ClampBitrate(new_bitrate_bps, estimated_throughput_bps);
+    state.current_bitrate_bps = ClampBitrate(config, state.current_bitrate_bps, new_bitrate_bps,
+            estimated_throughput_bps);
+    if (kDebugLog)
+        cout << "[ChangeBitrate] new_bitrate_bps=" << state.current_bitrate_bps << "bps"<< endl;
+    return state.current_bitrate_bps;
 }
 
 
 // gcc 草案During multiplicative increase, the estimate is increased by at most 8% per second.
 // eta = 1.08^min(time_since_last_update_ms / 1000, 1.0)
+// eta 由 MultiplicativeIncreaseFactor() 查表得到
 // A_hat(i) = eta * A_hat(i-1)
-uint32_t AimdRateControl::MultiplicativeRateIncrease(int64_t now_ms, int64_t last_ms, uint32_t current_bitrate_bps) const 
+static uint32_t MultiplicativeRateIncrease(int64_t now_ms, int64_t last_ms, uint32_t current_bitrate_bps)
 {
     // 系数与paper中1.05略有不同,与草案1.08相同,时间差作为指数
     double alpha = 1.08;
     if (last_ms > -1) {
-        // auto time_since_last_update_ms = rtc::SafeMin<int64_t>(now_ms - last_ms, 1000);
-        auto time_since_last_update_ms = now_ms - last_ms;
-        alpha = pow(alpha, time_since_last_update_ms / 1000.0);
+        alpha = MultiplicativeIncreaseFactor(now_ms - last_ms);
     }
     uint32_t multiplicative_increase_bps =
         std::max(current_bitrate_bps * (alpha - 1.0), 1000.0);
-
-    cout << "[MultiplicativeRateIncrease] " << "time_since_last_update_ms=" << now_ms - last_ms << "ms" << " alpha=" << alpha
-         << " multiplicative_increase_bps=" << multiplicative_increase_bps << "bps" << endl;
     return multiplicative_increase_bps;
 }
 
 // 加性码率增长
-uint32_t AimdRateControl::AdditiveRateIncrease(int64_t now_ms, int64_t last_ms) const {
+static uint32_t AdditiveRateIncrease(int64_t now_ms, int64_t last_ms,
+        int near_max_increase_rate_bps) {
     return static_cast<uint32_t>((now_ms - last_ms) *
-            GetNearMaxIncreaseRateBps() / 1000);
+            near_max_increase_rate_bps / 1000);
 }
 
 // 根据当前码率计算(每秒)应该增加的码率（在使用带宽已经接近linked capacity的场景下）
 // 增加一个包的大小 <-> 一个responsetime, 一秒钟增加多少码率?
 // 所谓加性增:在response_time时间内增加一个包的大小packet_size_bits, 换算成码率（即1秒增加多少bits）
-int AimdRateControl::GetNearMaxIncreaseRateBps() const {
+int NearMaxIncreaseRateBps(const AimdRateControlConfig& config,
+        uint32_t current_bitrate_bps, int64_t rtt) {
     // RTC_DCHECK_GT(current_bitrate_bps_, 0);
     // 和草案计算一样 
     // 每帧码率/每帧包数=每包码率=9.6Kbps
-    cout << "current_bitrate_bps=" << _current_bitrate_bps << "bps" << endl;
-    double bits_per_frame = static_cast<double>(_current_bitrate_bps) / 30.0;
-    cout << "bits_per_frame=" << bits_per_frame << "bits" << endl;
+    double bits_per_frame = static_cast<double>(current_bitrate_bps) / config.frame_rate_fps;
     // 每帧包数向上取整
-    double packets_per_frame = std::ceil(bits_per_frame / (8.0 * 1200.0)); // 至少为1
-    cout << "packets_per_frame=" << packets_per_frame << endl;
+    double packets_per_frame = std::ceil(bits_per_frame / (8.0 * config.packet_size_bytes)); // 至少为1
     double avg_packet_size_bits = bits_per_frame / packets_per_frame;
-    cout << "avg_packet_size_bits=" << avg_packet_size_bits << "bits" << endl;
 
     // 包从发送到接收rtcp transport fedback再到过载检测的时间??
     // Approximate the over-use estimator delay to 100 ms.
@@ -339,39 +455,49 @@ int AimdRateControl::GetNearMaxIncreaseRateBps() const {
     // 和草案不一致
     // During the additive increase the estimate is increased with at most
     // half a packet per response_time interval. 
-    const int64_t response_time = _in_experiment ? (_rtt + 100) * 2 : _rtt + 100;
-    cout << "response_time_interval=" << response_time << "ms" << endl;
+    const int64_t response_time = config.in_experiment ? (rtt + 100) * 2 : rtt + 100;
     constexpr double kMinIncreaseRateBps = 4000;
-    cout << "[GetNearMaxIncreaseRateBps] increase_rate=" << static_cast<int>(std::max(kMinIncreaseRateBps, (avg_packet_size_bits * 1000) / response_time)) / 1000  << "Kbps" << endl;
     // 低码率场景下(比如30Kbps)至少增加4Kbps
-    return static_cast<int>(std::max(kMinIncreaseRateBps, (avg_packet_size_bits * 1000) / response_time));
+    return static_cast<int>(
+            std::max(kMinIncreaseRateBps, (avg_packet_size_bits * 1000) / response_time));
+}
+
+int NearMaxIncreaseRateBps(const AimdRateControlConfig& config,
+        uint32_t current_bitrate_bps, int64_t rtt, NearMaxIncreaseRateCache& cache) {
+    if (cache.rate_bps >= 0 && cache.bitrate_bps == current_bitrate_bps && cache.rtt == rtt)
+        return cache.rate_bps;
+    cache.rate_bps = NearMaxIncreaseRateBps(config, current_bitrate_bps, rtt);
+    cache.bitrate_bps = current_bitrate_bps;
+    cache.rtt = rtt;
+    return cache.rate_bps;
 }
 
 // Returns the expected time between overuse signals (assuming steady state).???
 // BWE周期[0.5s/2s, 50s] ??? 默认3s
 // 拥塞过载状态增加BWE周期，减少探测???
-int AimdRateControl::GetExpectedBandwidthPeriodMs() const {
-    const int kMinPeriodMs = _smoothing_experiment ? 500 : 2000;
+int ExpectedBandwidthPeriodMs(const AimdRateControlConfig& config,
+        int last_decrease, int near_max_increase_rate_bps) {
+    const int kMinPeriodMs = config.smoothing_experiment ? 500 : 2000;
     constexpr int kDefaultPeriodMs = 3000;
     constexpr int kMaxPeriodMs = 50000;
 
-    int increase_rate = GetNearMaxIncreaseRateBps();
-
     // 未发生拥塞,使用默认BWE探测周期3s
-    if (!_last_decrease)
-        return _smoothing_experiment ? kMinPeriodMs : kDefaultPeriodMs;
+    if (!last_decrease)
+        return config.smoothing_experiment ? kMinPeriodMs : kDefaultPeriodMs;
 
-    // 为什么要用_last_decrease/increase_rate???
+    // 为什么要用last_decrease/increase_rate???
     // 拥塞过载场景下,rtt增大,increase_rate减小,BWE探测周期变大
     return std::min(kMaxPeriodMs,
-            std::max<int>(1000 * static_cast<int64_t>(_last_decrease) /
-                increase_rate,
+            std::max<int>(1000 * static_cast<int64_t>(last_decrease) /
+                near_max_increase_rate_bps,
                 kMinPeriodMs));
 }
 
 // 计算最大码率的方差
 // 在码率减少时进行估计??? 解决
-void AimdRateControl::UpdateMaxThroughputEstimate(float estimated_throughput_kbps) {
+void UpdateMaxThroughputEstimate(float estimated_throughput_kbps,
+        float& avg_max_bitrate_kbps,
+        float& var_max_bitrate_kbps) {
     // 草案, It is RECOMMENDED to measure this average and standard deviation with an
     // exponential moving average with the smoothing factor 0.95, as it is
     // expected that this average covers multiple occasions at which we are in the Decrease state.
@@ -379,33 +505,34 @@ void AimdRateControl::UpdateMaxThroughputEstimate(float estimated_throughput_kbp
 
     // 指数平滑平均最大码率
     // 码率的指数移动均值
-    if (_avg_max_bitrate_kbps == -1.0f) {
-        _avg_max_bitrate_kbps = estimated_throughput_kbps;
+    if (avg_max_bitrate_kbps == -1.0f) {
+        avg_max_bitrate_kbps = estimated_throughput_kbps;
     } else {
-        _avg_max_bitrate_kbps = (1 - alpha) * _avg_max_bitrate_kbps + alpha * estimated_throughput_kbps;
+        avg_max_bitrate_kbps = (1 - alpha) * avg_max_bitrate_kbps + alpha * estimated_throughput_kbps;
     }
 
     // 平滑最大码率方差
     // 计算码率方差、normalize 意欲何为? 归一化? 再平滑
     // 也只能这么解释了:Estimate the max bit rate variance and normalize the variance with the average max bit rate.
-    const float norm = std::max(_avg_max_bitrate_kbps, 1.0f);
-    _var_max_bitrate_kbps =
-        (1 - alpha) * _var_max_bitrate_kbps +
-        alpha * (_avg_max_bitrate_kbps - estimated_throughput_kbps) *
-        (_avg_max_bitrate_kbps - estimated_throughput_kbps) / norm;
+    const float norm = std::max(avg_max_bitrate_kbps, 1.0f);
+    var_max_bitrate_kbps =
+        (1 - alpha) * var_max_bitrate_kbps +
+        alpha * (avg_max_bitrate_kbps - estimated_throughput_kbps) *
+        (avg_max_bitrate_kbps - estimated_throughput_kbps) / norm;
     
     // 设置最小和最大波动值
     // 0.4 ~= 14 kbit/s at 500 kbit/s
-    if (_var_max_bitrate_kbps < 0.4f) {
-        _var_max_bitrate_kbps = 0.4f;
+    if (var_max_bitrate_kbps < 0.4f) {
+        var_max_bitrate_kbps = 0.4f;
     }
     // 2.5f ~= 35 kbit/s at 500 kbit/s
-    if (_var_max_bitrate_kbps > 2.5f) {
-        _var_max_bitrate_kbps = 2.5f;
+    if (var_max_bitrate_kbps > 2.5f) {
+        var_max_bitrate_kbps = 2.5f;
     }
 
-    cout << "[UpdateMaxThroughputEstimate] " << "avg_max_bitrate_kbps=" << _avg_max_bitrate_kbps << "Kbps" 
-         << " var_max_bitrate_kbps=" << _var_max_bitrate_kbps << endl;
+    if (kDebugLog)
+        cout << "[UpdateMaxThroughputEstimate] " << "avg_max_bitrate_kbps=" << avg_max_bitrate_kbps << "Kbps" 
+             << " var_max_bitrate_kbps=" << var_max_bitrate_kbps << endl;
 }
 
 // 码率控制状态机转换
@@ -414,37 +541,42 @@ void AimdRateControl::UpdateMaxThroughputEstimate(float estimated_throughput_kbp
 // 3. Normal状态
 // 3.1 当前在Hold、incr状态，此时会进入Inc状态
 // 3.2 当前在衰减状态，此时会进入hold状态
-void AimdRateControl::ChangeState(const RateControlInput& input, int64_t now_ms) {
-    switch(input.bw_state) {
+void ChangeState(BandwidthUsage bw_state, int64_t now_ms,
+        RateControlState& rate_control_state,
+        int64_t& time_last_bitrate_change) {
+    switch(bw_state) {
         case BandwidthUsage::kBwNormal:
             // 我认为:在网络正常的情况下,如果原来码率处于Decrease状态,说明码率降的已经适应当前网络状况了，所以转向Hold状态；
             // 如果原来码率处于Hold/Increase状态，说明码率还有再提升的空间，所以转向Increase状态
             // 为什么没处理kRcDecrease的情况?
-            if (_rate_control_state == kRcHold) {
-                _time_last_bitrate_change = now_ms;
-                _rate_control_state = kRcIncrease;
+            if (rate_control_state == kRcHold) {
+                time_last_bitrate_change = now_ms;
+                rate_control_state = kRcIncrease;
             }
             break;
         // 过载信号下码率控制状态均为kRcDecrease
         case BandwidthUsage::kBwOverusing:
-            if (_rate_control_state != kRcDecrease) {
-                _rate_control_state = kRcDecrease;
+            if (rate_control_state != kRcDecrease) {
+                rate_control_state = kRcDecrease;
             }
             break;
         // 低载信号下码率控制状态均为kRcHold,为什么?
         // 1.网络链路低载说明网络链路带宽能力未充分利用,说明当前网络链路的带宽质量完全可以承载当前发送码率，不需要做任何改变，保持即可，
         // 2.当前网络链路上传输的数据少,远未达到预估码率,所以不需要再increase, 要么decrease要么hold,为了和过载时的decrease作区分,算法在这种情况下决定hold
         case BandwidthUsage::kBwUnderusing:
-            _rate_control_state = kRcHold;
+            rate_control_state = kRcHold;
             break;
         default:
             assert(false);
     }
     // cout << "[ChangeState] " << "BandwidthUsage=" << static_cast<int>(input.bw_state)
     //      << " _rate_control_state=" << _rate_control_state << endl;
-    cout << "[ChangeState] " << "rate_control_state=increase" << endl;
+    if (kDebugLog)
+        cout << "[ChangeState] " << "rate_control_state=increase" << endl;
 }
 
+}  // namespace aimd
+
 } // namespace webrtc
 
 
@@ -39,6 +39,106 @@ struct RateControlInput {
     uint32_t estimated_throughput_bps;
 };
 
+// Returns the slow start increase factor 1.08^(t/1000) for a time since the
+// last update of t ms, with t clamped to [0, 1000]. Read from a table that is
+// built on first use; exact w.r.t. pow() for every integer ms delta.
+double MultiplicativeIncreaseFactor(int64_t time_since_last_update_ms);
+
+namespace congestion_controller {
+// 配置的最小码率, 音频走send side bwe时为5kbps, 否则10kbps
+int GetMinBitrateBps();
+}  // namespace congestion_controller
+
+// Configuration shared by every session: field trials are read once at
+// construction, frame rate and packet size can be changed afterwards.
+struct AimdRateControlConfig {
+    AimdRateControlConfig();
+
+    uint32_t min_configured_bitrate_bps;
+    uint32_t max_configured_bitrate_bps;
+    float beta;
+    bool in_experiment;
+    bool smoothing_experiment;
+    // Frame rate and packet size assumed when deriving the additive increase
+    // rate near the link capacity. Defaults to 30 fps and 1200 bytes.
+    double frame_rate_fps;
+    size_t packet_size_bytes;
+};
+
+// Cache of the near-max increase rate, keyed on the bitrate and rtt it was
+// computed from. A negative rate marks the cache as stale.
+struct NearMaxIncreaseRateCache {
+    NearMaxIncreaseRateCache() : rate_bps(-1), bitrate_bps(0), rtt(0) {}
+
+    int rate_bps;
+    uint32_t bitrate_bps;
+    int64_t rtt;
+};
+
+// 一个会话的码率控制状态, 引用指向实际存放的位置(AimdRateControl的成员, 或
+// AimdRateControlFleet按列存放的数组元素)。rtt和ALR只读, 直接传值。
+struct AimdRateControlStateRef {
+    uint32_t& current_bitrate_bps;
+    uint32_t& latest_estimated_throughput_bps;
+    float& avg_max_bitrate_kbps;
+    float& var_max_bitrate_kbps;
+    RateControlState& rate_control_state;
+    RateControlRegion& rate_control_region;
+    bool& bitrate_is_initialized;
+    int64_t& time_last_bitrate_change;
+    int64_t& time_last_bitrate_decrease;
+    int& last_decrease;
+    NearMaxIncreaseRateCache& near_max_increase_rate;
+    int64_t rtt;
+    bool in_alr;
+};
+
+// 码率控制的每一步计算, AimdRateControl和AimdRateControlFleet共用
+namespace aimd {
+
+// Update the target bitrate based on, among other things, the current rate
+// control state, the current target bitrate and the estimated throughput.
+// When in the "increase" state the bitrate will be increased either
+// additively or multiplicatively depending on the rate control region. When
+// in the "decrease" state the bitrate will be decreased to slightly below the
+// current throughput. When in the "hold" state the bitrate will be kept
+// constant to allow built up queues to drain.
+// 结果写回state.current_bitrate_bps并返回
+uint32_t ChangeBitrate(const AimdRateControlConfig& config,
+        const AimdRateControlStateRef& state,
+        const RateControlInput& input,
+        int64_t now_ms);
+
+// 固定码率
+// Clamps new_bitrate_bps to within the configured min bitrate and a linear
+// function of the throughput, so that the new bitrate can't grow too
+// large compared to the bitrate actually being received by the other end.
+uint32_t ClampBitrate(const AimdRateControlConfig& config,
+        uint32_t current_bitrate_bps,
+        uint32_t new_bitrate_bps,
+        uint32_t estimated_throughput_bps);
+
+void ChangeState(BandwidthUsage bw_state, int64_t now_ms,
+        RateControlState& rate_control_state,
+        int64_t& time_last_bitrate_change);
+
+void UpdateMaxThroughputEstimate(float estimated_throughput_kbps,
+        float& avg_max_bitrate_kbps,
+        float& var_max_bitrate_kbps);
+
+// Returns the increase rate when used bandwidth is near the link capacity.
+int NearMaxIncreaseRateBps(const AimdRateControlConfig& config,
+        uint32_t current_bitrate_bps, int64_t rtt);
+// 同上, 码率和rtt都没变时直接返回|cache|中的值
+int NearMaxIncreaseRateBps(const AimdRateControlConfig& config,
+        uint32_t current_bitrate_bps, int64_t rtt, NearMaxIncreaseRateCache& cache);
+
+// Returns the expected time between overuse signals (assuming steady state).
+int ExpectedBandwidthPeriodMs(const AimdRateControlConfig& config,
+        int last_decrease, int near_max_increase_rate_bps);
+
+}  // namespace aimd
+
 // A rate control implementation based on additive increases of
 // bitrate when no over-use is detected and multiplicative decreases when
 // over-uses are detected. When we think the available bandwidth has changes or
@@ -49,6 +149,8 @@ struct RateControlInput {
 // 为什么慢启动模式乘性增加???
 class AimdRateControl {
 public:
+    static constexpr int64_t kDefaultRttMs = 200;
+
     AimdRateControl();
     ~AimdRateControl();
 
@@ -59,42 +161,29 @@ public:
     bool TimeToReduceFurther(int64_t now_ms,
             uint32_t estimated_throughput_bps) const;
 
+    // Returns true if there is a valid estimate of the link capacity, i.e. the
+    // estimate has been set explicitly or an over-use has been acted upon.
+    bool ValidEstimate() const;
     uint32_t LatestEstimate() const;
+    // 设置rtt,影响过载时降码率的间隔以及加性增的response time
+    void SetRtt(int64_t rtt);
     uint32_t Update(const RateControlInput* input, int64_t now_ms);
     void SetEstimate(int bitrate_bps, int64_t now_ms);
+    // 应用受限(ALR)期间反馈无法证明链路能承载更高码率, 冻结增长, 降码率不受影响
+    void SetInApplicationLimitedRegion(bool in_alr);
+
+    // See AimdRateControlConfig.
+    void SetAssumedFrameRate(double frame_rate_fps);
+    void SetAssumedPacketSize(size_t packet_size_bytes);
 
     // Returns the increase rate when used bandwidth is near the link capacity.
+    // The value is cached and only recomputed when the current bitrate or the
+    // rtt changes.
     int GetNearMaxIncreaseRateBps() const;
     // Returns the expected time between overuse signals (assuming steady state).
     int GetExpectedBandwidthPeriodMs() const;
 private:
-    // Update the target bitrate based on, among other things, the current rate
-    // control state, the current target bitrate and the estimated throughput.
-    // When in the "increase" state the bitrate will be increased either
-    // additively or multiplicatively depending on the rate control region. When
-    // in the "decrease" state the bitrate will be decreased to slightly below the
-    // current throughput. When in the "hold" state the bitrate will be kept
-    // constant to allow built up queues to drain.
-    uint32_t ChangeBitrate(uint32_t current_bitrate, const RateControlInput& input, int64_t now_ms);
-
-    // 固定码率
-    // Clamps new_bitrate_bps to within the configured min bitrate and a linear
-    // function of the throughput, so that the new bitrate can't grow too
-    // large compared to the bitrate actually being received by the other end.
-    uint32_t ClampBitrate(uint32_t new_bitrate_bps,
-            uint32_t estimated_throughput_bps) const;
-
-    uint32_t MultiplicativeRateIncrease(int64_t now_ms,
-            int64_t last_ms,
-            uint32_t current_bitrate_bps) const;
-    uint32_t AdditiveRateIncrease(int64_t now_ms, int64_t last_ms) const;
-
-    void UpdateChangePeriod(int64_t now_ms);
-    void UpdateMaxThroughputEstimate(float estimated_throughput_kbps);
-    void ChangeState(const RateControlInput& input, int64_t now_ms);
-
-    uint32_t _min_configured_bitrate_bps;
-    uint32_t _max_configured_bitrate_bps;
+    AimdRateControlConfig _config;
     uint32_t _current_bitrate_bps;
     uint32_t _latest_estimated_throughput_bps;
     float _avg_max_bitrate_kbps;
@@ -105,13 +194,13 @@ private:
     int64_t _time_last_bitrate_decrease;
     int64_t _time_first_throughput_estimate;
     bool _bitrate_is_initialized;
-    float _beta;
     int64_t _rtt;
-    const bool _in_experiment;
-    const bool _smoothing_experiment;
     const bool _in_initial_backoff_interval_experiment;
     int64_t _initial_backoff_interval_ms;
     int _last_decrease;
+    // Shared by GetNearMaxIncreaseRateBps() and the additive increase in Update().
+    mutable NearMaxIncreaseRateCache _near_max_increase_rate;
+    bool _in_alr;
 };
 
 } // namespace webrtc
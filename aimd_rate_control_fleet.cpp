@@ -0,0 +1,100 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file aimd_rate_control_fleet.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "aimd_rate_control_fleet.h"
+
+#include <cassert>
+
+namespace webrtc {
+
+AimdRateControlFleet::AimdRateControlFleet() {}
+
+AimdRateControlFleet::~AimdRateControlFleet() {}
+
+// 初始状态与新构造的AimdRateControl相同
+uint32_t AimdRateControlFleet::AddSession() {
+    _current_bitrate_bps.push_back(_config.max_configured_bitrate_bps);
+    _latest_estimated_throughput_bps.push_back(_config.max_configured_bitrate_bps);
+    _avg_max_bitrate_kbps.push_back(-1.0f);
+    _var_max_bitrate_kbps.push_back(0.4f);
+    _rate_control_state.push_back(kRcHold);
+    _rate_control_region.push_back(kRcMaxUnknown);
+    _bitrate_is_initialized.push_back(0);
+    _time_last_bitrate_change.push_back(-1);
+    _time_last_bitrate_decrease.push_back(-1);
+    _rtt.push_back(AimdRateControl::kDefaultRttMs);
+    _last_decrease.push_back(0);
+    _near_max_increase_rate.push_back(NearMaxIncreaseRateCache());
+    _in_alr.push_back(0);
+    return static_cast<uint32_t>(_current_bitrate_bps.size() - 1);
+}
+
+void AimdRateControlFleet::SetAssumedFrameRate(double frame_rate_fps) {
+    assert(frame_rate_fps > 0);
+    _config.frame_rate_fps = frame_rate_fps;
+    for (NearMaxIncreaseRateCache& cache : _near_max_increase_rate)
+        cache.rate_bps = -1;
+}
+
+void AimdRateControlFleet::SetAssumedPacketSize(size_t packet_size_bytes) {
+    assert(packet_size_bytes > 0);
+    _config.packet_size_bytes = packet_size_bytes;
+    for (NearMaxIncreaseRateCache& cache : _near_max_increase_rate)
+        cache.rate_bps = -1;
+}
+
+void AimdRateControlFleet::SetEstimate(uint32_t session, int bitrate_bps, int64_t now_ms) {
+    _bitrate_is_initialized[session] = 1;
+    uint32_t prev_bitrate_bps = _current_bitrate_bps[session];
+    _current_bitrate_bps[session] = aimd::ClampBitrate(_config, prev_bitrate_bps, bitrate_bps, bitrate_bps);
+    _time_last_bitrate_change[session] = now_ms;
+    if (_current_bitrate_bps[session] < prev_bitrate_bps) {
+        _time_last_bitrate_decrease[session] = now_ms;
+    }
+}
+
+void AimdRateControlFleet::SetRtt(uint32_t session, int64_t rtt) {
+    _rtt[session] = rtt;
+}
+
+void AimdRateControlFleet::SetInApplicationLimitedRegion(uint32_t session, bool in_alr) {
+    _in_alr[session] = in_alr;
+}
+
+void AimdRateControlFleet::Update(const AimdFleetInput* inputs, size_t num_inputs, int64_t now_ms) {
+    for (size_t i = 0; i < num_inputs; ++i) {
+        const uint32_t session = inputs[i].session;
+        assert(session < num_sessions());
+        // 标志位按uint8_t存放, 先拷出来再写回
+        bool bitrate_is_initialized = _bitrate_is_initialized[session] != 0;
+        AimdRateControlStateRef state = {_current_bitrate_bps[session],
+            _latest_estimated_throughput_bps[session], _avg_max_bitrate_kbps[session],
+            _var_max_bitrate_kbps[session], _rate_control_state[session],
+            _rate_control_region[session], bitrate_is_initialized,
+            _time_last_bitrate_change[session], _time_last_bitrate_decrease[session],
+            _last_decrease[session], _near_max_increase_rate[session], _rtt[session],
+            _in_alr[session] != 0};
+        RateControlInput input(inputs[i].bw_state, inputs[i].estimated_throughput_bps);
+        aimd::ChangeBitrate(_config, state, input, now_ms);
+        _bitrate_is_initialized[session] = bitrate_is_initialized;
+    }
+}
+
+int AimdRateControlFleet::GetNearMaxIncreaseRateBps(uint32_t session) const {
+    return aimd::NearMaxIncreaseRateBps(_config, _current_bitrate_bps[session], _rtt[session],
+            _near_max_increase_rate[session]);
+}
+
+int AimdRateControlFleet::GetExpectedBandwidthPeriodMs(uint32_t session) const {
+    return aimd::ExpectedBandwidthPeriodMs(_config, _last_decrease[session],
+            GetNearMaxIncreaseRateBps(session));
+}
+
+} // namespace webrtc
@@ -0,0 +1,93 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file aimd_rate_control_fleet.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _AIMD_RATE_CONTROL_FLEET_H
+#define _AIMD_RATE_CONTROL_FLEET_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+#include "aimd_rate_control.h"
+
+namespace webrtc {
+
+// One feedback sample for one session of the fleet.
+struct AimdFleetInput {
+    uint32_t session;
+    BandwidthUsage bw_state;
+    uint32_t estimated_throughput_bps;
+};
+
+// SFU上每个下行一个AimdRateControl, 对象字段混杂且按会话分散存储,
+// 反馈批量到达时缓存命中差。这里把N个会话的状态按字段拆成数组(SoA),
+// 一批(session, input)只触碰用到的字段。
+// Runs the AimdRateControl state machine for many sessions at once. The
+// per-session state is kept in structure-of-arrays form and a batch of
+// (session, input) pairs is processed in order, so the result for every
+// session is identical to feeding the same inputs to its own
+// AimdRateControl. Configuration (field trials, min/max bitrate, assumed
+// frame rate and packet size) is shared by all sessions.
+class AimdRateControlFleet {
+public:
+    AimdRateControlFleet();
+    ~AimdRateControlFleet();
+
+    // Adds a session in the same state as a newly constructed
+    // AimdRateControl and returns its index.
+    uint32_t AddSession();
+    size_t num_sessions() const { return _current_bitrate_bps.size(); }
+
+    void SetAssumedFrameRate(double frame_rate_fps);
+    void SetAssumedPacketSize(size_t packet_size_bytes);
+
+    void SetEstimate(uint32_t session, int bitrate_bps, int64_t now_ms);
+    void SetRtt(uint32_t session, int64_t rtt);
+    void SetInApplicationLimitedRegion(uint32_t session, bool in_alr);
+
+    // Applies |num_inputs| inputs in order, all at |now_ms|.
+    void Update(const AimdFleetInput* inputs, size_t num_inputs, int64_t now_ms);
+
+    uint32_t LatestEstimate(uint32_t session) const {
+        return _current_bitrate_bps[session];
+    }
+    bool ValidEstimate(uint32_t session) const {
+        return _bitrate_is_initialized[session] != 0;
+    }
+    int GetNearMaxIncreaseRateBps(uint32_t session) const;
+    int GetExpectedBandwidthPeriodMs(uint32_t session) const;
+
+private:
+    // Shared by all sessions.
+    AimdRateControlConfig _config;
+
+    // Per-session state, one entry per session in each array.
+    std::vector<uint32_t> _current_bitrate_bps;
+    std::vector<uint32_t> _latest_estimated_throughput_bps;
+    std::vector<float> _avg_max_bitrate_kbps;
+    std::vector<float> _var_max_bitrate_kbps;
+    std::vector<RateControlState> _rate_control_state;
+    std::vector<RateControlRegion> _rate_control_region;
+    std::vector<uint8_t> _bitrate_is_initialized;
+    std::vector<int64_t> _time_last_bitrate_change;
+    std::vector<int64_t> _time_last_bitrate_decrease;
+    std::vector<int64_t> _rtt;
+    std::vector<int> _last_decrease;
+    // 配置改变时整列失效
+    mutable std::vector<NearMaxIncreaseRateCache> _near_max_increase_rate;
+    std::vector<uint8_t> _in_alr;
+};
+
+} // namespace webrtc
+
+#endif // _AIMD_RATE_CONTROL_FLEET_H
+
+
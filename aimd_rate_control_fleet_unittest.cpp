@@ -0,0 +1,156 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file aimd_rate_control_fleet_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ -O2 aimd_rate_control_fleet_unittest.cpp aimd_rate_control_fleet.cpp aimd_rate_control.cpp field_trail.cpp random.cpp -std=c++11
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+using namespace std;
+
+#include "aimd_rate_control.h"
+#include "aimd_rate_control_fleet.h"
+#include "random.h"
+
+namespace webrtc {
+
+static BandwidthUsage RandomBandwidthUsage(Random* random) {
+    // 大部分反馈是normal, 偶尔过载/低载
+    uint32_t r = random->Rand(99);
+    if (r < 80)
+        return BandwidthUsage::kBwNormal;
+    if (r < 92)
+        return BandwidthUsage::kBwOverusing;
+    return BandwidthUsage::kBwUnderusing;
+}
+
+// FleetMatchesScalar
+// 随机输入下每个会话的结果与独立的AimdRateControl逐次一致
+void TestAimdRateControlFleet01() {
+    constexpr int kNumSessions = 200;
+    constexpr int kNumRounds = 500;
+    Random random(0x1234567);
+
+    AimdRateControlFleet fleet;
+    std::vector<std::unique_ptr<AimdRateControl>> scalars;
+    int64_t now_ms = 100000;
+    for (int i = 0; i < kNumSessions; ++i) {
+        uint32_t session = fleet.AddSession();
+        assert(session == static_cast<uint32_t>(i));
+        scalars.emplace_back(new AimdRateControl());
+        // 一部分会话先设置初始码率和rtt, 其余从未初始化状态开始
+        if (i % 3 != 0) {
+            int bitrate_bps = random.Rand(30000, 3000000);
+            fleet.SetEstimate(session, bitrate_bps, now_ms);
+            scalars[i]->SetEstimate(bitrate_bps, now_ms);
+        }
+        if (i % 2 == 0) {
+            int64_t rtt = random.Rand(10, 400);
+            fleet.SetRtt(session, rtt);
+            scalars[i]->SetRtt(rtt);
+        }
+    }
+
+    std::vector<AimdFleetInput> batch;
+    for (int round = 0; round < kNumRounds; ++round) {
+        now_ms += random.Rand(5, 200);
+        // 随机切换会话的ALR状态
+        uint32_t alr_session = random.Rand(kNumSessions - 1);
+        bool in_alr = random.Rand(1) == 1;
+        fleet.SetInApplicationLimitedRegion(alr_session, in_alr);
+        scalars[alr_session]->SetInApplicationLimitedRegion(in_alr);
+        batch.clear();
+        // 每轮只有部分会话收到反馈, 同一会话可能出现多次
+        int batch_size = random.Rand(1, kNumSessions);
+        for (int j = 0; j < batch_size; ++j) {
+            AimdFleetInput input;
+            input.session = random.Rand(kNumSessions - 1);
+            input.bw_state = RandomBandwidthUsage(&random);
+            uint32_t current = scalars[input.session]->LatestEstimate();
+            input.estimated_throughput_bps = random.Rand(current / 2, current + current / 4);
+            batch.push_back(input);
+        }
+
+        fleet.Update(batch.data(), batch.size(), now_ms);
+        for (const AimdFleetInput& input : batch) {
+            RateControlInput scalar_input(input.bw_state, input.estimated_throughput_bps);
+            scalars[input.session]->Update(&scalar_input, now_ms);
+        }
+
+        for (int i = 0; i < kNumSessions; ++i) {
+            assert(fleet.LatestEstimate(i) == scalars[i]->LatestEstimate());
+            assert(fleet.ValidEstimate(i) == scalars[i]->ValidEstimate());
+            assert(fleet.GetNearMaxIncreaseRateBps(i) == scalars[i]->GetNearMaxIncreaseRateBps());
+            assert(fleet.GetExpectedBandwidthPeriodMs(i) == scalars[i]->GetExpectedBandwidthPeriodMs());
+        }
+    }
+    cout << "FleetMatchesScalar ok, sessions=" << kNumSessions << " rounds=" << kNumRounds << endl;
+}
+
+// FleetThroughput
+// 1k-100k会话, 每轮每个会话一条反馈
+void TestAimdRateControlFleet02() {
+    constexpr int kNumRounds = 20;
+    const int kSessionCounts[] = {1000, 10000, 100000};
+
+    for (int num_sessions : kSessionCounts) {
+        Random random(0x7654321);
+        AimdRateControlFleet fleet;
+        std::vector<AimdRateControl> scalars(num_sessions);
+        int64_t now_ms = 100000;
+        for (int i = 0; i < num_sessions; ++i) {
+            fleet.AddSession();
+            fleet.SetEstimate(i, 1000000, now_ms);
+            scalars[i].SetEstimate(1000000, now_ms);
+        }
+
+        std::vector<AimdFleetInput> batch(num_sessions);
+        for (int i = 0; i < num_sessions; ++i) {
+            batch[i].session = random.Rand(num_sessions - 1);
+            batch[i].bw_state = RandomBandwidthUsage(&random);
+            batch[i].estimated_throughput_bps = random.Rand(500000, 1500000);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < kNumRounds; ++round) {
+            now_ms += 100;
+            fleet.Update(batch.data(), batch.size(), now_ms);
+        }
+        auto fleet_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+        now_ms -= kNumRounds * 100;
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < kNumRounds; ++round) {
+            now_ms += 100;
+            for (const AimdFleetInput& input : batch) {
+                RateControlInput scalar_input(input.bw_state, input.estimated_throughput_bps);
+                scalars[input.session].Update(&scalar_input, now_ms);
+            }
+        }
+        int64_t scalar_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+        const double updates = static_cast<double>(num_sessions) * kNumRounds;
+        cout << "sessions=" << num_sessions
+             << " fleet=" << fleet_ns / updates << "ns/update"
+             << " scalar=" << scalar_ns / updates << "ns/update" << endl;
+    }
+}
+
+} // namespace webrtc
+
+int main() {
+    webrtc::TestAimdRateControlFleet01();
+    webrtc::TestAimdRateControlFleet02();
+
+    return 0;
+}
@@ -11,6 +11,10 @@
 #include <iostream>
 using namespace std;
 
+#include <cassert>
+#include <chrono>
+#include <cmath>
+
 #include "aimd_rate_control.h"
 
 namespace webrtc {
@@ -210,6 +214,122 @@ void TestAimdRateControl08() {
     delete aimd_rate_control;
 }
 
+// NearMaxIncreaseRateFollowsAssumedFrameRateAndPacketSize
+void TestAimdRateControl09() {
+    AimdRateControl* aimd_rate_control = new AimdRateControl();
+
+    constexpr int kBitrate = 90000;
+    aimd_rate_control->SetEstimate(kBitrate, simulated_clock.TimeInMilliseconds());
+    // 90kbps/30fps=3000bits,1个包,3000bits/300ms=10kbps
+    assert(aimd_rate_control->GetNearMaxIncreaseRateBps() == 10000);
+    // 码率和rtt不变, 返回缓存值
+    assert(aimd_rate_control->GetNearMaxIncreaseRateBps() == 10000);
+
+    // 90kbps/15fps=6000bits,1个包,6000bits/300ms=20kbps
+    aimd_rate_control->SetAssumedFrameRate(15.0);
+    assert(aimd_rate_control->GetNearMaxIncreaseRateBps() == 20000);
+
+    // 6000bits按500字节拆成2个包,3000bits/300ms=10kbps
+    aimd_rate_control->SetAssumedPacketSize(500);
+    assert(aimd_rate_control->GetNearMaxIncreaseRateBps() == 10000);
+
+    // 码率变化后缓存失效: 180kbps/15fps=12000bits,3个包,4000bits/300ms=13333bps
+    aimd_rate_control->SetEstimate(2 * kBitrate, simulated_clock.TimeInMilliseconds());
+    assert(aimd_rate_control->GetNearMaxIncreaseRateBps() == 13333);
+    cout << "GetNearMaxIncreaseRateBps ok" << endl;
+
+    delete aimd_rate_control;
+}
+
+// MultiplicativeIncreaseFactorMatchesPow
+// 查表结果与pow()的相对误差
+void TestAimdRateControl10() {
+    double max_relative_error = 0.0;
+    for (int64_t ms = -10; ms <= 2000; ++ms) {
+        const int64_t clamped_ms = std::min<int64_t>(std::max<int64_t>(ms, 0), 1000);
+        const double expected = pow(1.08, clamped_ms / 1000.0);
+        const double error = fabs(MultiplicativeIncreaseFactor(ms) - expected) / expected;
+        max_relative_error = std::max(max_relative_error, error);
+    }
+    cout << "max_relative_error=" << max_relative_error << endl;
+    assert(max_relative_error <= 1e-15);
+}
+
+// MultiplicativeIncreaseFactorPerf
+// 查表与pow()耗时对比
+void TestAimdRateControl11() {
+    constexpr int kIterations = 10000000;
+    double sum = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i)
+        sum += pow(1.08, (i % 1001) / 1000.0);
+    auto pow_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i)
+        sum += MultiplicativeIncreaseFactor(i % 1001);
+    auto table_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    cout << "pow=" << static_cast<double>(pow_ns) / kIterations << "ns/call"
+         << " table=" << static_cast<double>(table_ns) / kIterations << "ns/call"
+         << " (sum=" << sum << ")" << endl;
+}
+
+// TimeToReduceFurtherFollowsRtt
+void TestAimdRateControl12() {
+    AimdRateControl* aimd_rate_control = new AimdRateControl();
+
+    constexpr int kBitrate = 300000;
+    aimd_rate_control->SetEstimate(kBitrate, simulated_clock.TimeInMilliseconds());
+    const int64_t now_ms = simulated_clock.TimeInMilliseconds();
+
+    // 默认rtt=200ms, 50ms后还不能再次降码率
+    assert(!aimd_rate_control->TimeToReduceFurther(now_ms + 50, kBitrate));
+    assert(aimd_rate_control->TimeToReduceFurther(now_ms + 200, kBitrate));
+
+    // rtt=20ms, 20ms后即可再次降码率
+    aimd_rate_control->SetRtt(20);
+    assert(!aimd_rate_control->TimeToReduceFurther(now_ms + 10, kBitrate));
+    assert(aimd_rate_control->TimeToReduceFurther(now_ms + 20, kBitrate));
+
+    // 吞吐量低于估计值的一半,立即可以再次降码率
+    assert(aimd_rate_control->TimeToReduceFurther(now_ms + 10, kBitrate / 2 - 1));
+    cout << "TimeToReduceFurther ok" << endl;
+
+    delete aimd_rate_control;
+}
+
+// 过载后在给定rtt下加性增5s,返回恢复后的码率
+static uint32_t BitrateAfterRecovery(int64_t rtt_ms) {
+    AimdRateControl aimd_rate_control;
+    aimd_rate_control.SetRtt(rtt_ms);
+
+    constexpr int kBitrate = 300000;
+    int64_t now_ms = simulated_clock.TimeInMilliseconds();
+    aimd_rate_control.SetEstimate(kBitrate, now_ms);
+    RateControlInput overuse(BandwidthUsage::kBwOverusing, kBitrate);
+    aimd_rate_control.Update(&overuse, now_ms);
+
+    for (int i = 0; i < 50; ++i) {
+        now_ms += 100;
+        RateControlInput input(BandwidthUsage::kBwNormal, aimd_rate_control.LatestEstimate());
+        aimd_rate_control.Update(&input, now_ms);
+    }
+    return aimd_rate_control.LatestEstimate();
+}
+
+// FasterRecoveryAtLowRtt
+void TestAimdRateControl13() {
+    const uint32_t bitrate_200ms_rtt = BitrateAfterRecovery(200);
+    const uint32_t bitrate_20ms_rtt = BitrateAfterRecovery(20);
+    cout << "rtt=200ms bitrate=" << bitrate_200ms_rtt << "bps"
+         << " rtt=20ms bitrate=" << bitrate_20ms_rtt << "bps" << endl;
+    assert(bitrate_20ms_rtt > bitrate_200ms_rtt);
+}
+
 } // namespace webrtc
 
 int main() {
@@ -221,6 +341,11 @@ int main() {
     // webrtc::TestAimdRateControl06();
     // webrtc::TestAimdRateControl07();
     // webrtc::TestAimdRateControl08();
+    webrtc::TestAimdRateControl09();
+    webrtc::TestAimdRateControl10();
+    webrtc::TestAimdRateControl11();
+    webrtc::TestAimdRateControl12();
+    webrtc::TestAimdRateControl13();
 
     return 0;
 }
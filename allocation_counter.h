@@ -0,0 +1,74 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file allocation_counter.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _ALLOCATION_COUNTER_H
+#define _ALLOCATION_COUNTER_H
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <new>
+
+// 单元测试用: 替换全局operator new/delete, 统计堆分配次数, 用来验证某段代码不分配内存。
+// 这里定义的是全局函数, 一个程序只能有一个.cpp(单元测试的main文件)include本文件。
+// 所有形式都走malloc/free, new和delete按形式一一配对。
+static size_t g_num_allocations = 0;
+
+void* operator new(size_t size) {
+    ++g_num_allocations;
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    ++g_num_allocations;
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    ++g_num_allocations;
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    ++g_num_allocations;
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    free(p);
+}
+
+#endif // _ALLOCATION_COUNTER_H
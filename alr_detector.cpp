@@ -0,0 +1,73 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file alr_detector.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "alr_detector.h"
+
+namespace webrtc {
+
+// Sent traffic percentage as a function of network capacity used to determine
+// application-limited region. ALR region start when bandwidth usage drops
+// below kAlrStartUsageRatio and ends when it raises above
+// kAlrEndUsageRatio. NOTE: This is intentionally conservative at the moment
+// until BW adjustments of application limited region is fine tuned.
+static const double kDefaultBandwidthUsageRatio = 0.65;
+static const double kDefaultStartBudgetLevelRatio = 0.80;
+static const double kDefaultStopBudgetLevelRatio = 0.50;
+
+AlrDetector::AlrDetector()
+    : AlrDetector(kDefaultBandwidthUsageRatio,
+                  kDefaultStartBudgetLevelRatio,
+                  kDefaultStopBudgetLevelRatio) {}
+
+AlrDetector::AlrDetector(double bandwidth_usage_ratio,
+                         double start_budget_level_ratio,
+                         double stop_budget_level_ratio)
+    : _bandwidth_usage_ratio(bandwidth_usage_ratio),
+      _start_budget_level_ratio(start_budget_level_ratio),
+      _stop_budget_level_ratio(stop_budget_level_ratio),
+      _last_send_time_ms(-1),
+      _alr_budget(0, true),
+      _alr_started_time_ms(-1) {}
+
+AlrDetector::~AlrDetector() {}
+
+// 预算按估计码率的65%累积, 实际发送消耗预算; 剩余预算超过窗口的80%进入ALR, 低于50%退出
+void AlrDetector::OnBytesSent(size_t bytes_sent, int64_t send_time_ms) {
+    if (_last_send_time_ms < 0) {
+        _last_send_time_ms = send_time_ms;
+        // Since the duration for sending the bytes is unknwon, return without
+        // updating alr state.
+        return;
+    }
+    int64_t delta_time_ms = send_time_ms - _last_send_time_ms;
+    _last_send_time_ms = send_time_ms;
+
+    _alr_budget.UseBudget(bytes_sent);
+    _alr_budget.IncreaseBudget(delta_time_ms);
+    if (_alr_budget.budget_ratio() > _start_budget_level_ratio &&
+            _alr_started_time_ms < 0) {
+        _alr_started_time_ms = send_time_ms;
+    } else if (_alr_budget.budget_ratio() < _stop_budget_level_ratio &&
+            _alr_started_time_ms >= 0) {
+        _alr_started_time_ms = -1;
+    }
+}
+
+void AlrDetector::SetEstimatedBitrate(int bitrate_bps) {
+    int target_rate_kbps =
+        static_cast<double>(bitrate_bps) * _bandwidth_usage_ratio / 1000;
+    _alr_budget.set_target_rate_kbps(target_rate_kbps);
+}
+
+int64_t AlrDetector::GetApplicationLimitedRegionStartTime() const {
+    return _alr_started_time_ms;
+}
+
+} // namespace webrtc
@@ -0,0 +1,65 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file alr_detector.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _ALR_DETECTOR_H
+#define _ALR_DETECTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "interval_budget.h"
+
+namespace webrtc {
+
+// Application limited region detector is a class that utilizes signals of
+// elapsed time and bytes sent to estimate whether network traffic is
+// currently limited by the application's ability to generate traffic.
+//
+// AlrDetector provides a signal that can be utilized to adjust
+// estimate bandwidth.
+// Note: This class is not thread-safe.
+// 应用受限(ALR): 编码器产出远低于带宽估计(如静态屏幕共享), 此时的反馈无法验证更高的估计,
+// AIMD不应继续增长, 否则内容变为动态时会严重超发。
+class AlrDetector {
+public:
+    AlrDetector();
+    // |bandwidth_usage_ratio|: fraction of the estimate the budget refills at.
+    // ALR starts when the unused budget exceeds |start_budget_level_ratio| of
+    // the window and ends when it falls below |stop_budget_level_ratio|.
+    AlrDetector(double bandwidth_usage_ratio,
+                double start_budget_level_ratio,
+                double stop_budget_level_ratio);
+    ~AlrDetector();
+
+    void OnBytesSent(size_t bytes_sent, int64_t send_time_ms);
+
+    // Set current estimated bandwidth.
+    void SetEstimatedBitrate(int bitrate_bps);
+
+    // Returns time in milliseconds when the current application-limited region
+    // started or -1 if the sender is currently not application-limited.
+    int64_t GetApplicationLimitedRegionStartTime() const;
+
+private:
+    const double _bandwidth_usage_ratio;
+    const double _start_budget_level_ratio;
+    const double _stop_budget_level_ratio;
+
+    int64_t _last_send_time_ms;
+
+    IntervalBudget _alr_budget;
+    int64_t _alr_started_time_ms;
+};
+
+} // namespace webrtc
+
+#endif // _ALR_DETECTOR_H
+
+
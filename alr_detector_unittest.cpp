@@ -0,0 +1,224 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file alr_detector_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ alr_detector_unittest.cpp alr_detector.cpp interval_budget.cpp aimd_rate_control.cpp field_trail.cpp -std=c++11
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "aimd_rate_control.h"
+#include "alr_detector.h"
+
+namespace webrtc {
+
+constexpr int kEstimatedBitrateBps = 300000;
+
+// 以|usage_percentage|%的估计码率发送|interval_ms|
+static int64_t SimulateOutgoingTraffic(AlrDetector* alr_detector, int64_t now_ms,
+        int64_t interval_ms, int usage_percentage) {
+    const int64_t kTimeStepMs = 10;
+    for (int64_t t = 0; t < interval_ms; t += kTimeStepMs) {
+        now_ms += kTimeStepMs;
+        alr_detector->OnBytesSent(kEstimatedBitrateBps * usage_percentage *
+                kTimeStepMs / (8 * 100 * 1000), now_ms);
+    }
+    return now_ms;
+}
+
+// AlrDetection
+// 发送码率低于估计的20%进入ALR, 恢复到估计码率后退出
+void TestAlrDetector01() {
+    AlrDetector alr_detector;
+    alr_detector.SetEstimatedBitrate(kEstimatedBitrateBps);
+    int64_t now_ms = 1000;
+
+    // Start in non-ALR state.
+    assert(alr_detector.GetApplicationLimitedRegionStartTime() == -1);
+
+    // Stay in non-ALR state when usage is close to 100%.
+    now_ms = SimulateOutgoingTraffic(&alr_detector, now_ms, 1000, 90);
+    assert(alr_detector.GetApplicationLimitedRegionStartTime() == -1);
+
+    // Verify that we ALR starts when bitrate drops below 20%.
+    now_ms = SimulateOutgoingTraffic(&alr_detector, now_ms, 1500, 20);
+    assert(alr_detector.GetApplicationLimitedRegionStartTime() != -1);
+
+    // Verify that ALR ends when usage is above 65%.
+    now_ms = SimulateOutgoingTraffic(&alr_detector, now_ms, 4000, 100);
+    assert(alr_detector.GetApplicationLimitedRegionStartTime() == -1);
+}
+
+// ShortSpike
+// 短暂的突发不足以退出ALR
+void TestAlrDetector02() {
+    AlrDetector alr_detector;
+    alr_detector.SetEstimatedBitrate(kEstimatedBitrateBps);
+    int64_t now_ms = 1000;
+
+    now_ms = SimulateOutgoingTraffic(&alr_detector, now_ms, 1000, 20);
+    assert(alr_detector.GetApplicationLimitedRegionStartTime() != -1);
+
+    // Verify that we stay in ALR region even after a short bitrate spike.
+    now_ms = SimulateOutgoingTraffic(&alr_detector, now_ms, 100, 150);
+    assert(alr_detector.GetApplicationLimitedRegionStartTime() != -1);
+
+    // ALR ends when usage is above 65%.
+    now_ms = SimulateOutgoingTraffic(&alr_detector, now_ms, 3000, 100);
+    assert(alr_detector.GetApplicationLimitedRegionStartTime() == -1);
+}
+
+// BandwidthEstimateChanges
+// 估计码率上调后, 原来的发送码率变成应用受限
+void TestAlrDetector03() {
+    AlrDetector alr_detector;
+    alr_detector.SetEstimatedBitrate(kEstimatedBitrateBps);
+    int64_t now_ms = 1000;
+
+    // ALR starts when bitrate drops below 20%.
+    now_ms = SimulateOutgoingTraffic(&alr_detector, now_ms, 1000, 20);
+    assert(alr_detector.GetApplicationLimitedRegionStartTime() != -1);
+
+    // When bandwidth estimate drops the detector should stay in ALR mode and quit
+    // it shortly afterwards as the sender continues sending the same amount of
+    // traffic. This is necessary to ensure that ProbeController can still react
+    // to the BWE drop by initiating a new probe.
+    alr_detector.SetEstimatedBitrate(kEstimatedBitrateBps / 5);
+    assert(alr_detector.GetApplicationLimitedRegionStartTime() != -1);
+    now_ms = SimulateOutgoingTraffic(&alr_detector, now_ms, 1000, 50);
+    assert(alr_detector.GetApplicationLimitedRegionStartTime() == -1);
+}
+
+// 仿真: 1Mbps瓶颈链路, 流体队列模型。前120s为静态屏幕共享, 编码器约100kbps,
+// 每1s有一次200ms的局部刷新突发(900kbps); 之后内容变为动态, 编码器按估计码率发送。
+// 每100ms一次反馈, 反馈滞后一个rtt(100ms): 排队时延超过20ms即过载,
+// 吞吐量为该区间内链路实际送达的码率。
+class ContentSwitchSimulation {
+public:
+    explicit ContentSwitchSimulation(bool use_alr)
+        : _use_alr(use_alr), _queue_bits(0) {}
+
+    void Run() {
+        _rate_control.SetEstimate(kStartBitrateBps, 0);
+        _alr_detector.SetEstimatedBitrate(kStartBitrateBps);
+        double delay_sum_ms = 0;
+        int delay_samples = 0;
+        for (int64_t now_ms = 0; now_ms < kSwitchMs + kDynamicMs; now_ms += kStepMs) {
+            const int64_t send_bps = EncoderBitrateBps(now_ms);
+            const int64_t sent_bits = send_bps * kStepMs / 1000;
+            _alr_detector.OnBytesSent(sent_bits / 8, now_ms);
+
+            // 链路每个step最多送出capacity*step, 其余在队列里排队
+            const int64_t link_bits = kCapacityBps * kStepMs / 1000;
+            _queue_bits += sent_bits;
+            const int64_t delivered = std::min(_queue_bits, link_bits);
+            _queue_bits -= delivered;
+            const double queue_delay_ms = _queue_bits * 1000.0 / kCapacityBps;
+            _delivered_bits.push_back(delivered);
+            _queue_delay_ms.push_back(queue_delay_ms);
+
+            if (now_ms >= kSwitchMs) {
+                _max_delay_after_switch_ms = std::max(_max_delay_after_switch_ms, queue_delay_ms);
+                delay_sum_ms += queue_delay_ms;
+                ++delay_samples;
+            } else {
+                _estimate_at_switch_bps = _rate_control.LatestEstimate();
+            }
+
+            if (now_ms % kFeedbackIntervalMs == 0 && now_ms >= kFeedbackIntervalMs + kRttMs) {
+                if (_use_alr) {
+                    _rate_control.SetInApplicationLimitedRegion(
+                            _alr_detector.GetApplicationLimitedRegionStartTime() >= 0);
+                }
+                // 反馈覆盖[now - rtt - interval, now - rtt)
+                const size_t end = (now_ms - kRttMs) / kStepMs;
+                const size_t begin = end - kFeedbackIntervalMs / kStepMs;
+                int64_t feedback_bits = 0;
+                for (size_t i = begin; i < end; ++i)
+                    feedback_bits += _delivered_bits[i];
+                BandwidthUsage state = _queue_delay_ms[end - 1] > kOveruseDelayMs
+                    ? BandwidthUsage::kBwOverusing : BandwidthUsage::kBwNormal;
+                uint32_t throughput_bps = static_cast<uint32_t>(
+                        feedback_bits * 1000 / kFeedbackIntervalMs);
+                RateControlInput input(state, throughput_bps);
+                _rate_control.Update(&input, now_ms);
+                _alr_detector.SetEstimatedBitrate(_rate_control.LatestEstimate());
+            }
+        }
+        _avg_delay_after_switch_ms = delay_sum_ms / delay_samples;
+    }
+
+    uint32_t estimate_at_switch_bps() const { return _estimate_at_switch_bps; }
+    double max_delay_after_switch_ms() const { return _max_delay_after_switch_ms; }
+    double avg_delay_after_switch_ms() const { return _avg_delay_after_switch_ms; }
+
+private:
+    static constexpr int64_t kCapacityBps = 1000000;
+    static constexpr int64_t kStartBitrateBps = 300000;
+    static constexpr int64_t kStaticBitrateBps = 100000;
+    static constexpr int64_t kRefreshBitrateBps = 900000;
+    static constexpr int64_t kRefreshPeriodMs = 1000;
+    static constexpr int64_t kRefreshDurationMs = 200;
+    static constexpr int64_t kSwitchMs = 120000;
+    static constexpr int64_t kDynamicMs = 10000;
+    static constexpr int64_t kStepMs = 10;
+    static constexpr int64_t kFeedbackIntervalMs = 100;
+    static constexpr int64_t kRttMs = 100;
+    static constexpr double kOveruseDelayMs = 20;
+
+    int64_t EncoderBitrateBps(int64_t now_ms) const {
+        if (now_ms >= kSwitchMs)
+            return _rate_control.LatestEstimate();
+        if (now_ms % kRefreshPeriodMs < kRefreshDurationMs)
+            return kRefreshBitrateBps;
+        return kStaticBitrateBps;
+    }
+
+    const bool _use_alr;
+    AimdRateControl _rate_control;
+    AlrDetector _alr_detector;
+    int64_t _queue_bits;
+    // 每个step链路送达的比特数和队列时延, 用于构造滞后的反馈
+    std::vector<int64_t> _delivered_bits;
+    std::vector<double> _queue_delay_ms;
+    uint32_t _estimate_at_switch_bps = 0;
+    double _max_delay_after_switch_ms = 0;
+    double _avg_delay_after_switch_ms = 0;
+};
+
+// ContentSwitchQueueingDelay
+// 静态内容期间冻结增长, 切换为动态内容后的排队时延明显更低
+void TestAlrDetector04() {
+    ContentSwitchSimulation with_alr(true);
+    ContentSwitchSimulation without_alr(false);
+    with_alr.Run();
+    without_alr.Run();
+    cout << "with alr: estimate at switch=" << with_alr.estimate_at_switch_bps() << "bps"
+         << " max delay=" << with_alr.max_delay_after_switch_ms() << "ms"
+         << " avg delay=" << with_alr.avg_delay_after_switch_ms() << "ms" << endl;
+    cout << "without alr: estimate at switch=" << without_alr.estimate_at_switch_bps() << "bps"
+         << " max delay=" << without_alr.max_delay_after_switch_ms() << "ms"
+         << " avg delay=" << without_alr.avg_delay_after_switch_ms() << "ms" << endl;
+    assert(with_alr.estimate_at_switch_bps() < without_alr.estimate_at_switch_bps());
+    assert(with_alr.max_delay_after_switch_ms() < without_alr.max_delay_after_switch_ms());
+    assert(with_alr.avg_delay_after_switch_ms() < without_alr.avg_delay_after_switch_ms());
+}
+
+} // namespace webrtc
+
+int main() {
+    webrtc::TestAlrDetector01();
+    webrtc::TestAlrDetector02();
+    webrtc::TestAlrDetector03();
+    webrtc::TestAlrDetector04();
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file bitrate_estimator.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "bitrate_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace webrtc {
+
+static const int kInitialRateWindowMs = 500;
+static const int kRateWindowMs = 150;
+static const int kMaxRateWindowMs = 1000;
+static const float kUncertaintyScale = 10.0f;
+
+BitrateEstimator::BitrateEstimator()
+    : _rate_statistics(kMaxRateWindowMs, RateStatistics::kBpsScale),
+    _initial_window_ms(kInitialRateWindowMs),
+    _noninitial_window_ms(kRateWindowMs),
+    _uncertainty_scale(kUncertaintyScale),
+    _uncertainty_scale_in_alr(kUncertaintyScale),
+    _current_window_ms(0),
+    _prev_time_ms(-1),
+    _bitrate_estimate_kbps(-1.0f),
+    _bitrate_estimate_var(50.0f) {}
+
+BitrateEstimator::~BitrateEstimator() {}
+
+void BitrateEstimator::Update(int64_t now_ms, size_t bytes, bool in_alr) {
+    int rate_window_ms = _noninitial_window_ms;
+    // We use a larger window at the beginning to get a more stable sample that
+    // we can use to initialize the estimate.
+    if (_bitrate_estimate_kbps < 0.f)
+        rate_window_ms = _initial_window_ms;
+    float bitrate_sample_kbps = UpdateWindow(now_ms, bytes, rate_window_ms);
+    if (bitrate_sample_kbps < 0.0f)
+        return;
+    if (_bitrate_estimate_kbps < 0.0f) {
+        // This is the very first sample we get. Use it to initialize the estimate.
+        _bitrate_estimate_kbps = bitrate_sample_kbps;
+        return;
+    }
+    // Optionally use higher uncertainty for samples obtained during ALR.
+    float scale = _uncertainty_scale;
+    if (in_alr && bitrate_sample_kbps < _bitrate_estimate_kbps)
+        scale = _uncertainty_scale_in_alr;
+    // Define the sample uncertainty as a function of how far away it is from the
+    // current estimate.
+    float sample_uncertainty = scale * std::abs(_bitrate_estimate_kbps - bitrate_sample_kbps) /
+        _bitrate_estimate_kbps;
+    float sample_var = sample_uncertainty * sample_uncertainty;
+    // Update a bayesian estimate of the rate, weighting it lower if the sample
+    // uncertainty is large.
+    // The bitrate estimate uncertainty is increased with each update to model
+    // that the bitrate changes over time.
+    float pred_bitrate_estimate_var = _bitrate_estimate_var + 5.f;
+    _bitrate_estimate_kbps = (sample_var * _bitrate_estimate_kbps +
+            pred_bitrate_estimate_var * bitrate_sample_kbps) /
+        (sample_var + pred_bitrate_estimate_var);
+    _bitrate_estimate_var = sample_var * pred_bitrate_estimate_var /
+        (sample_var + pred_bitrate_estimate_var);
+}
+
+float BitrateEstimator::UpdateWindow(int64_t now_ms, size_t bytes, int rate_window_ms) {
+    // Reset if time moves backwards.
+    if (now_ms < _prev_time_ms) {
+        _prev_time_ms = -1;
+        _current_window_ms = 0;
+        _rate_statistics.Reset();
+    }
+    if (_prev_time_ms >= 0) {
+        _current_window_ms += now_ms - _prev_time_ms;
+        // Reset if nothing has been received for more than a full window.
+        if (now_ms - _prev_time_ms > rate_window_ms)
+            _current_window_ms %= rate_window_ms;
+    }
+    _prev_time_ms = now_ms;
+    _rate_statistics.SetWindowSize(rate_window_ms, now_ms);
+
+    _rate_statistics.Update(bytes, now_ms);
+
+    // 窗口满时取RateStatistics在最近rate_window_ms内的码率
+    float bitrate_sample_kbps = -1.0f;
+    if (_current_window_ms >= rate_window_ms) {
+        bitrate_sample_kbps = _rate_statistics.Rate(now_ms) / 1000.0f;
+        _current_window_ms -= rate_window_ms;
+    }
+    return bitrate_sample_kbps;
+}
+
+int BitrateEstimator::bitrate_bps() const {
+    if (_bitrate_estimate_kbps < 0.f)
+        return -1;
+    return static_cast<int>(_bitrate_estimate_kbps * 1000);
+}
+
+int BitrateEstimator::PeekRate(int64_t now_ms) const {
+    if (_current_window_ms > 0)
+        return static_cast<int>(_rate_statistics.Rate(now_ms));
+    return -1;
+}
+
+void BitrateEstimator::ExpectFastRateChange() {
+    // By setting the bitrate-estimate variance to a higher value we allow the
+    // bitrate to change fast for the next few samples.
+    _bitrate_estimate_var += 200;
+}
+
+} // namespace webrtc
@@ -0,0 +1,60 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file bitrate_estimator.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _BITRATE_ESTIMATOR_H
+#define _BITRATE_ESTIMATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rate_statistics.h"
+
+namespace webrtc {
+
+// Computes a bayesian estimate of the throughput given acks containing
+// the arrival time and payload size. Samples which are far from the current
+// estimate or are based on few packets are given a smaller weight, as they
+// are considered to be more likely to have been caused by, e.g., delay spikes
+// unrelated to congestion.
+// 每个窗口(首个500ms, 之后150ms)用RateStatistics取一个码率样本, 样本离当前估计越远方差越大,
+// 权重越小, 抑制接收端突发聚合(如wifi)带来的吞吐量抖动。
+class BitrateEstimator {
+public:
+    BitrateEstimator();
+    ~BitrateEstimator();
+    void Update(int64_t now_ms, size_t bytes, bool in_alr);
+
+    // Returns -1 until the first sample has been taken.
+    int bitrate_bps() const;
+    // Rate of the data received so far in the current window, -1 if none.
+    int PeekRate(int64_t now_ms) const;
+
+    void ExpectFastRateChange();
+
+private:
+    // 返回窗口结束时的码率样本(kbps), 窗口未满返回-1
+    float UpdateWindow(int64_t now_ms, size_t bytes, int rate_window_ms);
+
+    RateStatistics _rate_statistics;
+    const int _initial_window_ms;
+    const int _noninitial_window_ms;
+    const float _uncertainty_scale;
+    const float _uncertainty_scale_in_alr;
+    int64_t _current_window_ms;
+    int64_t _prev_time_ms;
+    float _bitrate_estimate_kbps;
+    float _bitrate_estimate_var;
+};
+
+} // namespace webrtc
+
+#endif // _BITRATE_ESTIMATOR_H
+
+
@@ -0,0 +1,75 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file byte_io.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _BYTE_IO_H
+#define _BYTE_IO_H
+
+#include <stdint.h>
+
+#include <limits>
+
+namespace webrtc {
+
+// 按网络字节序(大端)读写B字节整数, 例如ByteReader<int32_t, 3>读取24位有符号数。
+// Classes that read or write B bytes of type T from a buffer, B defaults to
+// sizeof(T). A signed T narrower than sizeof(T) is sign extended on read.
+template <typename T, unsigned int B = sizeof(T)>
+class ByteReader {
+public:
+    static_assert(B <= sizeof(T), "Target type must be large enough.");
+
+    static T ReadBigEndian(const uint8_t* data) {
+        uint64_t value = 0;
+        for (unsigned int i = 0; i < B; ++i)
+            value = (value << 8) | data[i];
+        return Extend(value);
+    }
+
+    static T ReadLittleEndian(const uint8_t* data) {
+        uint64_t value = 0;
+        for (unsigned int i = 0; i < B; ++i)
+            value |= static_cast<uint64_t>(data[i]) << (i * 8);
+        return Extend(value);
+    }
+
+private:
+    static T Extend(uint64_t value) {
+        if (std::numeric_limits<T>::is_signed && B < 8) {
+            const uint64_t sign_bit = uint64_t{1} << (B * 8 - 1);
+            if (value & sign_bit)
+                value |= ~((sign_bit << 1) - 1);
+        }
+        return static_cast<T>(value);
+    }
+};
+
+template <typename T, unsigned int B = sizeof(T)>
+class ByteWriter {
+public:
+    static_assert(B <= sizeof(T), "Target type must be large enough.");
+
+    static void WriteBigEndian(uint8_t* data, T val) {
+        uint64_t value = static_cast<uint64_t>(val);
+        for (unsigned int i = 0; i < B; ++i)
+            data[i] = static_cast<uint8_t>(value >> ((B - 1 - i) * 8));
+    }
+
+    static void WriteLittleEndian(uint8_t* data, T val) {
+        uint64_t value = static_cast<uint64_t>(val);
+        for (unsigned int i = 0; i < B; ++i)
+            data[i] = static_cast<uint8_t>(value >> (i * 8));
+    }
+};
+
+} // namespace webrtc
+
+#endif // _BYTE_IO_H
+
+
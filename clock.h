@@ -0,0 +1,54 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file clock.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _CLOCK_H
+#define _CLOCK_H
+
+#include <stdint.h>
+
+namespace webrtc {
+
+// A clock interface that allows reading of absolute and relative timestamps.
+class Clock {
+public:
+    virtual ~Clock() {}
+
+    // Return a timestamp in milliseconds relative to some arbitrary source; the
+    // source is fixed for this clock.
+    virtual int64_t TimeInMilliseconds() const = 0;
+
+    // Return a timestamp in microseconds relative to some arbitrary source; the
+    // source is fixed for this clock.
+    virtual int64_t TimeInMicroseconds() const = 0;
+};
+
+// 单测用的时钟, 只在AdvanceTime*()时前进
+class SimulatedClock : public Clock {
+public:
+    explicit SimulatedClock(int64_t initial_time_us) : _time_us(initial_time_us) {}
+    ~SimulatedClock() override {}
+
+    int64_t TimeInMilliseconds() const override { return (_time_us + 500) / 1000; }
+    int64_t TimeInMicroseconds() const override { return _time_us; }
+
+    // Advance the simulated clock with a given number of milliseconds or
+    // microseconds.
+    void AdvanceTimeMilliseconds(int64_t milliseconds) { _time_us += milliseconds * 1000; }
+    void AdvanceTimeMicroseconds(int64_t microseconds) { _time_us += microseconds; }
+
+private:
+    int64_t _time_us;
+};
+
+} // namespace webrtc
+
+#endif // _CLOCK_H
+
+
@@ -0,0 +1,78 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file common_header.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "common_header.h"
+
+#include "byte_io.h"
+
+namespace webrtc {
+
+namespace rtcp {
+
+//    0                   1           1       2                   3
+//    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |V=2|P|   C/F   |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// 1                 |  Packet Type  |
+//   ----------------+---------------+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// 2                                 |             length            |
+//   --------------------------------+-------------------------------+
+//
+// Common header for all RTCP packets, 4 octets.
+bool CommonHeader::Parse(const uint8_t* buffer, size_t size_bytes) {
+    const uint8_t kVersion = 2;
+
+    if (size_bytes < kHeaderSizeBytes) {
+        // RTC_LOG(LS_WARNING) << "Too little data remaining in buffer to parse RTCP header.";
+        return false;
+    }
+
+    uint8_t version = buffer[0] >> 6;
+    if (version != kVersion) {
+        // RTC_LOG(LS_WARNING) << "Invalid RTCP header: Version must be 2";
+        return false;
+    }
+
+    bool has_padding = (buffer[0] & 0x20) != 0;
+    _count_or_format = buffer[0] & 0x1F;
+    _packet_type = buffer[1];
+    _payload_size = ByteReader<uint16_t>::ReadBigEndian(&buffer[2]) * 4;
+    _payload = buffer + kHeaderSizeBytes;
+    _padding_size = 0;
+
+    if (size_bytes < kHeaderSizeBytes + _payload_size) {
+        // RTC_LOG(LS_WARNING) << "Buffer too small to fit an RTCP packet.";
+        return false;
+    }
+
+    if (has_padding) {
+        if (_payload_size == 0) {
+            // RTC_LOG(LS_WARNING) << "Invalid RTCP header: Padding bit set but 0 payload size specified.";
+            return false;
+        }
+
+        _padding_size = _payload[_payload_size - 1];
+        if (_padding_size == 0) {
+            // RTC_LOG(LS_WARNING) << "Invalid RTCP header: Padding bit set but 0 padding size specified.";
+            return false;
+        }
+        if (_padding_size > _payload_size) {
+            // RTC_LOG(LS_WARNING) << "Invalid RTCP header: Too many padding bytes";
+            return false;
+        }
+        _payload_size -= _padding_size;
+    }
+    return true;
+}
+
+} // namespace rtcp
+
+} // namespace webrtc
@@ -0,0 +1,61 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file common_header.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _COMMON_HEADER_H
+#define _COMMON_HEADER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace webrtc {
+
+namespace rtcp {
+
+// RTCP公共头, 只解析不拷贝, payload()指向原始buffer
+class CommonHeader {
+public:
+    static constexpr size_t kHeaderSizeBytes = 4;
+
+    CommonHeader() {}
+    CommonHeader(const CommonHeader&) = default;
+    CommonHeader& operator=(const CommonHeader&) = default;
+
+    bool Parse(const uint8_t* buffer, size_t size_bytes);
+
+    uint8_t type() const { return _packet_type; }
+    // Depending on packet type same header field can be used either as count or
+    // as feedback message type (fmt). Caller expected to know how it is used.
+    uint8_t fmt() const { return _count_or_format; }
+    uint8_t count() const { return _count_or_format; }
+    size_t payload_size_bytes() const { return _payload_size; }
+    const uint8_t* payload() const { return _payload; }
+    size_t packet_size() const {
+        return kHeaderSizeBytes + _payload_size + _padding_size;
+    }
+    // Returns pointer to the next RTCP packet in compound packet.
+    const uint8_t* NextPacket() const {
+        return _payload + _payload_size + _padding_size;
+    }
+
+private:
+    uint8_t _packet_type = 0;
+    uint8_t _count_or_format = 0;
+    uint8_t _padding_size = 0;
+    uint32_t _payload_size = 0;
+    const uint8_t* _payload = nullptr;
+};
+
+} // namespace rtcp
+
+} // namespace webrtc
+
+#endif // _COMMON_HEADER_H
+
+
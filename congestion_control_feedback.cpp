@@ -0,0 +1,235 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file congestion_control_feedback.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "congestion_control_feedback.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "byte_io.h"
+
+namespace webrtc {
+
+namespace rtcp {
+
+namespace {
+// * 4 bytes SSRC of RTCP packet sender
+// * 4 bytes Report Timestamp
+constexpr size_t kMinPayloadSizeBytes = 4 + 4;
+// * 4 bytes SSRC of RTP stream
+// * 2 bytes begin_seq, 2 bytes num_reports
+constexpr size_t kSsrcBlockHeaderSizeBytes = 8;
+constexpr uint16_t kAtoOverrange = 0x1FFE;
+constexpr uint16_t kAtoUnavailable = 0x1FFF;
+
+// 每个包2字节, 按4字节对齐
+inline size_t ReportsSizeBytes(size_t num_reports) {
+    return (2 * num_reports + 3) & ~static_cast<size_t>(3);
+}
+
+// Arrival time offset (ATO, 13 bits): 单位1/1024秒, 0x1FFE表示大于等于
+// 0x1FFE/1024秒, 0x1FFF表示没有到达时间。两者都解析为kArrivalTimeUnknown,
+// 包仍然算收到。
+inline uint16_t To13BitAto(int64_t arrival_time_offset_us) {
+    if (arrival_time_offset_us < 0)
+        return kAtoUnavailable;
+    return static_cast<uint16_t>(
+            std::min<int64_t>(arrival_time_offset_us * 1024 / 1000000, kAtoOverrange));
+}
+
+inline int64_t AtoToUs(uint16_t ato) {
+    if (ato >= kAtoOverrange)
+        return CongestionControlFeedback::kArrivalTimeUnknown;
+    return ato * int64_t{15625} / 16;
+}
+
+// 同一个SSRC连续的一段packets, 返回段尾
+template <typename It>
+It SsrcBlockEnd(It begin, It end) {
+    It it = begin;
+    while (it != end && it->ssrc == begin->ssrc)
+        ++it;
+    return it;
+}
+
+} // namespace
+
+constexpr uint8_t CongestionControlFeedback::kPacketType;
+constexpr uint8_t CongestionControlFeedback::kFeedbackMessageType;
+constexpr uint16_t CongestionControlFeedback::kMaxReportsPerSsrc;
+constexpr int64_t CongestionControlFeedback::kNotReceived;
+constexpr int64_t CongestionControlFeedback::kArrivalTimeUnknown;
+
+CongestionControlFeedback::CongestionControlFeedback()
+    : _report_timestamp_compact_ntp(0),
+    _size_bytes(kHeaderLength + kMinPayloadSizeBytes) {}
+
+CongestionControlFeedback::CongestionControlFeedback(std::vector<PacketInfo> packets,
+        uint32_t report_timestamp_compact_ntp)
+    : _packets(std::move(packets)),
+    _report_timestamp_compact_ntp(report_timestamp_compact_ntp),
+    _size_bytes(kHeaderLength + kMinPayloadSizeBytes) {
+    auto it = _packets.begin();
+    while (it != _packets.end()) {
+        auto block_end = SsrcBlockEnd(it, _packets.end());
+        uint16_t num_reports = static_cast<uint16_t>((block_end - 1)->sequence_number -
+                it->sequence_number) + 1;
+        assert(static_cast<ptrdiff_t>(num_reports) >= block_end - it);
+        assert(num_reports <= kMaxReportsPerSsrc);
+        _size_bytes += kSsrcBlockHeaderSizeBytes + ReportsSizeBytes(num_reports);
+        it = block_end;
+    }
+}
+
+CongestionControlFeedback::~CongestionControlFeedback() {}
+
+//  0                   1                   2                   3
+//  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |V=2|P| FMT=11  |   PT = 205    |          length               |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |                 SSRC of RTCP packet sender                    |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |                   SSRC of 1st RTP Stream                      |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |          begin_seq            |          num_reports          |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |R|ECN|  Arrival time offset    | ...                           .
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// .                                                               .
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |                   SSRC of nth RTP Stream                      |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |          begin_seq            |          num_reports          |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |R|ECN|  Arrival time offset    | ...                           |
+// .                                                               .
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |                 Report Timestamp (32 bits)                    |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+bool CongestionControlFeedback::Parse(const CommonHeader& packet) {
+    assert(packet.type() == kPacketType);
+    assert(packet.fmt() == kFeedbackMessageType);
+
+    _packets.clear();
+    const size_t payload_size = packet.payload_size_bytes();
+    if (payload_size < kMinPayloadSizeBytes || payload_size % 4 != 0) {
+        // RTC_LOG(LS_WARNING) << "Invalid congestion control feedback size: " << payload_size;
+        return false;
+    }
+
+    const uint8_t* const payload = packet.payload();
+    SetSenderSsrc(ByteReader<uint32_t>::ReadBigEndian(payload));
+    const size_t report_timestamp_index = payload_size - 4;
+    _report_timestamp_compact_ntp =
+        ByteReader<uint32_t>::ReadBigEndian(&payload[report_timestamp_index]);
+
+    size_t index = 4;
+    while (index < report_timestamp_index) {
+        if (index + kSsrcBlockHeaderSizeBytes > report_timestamp_index) {
+            // RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
+            _packets.clear();
+            return false;
+        }
+        uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[index]);
+        uint16_t seq_no = ByteReader<uint16_t>::ReadBigEndian(&payload[index + 4]);
+        uint16_t num_reports = ByteReader<uint16_t>::ReadBigEndian(&payload[index + 6]);
+        index += kSsrcBlockHeaderSizeBytes;
+        if (num_reports > kMaxReportsPerSsrc ||
+                index + ReportsSizeBytes(num_reports) > report_timestamp_index) {
+            // RTC_LOG(LS_WARNING) << "Invalid num_reports " << num_reports;
+            _packets.clear();
+            return false;
+        }
+
+        for (size_t i = 0; i < num_reports; ++i, ++seq_no) {
+            uint16_t packet_info = ByteReader<uint16_t>::ReadBigEndian(&payload[index + 2 * i]);
+            PacketInfo info;
+            info.ssrc = ssrc;
+            info.sequence_number = seq_no;
+            if (packet_info & 0x8000) {
+                info.arrival_time_offset_us = AtoToUs(packet_info & 0x1FFF);
+                info.ecn = static_cast<EcnMarking>((packet_info >> 13) & 0x03);
+            } else {
+                info.arrival_time_offset_us = kNotReceived;
+                info.ecn = EcnMarking::kNotEct;
+            }
+            _packets.push_back(info);
+        }
+        index += ReportsSizeBytes(num_reports);
+    }
+
+    _size_bytes = kHeaderLength + payload_size;
+    return true;
+}
+
+std::unique_ptr<CongestionControlFeedback> CongestionControlFeedback::ParseFrom(
+        const uint8_t* buffer, size_t length) {
+    CommonHeader header;
+    if (!header.Parse(buffer, length))
+        return nullptr;
+    if (header.type() != kPacketType || header.fmt() != kFeedbackMessageType)
+        return nullptr;
+    std::unique_ptr<CongestionControlFeedback> parsed(new CongestionControlFeedback);
+    if (!parsed->Parse(header))
+        return nullptr;
+    return parsed;
+}
+
+size_t CongestionControlFeedback::BlockLength() const {
+    return _size_bytes;
+}
+
+bool CongestionControlFeedback::Create(uint8_t* packet, size_t* position,
+        size_t max_length) const {
+    if (*position + BlockLength() > max_length)
+        return false;
+
+    const size_t position_end = *position + BlockLength();
+    CreateHeader(kFeedbackMessageType, kPacketType, HeaderLength(), false, packet, position);
+    ByteWriter<uint32_t>::WriteBigEndian(&packet[*position], sender_ssrc());
+    *position += 4;
+
+    auto it = _packets.begin();
+    while (it != _packets.end()) {
+        auto block_end = SsrcBlockEnd(it, _packets.end());
+        const uint16_t begin_seq = it->sequence_number;
+        const uint16_t num_reports = static_cast<uint16_t>((block_end - 1)->sequence_number -
+                begin_seq) + 1;
+        ByteWriter<uint32_t>::WriteBigEndian(&packet[*position], it->ssrc);
+        ByteWriter<uint16_t>::WriteBigEndian(&packet[*position + 4], begin_seq);
+        ByteWriter<uint16_t>::WriteBigEndian(&packet[*position + 6], num_reports);
+        *position += kSsrcBlockHeaderSizeBytes;
+
+        // 没有出现在packets中的序号以及padding都写0, 即没有收到
+        const size_t reports_size = ReportsSizeBytes(num_reports);
+        std::fill(&packet[*position], &packet[*position + reports_size], 0);
+        for (; it != block_end; ++it) {
+            if (it->arrival_time_offset_us == kNotReceived)
+                continue;
+            uint16_t packet_info = 0x8000 | (static_cast<uint16_t>(it->ecn) << 13) |
+                To13BitAto(it->arrival_time_offset_us);
+            uint16_t offset = it->sequence_number - begin_seq;
+            ByteWriter<uint16_t>::WriteBigEndian(&packet[*position + 2 * offset], packet_info);
+        }
+        *position += reports_size;
+    }
+
+    ByteWriter<uint32_t>::WriteBigEndian(&packet[*position], _report_timestamp_compact_ntp);
+    *position += 4;
+    assert(*position == position_end);
+    (void)position_end;
+    return true;
+}
+
+} // namespace rtcp
+
+} // namespace webrtc
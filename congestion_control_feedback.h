@@ -0,0 +1,93 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file congestion_control_feedback.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _CONGESTION_CONTROL_FEEDBACK_H
+#define _CONGESTION_CONTROL_FEEDBACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "common_header.h"
+#include "rtcp_packet.h"
+
+namespace webrtc {
+
+// IP头中ECN字段的取值, RFC 3168
+enum class EcnMarking : uint8_t {
+    kNotEct = 0, // Not ECN-Capable Transport
+    kEct1 = 1,   // ECN-Capable Transport
+    kEct0 = 2,   // Not used by L4s (or webrtc.)
+    kCe = 3,     // Congestion experienced
+};
+
+namespace rtcp {
+
+// RFC 8888 RTP Control Protocol (RTCP) Feedback for Congestion Control
+// https://www.rfc-editor.org/rfc/rfc8888
+//
+// 与transport-cc不同, 按SSRC和RTP序号反馈, 每个包带ECN和到达时间相对
+// report timestamp的偏移(1/1024秒)。
+class CongestionControlFeedback : public RtcpPacket {
+public:
+    static constexpr uint8_t kPacketType = 205;
+    static constexpr uint8_t kFeedbackMessageType = 11;
+    // 每个SSRC一次最多反馈的包数
+    static constexpr uint16_t kMaxReportsPerSsrc = 16384;
+    static constexpr int64_t kNotReceived = -1;
+    // 收到了但没有到达时间: 接收端不知道(ATO为0x1FFF), 或者偏移超过0x1FFE/1024秒
+    static constexpr int64_t kArrivalTimeUnknown = -2;
+
+    struct PacketInfo {
+        // 到达时间在report timestamp之前多少微秒。kNotReceived if the packet
+        // was lost, kArrivalTimeUnknown if it was received without a usable
+        // arrival time. 其他负值按kArrivalTimeUnknown序列化。
+        int64_t arrival_time_offset_us;
+        uint32_t ssrc;
+        uint16_t sequence_number;
+        EcnMarking ecn;
+    };
+
+    CongestionControlFeedback();
+    // |packets| MUST be sorted in sequence number order per SSRC and MUST NOT
+    // contain duplicates. Packets of one SSRC are reported as one block;
+    // sequence numbers missing between them are reported as not received.
+    CongestionControlFeedback(std::vector<PacketInfo> packets,
+            uint32_t report_timestamp_compact_ntp);
+    ~CongestionControlFeedback() override;
+
+    // 所有报告的包, 包括没有收到的, 按SSRC块的顺序排列
+    const std::vector<PacketInfo>& packets() const { return _packets; }
+    // NTP时间的中间32位(16.16秒)
+    uint32_t report_timestamp_compact_ntp() const { return _report_timestamp_compact_ntp; }
+
+    // 解析时复用packets()的空间, 对同一个对象反复Parse不分配内存
+    bool Parse(const CommonHeader& packet);
+    static std::unique_ptr<CongestionControlFeedback> ParseFrom(const uint8_t* buffer,
+            size_t length);
+
+    size_t BlockLength() const override;
+    bool Create(uint8_t* packet, size_t* position, size_t max_length) const override;
+
+private:
+    std::vector<PacketInfo> _packets;
+    uint32_t _report_timestamp_compact_ntp;
+    size_t _size_bytes;
+};
+
+} // namespace rtcp
+
+} // namespace webrtc
+
+#endif // _CONGESTION_CONTROL_FEEDBACK_H
+
+
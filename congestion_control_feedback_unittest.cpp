@@ -0,0 +1,445 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file congestion_control_feedback_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ congestion_control_feedback_unittest.cpp congestion_control_feedback.cpp transport_feedback_adapter.cpp send_time_history.cpp transport_feedback.cpp rtpfb.cpp rtcp_packet.cpp common_header.cpp random.cpp -std=c++11 -O2
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "random.h"
+#include "congestion_control_feedback.h"
+#include "transport_feedback_adapter.h"
+
+namespace webrtc {
+
+using rtcp::CongestionControlFeedback;
+
+// 16个ATO单位正好是15625us, 可以无损往返
+constexpr int64_t kExactOffsetUs = 15625;
+
+static CongestionControlFeedback::PacketInfo MakeInfo(uint32_t ssrc, uint16_t sequence_number,
+        int64_t arrival_time_offset_us, EcnMarking ecn) {
+    CongestionControlFeedback::PacketInfo info;
+    info.ssrc = ssrc;
+    info.sequence_number = sequence_number;
+    info.arrival_time_offset_us = arrival_time_offset_us;
+    info.ecn = ecn;
+    return info;
+}
+
+// 毫秒转成compact NTP(16.16秒)
+static uint32_t CompactNtp(int64_t time_ms) {
+    return static_cast<uint32_t>(time_ms * 65536 / 1000);
+}
+
+// RoundTrip / MissingSequenceNumbers / Padding
+// 两个SSRC, 序号回绕, 中间缺失的序号按没有收到报告; 奇数个报告时补2字节padding
+void TestCongestionControlFeedback01() {
+    std::vector<CongestionControlFeedback::PacketInfo> packets = {
+        MakeInfo(1, 0xFFFE, 3 * kExactOffsetUs, EcnMarking::kEct1),
+        MakeInfo(1, 0xFFFF, CongestionControlFeedback::kNotReceived, EcnMarking::kNotEct),
+        MakeInfo(1, 1, 0, EcnMarking::kCe),
+        MakeInfo(2, 100, 2 * kExactOffsetUs, EcnMarking::kNotEct),
+        MakeInfo(2, 101, 100 * kExactOffsetUs, EcnMarking::kEct0),
+    };
+    CongestionControlFeedback feedback(packets, 0x12345678);
+    feedback.SetSenderSsrc(0xABCD);
+    // header(4) + sender ssrc(4) + 8 + 4 * 2 + 8 + 2 * 2 + report timestamp(4)
+    assert(feedback.BlockLength() == 4 + 4 + 16 + 12 + 4);
+    std::vector<uint8_t> buffer = feedback.Build();
+    assert(buffer.size() == feedback.BlockLength());
+
+    std::unique_ptr<CongestionControlFeedback> parsed =
+        CongestionControlFeedback::ParseFrom(buffer.data(), buffer.size());
+    assert(parsed);
+    assert(parsed->sender_ssrc() == 0xABCD);
+    assert(parsed->report_timestamp_compact_ntp() == 0x12345678);
+    assert(parsed->BlockLength() == buffer.size());
+    const std::vector<CongestionControlFeedback::PacketInfo>& result = parsed->packets();
+    // 0xFFFE, 0xFFFF, 0, 1 和 100, 101
+    assert(result.size() == 6);
+    const uint16_t kExpectedSeqs[] = {0xFFFE, 0xFFFF, 0, 1, 100, 101};
+    const int64_t kExpectedOffsets[] = {3 * kExactOffsetUs, -1, -1, 0, 2 * kExactOffsetUs,
+        100 * kExactOffsetUs};
+    const EcnMarking kExpectedEcn[] = {EcnMarking::kEct1, EcnMarking::kNotEct, EcnMarking::kNotEct,
+        EcnMarking::kCe, EcnMarking::kNotEct, EcnMarking::kEct0};
+    for (size_t i = 0; i < result.size(); ++i) {
+        assert(result[i].ssrc == (i < 4 ? 1u : 2u));
+        assert(result[i].sequence_number == kExpectedSeqs[i]);
+        assert(result[i].arrival_time_offset_us == kExpectedOffsets[i]);
+        assert(result[i].ecn == kExpectedEcn[i]);
+    }
+
+    // 重新序列化得到相同的字节
+    CongestionControlFeedback rebuilt(result, parsed->report_timestamp_compact_ntp());
+    rebuilt.SetSenderSsrc(parsed->sender_ssrc());
+    assert(rebuilt.Build() == buffer);
+
+    // 超过0x1FFE/1024秒的偏移饱和成0x1FFE, 解析为收到了但没有到达时间
+    CongestionControlFeedback overrange({MakeInfo(3, 7, 10 * 1000 * 1000, EcnMarking::kNotEct)}, 0);
+    buffer = overrange.Build();
+    assert(buffer.size() == 4 + 4 + 12 + 4);
+    assert(buffer[16] == (0x80 | 0x1F) && buffer[17] == 0xFE);
+    parsed = CongestionControlFeedback::ParseFrom(buffer.data(), buffer.size());
+    assert(parsed && parsed->packets().size() == 1);
+    assert(parsed->packets()[0].arrival_time_offset_us ==
+            CongestionControlFeedback::kArrivalTimeUnknown);
+
+    // kArrivalTimeUnknown和其他负的偏移写成R=1, ATO=0x1FFF, 解析回来仍然是收到的包
+    CongestionControlFeedback unknown({
+            MakeInfo(3, 7, CongestionControlFeedback::kArrivalTimeUnknown, EcnMarking::kCe),
+            MakeInfo(3, 8, -5000, EcnMarking::kEct1)}, 0);
+    buffer = unknown.Build();
+    assert(buffer.size() == 4 + 4 + 12 + 4);
+    assert(buffer[16] == (0x80 | 0x60 | 0x1F) && buffer[17] == 0xFF);
+    assert(buffer[18] == (0x80 | 0x20 | 0x1F) && buffer[19] == 0xFF);
+    parsed = CongestionControlFeedback::ParseFrom(buffer.data(), buffer.size());
+    assert(parsed && parsed->packets().size() == 2);
+    for (const CongestionControlFeedback::PacketInfo& info : parsed->packets()) {
+        assert(info.arrival_time_offset_us == CongestionControlFeedback::kArrivalTimeUnknown);
+    }
+    assert(parsed->packets()[0].ecn == EcnMarking::kCe);
+    assert(parsed->packets()[1].ecn == EcnMarking::kEct1);
+    CongestionControlFeedback unknown_rebuilt(parsed->packets(), 0);
+    assert(unknown_rebuilt.Build() == buffer);
+
+    // 没有SSRC块的报告也是合法的
+    CongestionControlFeedback empty;
+    buffer = empty.Build();
+    assert(buffer.size() == 12);
+    parsed = CongestionControlFeedback::ParseFrom(buffer.data(), buffer.size());
+    assert(parsed && parsed->packets().empty());
+}
+
+// Malformed
+// 截断、num_reports越界或超过16384、类型不对的包都解析失败; 随机改写的包不越界访问
+void TestCongestionControlFeedback02() {
+    std::vector<CongestionControlFeedback::PacketInfo> packets;
+    for (uint16_t seq = 0; seq < 21; ++seq)
+        packets.push_back(MakeInfo(5, seq, seq * kExactOffsetUs, EcnMarking::kEct1));
+    CongestionControlFeedback feedback(packets, 1000);
+    std::vector<uint8_t> buffer = feedback.Build();
+
+    // 截断时改写length, 让公共头仍然合法
+    for (size_t size = 4; size < buffer.size(); size += 4) {
+        std::vector<uint8_t> truncated(buffer.begin(), buffer.begin() + size);
+        truncated[2] = 0;
+        truncated[3] = static_cast<uint8_t>(size / 4 - 1);
+        std::unique_ptr<CongestionControlFeedback> parsed =
+            CongestionControlFeedback::ParseFrom(truncated.data(), truncated.size());
+        // 只剩sender ssrc和report timestamp时是一个空报告
+        assert(!parsed || (size == 12 && parsed->packets().empty()));
+    }
+
+    std::vector<uint8_t> too_many = buffer;
+    too_many[14] = 0x40;
+    too_many[15] = 0x01;
+    assert(!CongestionControlFeedback::ParseFrom(too_many.data(), too_many.size()));
+    std::vector<uint8_t> overflow = buffer;
+    overflow[15] = 23;
+    assert(!CongestionControlFeedback::ParseFrom(overflow.data(), overflow.size()));
+    std::vector<uint8_t> wrong_fmt = buffer;
+    wrong_fmt[0] = (wrong_fmt[0] & 0xE0) | 15;
+    assert(!CongestionControlFeedback::ParseFrom(wrong_fmt.data(), wrong_fmt.size()));
+
+    Random random(0x39);
+    CongestionControlFeedback reused;
+    for (int i = 0; i < 20000; ++i) {
+        std::vector<uint8_t> mutated = buffer;
+        int num_mutations = random.Rand(1, 4);
+        for (int m = 0; m < num_mutations; ++m)
+            mutated[random.Rand<uint32_t>() % mutated.size()] = random.Rand<uint8_t>();
+        size_t size = random.Rand(0, 3) == 0 ? random.Rand<uint32_t>() % mutated.size() :
+            mutated.size();
+        // 精确大小的堆内存, 越界访问可以被ASan发现
+        std::unique_ptr<uint8_t[]> data(new uint8_t[size == 0 ? 1 : size]);
+        memcpy(data.get(), mutated.data(), size);
+        rtcp::CommonHeader header;
+        if (header.Parse(data.get(), size) &&
+                header.type() == CongestionControlFeedback::kPacketType &&
+                header.fmt() == CongestionControlFeedback::kFeedbackMessageType &&
+                reused.Parse(header)) {
+            // 每个报告至少占2字节
+            assert(reused.packets().size() <= size / 2);
+        }
+    }
+}
+
+// 一段时间窗口内发出的包, 接收端按两种格式各生成一个反馈
+struct FeedbackWindow {
+    std::vector<uint8_t> transport_feedback;
+    std::vector<uint8_t> congestion_control_feedback;
+    int64_t base_time_ms;
+    int64_t report_time_ms;
+};
+
+struct SentPacket {
+    uint32_t ssrc;
+    uint16_t rtp_sequence_number;
+    uint16_t sequence_number;
+    int64_t send_time_ms;
+    int64_t arrival_time_ms; // -1 if lost.
+    EcnMarking ecn;
+};
+
+// |packets|为一个窗口内按transport sequence number排列的包, 第一个包必须收到
+static FeedbackWindow MakeFeedbackWindow(const std::vector<SentPacket>& packets) {
+    FeedbackWindow window;
+    size_t last_received = 0;
+    int64_t max_arrival_ms = 0;
+    rtcp::TransportFeedback transport_feedback;
+    assert(packets[0].arrival_time_ms >= 0);
+    transport_feedback.SetBase(packets[0].sequence_number, packets[0].arrival_time_ms * 1000);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        if (packets[i].arrival_time_ms < 0)
+            continue;
+        bool added = transport_feedback.AddReceivedPacket(packets[i].sequence_number,
+                packets[i].arrival_time_ms * 1000);
+        assert(added);
+        last_received = i;
+        max_arrival_ms = std::max(max_arrival_ms, packets[i].arrival_time_ms);
+    }
+    window.transport_feedback = transport_feedback.Build();
+    window.base_time_ms = transport_feedback.GetBaseTimeUs() / 1000;
+
+    // report timestamp取125ms的整数倍, 换算成compact NTP没有误差
+    window.report_time_ms = (max_arrival_ms / 125 + 1) * 125;
+    // 和transport-cc覆盖同样的包: 最后一个收到的包之前的所有包, 按SSRC分块
+    std::vector<uint32_t> ssrcs;
+    for (size_t i = 0; i <= last_received; ++i) {
+        if (std::find(ssrcs.begin(), ssrcs.end(), packets[i].ssrc) == ssrcs.end())
+            ssrcs.push_back(packets[i].ssrc);
+    }
+    std::vector<CongestionControlFeedback::PacketInfo> infos;
+    for (uint32_t ssrc : ssrcs) {
+        for (size_t i = 0; i <= last_received; ++i) {
+            const SentPacket& packet = packets[i];
+            if (packet.ssrc != ssrc)
+                continue;
+            int64_t offset_us = packet.arrival_time_ms < 0 ? CongestionControlFeedback::kNotReceived :
+                (window.report_time_ms - packet.arrival_time_ms) * 1000;
+            infos.push_back(MakeInfo(ssrc, packet.rtp_sequence_number, offset_us, packet.ecn));
+        }
+    }
+    window.congestion_control_feedback =
+        CongestionControlFeedback(infos, CompactNtp(window.report_time_ms)).Build();
+    return window;
+}
+
+// 音频和视频两个SSRC交替发送, |loss_percent|的丢包, 到达时间有抖动
+static std::vector<std::vector<SentPacket>> MakeSession(size_t num_windows,
+        size_t packets_per_window, int loss_percent, Random* random) {
+    std::vector<std::vector<SentPacket>> windows(num_windows);
+    uint16_t sequence_number = 0xFF00;
+    uint16_t rtp_sequence_numbers[2] = {0xFFF0, 100};
+    int64_t now_ms = 1000;
+    for (std::vector<SentPacket>& window : windows) {
+        for (size_t i = 0; i < packets_per_window; ++i) {
+            int stream = random->Rand(0, 4) == 0 ? 1 : 0;
+            SentPacket packet;
+            packet.ssrc = 1000 + stream;
+            packet.rtp_sequence_number = rtp_sequence_numbers[stream]++;
+            packet.sequence_number = sequence_number++;
+            packet.send_time_ms = now_ms;
+            bool lost = i > 0 && random->Rand(0, 99) < loss_percent;
+            packet.arrival_time_ms = lost ? -1 : now_ms + 20 + random->Rand(0, 5);
+            packet.ecn = lost ? EcnMarking::kNotEct :
+                (random->Rand(0, 9) == 0 ? EcnMarking::kCe : EcnMarking::kEct1);
+            window.push_back(packet);
+            now_ms += random->Rand(0, 1);
+        }
+    }
+    return windows;
+}
+
+// SameResultsForBothFormats
+// 同一批包用transport-cc和RFC 8888反馈, 适配器输出的PacketResult数组相同
+// (RFC 8888的到达时间精度是1/1024秒, 允许1ms误差), RFC 8888的结果带有ECN
+void TestCongestionControlFeedback03() {
+    Random random(0x1039);
+    std::vector<std::vector<SentPacket>> session = MakeSession(50, 200, 5, &random);
+    TransportFeedbackAdapter twcc_adapter;
+    TransportFeedbackAdapter ccfb_adapter;
+    for (const std::vector<SentPacket>& window : session) {
+        for (const SentPacket& packet : window) {
+            twcc_adapter.AddPacket(packet.sequence_number, 1000 + packet.rtp_sequence_number % 200,
+                    PacketFeedback::kNotAProbe, packet.send_time_ms);
+            twcc_adapter.OnSentPacket(packet.sequence_number, packet.send_time_ms);
+            ccfb_adapter.AddPacket(packet.ssrc, packet.rtp_sequence_number, packet.sequence_number,
+                    1000 + packet.rtp_sequence_number % 200, PacketFeedback::kNotAProbe,
+                    packet.send_time_ms);
+            ccfb_adapter.OnSentPacket(packet.sequence_number, packet.send_time_ms);
+        }
+
+        FeedbackWindow feedback = MakeFeedbackWindow(window);
+        std::unique_ptr<rtcp::TransportFeedback> twcc = rtcp::TransportFeedback::ParseFrom(
+                feedback.transport_feedback.data(), feedback.transport_feedback.size());
+        std::unique_ptr<CongestionControlFeedback> ccfb = CongestionControlFeedback::ParseFrom(
+                feedback.congestion_control_feedback.data(),
+                feedback.congestion_control_feedback.size());
+        assert(twcc && ccfb);
+        // 让两个适配器的本地时间都等于接收端的时钟
+        size_t num_twcc = twcc_adapter.OnTransportFeedback(*twcc, feedback.base_time_ms);
+        size_t num_ccfb = ccfb_adapter.OnCongestionControlFeedback(*ccfb, feedback.report_time_ms);
+        assert(num_twcc == num_ccfb);
+        assert(num_twcc > 0);
+
+        const PacketResult* a = twcc_adapter.packet_results();
+        const PacketResult* b = ccfb_adapter.packet_results();
+        for (size_t i = 0; i < num_twcc; ++i) {
+            const SentPacket& sent = window[i];
+            assert(a[i].sequence_number == sent.sequence_number);
+            assert(b[i].sequence_number == sent.sequence_number);
+            assert(a[i].send_time_ms == b[i].send_time_ms);
+            assert(a[i].payload_size == b[i].payload_size);
+            assert(a[i].probe_cluster_id == b[i].probe_cluster_id);
+            assert(a[i].receive_time_ms == sent.arrival_time_ms);
+            assert(std::abs(b[i].receive_time_ms - sent.arrival_time_ms) <= 1);
+            assert(a[i].ecn == EcnMarking::kNotEct);
+            assert(b[i].ecn == sent.ecn);
+        }
+    }
+    assert(twcc_adapter.failed_lookups() == 0);
+    assert(ccfb_adapter.failed_lookups() == 0);
+}
+
+// ArrivalTimeUnknown
+// 收到了但没有到达时间的包不输出, 不算丢包; 之后的反馈再报告它时在历史中已经找不到
+void TestCongestionControlFeedback05() {
+    TransportFeedbackAdapter adapter;
+    for (uint16_t i = 0; i < 3; ++i) {
+        adapter.AddPacket(7, 100 + i, 10 + i, 1000, PacketFeedback::kNotAProbe, 1000 + i);
+        adapter.OnSentPacket(10 + i, 1000 + i);
+    }
+    CongestionControlFeedback feedback({
+            MakeInfo(7, 100, kExactOffsetUs, EcnMarking::kEct1),
+            MakeInfo(7, 101, CongestionControlFeedback::kArrivalTimeUnknown, EcnMarking::kEct1),
+            MakeInfo(7, 102, CongestionControlFeedback::kNotReceived, EcnMarking::kNotEct)},
+            CompactNtp(1125));
+    std::vector<uint8_t> buffer = feedback.Build();
+    std::unique_ptr<CongestionControlFeedback> parsed =
+        CongestionControlFeedback::ParseFrom(buffer.data(), buffer.size());
+    assert(parsed);
+    size_t num_results = adapter.OnCongestionControlFeedback(*parsed, 1125);
+    assert(num_results == 2);
+    const PacketResult* results = adapter.packet_results();
+    assert(results[0].sequence_number == 10 && results[0].receive_time_ms == 1109);
+    assert(results[1].sequence_number == 12 && results[1].receive_time_ms == -1);
+    assert(adapter.failed_lookups() == 0);
+
+    // 包11已经按收到处理, 从历史中删除了
+    num_results = adapter.OnCongestionControlFeedback(*parsed, 1125);
+    assert(num_results == 1);
+    assert(adapter.packet_results()[0].sequence_number == 12);
+    assert(adapter.failed_lookups() == 2);
+}
+
+// Benchmark
+// 每个反馈|packets_per_feedback|个包, 比较两种格式的解析吞吐量:
+// transport-cc(ParseFrom和零拷贝的TransportFeedbackView), RFC 8888(ParseFrom和复用对象的Parse)
+void TestCongestionControlFeedback04() {
+    const size_t kNumFeedbacks = 2000;
+    const size_t kPacketsPerFeedback[] = {100, 1000};
+    Random random(0x2039);
+    for (size_t packets_per_feedback : kPacketsPerFeedback) {
+        std::vector<FeedbackWindow> feedbacks;
+        std::vector<std::vector<SentPacket>> session =
+            MakeSession(kNumFeedbacks, packets_per_feedback, 1, &random);
+        for (const std::vector<SentPacket>& window : session)
+            feedbacks.push_back(MakeFeedbackWindow(window));
+        const double num_packets = static_cast<double>(kNumFeedbacks * packets_per_feedback);
+        size_t twcc_bytes = 0;
+        size_t ccfb_bytes = 0;
+        for (const FeedbackWindow& feedback : feedbacks) {
+            twcc_bytes += feedback.transport_feedback.size();
+            ccfb_bytes += feedback.congestion_control_feedback.size();
+        }
+
+        int64_t checksum[4] = {0, 0, 0, 0};
+        int64_t elapsed_ns[4];
+        auto start = std::chrono::steady_clock::now();
+        for (const FeedbackWindow& feedback : feedbacks) {
+            std::unique_ptr<rtcp::TransportFeedback> parsed = rtcp::TransportFeedback::ParseFrom(
+                    feedback.transport_feedback.data(), feedback.transport_feedback.size());
+            for (const auto& packet : parsed->GetReceivedPackets())
+                checksum[0] += packet.sequence_number();
+        }
+        elapsed_ns[0] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        rtcp::TransportFeedbackView view;
+        for (const FeedbackWindow& feedback : feedbacks) {
+            view.Parse(feedback.transport_feedback.data(), feedback.transport_feedback.size());
+            rtcp::TransportFeedbackView::Iterator it = view.begin();
+            uint16_t seq;
+            int16_t delta_ticks;
+            while (it.Next(&seq, &delta_ticks))
+                checksum[1] += seq;
+        }
+        elapsed_ns[1] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (const FeedbackWindow& feedback : feedbacks) {
+            std::unique_ptr<CongestionControlFeedback> parsed = CongestionControlFeedback::ParseFrom(
+                    feedback.congestion_control_feedback.data(),
+                    feedback.congestion_control_feedback.size());
+            for (const CongestionControlFeedback::PacketInfo& info : parsed->packets()) {
+                if (info.arrival_time_offset_us >= 0)
+                    ++checksum[2];
+            }
+        }
+        elapsed_ns[2] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        CongestionControlFeedback reused;
+        for (const FeedbackWindow& feedback : feedbacks) {
+            rtcp::CommonHeader header;
+            header.Parse(feedback.congestion_control_feedback.data(),
+                    feedback.congestion_control_feedback.size());
+            reused.Parse(header);
+            for (const CongestionControlFeedback::PacketInfo& info : reused.packets()) {
+                if (info.arrival_time_offset_us >= 0)
+                    ++checksum[3];
+            }
+        }
+        elapsed_ns[3] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        assert(checksum[0] == checksum[1]);
+        assert(checksum[2] == checksum[3]);
+
+        cout << "packets/feedback=" << packets_per_feedback
+            << " bytes/packet: transport-cc=" << twcc_bytes / num_packets
+            << " rfc8888=" << ccfb_bytes / num_packets << endl;
+        cout << "  transport-cc ParseFrom=" << elapsed_ns[0] / num_packets << "ns/packet"
+            << " view=" << elapsed_ns[1] / num_packets << "ns/packet"
+            << " | rfc8888 ParseFrom=" << elapsed_ns[2] / num_packets << "ns/packet"
+            << " reused=" << elapsed_ns[3] / num_packets << "ns/packet" << endl;
+    }
+}
+
+} // namespace webrtc
+
+int main() {
+    webrtc::TestCongestionControlFeedback01();
+    webrtc::TestCongestionControlFeedback02();
+    webrtc::TestCongestionControlFeedback03();
+    webrtc::TestCongestionControlFeedback04();
+    webrtc::TestCongestionControlFeedback05();
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file field_trail.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "field_trail.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace webrtc {
+namespace field_trial {
+
+static const char* trials_init_string = nullptr;
+
+namespace {
+
+bool StartsWith(const std::string& str, const char* prefix) {
+    return str.compare(0, strlen(prefix), prefix) == 0;
+}
+
+FieldTrialEntry MakeEntry(const std::string& name, const std::string& group) {
+    FieldTrialEntry entry;
+    entry.name = name;
+    entry.group = group;
+    entry.enabled = StartsWith(group, "Enabled");
+    entry.disabled = StartsWith(group, "Disabled");
+    return entry;
+}
+
+// 试验表: 解析一次,按name排序,之后只读
+// Immutable table of trials, sorted by name so lookups are a binary search.
+class FieldTrialTable {
+public:
+    explicit FieldTrialTable(const char* trials_string) {
+        if (trials_string && !Parse(trials_string))
+            _entries.clear();
+    }
+
+    const FieldTrialEntry* Find(const char* name) const {
+        auto it = std::lower_bound(_entries.begin(), _entries.end(), name,
+                [](const FieldTrialEntry& entry, const char* key) {
+                    return strcmp(entry.name.c_str(), key) < 0;
+                });
+        if (it == _entries.end() || it->name != name)
+            return nullptr;
+        return &*it;
+    }
+
+private:
+    // "Trial1/Group1/Trial2/Group2/", every token non-empty and a trial
+    // name listed at most once.
+    bool Parse(const char* trials_string) {
+        const std::string trials(trials_string);
+        size_t pos = 0;
+        while (pos < trials.size()) {
+            size_t name_end = trials.find('/', pos);
+            if (name_end == std::string::npos || name_end == pos)
+                return false;
+            size_t group_end = trials.find('/', name_end + 1);
+            if (group_end == std::string::npos || group_end == name_end + 1)
+                return false;
+
+            _entries.push_back(MakeEntry(trials.substr(pos, name_end - pos),
+                    trials.substr(name_end + 1, group_end - name_end - 1)));
+            pos = group_end + 1;
+        }
+
+        std::sort(_entries.begin(), _entries.end(),
+                [](const FieldTrialEntry& a, const FieldTrialEntry& b) {
+                    return a.name < b.name;
+                });
+        for (size_t i = 1; i < _entries.size(); ++i) {
+            if (_entries[i].name == _entries[i - 1].name)
+                return false;
+        }
+        return true;
+    }
+
+    std::vector<FieldTrialEntry> _entries;
+};
+
+// InitFieldTrialsFromString()之前为nullptr, 没有任何试验。建好后不再释放,
+// FindTrial()返回的指针一直有效
+const FieldTrialTable* trials_table = nullptr;
+
+}  // namespace
+
+const FieldTrialEntry* FindTrial(const char* name) {
+    if (!trials_table)
+        return nullptr;
+    return trials_table->Find(name);
+}
+
+std::string FindFullName(const std::string& name) {
+    const FieldTrialEntry* trial = FindTrial(name.c_str());
+    return trial ? trial->group : std::string();
+}
+
+void InitFieldTrialsFromString(const char* trials_string) {
+    assert(!trials_table);
+    trials_init_string = trials_string;
+    trials_table = new FieldTrialTable(trials_string);
+}
+
+const char* GetFieldTrialString() {
+    return trials_init_string;
+}
+
+}  // namespace field_trial
+}  // namespace webrtc
@@ -67,29 +67,57 @@
 namespace webrtc {
 namespace field_trial {
 
+// A trial parsed from the string given to InitFieldTrialsFromString(). The
+// table of entries is built by InitFieldTrialsFromString(), sorted by name and
+// never modified or freed afterwards, so a pointer returned by FindTrial() stays
+// valid for the lifetime of the process and can be kept by callers instead of
+// looking the trial up again.
+struct FieldTrialEntry {
+  std::string name;
+  std::string group;
+  bool enabled;   // |group| starts with "Enabled".
+  bool disabled;  // |group| starts with "Disabled".
+};
+
+// Returns the entry for the named trial, or nullptr if the trial does not
+// exist.
+const FieldTrialEntry* FindTrial(const char* name);
+
 // Returns the group name chosen for the named trial, or the empty string
 // if the trial does not exists.
 //
 // Note: To keep things tidy append all the trial names with WebRTC.
 std::string FindFullName(const std::string& name);
 
+// Convenience methods on an entry returned by FindTrial(), no lookup.
+inline bool IsEnabled(const FieldTrialEntry* trial) {
+  return trial && trial->enabled;
+}
+
+inline bool IsDisabled(const FieldTrialEntry* trial) {
+  return trial && trial->disabled;
+}
+
 // Convenience method, returns true iff FindFullName(name) return a string that
 // starts with "Enabled".
 // TODO(tommi): Make sure all implementations support this.
 inline bool IsEnabled(const char* name) {
-  return FindFullName(name).find("Enabled") == 0;
+  return IsEnabled(FindTrial(name));
 }
 
 // Convenience method, returns true iff FindFullName(name) return a string that
 // starts with "Disabled".
 inline bool IsDisabled(const char* name) {
-  return FindFullName(name).find("Disabled") == 0;
+  return IsDisabled(FindTrial(name));
 }
 
 // Optionally initialize field trial from a string.
 // This method can be called at most once before any other call into webrtc.
-// E.g. before the peer connection factory is constructed.
+// E.g. before the peer connection factory is constructed. Lookups made before
+// it see no trials.
 // Note: trials_string must never be destroyed.
+// The expected format is "Trial1/Group1/Trial2/Group2/". A malformed string is
+// ignored as a whole and no trial is enabled.
 void InitFieldTrialsFromString(const char* trials_string);
 
 const char* GetFieldTrialString();
@@ -0,0 +1,88 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file field_trail_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ field_trail_unittest.cpp field_trail.cpp aimd_rate_control.cpp -std=c++11
+
+#include <cassert>
+#include <iostream>
+using namespace std;
+
+#include "aimd_rate_control.h"
+#include "field_trail.h"
+
+namespace webrtc {
+
+static const char kTrialsString[] =
+    "WebRTC-BweBackOffFactor/Enabled-0.9/"
+    "WebRTC-AdaptiveBweThreshold/Enabled/"
+    "WebRTC-Audio-BandwidthSmoothing/Disabled/";
+
+// FindFullNameAndIsEnabled
+// InitFieldTrialsFromString()时建表, 之前查不到任何试验
+void TestFieldTrial01() {
+    assert(field_trial::FindTrial("WebRTC-BweBackOffFactor") == nullptr);
+    assert(!field_trial::IsEnabled("WebRTC-BweBackOffFactor"));
+    field_trial::InitFieldTrialsFromString(kTrialsString);
+
+    assert(field_trial::FindFullName("WebRTC-BweBackOffFactor") == "Enabled-0.9");
+    assert(field_trial::IsEnabled("WebRTC-BweBackOffFactor"));
+    assert(field_trial::IsEnabled("WebRTC-AdaptiveBweThreshold"));
+    assert(field_trial::IsDisabled("WebRTC-Audio-BandwidthSmoothing"));
+    assert(!field_trial::IsEnabled("WebRTC-Audio-BandwidthSmoothing"));
+
+    // 不存在的试验
+    assert(field_trial::FindFullName("WebRTC-NotATrial") == "");
+    assert(!field_trial::IsEnabled("WebRTC-NotATrial"));
+    assert(!field_trial::IsDisabled("WebRTC-NotATrial"));
+    // 前缀不算匹配
+    assert(field_trial::FindFullName("WebRTC-BweBackOff") == "");
+    cout << "FindFullName ok" << endl;
+}
+
+// HandlesAreStable
+// 多次查找返回同一个表项, 可以保存指针, 之后不再查找
+void TestFieldTrial02() {
+    const field_trial::FieldTrialEntry* first = field_trial::FindTrial("WebRTC-BweBackOffFactor");
+    const field_trial::FieldTrialEntry* second = field_trial::FindTrial("WebRTC-BweBackOffFactor");
+    assert(first && first == second);
+    assert(first->name == "WebRTC-BweBackOffFactor");
+    assert(field_trial::IsEnabled(first));
+    assert(!field_trial::IsDisabled(first));
+    assert(field_trial::FindTrial("WebRTC-NotATrial") == nullptr);
+    assert(!field_trial::IsEnabled(field_trial::FindTrial("WebRTC-NotATrial")));
+    assert(field_trial::GetFieldTrialString() == kTrialsString);
+    cout << "FindTrial ok" << endl;
+}
+
+// AimdRateControlReadsExperiments
+void TestFieldTrial03() {
+    AimdRateControl aimd_rate_control;
+
+    // 回退系数0.9
+    constexpr int kBitrate = 300000;
+    aimd_rate_control.SetEstimate(kBitrate, 0);
+    RateControlInput input(BandwidthUsage::kBwOverusing, kBitrate);
+    aimd_rate_control.Update(&input, 0);
+    cout << "bitrate after overuse=" << aimd_rate_control.LatestEstimate() << "bps" << endl;
+    assert(aimd_rate_control.LatestEstimate() == 270000);
+
+    // AdaptiveBweThreshold开启, response time加倍: 270kbps/30=9000bits/600ms=15kbps
+    cout << "GetNearMaxIncreaseRateBps=" << aimd_rate_control.GetNearMaxIncreaseRateBps() << endl;
+    assert(aimd_rate_control.GetNearMaxIncreaseRateBps() == 15000);
+}
+
+} // namespace webrtc
+
+int main() {
+    webrtc::TestFieldTrial01();
+    webrtc::TestFieldTrial02();
+    webrtc::TestFieldTrial03();
+
+    return 0;
+}
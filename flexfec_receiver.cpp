@@ -0,0 +1,218 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file flexfec_receiver.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "flexfec_receiver.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace webrtc {
+
+constexpr int64_t FlexfecReceiver::kWindowSize;
+constexpr size_t FlexfecReceiver::kMaxPendingFecPackets;
+
+FlexfecReceiver::FlexfecReceiver(std::shared_ptr<video_coding::PacketBuffer> packet_buffer)
+    : _packet_buffer(std::move(packet_buffer)),
+    _newest_seq_num(-1),
+    _media(kWindowSize),
+    _received(kWindowSize / 64, 0),
+    _num_recovered_packets(0) {
+    static_assert(kWindowSize > static_cast<int64_t>(FecHeader::kMaxMaskBits),
+            "FEC mask must fit in the window.");
+    assert(_packet_buffer);
+}
+
+bool FlexfecReceiver::OnMediaPacket(VCMPacket* packet) {
+    // 和PacketBuffer一样把new[]分配的负载包装成句柄, 两边共享同一份负载
+    if (packet->payload_buffer.empty() && packet->data_ptr) {
+        packet->payload_buffer = PayloadBuffer::Adopt(const_cast<uint8_t*>(packet->data_ptr),
+                packet->size_bytes);
+    }
+    const int64_t seq_num = _unwrapper.Unwrap(packet->seq_num);
+    const bool available = StoreMediaPacket(seq_num, *packet);
+    const bool inserted = _packet_buffer->InsertPacket(packet);
+    if (available)
+        OnPacketAvailable(seq_num);
+    return inserted;
+}
+
+bool FlexfecReceiver::OnFecPacket(const PayloadBuffer& buffer, const uint8_t* data, size_t size) {
+    PendingFec fec;
+    const size_t header_size = FecHeader::Parse(data, size, &fec.header);
+    if (header_size == 0 || size < header_size + kFecVideoHeaderSize)
+        return false;
+    fec.seq_num_base = _unwrapper.Unwrap(fec.header.seq_num_base);
+    // 保护的包已经移出窗口, 用不上
+    if (fec.seq_num_base <= _newest_seq_num - kWindowSize)
+        return true;
+    fec.buffer = buffer;
+    fec.payload = data + header_size;
+    fec.payload_size = size - header_size;
+
+    int64_t missing = 0;
+    fec.num_missing = CountMissing(fec, &missing);
+    if (fec.num_missing == 0)
+        return true;
+    if (fec.num_missing == 1) {
+        if (Recover(fec, missing))
+            OnPacketAvailable(missing);
+        return true;
+    }
+    if (_pending.size() >= kMaxPendingFecPackets)
+        _pending.erase(_pending.begin());
+    _pending.push_back(std::move(fec));
+    return true;
+}
+
+bool FlexfecReceiver::StoreMediaPacket(int64_t seq_num, const VCMPacket& packet) {
+    if (seq_num <= _newest_seq_num - kWindowSize)
+        return false;
+    if (seq_num > _newest_seq_num) {
+        // 环上新序号的位置还是kWindowSize之前的包, 按字清掉
+        int64_t begin = std::max(_newest_seq_num + 1, seq_num - kWindowSize + 1);
+        while (begin <= seq_num) {
+            const size_t index = static_cast<size_t>(begin & (kWindowSize - 1));
+            const size_t shift = index & 63;
+            const size_t bits = static_cast<size_t>(std::min<int64_t>(64 - shift, seq_num + 1 - begin));
+            const uint64_t mask = bits == 64 ? ~uint64_t{0} : ((uint64_t{1} << bits) - 1) << shift;
+            _received[index >> 6] &= ~mask;
+            begin += bits;
+        }
+        _newest_seq_num = seq_num;
+    }
+
+    const size_t index = static_cast<size_t>(seq_num & (kWindowSize - 1));
+    const uint64_t bit = uint64_t{1} << (index & 63);
+    if (_received[index >> 6] & bit)
+        return false;
+    _received[index >> 6] |= bit;
+    _media[index].seq_num = seq_num;
+    _media[index].packet = packet;
+    return true;
+}
+
+uint64_t FlexfecReceiver::ReceivedBits(int64_t seq_num) const {
+    const int64_t begin = std::max(seq_num, _newest_seq_num - kWindowSize + 1);
+    const int64_t end = std::min(seq_num + 64, _newest_seq_num + 1);
+    if (begin >= end)
+        return 0;
+
+    const size_t index = static_cast<size_t>(seq_num & (kWindowSize - 1));
+    const size_t shift = index & 63;
+    const size_t word = index >> 6;
+    uint64_t bits = _received[word] >> shift;
+    if (shift)
+        bits |= _received[(word + 1) & (_received.size() - 1)] << (64 - shift);
+
+    const size_t num_valid = static_cast<size_t>(end - begin);
+    const uint64_t valid = num_valid == 64 ? ~uint64_t{0} : (uint64_t{1} << num_valid) - 1;
+    return bits & (valid << (begin - seq_num));
+}
+
+size_t FlexfecReceiver::CountMissing(const PendingFec& fec, int64_t* missing) const {
+    size_t num_missing = 0;
+    for (size_t i = 0; i < 2; ++i) {
+        const int64_t seq_num = fec.seq_num_base + 64 * static_cast<int64_t>(i);
+        const uint64_t bits = fec.header.mask[i] & ~ReceivedBits(seq_num);
+        if (bits && num_missing == 0)
+            *missing = seq_num + __builtin_ctzll(bits);
+        num_missing += __builtin_popcountll(bits);
+    }
+    return num_missing;
+}
+
+bool FlexfecReceiver::Recover(const PendingFec& fec, int64_t seq_num) {
+    const size_t offset = static_cast<size_t>(seq_num - fec.seq_num_base);
+    uint8_t* data = new uint8_t[fec.payload_size];
+    PayloadBuffer buffer = PayloadBuffer::Adopt(data, fec.payload_size);
+    memcpy(data, fec.payload, fec.payload_size);
+
+    bool marker = fec.header.marker_recovery;
+    uint8_t payload_type = fec.header.payload_type_recovery;
+    uint16_t length = fec.header.length_recovery;
+    uint32_t timestamp = fec.header.timestamp_recovery;
+    for (size_t i = 0; i < 2; ++i) {
+        uint64_t bits = fec.header.mask[i];
+        if (offset >> 6 == i)
+            bits &= ~(uint64_t{1} << (offset & 63));
+        while (bits) {
+            const int64_t protected_seq_num = fec.seq_num_base + 64 * static_cast<int64_t>(i) +
+                __builtin_ctzll(bits);
+            bits &= bits - 1;
+            const MediaSlot& slot = _media[protected_seq_num & (kWindowSize - 1)];
+            assert(slot.seq_num == protected_seq_num);
+            const VCMPacket& packet = slot.packet;
+            // FEC包和媒体包对不上
+            if (kFecVideoHeaderSize + packet.size_bytes > fec.payload_size)
+                return false;
+            uint8_t video_header[kFecVideoHeaderSize];
+            WriteFecVideoHeader(packet, video_header);
+            data[0] ^= video_header[0];
+            data[1] ^= video_header[1];
+            XorPayload(data + kFecVideoHeaderSize, packet.data_ptr, packet.size_bytes);
+            marker ^= packet.marker_bit;
+            payload_type ^= packet.payload_type & 0x7f;
+            length ^= static_cast<uint16_t>(kFecVideoHeaderSize + packet.size_bytes);
+            timestamp ^= packet.timestamp;
+        }
+    }
+    if (length < kFecVideoHeaderSize || length > fec.payload_size)
+        return false;
+
+    VCMPacket recovered;
+    recovered.seq_num = static_cast<uint16_t>(seq_num);
+    recovered.timestamp = timestamp;
+    recovered.payload_type = payload_type;
+    recovered.marker_bit = marker;
+    ReadFecVideoHeader(data, &recovered);
+    recovered.data_ptr = data + kFecVideoHeaderSize;
+    recovered.size_bytes = length - kFecVideoHeaderSize;
+    recovered.payload_buffer = std::move(buffer);
+
+    StoreMediaPacket(seq_num, recovered);
+    ++_num_recovered_packets;
+    // RTC_LOG(LS_VERBOSE) << "Recovered packet " << recovered.seq_num;
+    _packet_buffer->InsertPacket(&recovered);
+    return true;
+}
+
+void FlexfecReceiver::OnPacketAvailable(int64_t seq_num) {
+    _available.push_back(seq_num);
+    while (!_available.empty()) {
+        const int64_t available = _available.back();
+        _available.pop_back();
+
+        size_t num_pending = 0;
+        for (size_t i = 0; i < _pending.size(); ++i) {
+            PendingFec& fec = _pending[i];
+            const int64_t offset = available - fec.seq_num_base;
+            bool done = fec.seq_num_base <= _newest_seq_num - kWindowSize;
+            if (!done && offset >= 0 && offset < static_cast<int64_t>(FecHeader::kMaxMaskBits) &&
+                    ((fec.header.mask[offset >> 6] >> (offset & 63)) & 1) && --fec.num_missing <= 1) {
+                // 只缺一个就恢复, 不缺了就没用了, 都不再等待
+                done = true;
+                int64_t missing = 0;
+                if (fec.num_missing == 1 && CountMissing(fec, &missing) == 1 && Recover(fec, missing))
+                    _available.push_back(missing);
+            }
+            if (!done) {
+                if (num_pending != i)
+                    _pending[num_pending] = std::move(fec);
+                ++num_pending;
+            }
+        }
+        _pending.erase(_pending.begin() + num_pending, _pending.end());
+    }
+}
+
+} // namespace webrtc
+
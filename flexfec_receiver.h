@@ -0,0 +1,95 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file flexfec_receiver.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _FLEXFEC_RECEIVER_H
+#define _FLEXFEC_RECEIVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "forward_error_correction.h"
+#include "module_common_types_public.h"
+#include "packet_buffer.h"
+#include "payload_buffer.h"
+#include "vcm_packet.h"
+
+namespace webrtc {
+
+// XOR FEC的接收端: 媒体包经过这里插入PacketBuffer, 同时保留负载的引用; FEC包
+// 保护的包只缺一个时把它恢复出来, 直接插入PacketBuffer。
+//
+// 收到的媒体包记在一个按unwrap后的序号索引的滑动位图中(kWindowSize位, 环形),
+// FEC包的掩码和位图按64位一个字比较就得到缺的包。缺不止一个的FEC包等待, 每个包
+// 到达或者被恢复时减少覆盖它的FEC包的缺包计数, 减到1就恢复, 恢复出的包又可能让
+// 别的FEC包只缺一个, 所以2-D的行列FEC会交替恢复, 直到不能再恢复为止。
+//
+// Note: This class is not thread-safe.
+class FlexfecReceiver {
+public:
+    // 保留的媒体包个数, 2的幂且大于FEC掩码的范围
+    static constexpr int64_t kWindowSize = 1024;
+    // 最多等待的FEC包, 超过时丢掉最老的
+    static constexpr size_t kMaxPendingFecPackets = 256;
+
+    explicit FlexfecReceiver(std::shared_ptr<video_coding::PacketBuffer> packet_buffer);
+
+    // 插入PacketBuffer并记下负载, 返回InsertPacket()的结果
+    bool OnMediaPacket(VCMPacket* packet);
+    // |data|是去掉RTP头的FEC包(FlexFEC头 + XOR负载), 在|buffer|内部, 等待期间持有
+    // |buffer|的引用。格式错误返回false。
+    bool OnFecPacket(const PayloadBuffer& buffer, const uint8_t* data, size_t size);
+
+    size_t num_recovered_packets() const { return _num_recovered_packets; }
+    size_t num_pending_fec_packets() const { return _pending.size(); }
+
+private:
+    struct MediaSlot {
+        int64_t seq_num;
+        VCMPacket packet;
+    };
+
+    struct PendingFec {
+        int64_t seq_num_base;
+        FecHeader header;
+        size_t num_missing;
+        PayloadBuffer buffer;
+        const uint8_t* payload;
+        size_t payload_size;
+    };
+
+    // 记下一个可用于恢复的包, 已经有了返回false
+    bool StoreMediaPacket(int64_t seq_num, const VCMPacket& packet);
+    // 序号[seq_num, seq_num + 64)中收到的包, 只有窗口内的位有效
+    uint64_t ReceivedBits(int64_t seq_num) const;
+    // |fec|保护的包中还没有收到的个数, |missing|是其中第一个
+    size_t CountMissing(const PendingFec& fec, int64_t* missing) const;
+    // 用|fec|和其余收到的包恢复|seq_num|, 插入PacketBuffer
+    bool Recover(const PendingFec& fec, int64_t seq_num);
+    // |seq_num|可用了, 更新等待的FEC包并恢复所有能恢复的包
+    void OnPacketAvailable(int64_t seq_num);
+
+    std::shared_ptr<video_coding::PacketBuffer> _packet_buffer;
+    SequenceNumberUnwrapper _unwrapper;
+    int64_t _newest_seq_num;
+    std::vector<MediaSlot> _media;
+    std::vector<uint64_t> _received;
+    // 按到达顺序
+    std::vector<PendingFec> _pending;
+    std::vector<int64_t> _available;
+    size_t _num_recovered_packets;
+};
+
+} // namespace webrtc
+
+#endif // _FLEXFEC_RECEIVER_H
+
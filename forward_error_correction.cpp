@@ -0,0 +1,290 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file forward_error_correction.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "forward_error_correction.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "byte_io.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr size_t kBaseHeaderSize = 12;
+// F=0时各段掩码的位数和写到这一段为止的头长度
+constexpr size_t kMaskBits0 = 15;
+constexpr size_t kMaskBits1 = 31;
+constexpr size_t kMaskBits2 = 64;
+constexpr size_t kHeaderSizeMask0 = 12;
+constexpr size_t kHeaderSizeMask1 = 16;
+constexpr size_t kHeaderSizeMask2 = 24;
+
+constexpr uint8_t kRetransmissionBit = 0x80;
+constexpr uint8_t kFixedMaskBit = 0x40;
+constexpr uint8_t kMarkerBit = 0x80;
+constexpr uint8_t kKBit = 0x80;
+constexpr uint8_t kFirstPacketBit = 0x80;
+
+inline void SetOffset(uint64_t* mask, size_t offset) {
+    mask[offset >> 6] |= uint64_t{1} << (offset & 63);
+}
+
+inline bool HasOffset(const uint64_t* mask, size_t offset) {
+    return (mask[offset >> 6] >> (offset & 63)) & 1;
+}
+
+// |bits|位的|chunk|, 最高位是偏移|first|
+inline void ReadMaskChunk(uint64_t chunk, size_t bits, size_t first, uint64_t* mask) {
+    for (size_t i = 0; i < bits; ++i) {
+        if ((chunk >> (bits - 1 - i)) & 1)
+            SetOffset(mask, first + i);
+    }
+}
+
+inline uint64_t WriteMaskChunk(const uint64_t* mask, size_t bits, size_t first) {
+    uint64_t chunk = 0;
+    for (size_t i = 0; i < bits; ++i) {
+        if (first + i < FecHeader::kMaxMaskBits && HasOffset(mask, first + i))
+            chunk |= uint64_t{1} << (bits - 1 - i);
+    }
+    return chunk;
+}
+
+} // namespace
+
+constexpr size_t FecHeader::kMaxMaskBits;
+
+FecHeader::FecHeader()
+    : fixed_mask(false),
+    num_columns(0),
+    num_rows(0),
+    seq_num_base(0),
+    mask{0, 0},
+    marker_recovery(false),
+    payload_type_recovery(0),
+    length_recovery(0),
+    timestamp_recovery(0) {}
+
+FecHeader FecHeader::Row(uint16_t seq_num_base, uint8_t num_packets) {
+    assert(num_packets > 0 && num_packets <= kMaxMaskBits);
+    FecHeader header;
+    header.fixed_mask = true;
+    header.num_columns = num_packets;
+    header.num_rows = 0;
+    header.seq_num_base = seq_num_base;
+    for (size_t i = 0; i < num_packets; ++i)
+        SetOffset(header.mask, i);
+    return header;
+}
+
+FecHeader FecHeader::Column(uint16_t seq_num_base, uint8_t num_columns, uint8_t num_rows) {
+    assert(num_columns > 0 && num_rows > 0);
+    assert(static_cast<size_t>(num_rows - 1) * num_columns < kMaxMaskBits);
+    FecHeader header;
+    header.fixed_mask = true;
+    header.num_columns = num_columns;
+    header.num_rows = num_rows;
+    header.seq_num_base = seq_num_base;
+    for (size_t i = 0; i < num_rows; ++i)
+        SetOffset(header.mask, i * num_columns);
+    return header;
+}
+
+FecHeader FecHeader::Flexible(uint16_t seq_num_base, uint64_t mask_low, uint64_t mask_high) {
+    // F=0最多110位
+    assert((mask_high >> (kMaskBits0 + kMaskBits1 + kMaskBits2 - 64)) == 0);
+    FecHeader header;
+    header.seq_num_base = seq_num_base;
+    header.mask[0] = mask_low;
+    header.mask[1] = mask_high;
+    return header;
+}
+
+size_t FecHeader::Parse(const uint8_t* data, size_t size, FecHeader* header) {
+    if (size < kBaseHeaderSize || (data[0] & kRetransmissionBit))
+        return 0;
+    *header = FecHeader();
+    header->fixed_mask = (data[0] & kFixedMaskBit) != 0;
+    header->marker_recovery = (data[1] & kMarkerBit) != 0;
+    header->payload_type_recovery = data[1] & 0x7f;
+    header->length_recovery = ByteReader<uint16_t>::ReadBigEndian(data + 2);
+    header->timestamp_recovery = ByteReader<uint32_t>::ReadBigEndian(data + 4);
+    header->seq_num_base = ByteReader<uint16_t>::ReadBigEndian(data + 8);
+
+    size_t header_size = 0;
+    if (header->fixed_mask) {
+        header->num_columns = data[10];
+        header->num_rows = data[11];
+        if (header->num_columns == 0)
+            return 0;
+        if (header->num_rows == 0) {
+            if (header->num_columns > kMaxMaskBits)
+                return 0;
+            for (size_t i = 0; i < header->num_columns; ++i)
+                SetOffset(header->mask, i);
+        } else {
+            if (static_cast<size_t>(header->num_rows - 1) * header->num_columns >= kMaxMaskBits)
+                return 0;
+            for (size_t i = 0; i < header->num_rows; ++i)
+                SetOffset(header->mask, i * header->num_columns);
+        }
+        header_size = kBaseHeaderSize;
+    } else {
+        ReadMaskChunk(ByteReader<uint16_t>::ReadBigEndian(data + 10) & 0x7fff,
+                kMaskBits0, 0, header->mask);
+        header_size = kHeaderSizeMask0;
+        if (!(data[10] & kKBit)) {
+            if (size < kHeaderSizeMask1)
+                return 0;
+            ReadMaskChunk(ByteReader<uint32_t>::ReadBigEndian(data + 12) & 0x7fffffff,
+                    kMaskBits1, kMaskBits0, header->mask);
+            header_size = kHeaderSizeMask1;
+            if (!(data[12] & kKBit)) {
+                if (size < kHeaderSizeMask2)
+                    return 0;
+                ReadMaskChunk(ByteReader<uint64_t>::ReadBigEndian(data + 16),
+                        kMaskBits2, kMaskBits0 + kMaskBits1, header->mask);
+                header_size = kHeaderSizeMask2;
+            }
+        }
+    }
+    // 至少保护一个包
+    if (header->num_protected() == 0)
+        return 0;
+    return header_size;
+}
+
+size_t FecHeader::size() const {
+    if (fixed_mask)
+        return kBaseHeaderSize;
+    if (mask[1] == 0 && (mask[0] >> kMaskBits0) == 0)
+        return kHeaderSizeMask0;
+    if (mask[1] == 0 && (mask[0] >> (kMaskBits0 + kMaskBits1)) == 0)
+        return kHeaderSizeMask1;
+    return kHeaderSizeMask2;
+}
+
+size_t FecHeader::Write(uint8_t* buffer) const {
+    buffer[0] = fixed_mask ? kFixedMaskBit : 0;
+    buffer[1] = (marker_recovery ? kMarkerBit : 0) | (payload_type_recovery & 0x7f);
+    ByteWriter<uint16_t>::WriteBigEndian(buffer + 2, length_recovery);
+    ByteWriter<uint32_t>::WriteBigEndian(buffer + 4, timestamp_recovery);
+    ByteWriter<uint16_t>::WriteBigEndian(buffer + 8, seq_num_base);
+    if (fixed_mask) {
+        buffer[10] = num_columns;
+        buffer[11] = num_rows;
+        return kBaseHeaderSize;
+    }
+
+    const size_t header_size = size();
+    ByteWriter<uint16_t>::WriteBigEndian(buffer + 10,
+            static_cast<uint16_t>(WriteMaskChunk(mask, kMaskBits0, 0)));
+    if (header_size == kHeaderSizeMask0) {
+        buffer[10] |= kKBit;
+        return header_size;
+    }
+    ByteWriter<uint32_t>::WriteBigEndian(buffer + 12,
+            static_cast<uint32_t>(WriteMaskChunk(mask, kMaskBits1, kMaskBits0)));
+    if (header_size == kHeaderSizeMask1) {
+        buffer[12] |= kKBit;
+        return header_size;
+    }
+    ByteWriter<uint64_t>::WriteBigEndian(buffer + 16,
+            WriteMaskChunk(mask, kMaskBits2, kMaskBits0 + kMaskBits1));
+    return header_size;
+}
+
+void XorPayload(uint8_t* dst, const uint8_t* src, size_t size) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= size; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(a, b));
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= size; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(a, b));
+    }
+#endif
+    for (; i + 8 <= size; i += 8) {
+        uint64_t a;
+        uint64_t b;
+        memcpy(&a, dst + i, 8);
+        memcpy(&b, src + i, 8);
+        a ^= b;
+        memcpy(dst + i, &a, 8);
+    }
+    for (; i < size; ++i)
+        dst[i] ^= src[i];
+}
+
+void EncodeFecPacket(const FecHeader& protection, const std::vector<const VCMPacket*>& packets,
+        std::vector<uint8_t>* fec_packet) {
+    assert(packets.size() == protection.num_protected());
+    FecHeader header = protection;
+    header.marker_recovery = false;
+    header.payload_type_recovery = 0;
+    header.length_recovery = 0;
+    header.timestamp_recovery = 0;
+
+    size_t payload_size = 0;
+    for (const VCMPacket* packet : packets)
+        payload_size = std::max(payload_size, kFecVideoHeaderSize + packet->size_bytes);
+    const size_t header_size = header.size();
+    fec_packet->assign(header_size + payload_size, 0);
+
+    uint8_t* payload = fec_packet->data() + header_size;
+    size_t next = 0;
+    for (size_t offset = 0; offset < FecHeader::kMaxMaskBits; ++offset) {
+        if (!HasOffset(header.mask, offset))
+            continue;
+        const VCMPacket& packet = *packets[next++];
+        assert(packet.seq_num == static_cast<uint16_t>(header.seq_num_base + offset));
+        uint8_t video_header[kFecVideoHeaderSize];
+        WriteFecVideoHeader(packet, video_header);
+        payload[0] ^= video_header[0];
+        payload[1] ^= video_header[1];
+        XorPayload(payload + kFecVideoHeaderSize, packet.data_ptr, packet.size_bytes);
+        header.marker_recovery ^= packet.marker_bit;
+        header.payload_type_recovery ^= packet.payload_type & 0x7f;
+        header.length_recovery ^= static_cast<uint16_t>(kFecVideoHeaderSize + packet.size_bytes);
+        header.timestamp_recovery ^= packet.timestamp;
+    }
+    header.Write(fec_packet->data());
+}
+
+void WriteFecVideoHeader(const VCMPacket& packet, uint8_t* video_header) {
+    video_header[0] = (packet.is_first_packet_in_frame ? kFirstPacketBit : 0) |
+        (static_cast<uint8_t>(packet.frame_type) & 0x7f);
+    video_header[1] = static_cast<uint8_t>(packet.codec);
+}
+
+void ReadFecVideoHeader(const uint8_t* video_header, VCMPacket* packet) {
+    packet->is_first_packet_in_frame = (video_header[0] & kFirstPacketBit) != 0;
+    packet->frame_type = static_cast<FrameType>(video_header[0] & 0x7f);
+    packet->codec = static_cast<VideoCodecType>(video_header[1]);
+}
+
+} // namespace webrtc
+
@@ -0,0 +1,98 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file forward_error_correction.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _FORWARD_ERROR_CORRECTION_H
+#define _FORWARD_ERROR_CORRECTION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "vcm_packet.h"
+
+namespace webrtc {
+
+// FEC保护的视频头: 每个媒体包的负载前面加两个字节一起参与XOR, 恢复出的包据此
+// 填写VCMPacket中本该由解包器给出的字段。
+//   byte 0: |F|  frame_type   |   F: is_first_packet_in_frame
+//   byte 1: |     codec       |
+constexpr size_t kFecVideoHeaderSize = 2;
+
+// FlexFEC头(RFC 8627 section 4.2.2.1), 只支持一个SSRC, P/X/CC不恢复, 写0。
+//
+//  0                   1                   2                   3
+//  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |0|F|P|X|  CC   |M| PT recovery |        length recovery        |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |                          TS recovery                          |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |           SN base_i           |k|          Mask [0-14]        |  F=0
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |k|                   Mask [15-45] (optional)                   |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |                     Mask [46-109] (optional)                  |
+// |                                                               |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//
+// F=1时SN base之后是L和D各一个字节: D为0时保护SN base开始连续L个包(行),
+// 否则保护SN base开始间隔L的D个包(列)。
+struct FecHeader {
+    // 掩码最多覆盖的序号个数, F=0时是110
+    static constexpr size_t kMaxMaskBits = 128;
+
+    FecHeader();
+
+    // 1-D行: 连续|num_packets|个包
+    static FecHeader Row(uint16_t seq_num_base, uint8_t num_packets);
+    // 1-D列: L列D行的块中的一列
+    static FecHeader Column(uint16_t seq_num_base, uint8_t num_columns, uint8_t num_rows);
+    // 任意掩码, 第i位保护seq_num_base + i, i < 110
+    static FecHeader Flexible(uint16_t seq_num_base, uint64_t mask_low, uint64_t mask_high);
+
+    // 解析|data|开头的FEC头, 返回头长度, 格式错误或者保护范围超过kMaxMaskBits返回0
+    static size_t Parse(const uint8_t* data, size_t size, FecHeader* header);
+    size_t size() const;
+    // 写到|buffer|, 返回写入的长度
+    size_t Write(uint8_t* buffer) const;
+    size_t num_protected() const {
+        return __builtin_popcountll(mask[0]) + __builtin_popcountll(mask[1]);
+    }
+
+    bool fixed_mask;
+    uint8_t num_columns;
+    uint8_t num_rows;
+    uint16_t seq_num_base;
+    // 第i位保护seq_num_base + i; F=1时由L/D展开
+    uint64_t mask[2];
+
+    bool marker_recovery;
+    uint8_t payload_type_recovery;
+    uint16_t length_recovery;
+    uint32_t timestamp_recovery;
+};
+
+// dst[i] ^= src[i], i < size。有AVX2时每次32字节, 否则有SSE2时每次16字节
+void XorPayload(uint8_t* dst, const uint8_t* src, size_t size);
+
+// 生成保护|packets|的FEC包写到|fec_packet|: |protection|给出SN base和掩码(Row/Column/Flexible),
+// |packets|按序号排列, 正好是掩码中的包。
+void EncodeFecPacket(const FecHeader& protection, const std::vector<const VCMPacket*>& packets,
+        std::vector<uint8_t>* fec_packet);
+
+// 媒体包参与XOR的视频头
+void WriteFecVideoHeader(const VCMPacket& packet, uint8_t* video_header);
+void ReadFecVideoHeader(const uint8_t* video_header, VCMPacket* packet);
+
+} // namespace webrtc
+
+#endif // _FORWARD_ERROR_CORRECTION_H
+
@@ -0,0 +1,554 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file forward_error_correction_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ forward_error_correction_unittest.cpp forward_error_correction.cpp flexfec_receiver.cpp packet_buffer.cpp frame_object.cpp payload_buffer.cpp random.cpp -std=c++11 -O2 [-mavx2]
+
+#include <string.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+using namespace std;
+
+#include "clock.h"
+#include "flexfec_receiver.h"
+#include "forward_error_correction.h"
+#include "frame_object.h"
+#include "packet_buffer.h"
+#include "payload_buffer.h"
+#include "random.h"
+
+using namespace webrtc;
+using namespace video_coding;
+
+static const char* XorKernelName() {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+class RecordingFrameCallback : public OnReceivedFrameCallback {
+public:
+    void OnReceivedFrame(std::unique_ptr<RtpFrameObject> frame) override {
+        _frames.push_back(std::move(frame));
+    }
+
+    std::vector<std::unique_ptr<RtpFrameObject>> _frames;
+};
+
+// 发送端的媒体流: 每帧|min_packets|~|max_packets|个包, 负载随机
+struct MediaStream {
+    std::vector<VCMPacket> packets;
+    std::vector<std::vector<uint8_t>> payloads;
+    // 每帧第一个包的下标, 最后多一个结束位置
+    std::vector<size_t> frame_begin;
+};
+
+static void GenerateStream(Random* random, uint16_t first_seq_num, size_t num_frames,
+        int min_packets, int max_packets, int max_payload_size, MediaStream* stream) {
+    for (size_t f = 0; f < num_frames; ++f) {
+        stream->frame_begin.push_back(stream->packets.size());
+        const int num_packets = random->Rand(min_packets, max_packets);
+        for (int i = 0; i < num_packets; ++i) {
+            VCMPacket packet;
+            packet.payload_type = 96 + f % 2;
+            packet.codec = f % 3 == 0 ? kVideoCodecH264 : kVideoCodecVP8;
+            packet.timestamp = static_cast<uint32_t>(f * 3000 + 0xFFFF0000u);
+            packet.seq_num = static_cast<uint16_t>(first_seq_num + stream->packets.size());
+            packet.frame_type = f % 50 == 0 ? kVideoFrameKey : kVideoFrameDelta;
+            packet.is_first_packet_in_frame = i == 0;
+            packet.marker_bit = i == num_packets - 1;
+            std::vector<uint8_t> payload(random->Rand(0, max_payload_size));
+            for (uint8_t& byte : payload)
+                byte = random->Rand<uint8_t>();
+            stream->payloads.push_back(payload);
+            stream->packets.push_back(packet);
+        }
+    }
+    stream->frame_begin.push_back(stream->packets.size());
+    for (size_t i = 0; i < stream->packets.size(); ++i)
+        stream->packets[i].data_ptr = stream->payloads[i].data();
+    for (size_t i = 0; i < stream->packets.size(); ++i)
+        stream->packets[i].size_bytes = stream->payloads[i].size();
+}
+
+// 一个FEC包, |protected_indices|是保护的媒体包下标
+struct SentFec {
+    std::vector<size_t> protected_indices;
+    std::vector<uint8_t> packet;
+};
+
+static SentFec MakeFec(const MediaStream& stream, const FecHeader& protection, size_t base_index) {
+    SentFec fec;
+    std::vector<const VCMPacket*> packets;
+    for (size_t offset = 0; offset < FecHeader::kMaxMaskBits; ++offset) {
+        if ((protection.mask[offset >> 6] >> (offset & 63)) & 1) {
+            fec.protected_indices.push_back(base_index + offset);
+            packets.push_back(&stream.packets[base_index + offset]);
+        }
+    }
+    EncodeFecPacket(protection, packets, &fec.packet);
+    return fec;
+}
+
+// 发送顺序中的一个包: fec < 0是媒体包|index|, 否则是第fec个FEC包
+struct SendEvent {
+    size_t index;
+    int fec;
+};
+
+// 每|L| x |D|个媒体包一个块, 每行|L|个包发完后发行FEC, 整块发完后发|L|个列FEC;
+// 最后不满一块的包不保护
+static void ProtectStream(const MediaStream& stream, uint8_t L, uint8_t D,
+        std::vector<SentFec>* fecs, std::vector<SendEvent>* events) {
+    const size_t block_size = static_cast<size_t>(L) * D;
+    for (size_t i = 0; i < stream.packets.size(); ++i) {
+        events->push_back(SendEvent{i, -1});
+        const size_t block = i / block_size;
+        const size_t in_block = i % block_size;
+        if ((block + 1) * block_size > stream.packets.size())
+            continue;
+        if (in_block % L == static_cast<size_t>(L - 1)) {
+            const size_t base = i + 1 - L;
+            fecs->push_back(MakeFec(stream, FecHeader::Row(stream.packets[base].seq_num, L), base));
+            events->push_back(SendEvent{0, static_cast<int>(fecs->size() - 1)});
+        }
+        if (in_block == block_size - 1) {
+            for (size_t c = 0; c < L; ++c) {
+                const size_t base = block * block_size + c;
+                fecs->push_back(MakeFec(stream,
+                            FecHeader::Column(stream.packets[base].seq_num, L, D), base));
+                events->push_back(SendEvent{0, static_cast<int>(fecs->size() - 1)});
+            }
+        }
+    }
+}
+
+static void SendMedia(FlexfecReceiver* receiver, const MediaStream& stream, size_t index) {
+    VCMPacket packet = stream.packets[index];
+    uint8_t* data = new uint8_t[packet.size_bytes];
+    if (packet.size_bytes > 0)
+        memcpy(data, stream.payloads[index].data(), packet.size_bytes);
+    packet.data_ptr = data;
+    receiver->OnMediaPacket(&packet);
+}
+
+static bool SendFec(FlexfecReceiver* receiver, const SentFec& fec) {
+    uint8_t* data = new uint8_t[fec.packet.size()];
+    memcpy(data, fec.packet.data(), fec.packet.size());
+    PayloadBuffer buffer = PayloadBuffer::Adopt(data, fec.packet.size());
+    return receiver->OnFecPacket(buffer, data, fec.packet.size());
+}
+
+// 收到的帧与发送的一致; 返回每帧收到的次数
+static std::vector<int> CheckFrames(const MediaStream& stream, RecordingFrameCallback* callback) {
+    std::map<uint16_t, size_t> frame_by_first_seq_num;
+    for (size_t f = 0; f + 1 < stream.frame_begin.size(); ++f)
+        frame_by_first_seq_num[stream.packets[stream.frame_begin[f]].seq_num] = f;
+    std::vector<int> num_received(stream.frame_begin.size() - 1, 0);
+    for (std::unique_ptr<RtpFrameObject>& frame : callback->_frames) {
+        auto it = frame_by_first_seq_num.find(frame->first_seq_num());
+        assert(it != frame_by_first_seq_num.end());
+        const size_t begin = stream.frame_begin[it->second];
+        const size_t end = stream.frame_begin[it->second + 1];
+        const VCMPacket& first = stream.packets[begin];
+        assert(frame->last_seq_num() == stream.packets[end - 1].seq_num);
+        assert(frame->timestamp() == first.timestamp);
+        assert(frame->frame_type() == first.frame_type);
+        assert(frame->codec_type() == first.codec);
+        std::vector<uint8_t> expected;
+        for (size_t i = begin; i < end; ++i)
+            expected.insert(expected.end(), stream.payloads[i].begin(), stream.payloads[i].end());
+        std::vector<uint8_t> bitstream(frame->size());
+        frame->CopyBitstream(bitstream.data());
+        assert(bitstream == expected);
+        ++num_received[it->second];
+    }
+    callback->_frames.clear();
+    return num_received;
+}
+
+// HeaderRoundTrip
+// 行/列/三种长度的灵活掩码写出再解析得到相同的字段; 截断、重传包、L为0、列超过
+// kMaxMaskBits的头解析失败
+void TestForwardErrorCorrection01() {
+    FecHeader headers[5] = {
+        FecHeader::Row(65530, 10),
+        FecHeader::Column(100, 10, 10),
+        FecHeader::Flexible(7, (uint64_t{1} << 14) | 1, 0),
+        FecHeader::Flexible(8, (uint64_t{1} << 45) | 6, 0),
+        FecHeader::Flexible(9, 0x8000000000000001ull, uint64_t{1} << 45),
+    };
+    const size_t sizes[5] = {12, 12, 12, 16, 24};
+    for (size_t i = 0; i < 5; ++i) {
+        FecHeader header = headers[i];
+        header.marker_recovery = i % 2 == 0;
+        header.payload_type_recovery = static_cast<uint8_t>(0x55 + i);
+        header.length_recovery = static_cast<uint16_t>(0xABCD + i);
+        header.timestamp_recovery = 0x89ABCDEFu + i;
+        assert(header.size() == sizes[i]);
+        uint8_t buffer[24];
+        assert(header.Write(buffer) == sizes[i]);
+
+        FecHeader parsed;
+        assert(FecHeader::Parse(buffer, sizes[i], &parsed) == sizes[i]);
+        assert(parsed.fixed_mask == header.fixed_mask);
+        assert(parsed.num_columns == header.num_columns);
+        assert(parsed.num_rows == header.num_rows);
+        assert(parsed.seq_num_base == header.seq_num_base);
+        assert(parsed.mask[0] == header.mask[0] && parsed.mask[1] == header.mask[1]);
+        assert(parsed.marker_recovery == header.marker_recovery);
+        assert(parsed.payload_type_recovery == header.payload_type_recovery);
+        assert(parsed.length_recovery == header.length_recovery);
+        assert(parsed.timestamp_recovery == header.timestamp_recovery);
+        assert(FecHeader::Parse(buffer, sizes[i] - 1, &parsed) == 0);
+    }
+    assert(headers[0].num_protected() == 10 && headers[0].mask[0] == 0x3ff);
+    assert(headers[1].num_protected() == 10 && headers[1].mask[1] ==
+            ((uint64_t{1} << (70 - 64)) | (uint64_t{1} << (80 - 64)) | (uint64_t{1} << (90 - 64))));
+
+    uint8_t buffer[24];
+    FecHeader parsed;
+    FecHeader::Row(1, 4).Write(buffer);
+    buffer[0] |= 0x80;
+    assert(FecHeader::Parse(buffer, 12, &parsed) == 0);
+    FecHeader::Row(1, 4).Write(buffer);
+    buffer[10] = 0;
+    assert(FecHeader::Parse(buffer, 12, &parsed) == 0);
+    buffer[10] = 200;
+    buffer[11] = 2;
+    assert(FecHeader::Parse(buffer, 12, &parsed) == 0);
+    buffer[10] = 127;
+    assert(FecHeader::Parse(buffer, 12, &parsed) == 12 && parsed.num_protected() == 2);
+
+    cout << "TestForwardErrorCorrection01 passed" << endl;
+}
+
+// XorKernel
+// 各种长度和对齐下与逐字节XOR的结果相同
+void TestForwardErrorCorrection02() {
+    Random random(0x4601);
+    std::vector<uint8_t> src(512 + 8);
+    std::vector<uint8_t> dst(512 + 8);
+    for (size_t size = 0; size <= 512; ++size) {
+        for (size_t align = 0; align < 8; ++align) {
+            for (uint8_t& byte : src)
+                byte = random.Rand<uint8_t>();
+            for (uint8_t& byte : dst)
+                byte = random.Rand<uint8_t>();
+            std::vector<uint8_t> expected = dst;
+            for (size_t i = 0; i < size; ++i)
+                expected[align + i] ^= src[7 - align + i];
+            XorPayload(dst.data() + align, src.data() + 7 - align, size);
+            assert(dst == expected);
+        }
+    }
+    cout << "TestForwardErrorCorrection02 passed (" << XorKernelName() << ")" << endl;
+}
+
+// Cascade
+// 4x4的块丢了(0,0)、(0,1)、(1,0): 行0和列0都缺两个包, 行1恢复(1,0)后列0只缺(0,0),
+// 恢复后行0只缺(0,1)。行FEC先到和列FEC先到都能恢复全部三个包
+void TestForwardErrorCorrection03() {
+    for (int columns_first = 0; columns_first < 2; ++columns_first) {
+        Random random(0x4602);
+        MediaStream stream;
+        GenerateStream(&random, 0xFFF8, 4, 4, 4, 300, &stream);
+        std::vector<SentFec> fecs;
+        std::vector<SendEvent> events;
+        ProtectStream(stream, 4, 4, &fecs, &events);
+        assert(fecs.size() == 8);
+
+        SimulatedClock clock(0);
+        RecordingFrameCallback callback;
+        FlexfecReceiver receiver(PacketBuffer::Create(&clock, 16, 64, &callback));
+        for (size_t i = 0; i < stream.packets.size(); ++i) {
+            if (i != 0 && i != 1 && i != 4)
+                SendMedia(&receiver, stream, i);
+        }
+        for (size_t i = 0; i < fecs.size(); ++i)
+            assert(SendFec(&receiver, fecs[columns_first ? (i + 4) % 8 : i]));
+
+        assert(receiver.num_recovered_packets() == 3);
+        assert(receiver.num_pending_fec_packets() == 0);
+        std::vector<int> num_received = CheckFrames(stream, &callback);
+        for (int n : num_received)
+            assert(n == 1);
+    }
+
+    // 截断的FEC包
+    SimulatedClock clock(0);
+    RecordingFrameCallback callback;
+    FlexfecReceiver receiver(PacketBuffer::Create(&clock, 16, 64, &callback));
+    uint8_t data[13];
+    FecHeader::Row(0, 4).Write(data);
+    assert(!receiver.OnFecPacket(PayloadBuffer(), data, 13));
+    cout << "TestForwardErrorCorrection03 passed" << endl;
+}
+
+// 按收到的媒体包和FEC包反复找只缺一个包的FEC, 直到不能再恢复; 结果与到达顺序无关
+static size_t PeelRecovery(const std::vector<SentFec>& fecs, const std::vector<bool>& fec_received,
+        std::vector<bool>* available) {
+    size_t num_recovered = 0;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < fecs.size(); ++i) {
+            if (!fec_received[i])
+                continue;
+            size_t num_missing = 0;
+            size_t missing = 0;
+            for (size_t index : fecs[i].protected_indices) {
+                if (!(*available)[index]) {
+                    ++num_missing;
+                    missing = index;
+                }
+            }
+            if (num_missing == 1) {
+                (*available)[missing] = true;
+                ++num_recovered;
+                changed = true;
+            }
+        }
+    }
+    return num_recovered;
+}
+
+// 10x5的2-D FEC, 媒体包和FEC包都有随机丢包, 按序或者在30个包的窗口内乱序, 序号回绕。
+// 按序时恢复的包数与逐个FEC反复检查的结果相同; 所有包都收到或恢复的帧恰好回调一次,
+// 时间戳/帧类型/codec/码流与发送的一致, 其余的帧不回调
+static void RunRandomLoss(int loss_percent, int reorder) {
+    Random random(0x4603 + loss_percent);
+    MediaStream stream;
+    GenerateStream(&random, 0xF000, 300, 1, 20, 1100, &stream);
+    std::vector<SentFec> fecs;
+    std::vector<SendEvent> events;
+    ProtectStream(stream, 10, 5, &fecs, &events);
+
+    std::vector<bool> available(stream.packets.size(), false);
+    std::vector<bool> fec_received(fecs.size(), false);
+    std::vector<std::pair<size_t, size_t>> order;
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (random.Rand(0, 99) < loss_percent)
+            continue;
+        if (events[i].fec < 0)
+            available[events[i].index] = true;
+        else
+            fec_received[events[i].fec] = true;
+        order.push_back(std::make_pair(i + random.Rand(0, reorder), i));
+    }
+    std::sort(order.begin(), order.end());
+    const size_t num_expected_recovered = PeelRecovery(fecs, fec_received, &available);
+
+    SimulatedClock clock(0);
+    RecordingFrameCallback callback;
+    FlexfecReceiver receiver(PacketBuffer::Create(&clock, 64, 4096, &callback));
+    for (const std::pair<size_t, size_t>& entry : order) {
+        const SendEvent& event = events[entry.second];
+        if (event.fec < 0)
+            SendMedia(&receiver, stream, event.index);
+        else
+            assert(SendFec(&receiver, fecs[event.fec]));
+    }
+    // 乱序晚到的包可能先被恢复出来, 恢复的包数不会更少
+    if (reorder == 0)
+        assert(receiver.num_recovered_packets() == num_expected_recovered);
+    else
+        assert(receiver.num_recovered_packets() >= num_expected_recovered);
+
+    std::vector<int> num_received = CheckFrames(stream, &callback);
+    size_t num_complete = 0;
+    for (size_t f = 0; f < num_received.size(); ++f) {
+        bool complete = true;
+        for (size_t i = stream.frame_begin[f]; i < stream.frame_begin[f + 1]; ++i)
+            complete = complete && available[i];
+        num_complete += complete;
+        assert(num_received[f] == (complete ? 1 : 0));
+    }
+    cout << "reorder=" << reorder << " loss=" << loss_percent << "% packets=" << stream.packets.size()
+        << " fec=" << fecs.size() << " recovered=" << receiver.num_recovered_packets()
+        << "(expected " << num_expected_recovered << ")"
+        << " frames=" << num_received.size() << " complete=" << num_complete << endl;
+}
+
+// RandomLoss
+// 2%~20%丢包, 按序和乱序各一次
+void TestForwardErrorCorrection04() {
+    const int kLossPercents[4] = {2, 5, 10, 20};
+    for (int loss_percent : kLossPercents) {
+        RunRandomLoss(loss_percent, 0);
+        RunRandomLoss(loss_percent, 30);
+    }
+    cout << "TestForwardErrorCorrection04 passed" << endl;
+}
+
+class DiscardingFrameCallback : public OnReceivedFrameCallback {
+public:
+    DiscardingFrameCallback() : _num_frames(0) {}
+    void OnReceivedFrame(std::unique_ptr<RtpFrameObject>) override { ++_num_frames; }
+
+    size_t _num_frames;
+};
+
+// 以|packets_per_second|的包速率、每帧|packets_per_frame|个1200字节的包发送10x10的2-D FEC
+// (20%冗余), 5%随机丢包。只统计接收端调用的耗时(PacketBuffer插入和组帧, 有FEC时加上
+// 记录负载和恢复), 折算成实际包速率下占用的CPU
+static void RunBenchmark(const char* name, int packets_per_second, int packets_per_frame,
+        bool use_fec) {
+    const size_t kNumBlocks = 2000;
+    const uint8_t L = 10;
+    const uint8_t D = 10;
+    const size_t kPayloadSize = 1200;
+    const size_t kBlockSize = static_cast<size_t>(L) * D;
+
+    Random random(0x4604);
+    std::vector<uint8_t> pool(kPayloadSize * 64);
+    for (uint8_t& byte : pool)
+        byte = random.Rand<uint8_t>();
+
+    PayloadSlabAllocator allocator;
+    SimulatedClock clock(0);
+    DiscardingFrameCallback callback;
+    std::shared_ptr<PacketBuffer> packet_buffer = PacketBuffer::Create(&clock, 512, 4096, &callback);
+    FlexfecReceiver receiver(packet_buffer);
+
+    MediaStream block;
+    block.packets.resize(kBlockSize);
+    block.payloads.resize(kBlockSize, std::vector<uint8_t>(kPayloadSize));
+    int64_t elapsed_ns = 0;
+    size_t seq_num = 0;
+    for (size_t b = 0; b < kNumBlocks; ++b) {
+        // 生成一块媒体包和FEC包, 不计时
+        for (size_t i = 0; i < kBlockSize; ++i, ++seq_num) {
+            VCMPacket& packet = block.packets[i];
+            packet = VCMPacket();
+            packet.payload_type = 96;
+            packet.codec = kVideoCodecH264;
+            packet.timestamp = static_cast<uint32_t>(seq_num / packets_per_frame * 3000);
+            packet.seq_num = static_cast<uint16_t>(seq_num);
+            packet.frame_type = kVideoFrameDelta;
+            packet.is_first_packet_in_frame = seq_num % packets_per_frame == 0;
+            packet.marker_bit = seq_num % packets_per_frame == static_cast<size_t>(packets_per_frame - 1);
+            memcpy(block.payloads[i].data(), pool.data() + random.Rand(0, 63) * kPayloadSize / 2,
+                    kPayloadSize);
+            packet.data_ptr = block.payloads[i].data();
+            packet.size_bytes = kPayloadSize;
+        }
+        std::vector<SentFec> fecs;
+        std::vector<SendEvent> events;
+        if (use_fec) {
+            ProtectStream(block, L, D, &fecs, &events);
+        } else {
+            for (size_t i = 0; i < kBlockSize; ++i)
+                events.push_back(SendEvent{i, -1});
+        }
+        std::vector<VCMPacket> media;
+        std::vector<std::pair<PayloadBuffer, size_t>> fec_buffers;
+        std::vector<int> kinds;
+        for (const SendEvent& event : events) {
+            if (random.Rand(0, 99) < 5)
+                continue;
+            PayloadBuffer buffer = allocator.Allocate();
+            if (event.fec < 0) {
+                media.push_back(block.packets[event.index]);
+                memcpy(buffer.data(), block.payloads[event.index].data(), kPayloadSize);
+                media.back().data_ptr = buffer.data();
+                media.back().payload_buffer = std::move(buffer);
+                kinds.push_back(-1);
+            } else {
+                const std::vector<uint8_t>& packet = fecs[event.fec].packet;
+                memcpy(buffer.data(), packet.data(), packet.size());
+                fec_buffers.push_back(std::make_pair(std::move(buffer), packet.size()));
+                kinds.push_back(static_cast<int>(fec_buffers.size() - 1));
+            }
+        }
+
+        size_t next_media = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int kind : kinds) {
+            if (kind < 0) {
+                VCMPacket& packet = media[next_media++];
+                if (use_fec)
+                    receiver.OnMediaPacket(&packet);
+                else
+                    packet_buffer->InsertPacket(&packet);
+            } else {
+                const std::pair<PayloadBuffer, size_t>& fec = fec_buffers[kind];
+                receiver.OnFecPacket(fec.first, fec.first.data(), fec.second);
+            }
+        }
+        elapsed_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - begin).count();
+        if (seq_num > 1000)
+            packet_buffer->ClearTo(static_cast<uint16_t>(seq_num - 1000));
+    }
+
+    const double ns_per_packet = static_cast<double>(elapsed_ns) / (kNumBlocks * kBlockSize);
+    cout << name << (use_fec ? " fec   " : " no fec") << ": " << packets_per_second << " pkt/s, "
+        << ns_per_packet << " ns/media packet, "
+        << ns_per_packet * packets_per_second / 1e7 << "% of a core, "
+        << "recovered=" << receiver.num_recovered_packets()
+        << " frames=" << callback._num_frames << endl;
+}
+
+// Benchmark
+// XOR内核吞吐; 1080p30(8Mbps)/4K30(35Mbps)/4K60(60Mbps)的包速率下接收端的耗时,
+// 与不带FEC只插入PacketBuffer比较
+void TestForwardErrorCorrection05() {
+    std::vector<uint8_t> dst(1200, 1);
+    std::vector<uint8_t> src(1200, 2);
+    const int kIterations = 2000000;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        XorPayload(dst.data(), src.data(), dst.size());
+        // 不让编译器把循环合并掉
+        asm volatile("" : : "r"(dst.data()) : "memory");
+    }
+    const int64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+    cout << "XorPayload(" << XorKernelName() << ") 1200 bytes: "
+        << static_cast<double>(elapsed_ns) / kIterations << " ns, "
+        << static_cast<double>(kIterations) * dst.size() / elapsed_ns << " GB/s" << endl;
+
+    struct Resolution {
+        const char* name;
+        int packets_per_second;
+        int packets_per_frame;
+    };
+    const Resolution kResolutions[3] = {
+        {"1080p30", 833, 28},
+        {"4K30   ", 3646, 122},
+        {"4K60   ", 6250, 104},
+    };
+    for (const Resolution& resolution : kResolutions) {
+        RunBenchmark(resolution.name, resolution.packets_per_second,
+                resolution.packets_per_frame, false);
+        RunBenchmark(resolution.name, resolution.packets_per_second,
+                resolution.packets_per_frame, true);
+    }
+}
+
+int main() {
+    TestForwardErrorCorrection01();
+    TestForwardErrorCorrection02();
+    TestForwardErrorCorrection03();
+    TestForwardErrorCorrection04();
+    TestForwardErrorCorrection05();
+
+    return 0;
+}
+
@@ -0,0 +1,299 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file frame_buffer.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "frame_buffer.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace webrtc {
+
+namespace video_coding {
+
+namespace {
+
+constexpr int64_t kRtpTimestampsPerMs = 90;
+// 传输时间均值的平滑系数
+constexpr double kTransitAlpha = 1.0 / 32;
+
+} // namespace
+
+constexpr int64_t FrameBuffer::kMaxFramesBuffered;
+constexpr size_t FrameBuffer::kMaxFrameDependents;
+
+FrameBuffer::FrameInfo::FrameInfo()
+    : picture_id(-1),
+    timestamp(0),
+    num_missing_continuous(0),
+    num_missing_decodable(0),
+    continuous(false),
+    num_dependents(0) {}
+
+FrameBuffer::FrameBuffer(Clock* clock)
+    : _clock(clock),
+    _frames(kMaxFramesBuffered),
+    _decodable(kMaxFramesBuffered / 64, 0),
+    _decoded(kMaxFramesBuffered / 64, 0),
+    _has_keyframe(false),
+    _last_decoded_picture_id(-1),
+    _last_continuous_picture_id(-1),
+    _num_frames(0),
+    _has_transit(false),
+    _transit_mean_ms(0),
+    _has_last_frame(false),
+    _last_frame_timestamp(0),
+    _last_frame_received_ms(0) {
+    static_assert((kMaxFramesBuffered & (kMaxFramesBuffered - 1)) == 0,
+            "kMaxFramesBuffered must be a power of 2.");
+    assert(clock);
+    _continuity_stack.reserve(kMaxFramesBuffered);
+}
+
+FrameBuffer::~FrameBuffer() {}
+
+int64_t FrameBuffer::InsertFrame(std::unique_ptr<RtpFrameObject> frame) {
+    assert(frame);
+    const int64_t picture_id = frame->picture_id();
+    const bool is_keyframe = frame->num_references() == 0;
+    if (picture_id < 0)
+        return _last_continuous_picture_id;
+
+    if (!_has_keyframe) {
+        // RTC_LOG(LS_WARNING) << "Waiting for a keyframe, dropping frame " << picture_id;
+        if (!is_keyframe)
+            return _last_continuous_picture_id;
+        _has_keyframe = true;
+        _last_decoded_picture_id = picture_id - 1;
+    }
+    if (picture_id <= _last_decoded_picture_id)
+        return _last_continuous_picture_id;
+    if (picture_id - _last_decoded_picture_id > kMaxFramesBuffered) {
+        // RTC_LOG(LS_WARNING) << "Frame buffer full, dropping frame " << picture_id;
+        if (!is_keyframe)
+            return _last_continuous_picture_id;
+        Clear();
+        _has_keyframe = true;
+        _last_decoded_picture_id = picture_id - 1;
+    }
+
+    FrameInfo& info = Slot(picture_id);
+    if (info.picture_id == picture_id && info.frame)
+        return _last_continuous_picture_id;
+
+    // 先检查所有参考帧, 不合法的帧不改变任何状态
+    size_t num_missing_continuous = 0;
+    size_t num_missing_decodable = 0;
+    const int64_t* references = frame->references();
+    for (size_t i = 0; i < frame->num_references(); ++i) {
+        const int64_t reference = references[i];
+        if (reference >= picture_id || picture_id - reference >= kMaxFramesBuffered)
+            return _last_continuous_picture_id;
+        if (reference <= _last_decoded_picture_id) {
+            // 参考帧被跳过了, 或者太老不知道有没有解码
+            if (_last_decoded_picture_id - reference >= kMaxFramesBuffered ||
+                    !TestBit(_decoded, reference)) {
+                return _last_continuous_picture_id;
+            }
+            continue;
+        }
+        const FrameInfo& ref = Slot(reference);
+        if (ref.picture_id == reference && ref.num_dependents >= kMaxFrameDependents)
+            return _last_continuous_picture_id;
+        ++num_missing_decodable;
+        if (ref.picture_id != reference || !ref.continuous)
+            ++num_missing_continuous;
+    }
+
+    for (size_t i = 0; i < frame->num_references(); ++i) {
+        const int64_t reference = references[i];
+        if (reference <= _last_decoded_picture_id)
+            continue;
+        FrameInfo& ref = Slot(reference);
+        if (ref.picture_id != reference) {
+            // 窗口内的picture id不会共用槽位, 不是它就是空的
+            assert(ref.picture_id == -1);
+            ResetSlot(&ref);
+            ref.picture_id = reference;
+        }
+        ref.dependents[ref.num_dependents++] = picture_id;
+    }
+
+    if (info.picture_id != picture_id) {
+        assert(info.picture_id == -1);
+        ResetSlot(&info);
+        info.picture_id = picture_id;
+    }
+    info.timestamp = _timestamp_unwrapper.Unwrap(frame->timestamp());
+    UpdateJitter(info.timestamp, frame->received_time_ms(), frame->size());
+    info.frame = std::move(frame);
+    info.num_missing_continuous = num_missing_continuous;
+    info.num_missing_decodable = num_missing_decodable;
+    ++_num_frames;
+
+    if (num_missing_decodable == 0)
+        SetBit(&_decodable, picture_id, true);
+    if (num_missing_continuous == 0)
+        PropagateContinuity(picture_id);
+    return _last_continuous_picture_id;
+}
+
+std::unique_ptr<RtpFrameObject> FrameBuffer::NextFrame(int64_t* wait_ms) {
+    int64_t picture_id = 0;
+    if (!FindNextDecodable(&picture_id)) {
+        *wait_ms = -1;
+        return nullptr;
+    }
+    FrameInfo& info = Slot(picture_id);
+    const int64_t now_ms = _clock->TimeInMilliseconds();
+    const int64_t release_time_ms = ReleaseTimeMs(info.timestamp);
+    if (release_time_ms > now_ms) {
+        *wait_ms = release_time_ms - now_ms;
+        return nullptr;
+    }
+
+    DropFramesBefore(picture_id);
+    std::unique_ptr<RtpFrameObject> frame = std::move(info.frame);
+    SetBit(&_decodable, picture_id, false);
+    SetBit(&_decoded, picture_id, true);
+    for (size_t i = 0; i < info.num_dependents; ++i) {
+        FrameInfo& dependent = Slot(info.dependents[i]);
+        if (dependent.picture_id == info.dependents[i] && --dependent.num_missing_decodable == 0)
+            SetBit(&_decodable, dependent.picture_id, true);
+    }
+    ResetSlot(&info);
+    --_num_frames;
+    _last_decoded_picture_id = picture_id;
+    *wait_ms = 0;
+    return frame;
+}
+
+void FrameBuffer::Clear() {
+    for (FrameInfo& info : _frames)
+        ResetSlot(&info);
+    std::fill(_decodable.begin(), _decodable.end(), 0);
+    std::fill(_decoded.begin(), _decoded.end(), 0);
+    _has_keyframe = false;
+    _last_decoded_picture_id = -1;
+    _last_continuous_picture_id = -1;
+    _num_frames = 0;
+    _has_transit = false;
+    _has_last_frame = false;
+    _jitter_estimator.Reset();
+}
+
+int64_t FrameBuffer::jitter_delay_ms() const {
+    return _jitter_estimator.GetJitterEstimate();
+}
+
+void FrameBuffer::ResetSlot(FrameInfo* info) {
+    info->picture_id = -1;
+    info->frame.reset();
+    info->num_missing_continuous = 0;
+    info->num_missing_decodable = 0;
+    info->continuous = false;
+    info->num_dependents = 0;
+}
+
+bool FrameBuffer::FindNextDecodable(int64_t* picture_id) const {
+    // 从_last_decoded_picture_id + 1开始按字扫描一圈, 最后一个字多扫的位是第一个字
+    // 跳过的位, 对应的picture id同样在窗口内
+    const int64_t begin = _last_decoded_picture_id + 1;
+    int64_t scanned = 0;
+    while (scanned < kMaxFramesBuffered) {
+        const size_t index = static_cast<size_t>((begin + scanned) & (kMaxFramesBuffered - 1));
+        const size_t shift = index & 63;
+        const uint64_t bits = _decodable[index >> 6] >> shift;
+        if (bits) {
+            *picture_id = begin + scanned + __builtin_ctzll(bits);
+            return true;
+        }
+        scanned += static_cast<int64_t>(64 - shift);
+    }
+    return false;
+}
+
+void FrameBuffer::DropFramesBefore(int64_t picture_id) {
+    for (int64_t id = _last_decoded_picture_id + 1; id < picture_id; ++id) {
+        FrameInfo& info = Slot(id);
+        if (info.picture_id == id) {
+            // RTC_LOG(LS_INFO) << "Skipping frame " << id;
+            if (info.frame)
+                --_num_frames;
+            ResetSlot(&info);
+        }
+        SetBit(&_decoded, id, false);
+    }
+}
+
+void FrameBuffer::PropagateContinuity(int64_t picture_id) {
+    _continuity_stack.push_back(picture_id);
+    while (!_continuity_stack.empty()) {
+        FrameInfo& info = Slot(_continuity_stack.back());
+        _continuity_stack.pop_back();
+        info.continuous = true;
+        _last_continuous_picture_id = std::max(_last_continuous_picture_id, info.picture_id);
+        for (size_t i = 0; i < info.num_dependents; ++i) {
+            FrameInfo& dependent = Slot(info.dependents[i]);
+            if (dependent.picture_id == info.dependents[i] &&
+                    --dependent.num_missing_continuous == 0) {
+                _continuity_stack.push_back(dependent.picture_id);
+            }
+        }
+    }
+}
+
+void FrameBuffer::UpdateJitter(int64_t timestamp, int64_t received_time_ms, size_t frame_size) {
+    const double transit_ms = static_cast<double>(received_time_ms) -
+        static_cast<double>(timestamp) / kRtpTimestampsPerMs;
+    if (!_has_transit) {
+        _transit_mean_ms = transit_ms;
+        _has_transit = true;
+    } else {
+        _transit_mean_ms += kTransitAlpha * (transit_ms - _transit_mean_ms);
+    }
+
+    // 乱序到达的帧不计算帧间延时
+    if (_has_last_frame && timestamp <= _last_frame_timestamp)
+        return;
+    // 第一帧只用来初始化帧大小
+    int64_t frame_delay_ms = 0;
+    if (_has_last_frame) {
+        frame_delay_ms = (received_time_ms - _last_frame_received_ms) -
+            (timestamp - _last_frame_timestamp + kRtpTimestampsPerMs / 2) / kRtpTimestampsPerMs;
+    }
+    _jitter_estimator.UpdateEstimate(frame_delay_ms, static_cast<uint32_t>(frame_size));
+    _has_last_frame = true;
+    _last_frame_timestamp = timestamp;
+    _last_frame_received_ms = received_time_ms;
+}
+
+int64_t FrameBuffer::ReleaseTimeMs(int64_t timestamp) const {
+    return static_cast<int64_t>(static_cast<double>(timestamp) / kRtpTimestampsPerMs +
+            _transit_mean_ms + 0.5) + jitter_delay_ms();
+}
+
+bool FrameBuffer::TestBit(const std::vector<uint64_t>& bits, int64_t picture_id) {
+    const size_t index = static_cast<size_t>(picture_id & (kMaxFramesBuffered - 1));
+    return (bits[index >> 6] >> (index & 63)) & 1;
+}
+
+void FrameBuffer::SetBit(std::vector<uint64_t>* bits, int64_t picture_id, bool value) {
+    const size_t index = static_cast<size_t>(picture_id & (kMaxFramesBuffered - 1));
+    const uint64_t bit = uint64_t{1} << (index & 63);
+    if (value)
+        (*bits)[index >> 6] |= bit;
+    else
+        (*bits)[index >> 6] &= ~bit;
+}
+
+} // namespace video_coding
+
+} // namespace webrtc
+
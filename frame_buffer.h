@@ -0,0 +1,126 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file frame_buffer.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _FRAME_BUFFER_H
+#define _FRAME_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "clock.h"
+#include "frame_object.h"
+#include "jitter_estimator.h"
+#include "module_common_types_public.h"
+
+namespace webrtc {
+
+namespace video_coding {
+
+// PacketBuffer之后的帧缓冲: 按RtpFrameObject的picture id和参考帧判断连续和可解码,
+// 可解码的帧到了释放时间就交给解码器。
+//
+// 帧放在kMaxFramesBuffered个槽位的环上, 下标是picture_id & (size - 1), 只接受比最后
+// 解码的帧新、且不超过一圈的帧。每帧记着还有几个参考帧不连续/没有解码, 以及参考
+// 它的帧, 帧变为连续或者解码时只更新参考它的帧。可解码的帧在一个位图中置位,
+// 找下一个可解码的帧按字扫描位图, 不重新遍历所有帧。
+//
+// 释放时间 = 捕获时间戳换算到本地时钟 + 抖动延时: 到达时间和时间戳之差的滑动平均作为
+// 传输时间的基准, 抖动延时由JitterEstimator按帧大小和帧间延时估计。
+//
+// Note: This class is not thread-safe.
+class FrameBuffer {
+public:
+    // 环上的槽位数, 2的幂
+    static constexpr int64_t kMaxFramesBuffered = 512;
+    // 一帧最多被这么多还没解码的帧参考, 超过时丢弃新来的帧
+    static constexpr size_t kMaxFrameDependents = 16;
+
+    explicit FrameBuffer(Clock* clock);
+    ~FrameBuffer();
+
+    // 返回最新的连续帧的picture id, 还没有连续帧返回-1。收到第一个关键帧之前的帧、
+    // 比最后解码的帧旧的帧、参考帧已经被跳过的帧都被丢弃; 放不下时关键帧清空缓冲区
+    // 重新开始, 其它帧丢弃。
+    int64_t InsertFrame(std::unique_ptr<RtpFrameObject> frame);
+
+    // picture id最小的可解码帧到了释放时间就返回它, 跳过它之前的帧, |wait_ms|为0;
+    // 否则返回nullptr, |wait_ms|是还要等待的时间, 没有可解码的帧时为-1。
+    std::unique_ptr<RtpFrameObject> NextFrame(int64_t* wait_ms);
+
+    void Clear();
+
+    int64_t jitter_delay_ms() const;
+    int64_t last_continuous_picture_id() const { return _last_continuous_picture_id; }
+    int64_t last_decoded_picture_id() const { return _last_decoded_picture_id; }
+    size_t num_frames() const { return _num_frames; }
+
+private:
+    struct FrameInfo {
+        FrameInfo();
+
+        // -1表示空槽位; 有picture id没有frame是还没收到、但被参考的帧
+        int64_t picture_id;
+        std::unique_ptr<RtpFrameObject> frame;
+        // unwrap后的RTP时间戳
+        int64_t timestamp;
+        size_t num_missing_continuous;
+        size_t num_missing_decodable;
+        bool continuous;
+        size_t num_dependents;
+        int64_t dependents[kMaxFrameDependents];
+    };
+
+    FrameInfo& Slot(int64_t picture_id) {
+        return _frames[static_cast<size_t>(picture_id & (kMaxFramesBuffered - 1))];
+    }
+    void ResetSlot(FrameInfo* info);
+    // 第一个picture id大于_last_decoded_picture_id的可解码帧
+    bool FindNextDecodable(int64_t* picture_id) const;
+    // |picture_id|之前的帧不再解码
+    void DropFramesBefore(int64_t picture_id);
+    void PropagateContinuity(int64_t picture_id);
+    void UpdateJitter(int64_t timestamp, int64_t received_time_ms, size_t frame_size);
+    int64_t ReleaseTimeMs(int64_t timestamp) const;
+
+    static bool TestBit(const std::vector<uint64_t>& bits, int64_t picture_id);
+    static void SetBit(std::vector<uint64_t>* bits, int64_t picture_id, bool value);
+
+    Clock* const _clock;
+    std::vector<FrameInfo> _frames;
+    // 可解码: 收到了且参考帧都已解码
+    std::vector<uint64_t> _decodable;
+    // 最近kMaxFramesBuffered个picture id是否解码了(跳过的为0)
+    std::vector<uint64_t> _decoded;
+    bool _has_keyframe;
+    int64_t _last_decoded_picture_id;
+    int64_t _last_continuous_picture_id;
+    size_t _num_frames;
+    std::vector<int64_t> _continuity_stack;
+
+    TimestampUnwrapper _timestamp_unwrapper;
+    bool _has_transit;
+    // 到达时间 - 时间戳(ms)的滑动平均
+    double _transit_mean_ms;
+    // 上一个时间戳最新的帧, 用来计算帧间延时
+    bool _has_last_frame;
+    int64_t _last_frame_timestamp;
+    int64_t _last_frame_received_ms;
+    JitterEstimator _jitter_estimator;
+};
+
+} // namespace video_coding
+
+} // namespace webrtc
+
+#endif // _FRAME_BUFFER_H
+
@@ -0,0 +1,342 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file frame_buffer_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ frame_buffer_unittest.cpp frame_buffer.cpp jitter_estimator.cpp packet_buffer.cpp frame_object.cpp payload_buffer.cpp random.cpp -std=c++11 -O2
+
+#include <math.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+using namespace std;
+
+#include "clock.h"
+#include "frame_buffer.h"
+#include "frame_object.h"
+#include "packet_buffer.h"
+#include "random.h"
+
+using namespace webrtc;
+using namespace video_coding;
+
+// 每帧一个包插入PacketBuffer, 组成的RtpFrameObject填上picture id和参考帧
+class FrameFactory : public OnReceivedFrameCallback {
+public:
+    explicit FrameFactory(Clock* clock)
+        : _packet_buffer(PacketBuffer::Create(clock, 512, 4096, this)),
+        _seq_num(0) {}
+
+    void OnReceivedFrame(std::unique_ptr<RtpFrameObject> frame) override {
+        _frame = std::move(frame);
+    }
+
+    std::unique_ptr<RtpFrameObject> MakeFrame(int64_t picture_id, uint32_t timestamp,
+            const std::vector<int64_t>& references, size_t size = 0) {
+        VCMPacket packet;
+        if (size) {
+            packet.data_ptr = new uint8_t[size]();
+            packet.size_bytes = size;
+        }
+        packet.timestamp = timestamp;
+        packet.seq_num = _seq_num++;
+        packet.frame_type = references.empty() ? kVideoFrameKey : kVideoFrameDelta;
+        packet.is_first_packet_in_frame = true;
+        packet.marker_bit = true;
+        _packet_buffer->InsertPacket(&packet);
+        assert(_frame);
+        _frame->SetReferences(picture_id, references.data(), references.size());
+        return std::move(_frame);
+    }
+
+private:
+    std::shared_ptr<PacketBuffer> _packet_buffer;
+    uint16_t _seq_num;
+    std::unique_ptr<RtpFrameObject> _frame;
+};
+
+static int64_t NextPictureId(FrameBuffer* buffer) {
+    int64_t wait_ms = 0;
+    std::unique_ptr<RtpFrameObject> frame = buffer->NextFrame(&wait_ms);
+    return frame ? frame->picture_id() : -1;
+}
+
+// Basic
+// 关键帧之前的帧丢弃; 缺参考帧时不连续也不能解码, 参考帧到了之后连续性向后传递;
+// 跳过不能解码的帧直接解码后面的关键帧, 参考被跳过的帧的帧丢弃; 重复和过旧的帧丢弃
+void TestFrameBuffer01() {
+    SimulatedClock clock(0);
+    FrameFactory factory(&clock);
+    FrameBuffer buffer(&clock);
+
+    assert(buffer.InsertFrame(factory.MakeFrame(9, 0, {8})) == -1);
+    assert(buffer.num_frames() == 0);
+    assert(buffer.InsertFrame(factory.MakeFrame(10, 0, {})) == 10);
+    assert(buffer.InsertFrame(factory.MakeFrame(10, 0, {})) == 10);
+    assert(buffer.num_frames() == 1);
+    // 12参考11、13参考10和12
+    assert(buffer.InsertFrame(factory.MakeFrame(12, 6000, {11})) == 10);
+    assert(buffer.InsertFrame(factory.MakeFrame(13, 9000, {10, 12})) == 10);
+    clock.AdvanceTimeMilliseconds(100);
+    assert(NextPictureId(&buffer) == 10);
+    int64_t wait_ms = 0;
+    assert(!buffer.NextFrame(&wait_ms) && wait_ms == -1);
+    assert(buffer.InsertFrame(factory.MakeFrame(11, 3000, {10})) == 13);
+    clock.AdvanceTimeMilliseconds(1000);
+    assert(NextPictureId(&buffer) == 11);
+    assert(NextPictureId(&buffer) == 12);
+    assert(NextPictureId(&buffer) == 13);
+    assert(buffer.last_decoded_picture_id() == 13);
+    assert(buffer.InsertFrame(factory.MakeFrame(13, 9000, {12})) == 13);
+    assert(buffer.num_frames() == 0);
+
+    // 14丢了, 15不能解码, 16是关键帧; 解码16时跳过15, 之后参考15的17丢弃
+    assert(buffer.InsertFrame(factory.MakeFrame(15, 15000, {14})) == 13);
+    assert(buffer.InsertFrame(factory.MakeFrame(16, 18000, {})) == 16);
+    assert(NextPictureId(&buffer) == 16);
+    assert(buffer.num_frames() == 0);
+    assert(buffer.InsertFrame(factory.MakeFrame(17, 21000, {15})) == 16);
+    assert(buffer.InsertFrame(factory.MakeFrame(18, 24000, {16})) == 18);
+    assert(buffer.num_frames() == 1);
+    assert(NextPictureId(&buffer) == 18);
+
+    // 超出一圈的帧: 非关键帧丢弃, 关键帧清空重新开始
+    const int64_t far = 18 + FrameBuffer::kMaxFramesBuffered + 1;
+    assert(buffer.InsertFrame(factory.MakeFrame(far, 30000, {far - 1})) == 18);
+    assert(buffer.InsertFrame(factory.MakeFrame(19, 27000, {18})) == 19);
+    assert(buffer.InsertFrame(factory.MakeFrame(far, 30000, {})) == far);
+    assert(buffer.num_frames() == 1);
+    // 重新开始后抖动延时也重新估计, 不为0
+    assert(NextPictureId(&buffer) == -1);
+    clock.AdvanceTimeMilliseconds(buffer.jitter_delay_ms());
+    assert(NextPictureId(&buffer) == far);
+    cout << "TestFrameBuffer01 passed" << endl;
+}
+
+// 模拟的一帧
+struct SimFrame {
+    int64_t picture_id;
+    uint32_t timestamp;
+    std::vector<int64_t> references;
+    size_t size;
+    int64_t capture_ms;
+    int64_t arrival_ms;
+    bool lost;
+    bool decodable;
+    int64_t release_ms;
+};
+
+static double Percentile(std::vector<int64_t> values, double percentile) {
+    std::sort(values.begin(), values.end());
+    return static_cast<double>(values[static_cast<size_t>(percentile * (values.size() - 1))]);
+}
+
+static double StdDev(const std::vector<int64_t>& values) {
+    double mean = 0;
+    for (int64_t value : values)
+        mean += value;
+    mean /= values.size();
+    double var = 0;
+    for (int64_t value : values)
+        var += (value - mean) * (value - mean);
+    return sqrt(var / values.size());
+}
+
+// 30fps的L1T2流(偶数帧参考上一个偶数帧, 奇数帧参考上一个偶数帧且不被参考), 每150帧
+// 一个关键帧(大小是普通帧的10倍), 1%丢帧。帧在2Mbps的链路上依次发送, 关键帧之后的
+// 帧要排队; 发送完之后的延时 = 40ms + |N(0, jitter_ms)| + 1%的帧额外100ms, 帧之间会乱序。每1ms把到达的帧插入FrameBuffer
+// 并取出所有到了释放时间的帧。
+// 解码顺序递增, 解码时参考帧都已经解码, 解码的帧都是收到且参考链完整的帧, 其中大部分
+// 都被解码; 相邻帧释放间隔的抖动小于到达间隔的抖动。统计到达和释放的端到端延时。
+static void RunJitterSimulation(double jitter_ms) {
+    const int kNumFrames = 9000;
+    const int64_t kFrameIntervalMs = 33;
+    const int64_t kBaseDelayMs = 40;
+    const double kBitsPerMs = 2000;
+
+    Random random(0x4701 + static_cast<uint32_t>(jitter_ms));
+    std::vector<SimFrame> frames(kNumFrames);
+    int64_t last_t0 = -1;
+    double send_done_ms = 0;
+    for (int i = 0; i < kNumFrames; ++i) {
+        SimFrame& frame = frames[i];
+        frame.picture_id = i;
+        frame.capture_ms = i * kFrameIntervalMs;
+        frame.timestamp = static_cast<uint32_t>(0xFFF00000u + frame.capture_ms * 90);
+        const bool keyframe = i % 150 == 0;
+        if (!keyframe)
+            frame.references.push_back(last_t0);
+        if (keyframe || i % 2 == 0)
+            last_t0 = i;
+        frame.size = (keyframe ? 10 : 1) * 2500;
+        const double frame_bits = frame.size * 8.0;
+        send_done_ms = std::max(send_done_ms, static_cast<double>(frame.capture_ms)) +
+            frame_bits / kBitsPerMs;
+        double delay_ms = kBaseDelayMs + fabs(random.Gaussian(0, jitter_ms));
+        if (random.Rand(0, 99) == 0)
+            delay_ms += 100;
+        frame.arrival_ms = static_cast<int64_t>(send_done_ms + delay_ms);
+        frame.lost = random.Rand(0, 99) == 0;
+        frame.decodable = !frame.lost;
+        for (int64_t reference : frame.references)
+            frame.decodable = frame.decodable && frames[reference].decodable;
+        frame.release_ms = -1;
+    }
+
+    std::vector<size_t> order;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (!frames[i].lost)
+            order.push_back(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&frames](size_t a, size_t b) {
+        return frames[a].arrival_ms < frames[b].arrival_ms;
+    });
+
+    SimulatedClock clock(0);
+    FrameFactory factory(&clock);
+    FrameBuffer buffer(&clock);
+    size_t next = 0;
+    int64_t last_released = -1;
+    const int64_t end_ms = frames.back().arrival_ms + 1000;
+    for (int64_t now_ms = 0; now_ms < end_ms; ++now_ms) {
+        clock.AdvanceTimeMilliseconds(now_ms - clock.TimeInMilliseconds());
+        for (; next < order.size() && frames[order[next]].arrival_ms <= now_ms; ++next) {
+            const SimFrame& frame = frames[order[next]];
+            buffer.InsertFrame(factory.MakeFrame(frame.picture_id, frame.timestamp, frame.references,
+                        frame.size));
+        }
+        int64_t wait_ms = 0;
+        while (std::unique_ptr<RtpFrameObject> frame = buffer.NextFrame(&wait_ms)) {
+            SimFrame& released = frames[frame->picture_id()];
+            assert(released.picture_id > last_released);
+            assert(released.decodable);
+            for (int64_t reference : released.references)
+                assert(frames[reference].release_ms >= 0);
+            released.release_ms = now_ms;
+            last_released = released.picture_id;
+        }
+    }
+
+    std::vector<int64_t> network_ms;
+    std::vector<int64_t> end_to_end_ms;
+    // 相邻两个解码的帧到达/释放的间隔与捕获间隔之差
+    std::vector<int64_t> arrival_jitter_ms;
+    std::vector<int64_t> playout_jitter_ms;
+    size_t num_decodable = 0;
+    size_t num_skipped = 0;
+    const SimFrame* previous = nullptr;
+    for (const SimFrame& frame : frames) {
+        num_decodable += frame.decodable;
+        if (frame.release_ms < 0) {
+            num_skipped += frame.decodable;
+            continue;
+        }
+        network_ms.push_back(frame.arrival_ms - frame.capture_ms);
+        end_to_end_ms.push_back(frame.release_ms - frame.capture_ms);
+        if (previous) {
+            const int64_t capture_interval_ms = frame.capture_ms - previous->capture_ms;
+            arrival_jitter_ms.push_back(frame.arrival_ms - previous->arrival_ms - capture_interval_ms);
+            playout_jitter_ms.push_back(frame.release_ms - previous->release_ms - capture_interval_ms);
+        }
+        previous = &frame;
+    }
+    assert(end_to_end_ms.size() > num_decodable * 95 / 100);
+    assert(StdDev(playout_jitter_ms) < StdDev(arrival_jitter_ms));
+    cout << "jitter=" << jitter_ms << "ms decodable=" << num_decodable
+        << " released=" << end_to_end_ms.size() << " skipped=" << num_skipped
+        << " jitter_delay=" << buffer.jitter_delay_ms() << "ms" << endl;
+    cout << "    network delay p50/p95/p99=" << Percentile(network_ms, 0.5) << "/"
+        << Percentile(network_ms, 0.95) << "/" << Percentile(network_ms, 0.99)
+        << " interval std=" << StdDev(arrival_jitter_ms) << endl;
+    cout << "    end to end    p50/p95/p99=" << Percentile(end_to_end_ms, 0.5) << "/"
+        << Percentile(end_to_end_ms, 0.95) << "/" << Percentile(end_to_end_ms, 0.99)
+        << " interval std=" << StdDev(playout_jitter_ms) << endl;
+}
+
+// JitterSimulation
+// 抖动标准差5/15/30ms
+void TestFrameBuffer02() {
+    RunJitterSimulation(5);
+    RunJitterSimulation(15);
+    RunJitterSimulation(30);
+    cout << "TestFrameBuffer02 passed" << endl;
+}
+
+// Benchmark
+// 帧在8/64/256帧的窗口内乱序到达, 每帧InsertFrame() + 取出到了释放时间的帧的耗时
+void TestFrameBuffer03() {
+    const int kDepths[3] = {8, 64, 256};
+    for (int depth : kDepths) {
+        const int64_t kNumBatches = 400;
+        const int64_t kBatchSize = 256;
+        const int64_t kFrameIntervalMs = 33;
+        // 帧的到达时间取自|arrival_clock|, 提前按到达顺序生成好, 不计入耗时
+        SimulatedClock clock(0);
+        SimulatedClock arrival_clock(0);
+        FrameFactory factory(&arrival_clock);
+        FrameBuffer buffer(&clock);
+        Random random(0x4702);
+        int64_t elapsed_ns = 0;
+        size_t num_released = 0;
+        std::vector<std::unique_ptr<RtpFrameObject>> batch(kBatchSize);
+        std::vector<std::pair<int64_t, int64_t>> order(kBatchSize);
+        for (int64_t b = 0; b < kNumBatches; ++b) {
+            // 每批从关键帧开始, 第i帧在批开始后i帧间隔捕获, 到达顺序在|depth|帧的窗口内乱序
+            const int64_t start_ms = clock.TimeInMilliseconds();
+            // 第一个关键帧之前的帧会被丢弃, 让它最先到
+            for (int64_t i = 0; i < kBatchSize; ++i)
+                order[i] = std::make_pair(i == 0 ? -1 : i + random.Rand(0, depth - 1), i);
+            std::sort(order.begin(), order.end());
+            for (int64_t p = 0; p < kBatchSize; ++p) {
+                const int64_t i = order[p].second;
+                const int64_t picture_id = b * kBatchSize + i;
+                std::vector<int64_t> references;
+                if (i > 0)
+                    references.push_back(picture_id - 1);
+                arrival_clock.AdvanceTimeMilliseconds(kFrameIntervalMs);
+                batch[p] = factory.MakeFrame(picture_id,
+                        static_cast<uint32_t>((start_ms + i * kFrameIntervalMs) * 90), references);
+            }
+
+            auto begin = std::chrono::steady_clock::now();
+            for (int64_t p = 0; p < kBatchSize; ++p) {
+                clock.AdvanceTimeMilliseconds(kFrameIntervalMs);
+                buffer.InsertFrame(std::move(batch[p]));
+                int64_t wait_ms = 0;
+                while (buffer.NextFrame(&wait_ms))
+                    ++num_released;
+            }
+            elapsed_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - begin).count();
+            // 取完这一批再开始下一批
+            // 传输时间基准随乱序的到达时间波动, 等一批的时长
+            clock.AdvanceTimeMilliseconds(buffer.jitter_delay_ms() + kBatchSize * kFrameIntervalMs);
+            arrival_clock.AdvanceTimeMilliseconds(buffer.jitter_delay_ms() + kBatchSize * kFrameIntervalMs);
+            int64_t wait_ms = 0;
+            while (buffer.NextFrame(&wait_ms))
+                ++num_released;
+            assert(buffer.num_frames() == 0);
+        }
+        assert(num_released == static_cast<size_t>(kNumBatches * kBatchSize));
+        cout << "reorder depth=" << depth << ": "
+            << static_cast<double>(elapsed_ns) / (kNumBatches * kBatchSize)
+            << " ns/frame, jitter_delay=" << buffer.jitter_delay_ms() << "ms" << endl;
+    }
+}
+
+int main() {
+    TestFrameBuffer01();
+    TestFrameBuffer02();
+    TestFrameBuffer03();
+
+    return 0;
+}
+
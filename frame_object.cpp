@@ -0,0 +1,78 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file frame_object.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "frame_object.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "packet_buffer.h"
+
+namespace webrtc {
+
+namespace video_coding {
+
+constexpr size_t RtpFrameObject::kMaxFrameReferences;
+
+RtpFrameObject::RtpFrameObject(std::shared_ptr<PacketBuffer> packet_buffer,
+        uint16_t first_seq_num, uint16_t last_seq_num, size_t frame_size,
+        int times_nacked, int64_t received_time_ms)
+    : _packet_buffer(std::move(packet_buffer)),
+    _frame_type(kEmptyFrame),
+    _codec_type(kVideoCodecGeneric),
+    _first_seq_num(first_seq_num),
+    _last_seq_num(last_seq_num),
+    _timestamp(0),
+    _ntp_time_ms(0),
+    _received_time_ms(received_time_ms),
+    _times_nacked(times_nacked),
+    _size(frame_size),
+    _picture_id(-1),
+    _num_references(0) {
+    const VCMPacket* first_packet = _packet_buffer->GetPacket(first_seq_num);
+    assert(first_packet);
+    if (first_packet) {
+        _frame_type = first_packet->frame_type;
+        _codec_type = first_packet->codec;
+        _timestamp = first_packet->timestamp;
+        _ntp_time_ms = first_packet->ntp_time_ms;
+    }
+
+    bool all_packets_found = _packet_buffer->GetPayloadSegments(*this, &_segments);
+    assert(all_packets_found);
+    (void)all_packets_found;
+}
+
+RtpFrameObject::~RtpFrameObject() {
+    _packet_buffer->ReturnFrame(this);
+}
+
+void RtpFrameObject::SetReferences(int64_t picture_id, const int64_t* references,
+        size_t num_references) {
+    assert(num_references <= kMaxFrameReferences);
+    _picture_id = picture_id;
+    _num_references = std::min(num_references, kMaxFrameReferences);
+    std::copy(references, references + _num_references, _references);
+}
+
+void RtpFrameObject::CopyBitstream(uint8_t* destination) const {
+    for (const PayloadSegment& segment : _segments) {
+        memcpy(destination, segment.data, segment.size);
+        destination += segment.size;
+    }
+}
+
+} // namespace video_coding
+
+} // namespace webrtc
+
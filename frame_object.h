@@ -0,0 +1,94 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file frame_object.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _FRAME_OBJECT_H
+#define _FRAME_OBJECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "payload_buffer.h"
+#include "vcm_packet.h"
+
+namespace webrtc {
+
+namespace video_coding {
+
+class PacketBuffer;
+
+// 帧中一个包的负载, 指向收包时的缓冲区, 持有它的引用
+struct PayloadSegment {
+    PayloadBuffer buffer;
+    const uint8_t* data;
+    size_t size;
+};
+
+// PacketBuffer组好的一帧, 由序号[first_seq_num, last_seq_num]的包组成。
+// 码流不拼成连续的内存, 而是按包分段引用收包时的缓冲区(scatter-gather), 解码器
+// 可以直接按段读取, 或者用CopyBitstream()拷贝一次到自己的缓冲区。
+// 对象存在期间这些包仍然占用PacketBuffer的槽位(重复的包不会再组出同一帧), 析构时归还。
+class RtpFrameObject {
+public:
+    static constexpr size_t kMaxFrameReferences = 5;
+
+    RtpFrameObject(std::shared_ptr<PacketBuffer> packet_buffer, uint16_t first_seq_num,
+            uint16_t last_seq_num, size_t frame_size, int times_nacked,
+            int64_t received_time_ms);
+    ~RtpFrameObject();
+
+    uint16_t first_seq_num() const { return _first_seq_num; }
+    uint16_t last_seq_num() const { return _last_seq_num; }
+    // 帧中的包最多被NACK的次数, -1表示没有NACK信息
+    int times_nacked() const { return _times_nacked; }
+    FrameType frame_type() const { return _frame_type; }
+    VideoCodecType codec_type() const { return _codec_type; }
+    uint32_t timestamp() const { return _timestamp; }
+    int64_t ntp_time_ms() const { return _ntp_time_ms; }
+    int64_t received_time_ms() const { return _received_time_ms; }
+    size_t size() const { return _size; }
+    // 每个非空的包一段, 按序号排列
+    const std::vector<PayloadSegment>& segments() const { return _segments; }
+    // 拷贝成连续的码流, |destination|至少有size()字节
+    void CopyBitstream(uint8_t* destination) const;
+
+    // 解码依赖: unwrap后的picture id和它参考的帧, 由接收端按codec的负载描述填写,
+    // FrameBuffer据此判断帧是否可以解码。没有参考帧的是关键帧。
+    void SetReferences(int64_t picture_id, const int64_t* references, size_t num_references);
+    int64_t picture_id() const { return _picture_id; }
+    size_t num_references() const { return _num_references; }
+    const int64_t* references() const { return _references; }
+
+private:
+    std::shared_ptr<PacketBuffer> _packet_buffer;
+    FrameType _frame_type;
+    VideoCodecType _codec_type;
+    uint16_t _first_seq_num;
+    uint16_t _last_seq_num;
+    uint32_t _timestamp;
+    int64_t _ntp_time_ms;
+    int64_t _received_time_ms;
+    int _times_nacked;
+    size_t _size;
+    std::vector<PayloadSegment> _segments;
+    int64_t _picture_id;
+    size_t _num_references;
+    int64_t _references[kMaxFrameReferences];
+};
+
+} // namespace video_coding
+
+} // namespace webrtc
+
+#endif // _FRAME_OBJECT_H
+
+
@@ -19,6 +19,13 @@ namespace webrtc {
 static const int kBurstDeltaThresholdMs = 5;
 static const int kMaxBurstDurationMs = 100;
 
+// 逐包打印计算过程, 编译时加-DINTER_ARRIVAL_DEBUG打开
+#if defined(INTER_ARRIVAL_DEBUG)
+static constexpr bool kDebugLog = true;
+#else
+static constexpr bool kDebugLog = false;
+#endif
+
 InterArrival::InterArrival(uint32_t timestamp_group_length_ticks,
                            double timestamp_to_ms_coeff,
                            bool enable_burst_grouping)
@@ -89,8 +96,9 @@ bool InterArrival::BelongsToBurst(int64_t arrival_time_ms, uint32_t timestamp) c
             arrival_time_ms - _current_timestamp_group.first_arrival_ms <
             kMaxBurstDurationMs) 
     {
-        cout << "[收到突发数据] 延迟梯度=" << propagation_delta_ms << " 到达时间间隔=" << arrival_time_delta_ms 
-             << " 与当前包组首包到达时间差=" << arrival_time_ms - _current_timestamp_group.first_arrival_ms << endl;
+        if (kDebugLog)
+            cout << "[收到突发数据] 延迟梯度=" << propagation_delta_ms << " 到达时间间隔=" << arrival_time_delta_ms 
+                 << " 与当前包组首包到达时间差=" << arrival_time_ms - _current_timestamp_group.first_arrival_ms << endl;
         return true;
     }
 
@@ -118,18 +126,21 @@ bool InterArrival::ComputeDeltas(uint32_t timestamp,
     bool calculated_deltas = false;
     // 如果是包组的首个包,先存储,不计算
     if (_current_timestamp_group.IsFirstPacket()) {
-        cout << "*首个包组到来" << endl;
+        if (kDebugLog)
+            cout << "*首个包组到来" << endl;
         // We don't have enough data to update the filter, so we store it until we
         // have two frames of data to process.
         _current_timestamp_group.timestamp = timestamp;
         _current_timestamp_group.first_timestamp = timestamp;
         _current_timestamp_group.first_arrival_ms = arrival_time_ms;
     } else if (!PacketInOrder(timestamp)) { // 包发送是否有序?
-        cout << "[包发送时间乱序,返回false] timestamp=" << timestamp << " current_timestamp_group.first_timestamp="  
-             << _current_timestamp_group.first_timestamp << endl;
+        if (kDebugLog)
+            cout << "[包发送时间乱序,返回false] timestamp=" << timestamp << " current_timestamp_group.first_timestamp="  
+                 << _current_timestamp_group.first_timestamp << endl;
         return false;
     } else if (NewTimestampGroup(arrival_time_ms, timestamp)) { // 新的包组到来,计算deltas
-        cout << "*新的包组到来" << endl;
+        if (kDebugLog)
+            cout << "*新的包组到来" << endl;
         // First packet of a later frame, the previous frame sample is ready.
         if (_prev_timestamp_group.complete_time_ms >= 0) {
             // 包组最后一个包的发送时间和到达时间
@@ -144,9 +155,10 @@ bool InterArrival::ComputeDeltas(uint32_t timestamp,
                 _prev_timestamp_group.last_system_time_ms;
             if (*arrival_time_delta_ms - system_time_delta_ms >=
                     kArrivalTimeOffsetThresholdMs) {
-                cout << "[到达时间跳变,重置,返回false] The arrival time clock offset has changed (diff = "
-                    << *arrival_time_delta_ms - system_time_delta_ms
-                    << " ms), resetting." << endl;
+                if (kDebugLog)
+                    cout << "[到达时间跳变,重置,返回false] The arrival time clock offset has changed (diff = "
+                        << *arrival_time_delta_ms - system_time_delta_ms
+                        << " ms), resetting." << endl;
                 Reset();
                 return false;
             }
@@ -156,14 +168,16 @@ bool InterArrival::ComputeDeltas(uint32_t timestamp,
                 // The group of packets has been reordered since receiving its local arrival timestamp.
                 ++_num_consecutive_reordered_packets;
                 if (_num_consecutive_reordered_packets >= kReorderedResetThreshold) {
-                    cout << "[重排序的包,到达时间乱序,到达时间间隔<0,重置] Packets are being reordered on the path from the "
-                        "socket to the bandwidth estimator. Ignoring." << endl;/* this "
+                    if (kDebugLog)
+                        cout << "[重排序的包,到达时间乱序,到达时间间隔<0,重置] Packets are being reordered on the path from the "
+                            "socket to the bandwidth estimator. Ignoring." << endl;/* this "
                         "packet for bandwidth estimation, resetting." << endl;;*/
                     Reset();
                     return false;
                 }
                 // cout << _current_timestamp_group.complete_time_ms << " " << _prev_timestamp_group.complete_time_ms << endl;
-                cout << "[重排序的包,到达时间乱序,到达时间间隔<0,返回false] arrival_time_delta_ms=" << *arrival_time_delta_ms << endl;
+                if (kDebugLog)
+                    cout << "[重排序的包,到达时间乱序,到达时间间隔<0,返回false] arrival_time_delta_ms=" << *arrival_time_delta_ms << endl;
                 return false;
             } else {
                 _num_consecutive_reordered_packets = 0;
@@ -180,7 +194,8 @@ bool InterArrival::ComputeDeltas(uint32_t timestamp,
         _current_timestamp_group.first_arrival_ms = arrival_time_ms;
         _current_timestamp_group.size = 0;
     } else { // 当前包组的包
-        cout << "*当前包组的包" << endl;
+        if (kDebugLog)
+            cout << "*当前包组的包" << endl;
         // ???
         _current_timestamp_group.timestamp = LatestTimestamp(_current_timestamp_group.timestamp, timestamp);
         // _current_timestamp_group.timestamp = timestamp;
@@ -191,14 +206,39 @@ bool InterArrival::ComputeDeltas(uint32_t timestamp,
     _current_timestamp_group.complete_time_ms = arrival_time_ms;
     _current_timestamp_group.last_system_time_ms = system_time_ms;
 
-    cout << "[计算Deltas]" << " 计算结果=" << calculated_deltas << " 发送时间=" << timestamp 
-         << " 到达时间=" << arrival_time_ms << " 系统时间=" << system_time_ms << " 数据包大小=" << packet_size 
-         << " 发送时间间隔=" << *timestamp_delta << " 到达时间间隔=" << *arrival_time_delta_ms 
-         << " 包组大小差值=" << *packet_size_delta << endl;
+    if (kDebugLog)
+        cout << "[计算Deltas]" << " 计算结果=" << calculated_deltas << " 发送时间=" << timestamp 
+             << " 到达时间=" << arrival_time_ms << " 系统时间=" << system_time_ms << " 数据包大小=" << packet_size 
+             << " 发送时间间隔=" << *timestamp_delta << " 到达时间间隔=" << *arrival_time_delta_ms 
+             << " 包组大小差值=" << *packet_size_delta << endl;
 
     return calculated_deltas;
 }
 
+size_t InterArrival::ComputeDeltas(const uint32_t* timestamps,
+                                   const int64_t* arrival_times_ms,
+                                   const int64_t* system_times_ms,
+                                   const size_t* packet_sizes,
+                                   size_t num_packets,
+                                   uint32_t* timestamp_deltas,
+                                   int64_t* arrival_time_deltas_ms,
+                                   int* packet_size_deltas,
+                                   size_t* packet_indices)
+{
+    // 结果直接写到下一个输出位置, 没有算出deltas时该位置会被下一个结果覆盖
+    size_t num_deltas = 0;
+    for (size_t i = 0; i < num_packets; ++i) {
+        if (ComputeDeltas(timestamps[i], arrival_times_ms[i], system_times_ms[i], packet_sizes[i],
+                    &timestamp_deltas[num_deltas], &arrival_time_deltas_ms[num_deltas],
+                    &packet_size_deltas[num_deltas])) {
+            if (packet_indices)
+                packet_indices[num_deltas] = i;
+            ++num_deltas;
+        }
+    }
+    return num_deltas;
+}
+
 } // namespace webrtc
 
 
@@ -38,6 +38,19 @@ public:
                        int64_t* arrival_time_delta_ms,
                        int* packet_size_delta);
 
+    // 一批包依次计算, 每个包的结果与逐个调用ComputeDeltas()相同。
+    // 算出deltas的包依次写到输出数组, |packet_indices|(可以为nullptr)记录它在这批
+    // 包中的下标。Returns the number of deltas computed.
+    size_t ComputeDeltas(const uint32_t* timestamps,
+                         const int64_t* arrival_times_ms,
+                         const int64_t* system_times_ms,
+                         const size_t* packet_sizes,
+                         size_t num_packets,
+                         uint32_t* timestamp_deltas,
+                         int64_t* arrival_time_deltas_ms,
+                         int* packet_size_deltas,
+                         size_t* packet_indices);
+
 private:
     struct TimestampGroup {
         TimestampGroup() 
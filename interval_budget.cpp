@@ -0,0 +1,67 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file interval_budget.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "interval_budget.h"
+
+#include <algorithm>
+
+namespace webrtc {
+
+namespace {
+constexpr int64_t kWindowMs = 500;
+}
+
+IntervalBudget::IntervalBudget(int initial_target_rate_kbps)
+    : IntervalBudget(initial_target_rate_kbps, false) {}
+
+IntervalBudget::IntervalBudget(int initial_target_rate_kbps,
+                               bool can_build_up_underuse)
+    : _bytes_remaining(0), _can_build_up_underuse(can_build_up_underuse) {
+    set_target_rate_kbps(initial_target_rate_kbps);
+}
+
+void IntervalBudget::set_target_rate_kbps(int target_rate_kbps) {
+    _target_rate_kbps = target_rate_kbps;
+    _max_bytes_in_budget = (kWindowMs * _target_rate_kbps) / 8;
+    _bytes_remaining = std::min(std::max(-_max_bytes_in_budget, _bytes_remaining),
+                                _max_bytes_in_budget);
+}
+
+void IntervalBudget::IncreaseBudget(int64_t delta_time_ms) {
+    int64_t bytes = _target_rate_kbps * delta_time_ms / 8;
+    if (_bytes_remaining < 0 || _can_build_up_underuse) {
+        // We overused last interval, compensate this interval.
+        _bytes_remaining = std::min(_bytes_remaining + bytes, _max_bytes_in_budget);
+    } else {
+        // If we underused last interval we can't use it this interval.
+        _bytes_remaining = std::min(bytes, _max_bytes_in_budget);
+    }
+}
+
+void IntervalBudget::UseBudget(size_t bytes) {
+    _bytes_remaining = std::max(_bytes_remaining - static_cast<int64_t>(bytes),
+                                -_max_bytes_in_budget);
+}
+
+size_t IntervalBudget::bytes_remaining() const {
+    return static_cast<size_t>(std::max<int64_t>(0, _bytes_remaining));
+}
+
+double IntervalBudget::budget_ratio() const {
+    if (_max_bytes_in_budget == 0)
+        return 0.0;
+    return static_cast<double>(_bytes_remaining) / _max_bytes_in_budget;
+}
+
+int IntervalBudget::target_rate_kbps() const {
+    return _target_rate_kbps;
+}
+
+} // namespace webrtc
@@ -0,0 +1,47 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file interval_budget.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _INTERVAL_BUDGET_H
+#define _INTERVAL_BUDGET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace webrtc {
+
+// pacer的发送预算: 按目标码率随时间累积, 发包时消耗, 最多累积一个窗口(500ms)的量
+// Also used outside the pacer, e.g. by the AlrDetector.
+class IntervalBudget {
+public:
+    explicit IntervalBudget(int initial_target_rate_kbps);
+    IntervalBudget(int initial_target_rate_kbps, bool can_build_up_underuse);
+
+    void set_target_rate_kbps(int target_rate_kbps);
+
+    void IncreaseBudget(int64_t delta_time_ms);
+    void UseBudget(size_t bytes);
+
+    size_t bytes_remaining() const;
+    // 剩余预算占窗口预算的比例, 发送不足时趋近1, 超发时为负
+    double budget_ratio() const;
+    int target_rate_kbps() const;
+
+private:
+    int _target_rate_kbps;
+    int64_t _max_bytes_in_budget;
+    int64_t _bytes_remaining;
+    bool _can_build_up_underuse;
+};
+
+} // namespace webrtc
+
+#endif // _INTERVAL_BUDGET_H
+
+
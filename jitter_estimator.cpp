@@ -0,0 +1,241 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file jitter_estimator.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "jitter_estimator.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace webrtc {
+
+namespace {
+
+// 平均帧大小和方差的平滑系数
+constexpr double kPhi = 0.97;
+// 最大帧大小每帧的衰减
+constexpr double kPsi = 0.9999;
+constexpr int kAlphaCountMax = 400;
+constexpr double kThetaLow = 0.000001;
+constexpr int kStartupDelaySamples = 30;
+constexpr uint32_t kFsAccuStartupSamples = 5;
+constexpr double kNumStdDevDelayOutlier = 15;
+constexpr double kNumStdDevFrameSizeOutlier = 3;
+constexpr double kNoiseStdDevs = 2.33;
+constexpr double kNoiseStdDevOffset = 30.0;
+// 帧间延时超过这么多倍噪声标准差时截断
+constexpr double kTimeDeviationUpperBound = 3.5;
+constexpr double kOperatingSystemJitterMs = 10.0;
+constexpr double kMaxJitterEstimateMs = 10000.0;
+
+} // namespace
+
+JitterEstimator::JitterEstimator() {
+    Reset();
+}
+
+void JitterEstimator::Reset() {
+    // 初始信道512kbps
+    _theta[0] = 1 / (512e3 / 8);
+    _theta[1] = 0;
+    _var_noise = 4.0;
+
+    _theta_cov[0][0] = 1e-4;
+    _theta_cov[1][1] = 1e2;
+    _theta_cov[0][1] = _theta_cov[1][0] = 0;
+    _q_cov[0][0] = 2.5e-10;
+    _q_cov[1][1] = 1e-10;
+    _q_cov[0][1] = _q_cov[1][0] = 0;
+    _avg_frame_size = 500;
+    _max_frame_size = 500;
+    _var_frame_size = 100;
+    _frame_size_sum = 0;
+    _frame_size_count = 0;
+    _prev_frame_size = 0;
+    _avg_noise = 0.0;
+    _alpha_count = 1;
+    _startup_count = 0;
+    _filter_jitter_estimate = 0.0;
+    _prev_estimate = -1.0;
+}
+
+void JitterEstimator::UpdateEstimate(int64_t frame_delay_ms, uint32_t frame_size_bytes,
+        bool incomplete_frame) {
+    if (frame_size_bytes == 0)
+        return;
+    const int32_t delta_frame_size = static_cast<int32_t>(frame_size_bytes) -
+        static_cast<int32_t>(_prev_frame_size);
+    if (_frame_size_count < kFsAccuStartupSamples) {
+        _frame_size_sum += frame_size_bytes;
+        ++_frame_size_count;
+    } else if (_frame_size_count == kFsAccuStartupSamples) {
+        // Give the frame size filter.
+        _avg_frame_size = static_cast<double>(_frame_size_sum) / _frame_size_count;
+        ++_frame_size_count;
+    }
+    if (!incomplete_frame || frame_size_bytes > _avg_frame_size) {
+        const double avg_frame_size = kPhi * _avg_frame_size + (1 - kPhi) * frame_size_bytes;
+        // Only update the average frame size if this sample wasn't a key frame.
+        if (frame_size_bytes < _avg_frame_size + 2 * sqrt(_var_frame_size))
+            _avg_frame_size = avg_frame_size;
+        // Update the variance anyway since we want to capture cases where we only
+        // get key frames.
+        const double deviation = frame_size_bytes - avg_frame_size;
+        _var_frame_size = std::max(kPhi * _var_frame_size + (1 - kPhi) * deviation * deviation, 1.0);
+    }
+
+    // Update max frame size estimate.
+    _max_frame_size = std::max(kPsi * _max_frame_size, static_cast<double>(frame_size_bytes));
+
+    if (_prev_frame_size == 0) {
+        _prev_frame_size = frame_size_bytes;
+        return;
+    }
+    _prev_frame_size = frame_size_bytes;
+
+    // Cap |frame_delay_ms| based on the current time deviation noise. 截断的是相对
+    // 直线的偏差而不是帧间延时本身, 否则大帧的发送时间被截掉, 斜率学不出来。
+    const int64_t max_time_deviation_ms =
+        static_cast<int64_t>(kTimeDeviationUpperBound * sqrt(_var_noise) + 0.5);
+    const int64_t expected_delay_ms = static_cast<int64_t>(
+            floor(_theta[0] * delta_frame_size + _theta[1] + 0.5));
+    frame_delay_ms = std::max(std::min(frame_delay_ms, expected_delay_ms + max_time_deviation_ms),
+            expected_delay_ms - max_time_deviation_ms);
+
+    // Only update the Kalman filter if the sample is not considered an extreme
+    // outlier. Even if it is an extreme outlier from a delay point of view, if
+    // the frame size also is large the deviation is probably due to an incorrect
+    // line slope.
+    const double deviation = DeviationFromExpectedDelay(frame_delay_ms, delta_frame_size);
+    if (fabs(deviation) < kNumStdDevDelayOutlier * sqrt(_var_noise) ||
+            frame_size_bytes > _avg_frame_size + kNumStdDevFrameSizeOutlier * sqrt(_var_frame_size)) {
+        // Update the variance of the deviation from the line given by the Kalman filter.
+        EstimateRandomJitter(deviation, incomplete_frame);
+        // Prevent updating with frames which have been congested by a large frame,
+        // and therefore arrives almost at the same time as that frame. This can
+        // occur when we receive a large frame (key frame) which has been delayed.
+        // The next frame is of normal size (delta frame), and thus delta_frame_size
+        // will be << 0. This removes all frame samples which arrives after a key frame.
+        if ((!incomplete_frame || deviation >= 0.0) && delta_frame_size > -0.25 * _max_frame_size)
+            KalmanEstimateChannel(frame_delay_ms, delta_frame_size);
+    } else {
+        const double num_std_dev = deviation >= 0 ? kNumStdDevDelayOutlier : -kNumStdDevDelayOutlier;
+        EstimateRandomJitter(num_std_dev * sqrt(_var_noise), incomplete_frame);
+    }
+    // Post process the total estimated jitter.
+    _prev_estimate = CalculateEstimate();
+    if (_startup_count >= kStartupDelaySamples)
+        _filter_jitter_estimate = _prev_estimate;
+    else
+        ++_startup_count;
+}
+
+int JitterEstimator::GetJitterEstimate() const {
+    double jitter_ms = CalculateEstimate() + kOperatingSystemJitterMs;
+    if (_filter_jitter_estimate > jitter_ms)
+        jitter_ms = _filter_jitter_estimate;
+    return jitter_ms >= 0 ? static_cast<int>(jitter_ms + 0.5) : 0;
+}
+
+double JitterEstimator::noise_std_dev_ms() const {
+    return sqrt(_var_noise);
+}
+
+void JitterEstimator::KalmanEstimateChannel(int64_t frame_delay_ms, int32_t delta_frame_size_bytes) {
+    if (_max_frame_size < 1.0)
+        return;
+    const double delta_fs = delta_frame_size_bytes;
+
+    // Prediction: M = M + Q
+    _theta_cov[0][0] += _q_cov[0][0];
+    _theta_cov[0][1] += _q_cov[0][1];
+    _theta_cov[1][0] += _q_cov[1][0];
+    _theta_cov[1][1] += _q_cov[1][1];
+
+    // Kalman gain: K = M*h'/(sigma2n + h*M*h') = M*h'/(1 + h*M*h'), h = [dFS 1]
+    const double mh[2] = {
+        _theta_cov[0][0] * delta_fs + _theta_cov[0][1],
+        _theta_cov[1][0] * delta_fs + _theta_cov[1][1],
+    };
+    // sigma weights measurements with a small dFS as noisy and measurements
+    // with large dFS as good.
+    double sigma = (300.0 * exp(-fabs(delta_fs) / _max_frame_size) + 1) * sqrt(_var_noise);
+    if (sigma < 1.0)
+        sigma = 1.0;
+    const double hmh_sigma = delta_fs * mh[0] + mh[1] + sigma;
+    if (fabs(hmh_sigma) < 1e-9) {
+        assert(false);
+        return;
+    }
+    const double kalman_gain[2] = {mh[0] / hmh_sigma, mh[1] / hmh_sigma};
+
+    // Correction: theta = theta + K*(dT - h*theta)
+    const double measure_res = frame_delay_ms - (delta_fs * _theta[0] + _theta[1]);
+    _theta[0] += kalman_gain[0] * measure_res;
+    _theta[1] += kalman_gain[1] * measure_res;
+    if (_theta[0] < kThetaLow)
+        _theta[0] = kThetaLow;
+
+    // M = (I - K*h)*M
+    const double t00 = _theta_cov[0][0];
+    const double t01 = _theta_cov[0][1];
+    _theta_cov[0][0] = (1 - kalman_gain[0] * delta_fs) * t00 - kalman_gain[0] * _theta_cov[1][0];
+    _theta_cov[0][1] = (1 - kalman_gain[0] * delta_fs) * t01 - kalman_gain[0] * _theta_cov[1][1];
+    _theta_cov[1][0] = _theta_cov[1][0] * (1 - kalman_gain[1]) - kalman_gain[1] * delta_fs * t00;
+    _theta_cov[1][1] = _theta_cov[1][1] * (1 - kalman_gain[1]) - kalman_gain[1] * delta_fs * t01;
+
+    // Covariance matrix, must be positive semi-definite.
+    assert(_theta_cov[0][0] + _theta_cov[1][1] >= 0 &&
+            _theta_cov[0][0] * _theta_cov[1][1] - _theta_cov[0][1] * _theta_cov[1][0] >= 0 &&
+            _theta_cov[0][0] >= 0);
+}
+
+void JitterEstimator::EstimateRandomJitter(double d_dt, bool incomplete_frame) {
+    double alpha = static_cast<double>(_alpha_count - 1) / _alpha_count;
+    if (++_alpha_count > kAlphaCountMax)
+        _alpha_count = kAlphaCountMax;
+
+    const double avg_noise = alpha * _avg_noise + (1 - alpha) * d_dt;
+    const double var_noise = alpha * _var_noise +
+        (1 - alpha) * (d_dt - _avg_noise) * (d_dt - _avg_noise);
+    if (!incomplete_frame || var_noise > _var_noise) {
+        _avg_noise = avg_noise;
+        _var_noise = var_noise;
+    }
+    if (_var_noise < 1.0) {
+        // The variance should never be zero, since we might get stuck and consider
+        // all samples as outliers.
+        _var_noise = 1.0;
+    }
+}
+
+double JitterEstimator::NoiseThreshold() const {
+    const double noise_threshold = kNoiseStdDevs * sqrt(_var_noise) - kNoiseStdDevOffset;
+    return noise_threshold < 1.0 ? 1.0 : noise_threshold;
+}
+
+double JitterEstimator::CalculateEstimate() const {
+    double ret = _theta[0] * (_max_frame_size - _avg_frame_size) + NoiseThreshold();
+    // A very low estimate (or negative) is neglected.
+    if (ret < 1.0)
+        ret = _prev_estimate <= 0.01 ? 1.0 : _prev_estimate;
+    if (ret > kMaxJitterEstimateMs)
+        ret = kMaxJitterEstimateMs;
+    return ret;
+}
+
+double JitterEstimator::DeviationFromExpectedDelay(int64_t frame_delay_ms,
+        int32_t delta_frame_size_bytes) const {
+    return frame_delay_ms - (_theta[0] * delta_frame_size_bytes + _theta[1]);
+}
+
+} // namespace webrtc
+
@@ -0,0 +1,80 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file jitter_estimator.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _JITTER_ESTIMATOR_H
+#define _JITTER_ESTIMATOR_H
+
+#include <stdint.h>
+
+namespace webrtc {
+
+// 接收端的帧间抖动估计, 输出建议的播放延时(抖动缓冲延时)。
+//
+// 帧间延时 d = (到达间隔 - 时间戳间隔), 建模为 d = theta[0] * dFS + theta[1] + w:
+// dFS是和上一帧的大小之差, theta[0]是每字节的传输时间(信道带宽的倒数), theta[1]是
+// 排队延时的变化, w是随机抖动。theta用Kalman滤波估计, w的均值和方差用指数滑动平均
+// 估计。抖动延时 = theta[0] * (最大帧 - 平均帧) + 随机抖动的阈值, 即一个最大帧
+// (关键帧)比平均帧多出的传输时间加上噪声。
+//
+// 状态都是固定大小的标量和2x2矩阵, 每帧更新不分配内存。
+//
+// Note: This class is not thread-safe.
+class JitterEstimator {
+public:
+    JitterEstimator();
+
+    void Reset();
+
+    // |frame_delay_ms|: 帧间延时; |frame_size_bytes|: 帧大小;
+    // |incomplete_frame|: 帧不完整(比如丢包), 只在它让估计变大时使用
+    void UpdateEstimate(int64_t frame_delay_ms, uint32_t frame_size_bytes,
+            bool incomplete_frame = false);
+
+    // 建议的抖动缓冲延时(ms)
+    int GetJitterEstimate() const;
+
+    double frame_size_slope() const { return _theta[0]; }
+    double noise_std_dev_ms() const;
+    double avg_frame_size() const { return _avg_frame_size; }
+    double max_frame_size() const { return _max_frame_size; }
+
+private:
+    // Updates the Kalman filter for the line describing the frame size dependent jitter.
+    void KalmanEstimateChannel(int64_t frame_delay_ms, int32_t delta_frame_size_bytes);
+    // Updates the random jitter estimate, i.e. the variance of the time deviations
+    // from the line given by the Kalman filter.
+    void EstimateRandomJitter(double d_dt, bool incomplete_frame);
+    double NoiseThreshold() const;
+    double CalculateEstimate() const;
+    double DeviationFromExpectedDelay(int64_t frame_delay_ms, int32_t delta_frame_size_bytes) const;
+
+    double _theta[2];
+    double _theta_cov[2][2];
+    double _q_cov[2][2];
+    double _avg_frame_size;
+    double _var_frame_size;
+    double _max_frame_size;
+    uint32_t _frame_size_sum;
+    uint32_t _frame_size_count;
+    uint32_t _prev_frame_size;
+    double _avg_noise;
+    double _var_noise;
+    int _alpha_count;
+    int _startup_count;
+    double _filter_jitter_estimate;
+    // 上一次UpdateEstimate()算出的估计, CalculateEstimate()估计过低时沿用它。
+    // 只在UpdateEstimate()中更新, GetJitterEstimate()不改变状态
+    double _prev_estimate;
+};
+
+} // namespace webrtc
+
+#endif // _JITTER_ESTIMATOR_H
+
@@ -0,0 +1,192 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file jitter_estimator_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ jitter_estimator_unittest.cpp jitter_estimator.cpp random.cpp -std=c++11 -O2
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+using namespace std;
+
+#include "allocation_counter.h"
+#include "jitter_estimator.h"
+#include "random.h"
+
+using namespace webrtc;
+
+// 30fps, 普通帧大小N(2500, 500)字节, 每150帧一个10倍大小的关键帧。帧在|bits_per_ms|的
+// 链路上依次发送, 发送完之后的延时 = 40ms + N(0, jitter_ms), 按捕获顺序计算帧间延时。
+class TraceGenerator {
+public:
+    TraceGenerator(uint64_t seed, double jitter_ms)
+        : _random(seed),
+        _jitter_ms(jitter_ms),
+        _bits_per_ms(2000),
+        _index(0),
+        _send_done_ms(0),
+        _last_capture_ms(0),
+        _last_arrival_ms(0) {}
+
+    void set_bits_per_ms(double bits_per_ms) { _bits_per_ms = bits_per_ms; }
+
+    // 下一帧的帧间延时和大小, 第一帧的帧间延时为0
+    void NextFrame(int64_t* frame_delay_ms, uint32_t* frame_size, int64_t extra_delay_ms = 0) {
+        const double capture_ms = _index * 33.0;
+        const bool keyframe = _index % 150 == 0;
+        double size = _random.Gaussian(2500, 500);
+        if (keyframe)
+            size *= 10;
+        *frame_size = static_cast<uint32_t>(std::max(size, 100.0));
+        _send_done_ms = std::max(_send_done_ms, capture_ms) + *frame_size * 8.0 / _bits_per_ms;
+        const double arrival_ms = _send_done_ms + 40 + _random.Gaussian(0, _jitter_ms) +
+            extra_delay_ms;
+        *frame_delay_ms = _index == 0 ? 0 : static_cast<int64_t>(
+                floor((arrival_ms - _last_arrival_ms) - (capture_ms - _last_capture_ms) + 0.5));
+        _last_capture_ms = capture_ms;
+        _last_arrival_ms = arrival_ms;
+        ++_index;
+    }
+
+private:
+    Random _random;
+    double _jitter_ms;
+    double _bits_per_ms;
+    int64_t _index;
+    double _send_done_ms;
+    double _last_capture_ms;
+    double _last_arrival_ms;
+};
+
+static void RunFrames(TraceGenerator* trace, JitterEstimator* estimator, int num_frames) {
+    for (int i = 0; i < num_frames; ++i) {
+        int64_t frame_delay_ms = 0;
+        uint32_t frame_size = 0;
+        trace->NextFrame(&frame_delay_ms, &frame_size);
+        estimator->UpdateEstimate(frame_delay_ms, frame_size);
+    }
+}
+
+static void RunConvergence(double bits_per_ms, double jitter_ms) {
+    TraceGenerator trace(0x4801 + static_cast<uint64_t>(bits_per_ms + jitter_ms), jitter_ms);
+    trace.set_bits_per_ms(bits_per_ms);
+    JitterEstimator estimator;
+    RunFrames(&trace, &estimator, 3000);
+
+    const double slope = 8.0 / bits_per_ms;
+    // 帧间延时的随机部分是两个N(0, jitter_ms)之差
+    const double noise_std_dev = std::max(sqrt(2.0) * jitter_ms, 1.0);
+    // 关键帧比平均帧多出的发送时间
+    const double keyframe_delay_ms = slope * (25000 - 2500);
+    cout << "bandwidth=" << bits_per_ms << "kbps jitter=" << jitter_ms
+        << "ms: slope=" << estimator.frame_size_slope() << "(" << slope << ")"
+        << " noise=" << estimator.noise_std_dev_ms() << "(" << noise_std_dev << ")"
+        << " avg/max size=" << estimator.avg_frame_size() << "/" << estimator.max_frame_size()
+        << " estimate=" << estimator.GetJitterEstimate() << "ms" << endl;
+    assert(fabs(estimator.frame_size_slope() - slope) < 0.25 * slope);
+    assert(estimator.noise_std_dev_ms() > 0.7 * noise_std_dev);
+    assert(estimator.noise_std_dev_ms() < 1.5 * noise_std_dev);
+    assert(fabs(estimator.avg_frame_size() - 2500) < 250);
+    assert(estimator.GetJitterEstimate() > 0.75 * keyframe_delay_ms);
+    assert(estimator.GetJitterEstimate() < 1.5 * keyframe_delay_ms + 2.33 * noise_std_dev + 10);
+}
+
+// Convergence
+// 不同带宽和抖动下, 每字节发送时间收敛到带宽的倒数, 噪声标准差收敛到sqrt(2)*jitter,
+// 抖动延时覆盖关键帧多出的发送时间
+void TestJitterEstimator01() {
+    RunConvergence(1000, 5);
+    RunConvergence(2000, 5);
+    RunConvergence(2000, 20);
+    RunConvergence(4000, 10);
+    cout << "TestJitterEstimator01 passed" << endl;
+}
+
+// BandwidthDrop
+// 带宽从4Mbps降到1Mbps后每字节发送时间跟上新的带宽, 抖动延时随之变大
+void TestJitterEstimator02() {
+    TraceGenerator trace(0x4802, 5);
+    trace.set_bits_per_ms(4000);
+    JitterEstimator estimator;
+    RunFrames(&trace, &estimator, 3000);
+    assert(fabs(estimator.frame_size_slope() - 0.002) < 0.0005);
+    const int before = estimator.GetJitterEstimate();
+
+    // 过程噪声很小, 斜率要几千帧才能跟上
+    trace.set_bits_per_ms(1000);
+    RunFrames(&trace, &estimator, 6000);
+    const int after = estimator.GetJitterEstimate();
+    cout << "slope=" << estimator.frame_size_slope() << " estimate " << before << "ms -> "
+        << after << "ms" << endl;
+    assert(fabs(estimator.frame_size_slope() - 0.008) < 0.002);
+    assert(after > 2 * before);
+    cout << "TestJitterEstimator02 passed" << endl;
+}
+
+// DelaySpike
+// 单个帧晚到1s被当作异常值截断, 抖动延时不会跳变, 之后回到原来的水平
+void TestJitterEstimator03() {
+    TraceGenerator trace(0x4803, 10);
+    JitterEstimator estimator;
+    RunFrames(&trace, &estimator, 3000);
+    const int before = estimator.GetJitterEstimate();
+
+    int64_t frame_delay_ms = 0;
+    uint32_t frame_size = 0;
+    trace.NextFrame(&frame_delay_ms, &frame_size, 1000);
+    assert(frame_delay_ms > 900);
+    estimator.UpdateEstimate(frame_delay_ms, frame_size);
+    const int spike = estimator.GetJitterEstimate();
+    RunFrames(&trace, &estimator, 600);
+    const int after = estimator.GetJitterEstimate();
+    cout << "estimate " << before << "ms -> " << spike << "ms -> " << after << "ms" << endl;
+    assert(spike < before * 3 / 2);
+    assert(abs(after - before) < before / 5);
+    cout << "TestJitterEstimator03 passed" << endl;
+}
+
+// AllocationFree
+// 预先生成轨迹, 每帧UpdateEstimate() + GetJitterEstimate()不分配内存, 统计耗时
+void TestJitterEstimator04() {
+    const int kNumFrames = 1000000;
+    TraceGenerator trace(0x4804, 10);
+    int64_t* frame_delays = new int64_t[kNumFrames];
+    uint32_t* frame_sizes = new uint32_t[kNumFrames];
+    for (int i = 0; i < kNumFrames; ++i)
+        trace.NextFrame(&frame_delays[i], &frame_sizes[i]);
+
+    JitterEstimator estimator;
+    int64_t sum = 0;
+    const size_t num_allocations = g_num_allocations;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < kNumFrames; ++i) {
+        estimator.UpdateEstimate(frame_delays[i], frame_sizes[i]);
+        sum += estimator.GetJitterEstimate();
+    }
+    const int64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+    assert(g_num_allocations == num_allocations);
+    assert(sum > 0);
+    cout << static_cast<double>(elapsed_ns) / kNumFrames << " ns/frame" << endl;
+    delete[] frame_delays;
+    delete[] frame_sizes;
+    cout << "TestJitterEstimator04 passed" << endl;
+}
+
+int main() {
+    TestJitterEstimator01();
+    TestJitterEstimator02();
+    TestJitterEstimator03();
+    TestJitterEstimator04();
+    return 0;
+}
+
@@ -0,0 +1,200 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file loss_based_bandwidth_estimation.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "loss_based_bandwidth_estimation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "field_trail.h"
+
+namespace webrtc {
+
+static const char kBweLossBasedControl[] = "WebRTC-Bwe-LossBasedControl";
+static const int kNoBitrateCap = std::numeric_limits<int>::max();
+
+// Use the convention that exponential window length (which is really
+// infinite) is the time it takes to dampen to 1/e.
+static double ExponentialUpdate(int64_t window_ms, int64_t interval_ms) {
+    if (window_ms <= 0)
+        return 1.0;
+    return 1.0 - std::exp(-static_cast<double>(interval_ms) / window_ms);
+}
+
+// 码率|bitrate_bps|下可以接受的丢包率
+static double LossFromBitrate(int bitrate_bps, int loss_bandwidth_balance_bps,
+        double exponent) {
+    if (loss_bandwidth_balance_bps >= bitrate_bps)
+        return 1.0;
+    return std::pow(static_cast<double>(loss_bandwidth_balance_bps) / bitrate_bps, exponent);
+}
+
+// 丢包率|loss|恰好可以接受时的码率
+static int BitrateFromLoss(double loss, int loss_bandwidth_balance_bps,
+        double exponent) {
+    if (exponent <= 0 || loss < 1e-5)
+        return kNoBitrateCap;
+    double bitrate_bps = loss_bandwidth_balance_bps * std::pow(loss, -1.0 / exponent);
+    if (bitrate_bps >= kNoBitrateCap)
+        return kNoBitrateCap;
+    return static_cast<int>(bitrate_bps);
+}
+
+// rtt越小增长越快, 在[min_increase_factor, max_increase_factor]之间线性插值
+static double GetIncreaseFactor(const LossBasedControlConfig& config, int64_t rtt_ms) {
+    const int64_t rtt_range_ms = config.increase_high_rtt_ms - config.increase_low_rtt_ms;
+    if (rtt_range_ms <= 0)
+        return config.max_increase_factor;
+    const int64_t rtt_offset_ms = std::min(std::max(rtt_ms, config.increase_low_rtt_ms),
+            config.increase_high_rtt_ms) - config.increase_low_rtt_ms;
+    const double relative_offset = static_cast<double>(rtt_offset_ms) / rtt_range_ms;
+    const double factor_range = config.max_increase_factor - config.min_increase_factor;
+    return config.min_increase_factor + (1 - relative_offset) * factor_range;
+}
+
+LossBasedControlConfig::LossBasedControlConfig()
+    : enabled(webrtc::field_trial::IsEnabled(kBweLossBasedControl)),
+    min_increase_factor(1.02),
+    max_increase_factor(1.08),
+    increase_low_rtt_ms(200),
+    increase_high_rtt_ms(800),
+    decrease_factor(0.99),
+    loss_window_ms(800),
+    loss_max_window_ms(800),
+    acknowledged_rate_max_window_ms(800),
+    increase_offset_bps(1000),
+    loss_bandwidth_balance_increase_bps(500),
+    loss_bandwidth_balance_decrease_bps(4000),
+    loss_bandwidth_balance_exponent(0.5),
+    decrease_interval_ms(300),
+    loss_report_timeout_ms(6000) {}
+
+LossBasedBandwidthEstimation::LossBasedBandwidthEstimation()
+    : LossBasedBandwidthEstimation(LossBasedControlConfig()) {}
+
+LossBasedBandwidthEstimation::LossBasedBandwidthEstimation(
+        const LossBasedControlConfig& config)
+    : _config(config),
+    _average_loss(0),
+    _average_loss_max(0),
+    _loss_based_bitrate_bps(0),
+    _acknowledged_bitrate_max_bps(0),
+    _acknowledged_bitrate_last_update_ms(-1),
+    _time_last_decrease_ms(-1),
+    _has_decreased_since_last_loss_report(false),
+    _last_loss_packet_report_ms(-1),
+    _last_loss_ratio(0) {}
+
+void LossBasedBandwidthEstimation::UpdateLossStatistics(int packets_lost,
+        int number_of_packets, int64_t now_ms) {
+    if (number_of_packets <= 0)
+        return;
+    _last_loss_ratio = static_cast<double>(packets_lost) / number_of_packets;
+    const int64_t time_passed_ms = _last_loss_packet_report_ms >= 0
+        ? now_ms - _last_loss_packet_report_ms : 1000;
+    _last_loss_packet_report_ms = now_ms;
+    _has_decreased_since_last_loss_report = false;
+
+    // 平均丢包率, 以及缓慢回落的平均丢包率峰值
+    _average_loss += ExponentialUpdate(_config.loss_window_ms, time_passed_ms) *
+        (_last_loss_ratio - _average_loss);
+    if (_average_loss > _average_loss_max) {
+        _average_loss_max = _average_loss;
+    } else {
+        _average_loss_max += ExponentialUpdate(_config.loss_max_window_ms, time_passed_ms) *
+            (_average_loss - _average_loss_max);
+    }
+}
+
+void LossBasedBandwidthEstimation::UpdateAcknowledgedBitrate(
+        int acknowledged_bitrate_bps, int64_t now_ms) {
+    const int64_t time_passed_ms = _acknowledged_bitrate_last_update_ms >= 0
+        ? now_ms - _acknowledged_bitrate_last_update_ms : 1000;
+    _acknowledged_bitrate_last_update_ms = now_ms;
+    if (acknowledged_bitrate_bps > _acknowledged_bitrate_max_bps) {
+        _acknowledged_bitrate_max_bps = acknowledged_bitrate_bps;
+    } else {
+        _acknowledged_bitrate_max_bps -= static_cast<int>(
+                ExponentialUpdate(_config.acknowledged_rate_max_window_ms, time_passed_ms) *
+                (_acknowledged_bitrate_max_bps - acknowledged_bitrate_bps));
+    }
+}
+
+void LossBasedBandwidthEstimation::Update(int64_t now_ms, int wanted_bitrate_bps,
+        int64_t last_round_trip_time_ms) {
+    if (_loss_based_bitrate_bps == 0)
+        _loss_based_bitrate_bps = wanted_bitrate_bps;
+
+    // Only increase if loss has been low for some time.
+    const double loss_estimate_for_increase = _average_loss_max;
+    // Avoid multiple decreases from averaging over one loss spike.
+    const double loss_estimate_for_decrease = std::min(_average_loss, _last_loss_ratio);
+    const bool allow_decrease = !_has_decreased_since_last_loss_report &&
+        (_time_last_decrease_ms < 0 || now_ms - _time_last_decrease_ms >=
+         last_round_trip_time_ms + _config.decrease_interval_ms);
+    // If packet lost reports are too old, dont increase bitrate.
+    const bool loss_report_valid = _last_loss_packet_report_ms >= 0 &&
+        now_ms - _last_loss_packet_report_ms < _config.loss_report_timeout_ms;
+
+    if (loss_report_valid && loss_estimate_for_increase < loss_increase_threshold()) {
+        // Increase bitrate by RTT-adaptive ratio.
+        int new_increased_bitrate_bps = static_cast<int>(
+                wanted_bitrate_bps * GetIncreaseFactor(_config, last_round_trip_time_ms)) +
+            _config.increase_offset_bps;
+        // The bitrate that would make the loss "just high enough".
+        const int new_increased_bitrate_cap_bps = BitrateFromLoss(loss_estimate_for_increase,
+                _config.loss_bandwidth_balance_increase_bps,
+                _config.loss_bandwidth_balance_exponent);
+        new_increased_bitrate_bps = std::min(new_increased_bitrate_bps,
+                new_increased_bitrate_cap_bps);
+        _loss_based_bitrate_bps = std::max(new_increased_bitrate_bps, _loss_based_bitrate_bps);
+    } else if (loss_estimate_for_decrease > loss_decrease_threshold() && allow_decrease) {
+        // The bitrate that would make the loss "just acceptable".
+        const int new_decreased_bitrate_floor_bps = BitrateFromLoss(loss_estimate_for_decrease,
+                _config.loss_bandwidth_balance_decrease_bps,
+                _config.loss_bandwidth_balance_exponent);
+        const int new_decreased_bitrate_bps = std::max(decreased_bitrate(),
+                new_decreased_bitrate_floor_bps);
+        if (new_decreased_bitrate_bps < _loss_based_bitrate_bps) {
+            _time_last_decrease_ms = now_ms;
+            _has_decreased_since_last_loss_report = true;
+            _loss_based_bitrate_bps = new_decreased_bitrate_bps;
+        }
+    }
+}
+
+void LossBasedBandwidthEstimation::SetInitialBitrate(int bitrate_bps) {
+    Reset(bitrate_bps);
+}
+
+void LossBasedBandwidthEstimation::Reset(int bitrate_bps) {
+    _loss_based_bitrate_bps = bitrate_bps;
+    _average_loss = 0;
+    _average_loss_max = 0;
+}
+
+double LossBasedBandwidthEstimation::loss_increase_threshold() const {
+    return LossFromBitrate(_loss_based_bitrate_bps,
+            _config.loss_bandwidth_balance_increase_bps,
+            _config.loss_bandwidth_balance_exponent);
+}
+
+double LossBasedBandwidthEstimation::loss_decrease_threshold() const {
+    return LossFromBitrate(_loss_based_bitrate_bps,
+            _config.loss_bandwidth_balance_decrease_bps,
+            _config.loss_bandwidth_balance_exponent);
+}
+
+int LossBasedBandwidthEstimation::decreased_bitrate() const {
+    return static_cast<int>(_config.decrease_factor * _acknowledged_bitrate_max_bps);
+}
+
+} // namespace webrtc
@@ -0,0 +1,80 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file loss_based_bandwidth_estimation.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _LOSS_BASED_BANDWIDTH_ESTIMATION_H
+#define _LOSS_BASED_BANDWIDTH_ESTIMATION_H
+
+#include <stdint.h>
+
+namespace webrtc {
+
+// 基于丢包的码率估计(上游LossBasedBandwidthEstimation)的参数
+// 丢包率与码率的关系建模为 loss = (balance / bitrate)^exponent,
+// 码率越高可容忍的丢包越低, 不再使用固定的2%/10%门限。
+struct LossBasedControlConfig {
+    LossBasedControlConfig();
+
+    bool enabled;
+    double min_increase_factor;
+    double max_increase_factor;
+    int64_t increase_low_rtt_ms;
+    int64_t increase_high_rtt_ms;
+    double decrease_factor;
+    int64_t loss_window_ms;
+    int64_t loss_max_window_ms;
+    int64_t acknowledged_rate_max_window_ms;
+    int increase_offset_bps;
+    int loss_bandwidth_balance_increase_bps;
+    int loss_bandwidth_balance_decrease_bps;
+    double loss_bandwidth_balance_exponent;
+    int64_t decrease_interval_ms;
+    int64_t loss_report_timeout_ms;
+};
+
+// Estimates the bandwidth from the loss ratio reported in the feedback and
+// the acknowledged bitrate. Holds no containers, so updates never allocate.
+class LossBasedBandwidthEstimation {
+public:
+    LossBasedBandwidthEstimation();
+    explicit LossBasedBandwidthEstimation(const LossBasedControlConfig& config);
+
+    // |wanted_bitrate_bps| is the lowest target bitrate of the last second.
+    void Update(int64_t now_ms, int wanted_bitrate_bps, int64_t last_round_trip_time_ms);
+    void UpdateAcknowledgedBitrate(int acknowledged_bitrate_bps, int64_t now_ms);
+    void SetInitialBitrate(int bitrate_bps);
+    bool Enabled() const { return _config.enabled; }
+    // |packets_lost| out of |number_of_packets| in one feedback report.
+    void UpdateLossStatistics(int packets_lost, int number_of_packets, int64_t now_ms);
+    // Returns 0 until the first update.
+    int GetEstimate() const { return _loss_based_bitrate_bps; }
+
+private:
+    void Reset(int bitrate_bps);
+    double loss_increase_threshold() const;
+    double loss_decrease_threshold() const;
+    int decreased_bitrate() const;
+
+    LossBasedControlConfig _config;
+    double _average_loss;
+    double _average_loss_max;
+    int _loss_based_bitrate_bps;
+    int _acknowledged_bitrate_max_bps;
+    int64_t _acknowledged_bitrate_last_update_ms;
+    int64_t _time_last_decrease_ms;
+    bool _has_decreased_since_last_loss_report;
+    int64_t _last_loss_packet_report_ms;
+    double _last_loss_ratio;
+};
+
+} // namespace webrtc
+
+#endif // _LOSS_BASED_BANDWIDTH_ESTIMATION_H
+
+
@@ -11,69 +11,166 @@
 #ifndef _MODULE_COMMON_TYPES_PUBLIC_H
 #define _MODULE_COMMON_TYPES_PUBLIC_H
 
-#include <limits>
+#include <stddef.h>
 #include <stdint.h>
-#include <iostream>
-using namespace std;
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace webrtc {
 
 // 必须是无符号数
+// kBreakpoint is the half-way mark for the type U. For instance, for a
+// uint16_t it will be 0x8000, and for a uint32_t, it will be 0x8000000.
 template <typename U>
-inline bool IsNewer(U value, U prev_value) {
+constexpr U WrappingBreakpoint() {
   static_assert(!std::numeric_limits<U>::is_signed, "U must be unsigned");
-  // kBreakpoint is the half-way mark for the type U. For instance, for a
-  // uint16_t it will be 0x8000, and for a uint32_t, it will be 0x8000000.
-  constexpr U kBreakpoint = (std::numeric_limits<U>::max() >> 1) + 1;
-
-  cout << "[IsNewer] value=" << value << " prev_value=" << prev_value 
-      << " value-prev_value=" << static_cast<U>(value-prev_value) << " kBreakpoint=" << kBreakpoint << endl;
-
-  // Distinguish between elements that are exactly kBreakpoint apart.
-  // If t1>t2 and |t1-t2| = kBreakpoint: IsNewer(t1,t2)=true,
-  // IsNewer(t2,t1)=false
-  // rather than having IsNewer(t1,t2) = IsNewer(t2,t1) = false.
-
-  // kBreakpoint一定是正数，这种场景发生时一定是value>prev_value
-  if (value - prev_value == kBreakpoint) {
-    return value > prev_value;
-  }
-
-  // cout << "fuck value=" << value << " prev_value=" << prev_value 
-  //    << " value-prev_value=" << static_cast<U>(value-prev_value) << " kBreakpoint=" << kBreakpoint << endl;
+  return static_cast<U>((std::numeric_limits<U>::max() >> 1) + 1);
+}
 
-  // 肯定不能相等
-  // 1.距离小于一半 
-  // 2.距离等于一半(value>prev_value的情况下)
-  // 认为value>prev_value value为最新的包号
-  return value != prev_value &&
-         static_cast<U>(value - prev_value) < kBreakpoint;
+// value在回绕顺序上是否比prev_value新:
+// 1.距离(value - prev_value, 按U回绕)在(0, kBreakpoint)之间
+// 2.距离正好是kBreakpoint时, value > prev_value才算新
+// Distinguish between elements that are exactly kBreakpoint apart.
+// If t1>t2 and |t1-t2| = kBreakpoint: IsNewer(t1,t2)=true,
+// IsNewer(t2,t1)=false
+// rather than having IsNewer(t1,t2) = IsNewer(t2,t1) = false.
+//
+// 比较结果用&和|组合, 不产生分支
+template <typename U>
+constexpr bool IsNewer(U value, U prev_value) {
+  static_assert(!std::numeric_limits<U>::is_signed, "U must be unsigned");
+  return (static_cast<U>(value - prev_value) != 0) &
+         ((static_cast<U>(value - prev_value) < WrappingBreakpoint<U>()) |
+          ((static_cast<U>(value - prev_value) == WrappingBreakpoint<U>()) &
+           (value > prev_value)));
 }
 
 // NB: Doesn't fulfill strict weak ordering requirements.
 //     Mustn't be used as std::map Compare function.
-inline bool IsNewerSequenceNumber(uint16_t sequence_number,
-                                  uint16_t prev_sequence_number) {
+constexpr bool IsNewerSequenceNumber(uint16_t sequence_number,
+                                     uint16_t prev_sequence_number) {
   return IsNewer(sequence_number, prev_sequence_number);
 }
 
 // NB: Doesn't fulfill strict weak ordering requirements.
 //     Mustn't be used as std::map Compare function.
-inline bool IsNewerTimestamp(uint32_t timestamp, uint32_t prev_timestamp) {
+constexpr bool IsNewerTimestamp(uint32_t timestamp, uint32_t prev_timestamp) {
   return IsNewer(timestamp, prev_timestamp);
 }
 
-inline uint16_t LatestSequenceNumber(uint16_t sequence_number1,
-                                     uint16_t sequence_number2) {
-  return IsNewerSequenceNumber(sequence_number1, sequence_number2)
-             ? sequence_number1
-             : sequence_number2;
+template <typename U>
+constexpr U Latest(U value1, U value2) {
+  return IsNewer(value1, value2) ? value1 : value2;
+}
+
+constexpr uint16_t LatestSequenceNumber(uint16_t sequence_number1,
+                                        uint16_t sequence_number2) {
+  return Latest(sequence_number1, sequence_number2);
+}
+
+constexpr uint32_t LatestTimestamp(uint32_t timestamp1, uint32_t timestamp2) {
+  return Latest(timestamp1, timestamp2);
 }
 
-inline uint32_t LatestTimestamp(uint32_t timestamp1, uint32_t timestamp2) {
-  return IsNewerTimestamp(timestamp1, timestamp2) ? timestamp1 : timestamp2;
+// 数组中最新的值。要求所有值彼此相差不到半程(同一个反馈中的序号都满足), 此时结果
+// 与依次调用Latest()相同。按与values[0]的有符号距离取最大值, 循环没有依赖IsNewer
+// 的分支, 编译器可以向量化。
+template <typename U>
+inline U NewestOf(const U* values, size_t size) {
+  typedef typename std::make_signed<U>::type S;
+  if (size == 0)
+    return 0;
+  const U first = values[0];
+  S max_distance = 0;
+  for (size_t i = 1; i < size; ++i) {
+    S distance = static_cast<S>(static_cast<U>(values[i] - first));
+    max_distance = distance > max_distance ? distance : max_distance;
+  }
+  return static_cast<U>(first + max_distance);
+}
+
+// 按回绕顺序从旧到新排序, 前提同NewestOf()。
+// IsNewer不是严格弱序, 不能直接作为比较函数, 这里按与最新值的距离排序。
+template <typename U>
+inline void SortByWrappingOrder(U* values, size_t size) {
+  const U newest = NewestOf(values, size);
+  std::sort(values, values + size, [newest](U a, U b) {
+    return static_cast<U>(newest - a) > static_cast<U>(newest - b);
+  });
+}
+
+namespace internal {
+
+// 批量unwrap的快速路径: 从*last开始, 只要相邻两个值的差(模2^16)小于0x8000,
+// 即每个值都比前一个新或者相等, unwrap结果就是前缀和。遇到第一个不满足的值停下,
+// 返回处理的个数, *last更新为最后一个结果。
+// 有SSE2时一次处理8个值: 差值在16位上计算, 前缀和扩展到32位再加到64位的*last上。
+inline size_t UnwrapIncreasingRun(const uint16_t* values, size_t size,
+                                  int64_t* last, int64_t* unwrapped) {
+  size_t i = 0;
+  int64_t last_value = *last;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= size; i += 8) {
+    __m128i current =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    // 每个lane的前一个值, lane 0是上一批的最后一个值
+    __m128i previous = _mm_or_si128(
+        _mm_slli_si128(current, 2),
+        _mm_cvtsi32_si128(static_cast<uint16_t>(last_value)));
+    __m128i deltas = _mm_sub_epi16(current, previous);
+    // 有差值>=0x8000(变旧或者半程)时交给逐个Unwrap
+    if (_mm_movemask_epi8(deltas) & 0xAAAA)
+      break;
+
+    __m128i sum_lo = _mm_unpacklo_epi16(deltas, zero);
+    __m128i sum_hi = _mm_unpackhi_epi16(deltas, zero);
+    sum_lo = _mm_add_epi32(sum_lo, _mm_slli_si128(sum_lo, 4));
+    sum_lo = _mm_add_epi32(sum_lo, _mm_slli_si128(sum_lo, 8));
+    sum_hi = _mm_add_epi32(sum_hi, _mm_slli_si128(sum_hi, 4));
+    sum_hi = _mm_add_epi32(sum_hi, _mm_slli_si128(sum_hi, 8));
+    sum_hi = _mm_add_epi32(sum_hi, _mm_shuffle_epi32(sum_lo, 0xFF));
+
+    const __m128i base = _mm_set1_epi64x(last_value);
+    __m128i* out = reinterpret_cast<__m128i*>(unwrapped + i);
+    _mm_storeu_si128(out + 0,
+                     _mm_add_epi64(base, _mm_unpacklo_epi32(sum_lo, zero)));
+    _mm_storeu_si128(out + 1,
+                     _mm_add_epi64(base, _mm_unpackhi_epi32(sum_lo, zero)));
+    _mm_storeu_si128(out + 2,
+                     _mm_add_epi64(base, _mm_unpacklo_epi32(sum_hi, zero)));
+    _mm_storeu_si128(out + 3,
+                     _mm_add_epi64(base, _mm_unpackhi_epi32(sum_hi, zero)));
+    last_value = unwrapped[i + 7];
+  }
+#endif
+  for (; i < size; ++i) {
+    uint16_t delta = values[i] - static_cast<uint16_t>(last_value);
+    if (delta >= 0x8000)
+      break;
+    last_value += delta;
+    unwrapped[i] = last_value;
+  }
+  *last = last_value;
+  return i;
 }
 
+// 其它类型没有快速路径
+template <typename U>
+inline size_t UnwrapIncreasingRun(const U* /* values */, size_t /* size */,
+                                  int64_t* /* last */,
+                                  int64_t* /* unwrapped */) {
+  return 0;
+}
+
+}  // namespace internal
+
 // 将数字解封装得到更大的类型的数字
 // Utility class to unwrap a number to a larger type. The numbers will never be
 // unwrapped to a negative value.
@@ -126,6 +223,21 @@ class Unwrapper {
     return unwrapped;
   }
 
+  // 批量unwrap |size|个值到|unwrapped|, 结果和依次调用Unwrap()完全相同。
+  // 连续变新的一段(反馈中的序号通常如此)按差值的前缀和计算, 遇到变旧(乱序)
+  // 或者相差半程的值时退回逐个Unwrap()。
+  void UnwrapBatch(const U* values, size_t size, int64_t* unwrapped) {
+    size_t i = 0;
+    while (i < size) {
+      i += internal::UnwrapIncreasingRun(values + i, size - i, &last_value_,
+                                         unwrapped + i);
+      if (i < size) {
+        unwrapped[i] = Unwrap(values[i]);
+        ++i;
+      }
+    }
+  }
+
  private:
   // absl::optional<int64_t> last_value_;
   int64_t last_value_ = 0;
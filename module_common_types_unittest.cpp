@@ -7,10 +7,63 @@
 * @brief 
 *****************************************************************/
 
+// g++ module_common_types_unittest.cpp random.cpp -std=c++11 -O2
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <vector>
 
 #include "module_common_types_public.h"
+#include "random.h"
+using namespace std;
 using namespace webrtc;
 
+// 编译期测试
+// Equal
+static_assert(!IsNewerSequenceNumber(0x0001, 0x0001), "");
+// NoWrap
+static_assert(IsNewerSequenceNumber(0xFFFF, 0xFFFE), "");
+static_assert(IsNewerSequenceNumber(0x0001, 0x0000), "");
+static_assert(IsNewerSequenceNumber(0x0100, 0x00FF), "");
+// ForwardWrap: 向前回绕认为是新的数字
+static_assert(IsNewerSequenceNumber(0x0000, 0xFFFF), "");
+static_assert(IsNewerSequenceNumber(0x0000, 0xFF00), "");
+static_assert(IsNewerSequenceNumber(0x00FF, 0xFFFF), "");
+static_assert(IsNewerSequenceNumber(0x00FF, 0xFF00), "");
+// BackwardWrap: 向后回绕认为不是新的数字
+static_assert(!IsNewerSequenceNumber(0xFFFF, 0x0000), "");
+static_assert(!IsNewerSequenceNumber(0xFF00, 0x0000), "");
+static_assert(!IsNewerSequenceNumber(0xFFFF, 0x00FF), "");
+static_assert(!IsNewerSequenceNumber(0xFF00, 0x00FF), "");
+// HalfWayApart: 正好半程时大的数字是新的
+static_assert(IsNewerSequenceNumber(0x8000, 0x0000), "");
+static_assert(!IsNewerSequenceNumber(0x0000, 0x8000), "");
+static_assert(IsNewerSequenceNumber(0x8001, 0x0001), "");
+static_assert(!IsNewerSequenceNumber(0x0001, 0x8001), "");
+
+static_assert(WrappingBreakpoint<uint8_t>() == 0x80, "");
+static_assert(WrappingBreakpoint<uint16_t>() == 0x8000, "");
+static_assert(WrappingBreakpoint<uint32_t>() == 0x80000000, "");
+static_assert(!IsNewerTimestamp(0x12345678, 0x12345678), "");
+static_assert(IsNewerTimestamp(0x00000000, 0xFFFFFFFF), "");
+static_assert(!IsNewerTimestamp(0xFFFFFFFF, 0x00000000), "");
+static_assert(IsNewerTimestamp(0x80000000, 0x00000000), "");
+static_assert(!IsNewerTimestamp(0x00000000, 0x80000000), "");
+static_assert(IsNewerTimestamp(0x7FFFFFFF, 0x00000000), "");
+static_assert(!IsNewerTimestamp(0x80000001, 0x00000000), "");
+
+static_assert(LatestSequenceNumber(0xFFFF, 0xFFFE) == 0xFFFF, "");
+static_assert(LatestSequenceNumber(0x0001, 0x0000) == 0x0001, "");
+static_assert(LatestSequenceNumber(0x0100, 0x00FF) == 0x0100, "");
+static_assert(LatestSequenceNumber(0xFFFE, 0xFFFF) == 0xFFFF, "");
+static_assert(LatestSequenceNumber(0x0000, 0x0001) == 0x0001, "");
+static_assert(LatestSequenceNumber(0x00FF, 0x0100) == 0x0100, "");
+static_assert(LatestSequenceNumber(0x0000, 0xFFFF) == 0x0000, "");
+static_assert(LatestSequenceNumber(0xFFFF, 0x0000) == 0x0000, "");
+static_assert(LatestTimestamp(0xFFFFFF00, 0x00000010) == 0x00000010, "");
+static_assert(LatestTimestamp(0x00000010, 0xFFFFFF00) == 0x00000010, "");
+
 void TestSequenceNumberUnwrapper01() {
     int64_t seq = 0;
     SequenceNumberUnwrapper unwrapper;
@@ -62,50 +115,197 @@ void TestSequenceNumberUnwrapper02() {
 #endif
 }
 
+// 随机序列: 连续递增为主, 夹杂重复、乱序、大跳和回绕
+template <typename U>
+static std::vector<U> RandomSequence(Random* random, size_t size) {
+    std::vector<U> values(size);
+    uint64_t value = random->Rand<uint32_t>();
+    for (size_t i = 0; i < size; ++i) {
+        int kind = random->Rand(0, 99);
+        if (kind < 80) {
+            value += random->Rand(0, 3);
+        } else if (kind < 90) {
+            value -= random->Rand(1, 20);
+        } else if (kind < 95) {
+            value += random->Rand<uint32_t>();
+        } else {
+            // 正好半程, 以及半程附近
+            value += (static_cast<uint64_t>(std::numeric_limits<U>::max()) + 1) / 2 +
+                random->Rand(-1, 1);
+        }
+        values[i] = static_cast<U>(value);
+    }
+    return values;
+}
 
-int main() {
-    // 测试用例
-#if 1
-    cout << "=====Test Equal=====" << endl;
-    cout << "result=" << IsNewerSequenceNumber(0x0001, 0x0001) << endl;
-
-    cout << "=====Test NoWrap=====" << endl;
-    cout << "result=" << IsNewerSequenceNumber(0xFFFF, 0xFFFE) << endl;
-    cout << "result=" << IsNewerSequenceNumber(0x0001, 0x0000) << endl; 
-    cout << "result=" << IsNewerSequenceNumber(0x0100, 0x00FF) << endl; 
-
-    // 向前回绕认为是新的数字
-    // 新的数字远小于前一个数字
-    cout << "=====Test ForwardWrap=====" << endl;
-    cout << "result=" << IsNewerSequenceNumber(0x0000, 0xFFFF) << endl; 
-    cout << "result=" << IsNewerSequenceNumber(0x0000, 0xFF00) << endl;
-    cout << "result=" << IsNewerSequenceNumber(0x00FF, 0xFFFF) << endl;
-    cout << "result=" << IsNewerSequenceNumber(0x00FF, 0xFF00) << endl;
-
-    // 向后回绕认为不是新的数字
-    // 新的数字远大于前一个数字
-    cout << "=====Test BackwardWrap=====" << endl;
-    cout << "result=" << IsNewerSequenceNumber(0xFFFF, 0x0000) << endl;
-    cout << "result=" << IsNewerSequenceNumber(0xFF00, 0x0000) << endl;
-    cout << "result=" << IsNewerSequenceNumber(0xFFFF, 0x00FF) << endl;
-    cout << "result=" << IsNewerSequenceNumber(0xFF00, 0x00FF) << endl;
-
-    cout << "=====Test HalfWayApart=====" << endl;
-    cout << "result=" << IsNewerSequenceNumber(0x8000, 0x0000) << endl;
-    cout << "result=" << IsNewerSequenceNumber(0x0000, 0x8000) << endl;
-#endif
+// 批量unwrap和逐个Unwrap()的结果及内部状态完全一致
+template <typename U>
+static void CheckUnwrapBatch(Random* random) {
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        std::vector<U> values = RandomSequence<U>(random, random->Rand(0, 300));
+        Unwrapper<U> reference;
+        Unwrapper<U> batch;
+        // 一部分从非零状态开始, 包括接近0时不能向后回绕的情况
+        if (random->Rand(0, 1)) {
+            int64_t last = random->Rand(0, 1) ? random->Rand(0, 100) : random->Rand<uint32_t>();
+            reference.UpdateLast(last);
+            batch.UpdateLast(last);
+        }
+        std::vector<int64_t> expected(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+            expected[i] = reference.Unwrap(values[i]);
+
+        // 分成随机长度的几段调用
+        std::vector<int64_t> unwrapped(values.size());
+        size_t begin = 0;
+        while (begin < values.size()) {
+            size_t size = std::min<size_t>(values.size() - begin, random->Rand(1, 64));
+            batch.UnwrapBatch(values.data() + begin, size, unwrapped.data() + begin);
+            begin += size;
+        }
+        assert(unwrapped == expected);
+        assert(batch.UnwrapWithoutUpdate(0) == reference.UnwrapWithoutUpdate(0));
+    }
+}
+
+// UnwrapBatchMatchesUnwrap
+// 随机序列上UnwrapBatch()与逐个Unwrap()一致, 包括uint16_t的SIMD路径和uint32_t
+void TestSequenceNumberUnwrapper03() {
+    Random random(0x40);
+    CheckUnwrapBatch<uint16_t>(&random);
+    CheckUnwrapBatch<uint32_t>(&random);
+    cout << "UnwrapBatch matches Unwrap" << endl;
+}
+
+// Benchmark
+// 反馈中1000个连续序号(1%乱序), 比较逐个Unwrap()和UnwrapBatch()
+void TestSequenceNumberUnwrapper04() {
+    const size_t kNumFeedbacks = 1000;
+    const size_t kPacketsPerFeedback = 1000;
+    std::vector<uint16_t> values(kNumFeedbacks * kPacketsPerFeedback);
+    Random random(0x140);
+    uint16_t seq = 0xF000;
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = seq++;
+        if (random.Rand(0, 99) == 0 && i > 0)
+            std::swap(values[i], values[i - 1]);
+    }
+
+    std::vector<int64_t> expected(values.size());
+    std::vector<int64_t> unwrapped(values.size());
+    int64_t scalar_ns, batch_ns;
+    SequenceNumberUnwrapper unwrapper;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < values.size(); ++i)
+        expected[i] = unwrapper.Unwrap(values[i]);
+    scalar_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    SequenceNumberUnwrapper batch;
+    start = std::chrono::steady_clock::now();
+    for (size_t f = 0; f < kNumFeedbacks; ++f) {
+        batch.UnwrapBatch(values.data() + f * kPacketsPerFeedback, kPacketsPerFeedback,
+                unwrapped.data() + f * kPacketsPerFeedback);
+    }
+    batch_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    assert(unwrapped == expected);
+    cout << "Unwrap=" << static_cast<double>(scalar_ns) / values.size() << "ns/value"
+        << " UnwrapBatch=" << static_cast<double>(batch_ns) / values.size() << "ns/value" << endl;
+}
+
+// 一段彼此相差不到半程的随机值, 模拟一个反馈中乱序的序号
+template <typename U>
+static std::vector<U> RandomWindow(Random* random, size_t size) {
+    const int64_t kWindow = std::min<int64_t>(WrappingBreakpoint<U>() - 1, 3000);
+    std::vector<U> values(size);
+    const U base = static_cast<U>(random->Rand<uint32_t>());
+    for (size_t i = 0; i < size; ++i)
+        values[i] = static_cast<U>(base + random->Rand(0, static_cast<int>(kWindow)));
+    return values;
+}
+
+// 与逐个调用Latest()/IsNewer()的结果一致
+template <typename U>
+static void CheckWindowFunctions(Random* random) {
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        std::vector<U> values = RandomWindow<U>(random, random->Rand(1, 200));
+        U expected = values[0];
+        for (U value : values)
+            expected = Latest(expected, value);
+        assert(NewestOf(values.data(), values.size()) == expected);
+
+        SortByWrappingOrder(values.data(), values.size());
+        assert(values.back() == expected);
+        for (size_t i = 1; i < values.size(); ++i)
+            assert(!IsNewer(values[i - 1], values[i]));
+    }
+}
+
+// NewestOfAndSortByWrappingOrder
+// 回绕附近的随机窗口上, NewestOf()与Latest()折叠一致, 排序后相邻两个不逆序
+void TestIsNewer01() {
+    Random random(0x41);
+    CheckWindowFunctions<uint16_t>(&random);
+    CheckWindowFunctions<uint32_t>(&random);
+    cout << "NewestOf/SortByWrappingOrder match IsNewer" << endl;
+}
 
-/*
-    // NoWrap
-    cout << webrtc::LatestSequenceNumber(0xFFFF, 0xFFFE) << endl;
-    cout << webrtc::LatestSequenceNumber(0x0001, 0x0000) << endl;
-    cout << webrtc::LatestSequenceNumber(0x0100, 0x00FF) << endl;
+// Benchmark
+// 每个反馈100个序号, 比较逐对IsNewer、NewestOf与Latest折叠、排序
+void TestIsNewer02() {
+    const size_t kNumFeedbacks = 20000;
+    const size_t kPacketsPerFeedback = 100;
+    Random random(0x141);
+    std::vector<uint16_t> values;
+    for (size_t f = 0; f < kNumFeedbacks; ++f) {
+        std::vector<uint16_t> window = RandomWindow<uint16_t>(&random, kPacketsPerFeedback);
+        values.insert(values.end(), window.begin(), window.end());
+    }
+    const size_t num_values = values.size();
+
+    size_t num_newer = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 1; i < num_values; ++i)
+        num_newer += IsNewerSequenceNumber(values[i], values[i - 1]);
+    int64_t is_newer_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    uint32_t fold_checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t f = 0; f < kNumFeedbacks; ++f) {
+        const uint16_t* window = values.data() + f * kPacketsPerFeedback;
+        uint16_t newest = window[0];
+        for (size_t i = 1; i < kPacketsPerFeedback; ++i)
+            newest = LatestSequenceNumber(newest, window[i]);
+        fold_checksum += newest;
+    }
+    int64_t fold_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    uint32_t newest_checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t f = 0; f < kNumFeedbacks; ++f)
+        newest_checksum += NewestOf(values.data() + f * kPacketsPerFeedback, kPacketsPerFeedback);
+    int64_t newest_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    assert(newest_checksum == fold_checksum);
 
-    cout << webrtc::LatestSequenceNumber(0xFFFE, 0xFFFF) << endl;
-    cout << webrtc::LatestSequenceNumber(0x0000, 0x0001) << endl;
-    cout << webrtc::LatestSequenceNumber(0x00FF, 0x0100) << endl;
-*/
+    start = std::chrono::steady_clock::now();
+    for (size_t f = 0; f < kNumFeedbacks; ++f)
+        SortByWrappingOrder(values.data() + f * kPacketsPerFeedback, kPacketsPerFeedback);
+    int64_t sort_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
 
+    cout << "newer=" << num_newer
+        << " IsNewer=" << static_cast<double>(is_newer_ns) / num_values << "ns/pair"
+        << " Latest fold=" << static_cast<double>(fold_ns) / num_values << "ns/value"
+        << " NewestOf=" << static_cast<double>(newest_ns) / num_values << "ns/value"
+        << " SortByWrappingOrder=" << static_cast<double>(sort_ns) / num_values << "ns/value"
+        << endl;
+}
+
+int main() {
     // 测试用例
 #if 0
     webrtc::SequenceNumberUnwrapper unwrapper;
@@ -130,6 +330,14 @@ int main() {
     cout << "=====BackwardWraps=====" << endl;
     // TestSequenceNumberUnwrapper02();
 
+    cout << "=====UnwrapBatch=====" << endl;
+    TestSequenceNumberUnwrapper03();
+    TestSequenceNumberUnwrapper04();
+
+    cout << "=====NewestOf/SortByWrappingOrder=====" << endl;
+    TestIsNewer01();
+    TestIsNewer02();
+
     return 0;
 }
 
@@ -0,0 +1,279 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file nack_module.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "nack_module.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace webrtc {
+
+constexpr size_t NackModule::kMaxNackPackets;
+constexpr int NackModule::kMaxNackRetries;
+constexpr int64_t NackModule::kDefaultRttMs;
+constexpr int64_t NackModule::kProcessIntervalMs;
+constexpr int64_t NackModule::kMaxPacketAge;
+constexpr int64_t NackModule::kWindowSize;
+
+NackModule::NackModule(Clock* clock, NackSender* nack_sender,
+        KeyFrameRequestSender* keyframe_request_sender)
+    : _clock(clock),
+    _nack_sender(nack_sender),
+    _keyframe_request_sender(keyframe_request_sender),
+    _initialized(false),
+    _newest_seq_num(0),
+    _rtt_ms(kDefaultRttMs),
+    _next_process_time_ms(-1),
+    _missing(kWindowSize / 64, 0),
+    _num_missing(0) {
+    assert(clock);
+    assert(nack_sender);
+    assert(keyframe_request_sender);
+}
+
+int NackModule::OnReceivedPacket(uint16_t seq_num, bool is_keyframe) {
+    return OnReceivedPacket(seq_num, is_keyframe, false);
+}
+
+int NackModule::OnReceivedPacket(uint16_t seq_num, bool is_keyframe, bool is_recovered) {
+    const int64_t unwrapped = _unwrapper.Unwrap(seq_num);
+    if (!_initialized) {
+        _newest_seq_num = unwrapped;
+        if (is_keyframe)
+            _keyframe_list.insert(unwrapped);
+        _initialized = true;
+        return 0;
+    }
+
+    // Since the |_newest_seq_num| is a packet we have actually received we know
+    // that packet has never been Nacked.
+    if (unwrapped == _newest_seq_num)
+        return 0;
+
+    if (unwrapped < _newest_seq_num) {
+        // An out of order packet has been received.
+        std::deque<NackRun>::iterator run = FindRun(unwrapped);
+        if (run == _runs.end() || ClearMissing(unwrapped, unwrapped + 1) == 0)
+            return 0;
+        const int nacks_sent_for_packet = run->retries;
+        if (--run->num_missing == 0)
+            _runs.erase(run);
+        return nacks_sent_for_packet;
+    }
+
+    // Keep track of new keyframes.
+    if (is_keyframe)
+        _keyframe_list.insert(unwrapped);
+    // And remove old ones so we don't accumulate keyframes.
+    _keyframe_list.erase(_keyframe_list.begin(),
+            _keyframe_list.lower_bound(unwrapped - kMaxPacketAge));
+
+    AddPacketsToNack(_newest_seq_num + 1, unwrapped);
+    _newest_seq_num = unwrapped;
+
+    // Do not send nack for packets recovered by FEC or RTX. 它之前新发现的丢包
+    // 等下一个媒体包或者Process()再发送。
+    if (is_recovered)
+        return 0;
+
+    // Are there any nacks that are waiting for this seq_num.
+    GetNackBatch(true, false);
+    if (!_nack_batch.empty())
+        _nack_sender->SendNack(_nack_batch);
+    return 0;
+}
+
+void NackModule::ClearUpTo(uint16_t seq_num) {
+    if (!_initialized)
+        return;
+    const int64_t unwrapped = _unwrapper.UnwrapWithoutUpdate(seq_num);
+    RemovePacketsBefore(unwrapped);
+    _keyframe_list.erase(_keyframe_list.begin(), _keyframe_list.lower_bound(unwrapped));
+}
+
+void NackModule::Clear() {
+    std::fill(_missing.begin(), _missing.end(), 0);
+    _num_missing = 0;
+    _runs.clear();
+    _keyframe_list.clear();
+}
+
+int64_t NackModule::TimeUntilNextProcess() {
+    return std::max<int64_t>(_next_process_time_ms - _clock->TimeInMilliseconds(), 0);
+}
+
+void NackModule::Process() {
+    GetNackBatch(false, true);
+    if (!_nack_batch.empty())
+        _nack_sender->SendNack(_nack_batch);
+
+    // Update the |_next_process_time_ms| in intervals to achieve
+    // the targeted frequency over time. Also add multiple intervals
+    // in case of a skip in time as to not make uneccessary
+    // calls to Process in order to catch up.
+    const int64_t now_ms = _clock->TimeInMilliseconds();
+    if (_next_process_time_ms == -1) {
+        _next_process_time_ms = now_ms + kProcessIntervalMs;
+    } else {
+        _next_process_time_ms = _next_process_time_ms + kProcessIntervalMs +
+            (now_ms - _next_process_time_ms) / kProcessIntervalMs * kProcessIntervalMs;
+    }
+}
+
+void NackModule::AddPacketsToNack(int64_t begin, int64_t end) {
+    // Remove old packets.
+    RemovePacketsBefore(end - kMaxPacketAge);
+    if (begin >= end)
+        return;
+
+    // If the nack list is too large, remove packets from the nack list until
+    // the latest first packet of a keyframe. If the list is still too large,
+    // clear it and request a keyframe.
+    const size_t num_new_nacks = static_cast<size_t>(end - begin);
+    if (_num_missing + num_new_nacks > kMaxNackPackets) {
+        while (RemovePacketsUntilKeyFrame() && _num_missing + num_new_nacks > kMaxNackPackets) {}
+
+        if (_num_missing + num_new_nacks > kMaxNackPackets) {
+            RemovePacketsBefore(end);
+            // RTC_LOG(LS_WARNING) << "NACK list full, clearing NACK"
+            //     " list and requesting keyframe.";
+            _keyframe_request_sender->RequestKeyFrame();
+            return;
+        }
+    }
+
+    SetMissing(begin, end);
+    // 还没发送过的段状态都一样, 直接延长
+    if (!_runs.empty() && _runs.back().sent_at_time == -1) {
+        _runs.back().end = end;
+        _runs.back().num_missing += num_new_nacks;
+    } else {
+        NackRun run;
+        run.begin = begin;
+        run.end = end;
+        run.num_missing = num_new_nacks;
+        run.sent_at_time = -1;
+        run.retries = 0;
+        _runs.push_back(run);
+    }
+}
+
+bool NackModule::RemovePacketsUntilKeyFrame() {
+    while (!_keyframe_list.empty()) {
+        // We have found a keyframe that actually is newer than at least one
+        // packet in the nack list.
+        if (RemovePacketsBefore(*_keyframe_list.begin()) > 0)
+            return true;
+        // If this keyframe is so old it does not remove any packets from the list,
+        // remove it from the list of keyframes and try the next keyframe.
+        _keyframe_list.erase(_keyframe_list.begin());
+    }
+    return false;
+}
+
+size_t NackModule::RemovePacketsBefore(int64_t seq_num) {
+    size_t num_removed = 0;
+    while (!_runs.empty() && _runs.front().begin < seq_num) {
+        NackRun& run = _runs.front();
+        const int64_t end = std::min(run.end, seq_num);
+        const size_t num_cleared = ClearMissing(run.begin, end);
+        num_removed += num_cleared;
+        run.num_missing -= num_cleared;
+        run.begin = end;
+        if (run.num_missing > 0)
+            break;
+        _runs.pop_front();
+    }
+    return num_removed;
+}
+
+void NackModule::GetNackBatch(bool consider_seq_num, bool consider_timestamp) {
+    _nack_batch.clear();
+    const int64_t now_ms = _clock->TimeInMilliseconds();
+    // 还没发送过的丢包都在最后一段, 只按序号发送时不用检查前面的段
+    size_t num_runs = consider_timestamp || _runs.empty() ? 0 : _runs.size() - 1;
+    for (size_t i = num_runs; i < _runs.size(); ++i) {
+        NackRun run = _runs[i];
+        const bool nack_on_rtt_passed = now_ms - run.sent_at_time >= _rtt_ms;
+        const bool nack_on_seq_num_passed = run.sent_at_time == -1;
+        if ((consider_seq_num && nack_on_seq_num_passed) ||
+                (consider_timestamp && nack_on_rtt_passed)) {
+            ForEachWord(run.begin, run.end, [this](uint64_t& word, uint64_t mask, int64_t seq_num) {
+                uint64_t missing = word & mask;
+                while (missing) {
+                    _nack_batch.push_back(static_cast<uint16_t>(seq_num + __builtin_ctzll(missing)));
+                    missing &= missing - 1;
+                }
+            });
+            ++run.retries;
+            run.sent_at_time = now_ms;
+            if (run.retries >= kMaxNackRetries) {
+                // RTC_LOG(LS_WARNING) << "Sequence numbers [" << run.begin << ", " << run.end
+                //     << ") removed from NACK list due to max retries.";
+                ClearMissing(run.begin, run.end);
+                continue;
+            }
+        }
+
+        // 这次一起发送的相邻段状态相同, 合并
+        if (num_runs > 0 && _runs[num_runs - 1].sent_at_time == run.sent_at_time &&
+                _runs[num_runs - 1].retries == run.retries) {
+            _runs[num_runs - 1].end = run.end;
+            _runs[num_runs - 1].num_missing += run.num_missing;
+        } else {
+            _runs[num_runs++] = run;
+        }
+    }
+    _runs.resize(num_runs);
+}
+
+std::deque<NackModule::NackRun>::iterator NackModule::FindRun(int64_t seq_num) {
+    std::deque<NackRun>::iterator it = std::upper_bound(_runs.begin(), _runs.end(), seq_num,
+            [](int64_t seq, const NackRun& run) { return seq < run.begin; });
+    if (it == _runs.begin())
+        return _runs.end();
+    --it;
+    return seq_num < it->end ? it : _runs.end();
+}
+
+template <typename F>
+void NackModule::ForEachWord(int64_t begin, int64_t end, F f) {
+    assert(end - begin <= kWindowSize);
+    while (begin < end) {
+        const size_t index = static_cast<size_t>(begin & (kWindowSize - 1));
+        const size_t shift = index & 63;
+        const size_t bits = static_cast<size_t>(std::min<int64_t>(64 - shift, end - begin));
+        const uint64_t mask = bits == 64 ? ~uint64_t{0} : ((uint64_t{1} << bits) - 1) << shift;
+        f(_missing[index >> 6], mask, begin - static_cast<int64_t>(shift));
+        begin += bits;
+    }
+}
+
+void NackModule::SetMissing(int64_t begin, int64_t end) {
+    ForEachWord(begin, end, [](uint64_t& word, uint64_t mask, int64_t) {
+        // 新的序号在环上的位置已经在RemovePacketsBefore()中清掉
+        assert((word & mask) == 0);
+        word |= mask;
+    });
+    _num_missing += static_cast<size_t>(end - begin);
+}
+
+size_t NackModule::ClearMissing(int64_t begin, int64_t end) {
+    size_t num_cleared = 0;
+    ForEachWord(begin, end, [&num_cleared](uint64_t& word, uint64_t mask, int64_t) {
+        num_cleared += __builtin_popcountll(word & mask);
+        word &= ~mask;
+    });
+    _num_missing -= num_cleared;
+    return num_cleared;
+}
+
+} // namespace webrtc
+
@@ -0,0 +1,132 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file nack_module.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _NACK_MODULE_H
+#define _NACK_MODULE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <set>
+#include <vector>
+
+#include "clock.h"
+#include "module_common_types_public.h"
+
+namespace webrtc {
+
+class NackSender {
+public:
+    virtual ~NackSender() {}
+    virtual void SendNack(const std::vector<uint16_t>& sequence_numbers) = 0;
+};
+
+class KeyFrameRequestSender {
+public:
+    virtual ~KeyFrameRequestSender() {}
+    virtual void RequestKeyFrame() = 0;
+};
+
+// 视频接收端的NACK列表: 按unwrap后的序号发现丢包, 新发现的丢包立即NACK, 之后每过
+// 一个RTT重发一次, 最多kMaxNackRetries次。
+//
+// 丢包状态是一个按unwrap后的序号索引的滑动位图(kWindowSize位, 环形), 1表示还在
+// 等待重传, 发现/清理/扫描丢包都按64位一个字处理。一起发现、一起发送的丢包重传
+// 状态相同, 这样的一段序号共用一个NackRun(发送时间和次数), 状态相同的相邻段合并,
+// 1000个包的连续丢包只需要1000位加一个NackRun。
+//
+// Note: This class is not thread-safe.
+class NackModule {
+public:
+    // 列表中最多的丢包个数, 超过时先清掉最近关键帧之前的丢包, 仍然超过则清空并请求关键帧
+    static constexpr size_t kMaxNackPackets = 1000;
+    static constexpr int kMaxNackRetries = 10;
+    static constexpr int64_t kDefaultRttMs = 100;
+    static constexpr int64_t kProcessIntervalMs = 20;
+    // 比最新的包旧这么多的丢包不再NACK
+    static constexpr int64_t kMaxPacketAge = 10000;
+    // 位图覆盖的序号个数, 2的幂且大于kMaxPacketAge, 环上不会有两个有效的序号重叠
+    static constexpr int64_t kWindowSize = 1 << 14;
+
+    NackModule(Clock* clock, NackSender* nack_sender,
+            KeyFrameRequestSender* keyframe_request_sender);
+
+    // 返回这个包被NACK过的次数, 可以填到VCMPacket::times_nacked。
+    // |is_recovered|: FEC/RTX恢复的包, 不会因为它立即发送NACK。
+    int OnReceivedPacket(uint16_t seq_num, bool is_keyframe);
+    int OnReceivedPacket(uint16_t seq_num, bool is_keyframe, bool is_recovered);
+
+    // 不再NACK比|seq_num|旧的包
+    void ClearUpTo(uint16_t seq_num);
+    void UpdateRtt(int64_t rtt_ms) { _rtt_ms = rtt_ms; }
+    void Clear();
+
+    // Returns the time in ms until Process() should be called.
+    int64_t TimeUntilNextProcess();
+    // 重发超过一个RTT没有收到的包
+    void Process();
+
+    // 还在等待重传的包数
+    size_t num_missing() const { return _num_missing; }
+    // 当前的NackRun个数, 和位图一起就是全部的丢包状态
+    size_t num_runs() const { return _runs.size(); }
+
+private:
+    // 序号[begin, end)中还在等待重传的包, 它们的发送时间和次数相同
+    struct NackRun {
+        int64_t begin;
+        int64_t end;
+        size_t num_missing;
+        // -1表示还没有发送过
+        int64_t sent_at_time;
+        int retries;
+    };
+
+    void AddPacketsToNack(int64_t begin, int64_t end);
+    // 清掉最老的关键帧之前的丢包, 它之前没有丢包时换下一个关键帧; 都没有清掉返回false
+    bool RemovePacketsUntilKeyFrame();
+    // 清掉序号比|seq_num|小的丢包, 返回清掉的个数
+    size_t RemovePacketsBefore(int64_t seq_num);
+    // |consider_seq_num|: 还没发送过的包; |consider_timestamp|: 上次发送已经超过一个RTT的包。
+    // 结果放在_nack_batch。
+    void GetNackBatch(bool consider_seq_num, bool consider_timestamp);
+    // 包含|seq_num|的NackRun, 没有返回_runs.end()
+    std::deque<NackRun>::iterator FindRun(int64_t seq_num);
+
+    // 对位图中序号[begin, end)按字调用f(word, mask, seq), seq是这个字第0位的序号
+    template <typename F>
+    void ForEachWord(int64_t begin, int64_t end, F f);
+    void SetMissing(int64_t begin, int64_t end);
+    // 返回清掉的丢包个数
+    size_t ClearMissing(int64_t begin, int64_t end);
+
+    Clock* const _clock;
+    NackSender* const _nack_sender;
+    KeyFrameRequestSender* const _keyframe_request_sender;
+
+    SequenceNumberUnwrapper _unwrapper;
+    bool _initialized;
+    int64_t _newest_seq_num;
+    int64_t _rtt_ms;
+    int64_t _next_process_time_ms;
+
+    std::vector<uint64_t> _missing;
+    size_t _num_missing;
+    // 按序号排列, 互不重叠, 每个都至少有一个丢包
+    std::deque<NackRun> _runs;
+    std::set<int64_t> _keyframe_list;
+    std::vector<uint16_t> _nack_batch;
+};
+
+} // namespace webrtc
+
+#endif // _NACK_MODULE_H
+
@@ -0,0 +1,422 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file nack_module_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ nack_module_unittest.cpp nack_module.cpp random.cpp -std=c++11 -O2
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+using namespace std;
+
+#include "clock.h"
+#include "nack_module.h"
+#include "random.h"
+
+using namespace webrtc;
+
+class RecordingNackSender : public NackSender, public KeyFrameRequestSender {
+public:
+    RecordingNackSender() : _num_keyframe_requests(0) {}
+
+    void SendNack(const std::vector<uint16_t>& sequence_numbers) override {
+        _batches.push_back(sequence_numbers);
+    }
+    void RequestKeyFrame() override { ++_num_keyframe_requests; }
+
+    std::vector<std::vector<uint16_t>> _batches;
+    int _num_keyframe_requests;
+};
+
+// 逐包保存状态的NACK列表(std::map), 与NackModule的输出逐次比较, 也是基准测试的对照
+class ReferenceNackModule {
+public:
+    ReferenceNackModule(Clock* clock, NackSender* nack_sender,
+            KeyFrameRequestSender* keyframe_request_sender)
+        : _clock(clock),
+        _nack_sender(nack_sender),
+        _keyframe_request_sender(keyframe_request_sender),
+        _initialized(false),
+        _newest_seq_num(0),
+        _rtt_ms(NackModule::kDefaultRttMs),
+        _next_process_time_ms(-1) {}
+
+    int OnReceivedPacket(uint16_t seq_num, bool is_keyframe, bool is_recovered) {
+        const int64_t unwrapped = _unwrapper.Unwrap(seq_num);
+        if (!_initialized) {
+            _newest_seq_num = unwrapped;
+            if (is_keyframe)
+                _keyframe_list.insert(unwrapped);
+            _initialized = true;
+            return 0;
+        }
+        if (unwrapped == _newest_seq_num)
+            return 0;
+        if (unwrapped < _newest_seq_num) {
+            auto it = _nack_list.find(unwrapped);
+            if (it == _nack_list.end())
+                return 0;
+            const int retries = it->second.retries;
+            _nack_list.erase(it);
+            return retries;
+        }
+        if (is_keyframe)
+            _keyframe_list.insert(unwrapped);
+        _keyframe_list.erase(_keyframe_list.begin(),
+                _keyframe_list.lower_bound(unwrapped - NackModule::kMaxPacketAge));
+        AddPacketsToNack(_newest_seq_num + 1, unwrapped);
+        _newest_seq_num = unwrapped;
+        if (is_recovered)
+            return 0;
+        GetNackBatch(true, false);
+        return 0;
+    }
+
+    void ClearUpTo(uint16_t seq_num) {
+        if (!_initialized)
+            return;
+        const int64_t unwrapped = _unwrapper.UnwrapWithoutUpdate(seq_num);
+        _nack_list.erase(_nack_list.begin(), _nack_list.lower_bound(unwrapped));
+        _keyframe_list.erase(_keyframe_list.begin(), _keyframe_list.lower_bound(unwrapped));
+    }
+
+    int64_t TimeUntilNextProcess() {
+        return std::max<int64_t>(_next_process_time_ms - _clock->TimeInMilliseconds(), 0);
+    }
+
+    void Process() {
+        GetNackBatch(false, true);
+        const int64_t now_ms = _clock->TimeInMilliseconds();
+        const int64_t interval_ms = NackModule::kProcessIntervalMs;
+        if (_next_process_time_ms == -1) {
+            _next_process_time_ms = now_ms + interval_ms;
+        } else {
+            _next_process_time_ms = _next_process_time_ms + interval_ms +
+                (now_ms - _next_process_time_ms) / interval_ms * interval_ms;
+        }
+    }
+
+    size_t num_missing() const { return _nack_list.size(); }
+    // 每个丢包一项
+    size_t num_runs() const { return _nack_list.size(); }
+
+private:
+    struct NackInfo {
+        int64_t sent_at_time;
+        int retries;
+    };
+
+    void AddPacketsToNack(int64_t begin, int64_t end) {
+        _nack_list.erase(_nack_list.begin(),
+                _nack_list.lower_bound(end - NackModule::kMaxPacketAge));
+        if (begin >= end)
+            return;
+        const size_t num_new_nacks = static_cast<size_t>(end - begin);
+        if (_nack_list.size() + num_new_nacks > NackModule::kMaxNackPackets) {
+            while (RemovePacketsUntilKeyFrame() &&
+                    _nack_list.size() + num_new_nacks > NackModule::kMaxNackPackets) {}
+            if (_nack_list.size() + num_new_nacks > NackModule::kMaxNackPackets) {
+                _nack_list.clear();
+                _keyframe_request_sender->RequestKeyFrame();
+                return;
+            }
+        }
+        for (int64_t seq_num = begin; seq_num < end; ++seq_num) {
+            NackInfo info;
+            info.sent_at_time = -1;
+            info.retries = 0;
+            _nack_list[seq_num] = info;
+        }
+    }
+
+    bool RemovePacketsUntilKeyFrame() {
+        while (!_keyframe_list.empty()) {
+            auto it = _nack_list.lower_bound(*_keyframe_list.begin());
+            if (it != _nack_list.begin()) {
+                _nack_list.erase(_nack_list.begin(), it);
+                return true;
+            }
+            _keyframe_list.erase(_keyframe_list.begin());
+        }
+        return false;
+    }
+
+    void GetNackBatch(bool consider_seq_num, bool consider_timestamp) {
+        std::vector<uint16_t> nack_batch;
+        const int64_t now_ms = _clock->TimeInMilliseconds();
+        auto it = _nack_list.begin();
+        while (it != _nack_list.end()) {
+            const bool nack_on_rtt_passed = now_ms - it->second.sent_at_time >= _rtt_ms;
+            const bool nack_on_seq_num_passed = it->second.sent_at_time == -1;
+            if ((consider_seq_num && nack_on_seq_num_passed) ||
+                    (consider_timestamp && nack_on_rtt_passed)) {
+                nack_batch.push_back(static_cast<uint16_t>(it->first));
+                ++it->second.retries;
+                it->second.sent_at_time = now_ms;
+                if (it->second.retries >= NackModule::kMaxNackRetries) {
+                    it = _nack_list.erase(it);
+                    continue;
+                }
+            }
+            ++it;
+        }
+        if (!nack_batch.empty())
+            _nack_sender->SendNack(nack_batch);
+    }
+
+    Clock* const _clock;
+    NackSender* const _nack_sender;
+    KeyFrameRequestSender* const _keyframe_request_sender;
+    SequenceNumberUnwrapper _unwrapper;
+    bool _initialized;
+    int64_t _newest_seq_num;
+    int64_t _rtt_ms;
+    int64_t _next_process_time_ms;
+    std::map<int64_t, NackInfo> _nack_list;
+    std::set<int64_t> _keyframe_list;
+};
+
+// 接收端的一次调用
+struct NackEvent {
+    enum Type { kPacket, kProcess, kClearUpTo };
+    Type type;
+    int64_t time_ms;
+    uint16_t seq_num;
+    bool is_keyframe;
+    bool is_recovered;
+};
+
+// 模拟2ms发一个包、单程20~30ms(会乱序)、RTT约100ms的链路, |loss_percent|的随机丢包,
+// 重传包同样会丢, 丢包中有十分之一被FEC恢复; 每10000个包有一次600或1200个包的断流
+// (后者超过kMaxNackPackets)。每3000个包一个关键帧, 每50个包ClearUpTo()到300个包之前。
+// 记录接收端的调用序列, 回放给不同的实现。
+static void GenerateTrace(uint32_t seed, int loss_percent, size_t num_packets,
+        std::vector<NackEvent>* trace) {
+    Random random(seed);
+    SimulatedClock clock(0);
+    RecordingNackSender sender;
+    NackModule nack_module(&clock, &sender, &sender);
+    std::multimap<int64_t, NackEvent> in_flight;
+    uint16_t seq_num = 0xFF00;
+
+    auto receive = [&](const NackEvent& event) {
+        trace->push_back(event);
+        if (event.type == NackEvent::kPacket)
+            nack_module.OnReceivedPacket(event.seq_num, event.is_keyframe, event.is_recovered);
+        else if (event.type == NackEvent::kProcess)
+            nack_module.Process();
+        else
+            nack_module.ClearUpTo(event.seq_num);
+        // 发送端收到NACK后重传
+        for (const std::vector<uint16_t>& batch : sender._batches) {
+            for (uint16_t nacked : batch) {
+                if (static_cast<int>(random.Rand(0, 99)) < loss_percent)
+                    continue;
+                NackEvent retransmission = {NackEvent::kPacket, 0, nacked, false, false};
+                in_flight.insert(std::make_pair(event.time_ms + 95 + random.Rand(0, 10), retransmission));
+            }
+        }
+        sender._batches.clear();
+    };
+
+    for (size_t i = 0; i < num_packets; ++i) {
+        const int64_t now_ms = clock.TimeInMilliseconds();
+        const size_t burst_length = (i / 10000) % 2 == 0 ? 600 : 1200;
+        const bool in_outage = i % 10000 >= 5000 && i % 10000 < 5000 + burst_length;
+        NackEvent packet = {NackEvent::kPacket, 0, seq_num, i % 3000 == 0, false};
+        if (!in_outage && static_cast<int>(random.Rand(0, 99)) >= loss_percent) {
+            in_flight.insert(std::make_pair(now_ms + 20 + random.Rand(0, 10), packet));
+        } else if (!in_outage && random.Rand(0, 9) == 0) {
+            packet.is_recovered = true;
+            in_flight.insert(std::make_pair(now_ms + 40, packet));
+        }
+        ++seq_num;
+
+        while (!in_flight.empty() && in_flight.begin()->first <= now_ms) {
+            NackEvent event = in_flight.begin()->second;
+            event.time_ms = now_ms;
+            in_flight.erase(in_flight.begin());
+            receive(event);
+        }
+        if (nack_module.TimeUntilNextProcess() == 0) {
+            NackEvent event = {NackEvent::kProcess, now_ms, 0, false, false};
+            receive(event);
+        }
+        if (i % 50 == 49) {
+            NackEvent event = {NackEvent::kClearUpTo, now_ms, static_cast<uint16_t>(seq_num - 300),
+                false, false};
+            receive(event);
+        }
+        clock.AdvanceTimeMilliseconds(2);
+    }
+}
+
+template <typename Module>
+static int Replay(SimulatedClock* clock, Module* module, const NackEvent& event) {
+    clock->AdvanceTimeMilliseconds(event.time_ms - clock->TimeInMilliseconds());
+    if (event.type == NackEvent::kPacket)
+        return module->OnReceivedPacket(event.seq_num, event.is_keyframe, event.is_recovered);
+    if (event.type == NackEvent::kProcess)
+        module->Process();
+    else
+        module->ClearUpTo(event.seq_num);
+    return 0;
+}
+
+// Basic
+// 发现丢包立即NACK, 每过一个RTT重发, 重传包返回NACK次数; 超过kMaxNackRetries不再NACK;
+// 序号回绕; 丢包过多时清掉关键帧之前的丢包, 仍然过多则请求关键帧
+void TestNackModule01() {
+    SimulatedClock clock(0);
+    RecordingNackSender sender;
+    NackModule nack_module(&clock, &sender, &sender);
+
+    nack_module.OnReceivedPacket(65534, false);
+    nack_module.OnReceivedPacket(65535, false);
+    nack_module.OnReceivedPacket(2, false);
+    assert(sender._batches.size() == 1);
+    assert((sender._batches[0] == std::vector<uint16_t>{0, 1}));
+    assert(nack_module.num_missing() == 2 && nack_module.num_runs() == 1);
+
+    // 没到一个RTT不重发
+    nack_module.Process();
+    assert(sender._batches.size() == 1);
+    clock.AdvanceTimeMilliseconds(NackModule::kDefaultRttMs);
+    nack_module.Process();
+    assert(sender._batches.size() == 2 && sender._batches[1].size() == 2);
+    assert(nack_module.OnReceivedPacket(1, false) == 2);
+    assert(nack_module.num_missing() == 1);
+
+    nack_module.UpdateRtt(10);
+    for (int i = 0; i < NackModule::kMaxNackRetries; ++i) {
+        clock.AdvanceTimeMilliseconds(10);
+        nack_module.Process();
+    }
+    // 第一次发送加上kMaxNackRetries - 1次重发
+    assert(sender._batches.size() == static_cast<size_t>(NackModule::kMaxNackRetries));
+    assert(nack_module.num_missing() == 0 && nack_module.num_runs() == 0);
+    assert(nack_module.OnReceivedPacket(0, false) == 0);
+
+    // 1000个包的断流: 1000位加一个NackRun
+    sender._batches.clear();
+    nack_module.OnReceivedPacket(1003, true);
+    assert(nack_module.num_missing() == 1000 && nack_module.num_runs() == 1);
+    assert(sender._batches.size() == 1 && sender._batches[0].size() == 1000);
+    // 再丢10个包超过kMaxNackPackets, 关键帧1003之前的丢包被清掉
+    nack_module.OnReceivedPacket(1014, false);
+    assert(nack_module.num_missing() == 10 && sender._num_keyframe_requests == 0);
+    // 关键帧之后丢1001个包, 只能清空并请求关键帧
+    nack_module.OnReceivedPacket(2016, false);
+    assert(nack_module.num_missing() == 0 && sender._num_keyframe_requests == 1);
+
+    nack_module.OnReceivedPacket(2020, false);
+    // 2017~2019丢失, 清掉2017
+    nack_module.ClearUpTo(2018);
+    assert(nack_module.num_missing() == 2);
+    cout << "basic ok" << endl;
+}
+
+// RandomTrace
+// 1%~20%丢包的调用序列回放给NackModule和逐包保存状态的参照实现, 每次调用的返回值、
+// 发出的NACK和关键帧请求都相同
+void TestNackModule02() {
+    const int kLossPercents[] = {1, 5, 10, 20};
+    for (int loss_percent : kLossPercents) {
+        std::vector<NackEvent> trace;
+        GenerateTrace(0x45 + loss_percent, loss_percent, 50000, &trace);
+
+        SimulatedClock clock(0), reference_clock(0);
+        RecordingNackSender sender, reference_sender;
+        NackModule nack_module(&clock, &sender, &sender);
+        ReferenceNackModule reference(&reference_clock, &reference_sender, &reference_sender);
+        size_t num_nacks = 0;
+        for (const NackEvent& event : trace) {
+            int retries = Replay(&clock, &nack_module, event);
+            int reference_retries = Replay(&reference_clock, &reference, event);
+            assert(retries == reference_retries);
+            assert(sender._batches == reference_sender._batches);
+            assert(nack_module.num_missing() == reference.num_missing());
+            for (const std::vector<uint16_t>& batch : sender._batches)
+                num_nacks += batch.size();
+            sender._batches.clear();
+            reference_sender._batches.clear();
+            (void)retries;
+            (void)reference_retries;
+        }
+        assert(sender._num_keyframe_requests == reference_sender._num_keyframe_requests);
+        assert(sender._num_keyframe_requests > 0);
+        cout << "loss=" << loss_percent << "% events=" << trace.size() << " nacks=" << num_nacks
+            << " keyframe_requests=" << sender._num_keyframe_requests << endl;
+    }
+}
+
+class CountingNackSender : public NackSender, public KeyFrameRequestSender {
+public:
+    CountingNackSender() : _num_nacks(0) {}
+    void SendNack(const std::vector<uint16_t>& sequence_numbers) override {
+        _num_nacks += sequence_numbers.size();
+    }
+    void RequestKeyFrame() override {}
+    size_t _num_nacks;
+};
+
+template <typename Module>
+static int64_t TimeReplay(const std::vector<NackEvent>& trace, size_t* num_nacks,
+        size_t* peak_missing, size_t* peak_runs) {
+    SimulatedClock clock(0);
+    CountingNackSender sender;
+    Module module(&clock, &sender, &sender);
+    *peak_missing = 0;
+    *peak_runs = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const NackEvent& event : trace) {
+        Replay(&clock, &module, event);
+        *peak_missing = std::max(*peak_missing, module.num_missing());
+        *peak_runs = std::max(*peak_runs, module.num_runs());
+    }
+    int64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    *num_nacks = sender._num_nacks;
+    return elapsed_ns;
+}
+
+// Benchmark
+// 1%~20%丢包时每次调用的耗时, 位图+NackRun与逐包std::map比较; 另外统计最多的丢包数
+// 和NackRun个数(std::map每个丢包一个节点)
+void TestNackModule03() {
+    const int kLossPercents[] = {1, 5, 10, 20};
+    for (int loss_percent : kLossPercents) {
+        std::vector<NackEvent> trace;
+        GenerateTrace(0x4500 + loss_percent, loss_percent, 400000, &trace);
+
+        size_t num_nacks, reference_num_nacks, peak_missing, reference_peak_missing;
+        size_t peak_runs, reference_peak_runs;
+        int64_t bitmap_ns = TimeReplay<NackModule>(trace, &num_nacks, &peak_missing, &peak_runs);
+        int64_t map_ns = TimeReplay<ReferenceNackModule>(trace, &reference_num_nacks,
+                &reference_peak_missing, &reference_peak_runs);
+        assert(num_nacks == reference_num_nacks && peak_missing == reference_peak_missing);
+        (void)reference_num_nacks;
+
+        cout << "loss=" << loss_percent << "% events=" << trace.size()
+            << " peak_missing=" << peak_missing << " peak_runs=" << peak_runs
+            << " bitmap=" << static_cast<double>(bitmap_ns) / trace.size() << "ns/event"
+            << " map=" << static_cast<double>(map_ns) / trace.size() << "ns/event" << endl;
+    }
+}
+
+int main() {
+    TestNackModule01();
+    TestNackModule02();
+    TestNackModule03();
+
+    return 0;
+}
+
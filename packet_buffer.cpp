@@ -0,0 +1,490 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file packet_buffer.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "packet_buffer.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "module_common_types_public.h"
+
+namespace webrtc {
+
+namespace video_coding {
+
+namespace {
+
+size_t NumGroups(size_t size) {
+    return (size + 63) / 64;
+}
+
+// 组内从第|shift|位开始的|bits|位
+uint64_t RangeMask(size_t shift, size_t bits) {
+    return bits == 64 ? ~uint64_t{0} : ((uint64_t{1} << bits) - 1) << shift;
+}
+
+} // namespace
+
+constexpr size_t PacketBuffer::kSplitGroupsPerInsert;
+
+std::shared_ptr<PacketBuffer> PacketBuffer::Create(Clock* clock, size_t start_buffer_size,
+        size_t max_buffer_size, OnReceivedFrameCallback* frame_callback) {
+    return std::shared_ptr<PacketBuffer>(
+            new PacketBuffer(clock, start_buffer_size, max_buffer_size, frame_callback));
+}
+
+PacketBuffer::PacketBuffer(Clock* clock, size_t start_buffer_size, size_t max_buffer_size,
+        OnReceivedFrameCallback* frame_callback)
+    : _clock(clock),
+    _max_size(max_buffer_size),
+    _size(start_buffer_size),
+    _num_split_groups(0),
+    _split_cursor(0),
+    _first_packet_received(false),
+    _first_seq_num(0),
+    _is_cleared_to_first_seq_num(false),
+    _last_received_packet_ms(-1),
+    _last_received_keyframe_packet_ms(-1),
+    _received_frame_callback(frame_callback) {
+    assert(start_buffer_size <= max_buffer_size);
+    // Buffer size must always be a power of 2.
+    assert((start_buffer_size & (start_buffer_size - 1)) == 0);
+    assert((max_buffer_size & (max_buffer_size - 1)) == 0);
+    _groups.reserve(NumGroups(max_buffer_size));
+    // 值初始化, 状态位清零
+    for (size_t i = 0; i < NumGroups(start_buffer_size); ++i)
+        _groups.emplace_back(new SlotGroup());
+}
+
+PacketBuffer::~PacketBuffer() {
+    Clear();
+}
+
+bool PacketBuffer::InsertPacket(VCMPacket* packet) {
+    std::vector<std::unique_ptr<RtpFrameObject>> found_frames;
+    {
+        if (packet->payload_buffer.empty() && packet->data_ptr) {
+            packet->payload_buffer = PayloadBuffer::Adopt(const_cast<uint8_t*>(packet->data_ptr),
+                    packet->size_bytes);
+        }
+
+        if (growing())
+            ContinueGrowing(kSplitGroupsPerInsert);
+
+        const uint16_t seq_num = packet->seq_num;
+
+        // If we have explicitly cleared past this packet then it's old,
+        // don't insert it.
+        if (_first_packet_received && _is_cleared_to_first_seq_num &&
+                IsNewerSequenceNumber(_first_seq_num, seq_num)) {
+            ReleasePayload(packet);
+            return false;
+        }
+
+        if (!MakeRoomFor(seq_num)) {
+            if (growing()) {
+                // 这次扩容还没完成, 丢弃这个包, 缓冲区里的包保留
+                ReleasePayload(packet);
+                return false;
+            }
+            // Clear the buffer, delete payload, and return false to signal
+            // that a new keyframe is needed.
+            // RTC_LOG(LS_WARNING) << "Clear PacketBuffer and request key frame.";
+            Clear();
+            ReleasePayload(packet);
+            return false;
+        }
+
+        if (!_first_packet_received) {
+            _first_seq_num = seq_num;
+            _first_packet_received = true;
+        } else if (IsNewerSequenceNumber(_first_seq_num, seq_num)) {
+            _first_seq_num = seq_num;
+        }
+
+        const size_t index = Index(seq_num);
+        if (TestBit(kUsed, index)) {
+            // Duplicate packet, just delete the payload.
+            ReleasePayload(packet);
+            return true;
+        }
+
+        const int64_t now_ms = _clock->TimeInMilliseconds();
+        _last_received_packet_ms = now_ms;
+        if (packet->frame_type == kVideoFrameKey)
+            _last_received_keyframe_packet_ms = now_ms;
+
+        SetBit(kUsed, index, true);
+        SetBit(kFrameBegin, index, packet->is_first_packet_in_frame);
+        SetBit(kFrameEnd, index, packet->marker_bit);
+        SetBit(kContinuous, index, false);
+        SetBit(kFrameCreated, index, false);
+        Packet(index) = std::move(*packet);
+        packet->data_ptr = nullptr;
+        UpdateLinked(index);
+
+        FindFrames(seq_num, &found_frames);
+    }
+
+    for (std::unique_ptr<RtpFrameObject>& frame : found_frames)
+        _received_frame_callback->OnReceivedFrame(std::move(frame));
+
+    return true;
+}
+
+void PacketBuffer::ClearTo(uint16_t seq_num) {
+    // We have already cleared past this sequence number, no need to do anything.
+    if (_is_cleared_to_first_seq_num && IsNewerSequenceNumber(_first_seq_num, seq_num))
+        return;
+
+    // If the packet buffer was cleared between a frame was created and returned.
+    if (!_first_packet_received)
+        return;
+
+    ++seq_num;
+    const size_t diff = static_cast<uint16_t>(seq_num - _first_seq_num);
+    if (diff < _size) {
+        ForEachSlotRun(_first_seq_num, diff,
+                [this, seq_num](uint16_t, size_t index, uint64_t mask) {
+            uint64_t used = Bits(index).words[kUsed] & mask;
+            while (used) {
+                const size_t slot = (index & ~static_cast<size_t>(63)) + __builtin_ctzll(used);
+                used &= used - 1;
+                if (IsNewerSequenceNumber(seq_num, Packet(slot).seq_num))
+                    ClearSlot(slot);
+            }
+        });
+    } else {
+        // 超过一圈时已拆分的组两半都要检查, 直接遍历所有有包的槽位
+        ForEachUsedSlot([this, seq_num](size_t index) {
+            if (IsNewerSequenceNumber(seq_num, Packet(index).seq_num))
+                ClearSlot(index);
+        });
+    }
+
+    _first_seq_num = seq_num;
+    _is_cleared_to_first_seq_num = true;
+}
+
+void PacketBuffer::Clear() {
+    ForEachUsedSlot([this](size_t index) {
+        ReleasePayload(&Packet(index));
+    });
+    for (std::unique_ptr<SlotGroup>& group : _groups) {
+        if (group)
+            memset(&group->bits, 0, sizeof(SlotBits));
+    }
+
+    _first_packet_received = false;
+    _is_cleared_to_first_seq_num = false;
+    _last_received_packet_ms = -1;
+    _last_received_keyframe_packet_ms = -1;
+}
+
+bool PacketBuffer::MakeRoomFor(uint16_t seq_num) {
+    while (true) {
+        const size_t index = Index(seq_num);
+        if (!TestBit(kUsed, index) || Packet(index).seq_num == seq_num)
+            return true;
+
+        if (growing()) {
+            const size_t group = (seq_num & (_size - 1)) >> 6;
+            // 拆分后仍然冲突, 2 * _size也放不下; 一次插入完成剩下的拆分没有上限, 由调用者丢弃
+            if (_split_groups[group])
+                return false;
+            SplitGroup(group);
+        } else if (!StartGrowing()) {
+            return false;
+        }
+    }
+}
+
+bool PacketBuffer::StartGrowing() {
+    if (_size == _max_size) {
+        // RTC_LOG(LS_WARNING) << "PacketBuffer is already at max size (" << _max_size
+        //     << "), failed to increase size.";
+        return false;
+    }
+
+    if (_size < 64) {
+        // 新旧槽位都在第0组内, 最多搬64个包, 直接完成
+        uint64_t used = _groups[0]->bits.words[kUsed] & ((uint64_t{1} << _size) - 1);
+        while (used) {
+            const size_t index = __builtin_ctzll(used);
+            used &= used - 1;
+            if (Packet(index).seq_num & _size)
+                MoveSlot(index, index + _size);
+        }
+        _size *= 2;
+        // RTC_LOG(LS_INFO) << "PacketBuffer size expanded to " << _size;
+        return true;
+    }
+
+    // 只补空指针, 容量已经预留, 不会搬迁已有的组
+    _groups.resize(2 * _size / 64);
+    _split_groups.assign(_size / 64, 0);
+    _num_split_groups = 0;
+    _split_cursor = 0;
+    return true;
+}
+
+void PacketBuffer::SplitGroup(size_t group) {
+    const size_t sibling = group + _size / 64;
+    if (!_groups[sibling])
+        _groups[sibling].reset(new SlotGroup());
+
+    uint64_t used = _groups[group]->bits.words[kUsed];
+    while (used) {
+        const size_t index = group * 64 + __builtin_ctzll(used);
+        used &= used - 1;
+        if (Packet(index).seq_num & _size)
+            MoveSlot(index, index + _size);
+    }
+    _split_groups[group] = 1;
+
+    if (++_num_split_groups == _size / 64) {
+        _size *= 2;
+        _split_groups.clear();
+        _num_split_groups = 0;
+        // RTC_LOG(LS_INFO) << "PacketBuffer size expanded to " << _size;
+    }
+}
+
+void PacketBuffer::ContinueGrowing(size_t max_groups) {
+    while (max_groups > 0 && growing()) {
+        if (!_split_groups[_split_cursor]) {
+            SplitGroup(_split_cursor);
+            --max_groups;
+        }
+        ++_split_cursor;
+    }
+}
+
+void PacketBuffer::MoveSlot(size_t from, size_t to) {
+    Packet(to) = std::move(Packet(from));
+    ReleasePayload(&Packet(from));
+    // kLinked只与序号有关, 跟着包走仍然正确
+    for (int bit = kUsed; bit < kNumSlotBits; ++bit) {
+        SetBit(static_cast<SlotBit>(bit), to, TestBit(static_cast<SlotBit>(bit), from));
+        SetBit(static_cast<SlotBit>(bit), from, false);
+    }
+}
+
+template <typename F>
+void PacketBuffer::ForEachSlotRun(uint16_t seq_num, size_t count, F f) const {
+    while (count > 0) {
+        const size_t index = Index(seq_num);
+        const size_t shift = index & 63;
+        const size_t bits = std::min(std::min<size_t>(64 - shift, _size - (index & (_size - 1))),
+                count);
+        f(seq_num, index, RangeMask(shift, bits));
+        count -= bits;
+        seq_num += bits;
+    }
+}
+
+template <typename F>
+void PacketBuffer::ForEachUsedSlot(F f) const {
+    for (size_t group = 0; group < _groups.size(); ++group) {
+        if (!_groups[group])
+            continue;
+        uint64_t used = _groups[group]->bits.words[kUsed];
+        while (used) {
+            const size_t index = group * 64 + __builtin_ctzll(used);
+            used &= used - 1;
+            f(index);
+        }
+    }
+}
+
+bool PacketBuffer::PotentialNewFrame(uint16_t seq_num) const {
+    const size_t index = Index(seq_num);
+
+    if (!TestBit(kUsed, index))
+        return false;
+    if (Packet(index).seq_num != seq_num)
+        return false;
+    if (TestBit(kFrameCreated, index))
+        return false;
+    if (TestBit(kFrameBegin, index))
+        return true;
+    // kLinked: 前一个序号的包也在缓冲区里
+    if (!TestBit(kLinked, index))
+        return false;
+    const size_t prev_index = Index(seq_num - 1);
+    if (TestBit(kFrameCreated, prev_index))
+        return false;
+    return TestBit(kContinuous, prev_index);
+}
+
+void PacketBuffer::FindFrames(uint16_t seq_num,
+        std::vector<std::unique_ptr<RtpFrameObject>>* found_frames) {
+    if (!PotentialNewFrame(seq_num))
+        return;
+
+    // 新包连续后, 后面已经到达的包依次变成连续, 一次按字扫描出整个区间, 然后
+    // 区间内每个帧尾都组成一帧。
+    const size_t run_length = 1 + ContinuousRunLength(seq_num + 1, capacity() - 1);
+    ForEachSlotRun(seq_num, run_length, [this](uint16_t, size_t index, uint64_t mask) {
+        Bits(index).words[kContinuous] |= mask;
+    });
+    ForEachSlotRun(seq_num, run_length,
+            [this, found_frames](uint16_t run_seq_num, size_t index, uint64_t mask) {
+        uint64_t frame_ends = Bits(index).words[kFrameEnd] & mask;
+        while (frame_ends) {
+            const size_t distance = __builtin_ctzll(frame_ends) - (index & 63);
+            frame_ends &= frame_ends - 1;
+            std::unique_ptr<RtpFrameObject> frame = CreateFrame(run_seq_num + distance);
+            if (frame)
+                found_frames->push_back(std::move(frame));
+        }
+    });
+}
+
+std::unique_ptr<RtpFrameObject> PacketBuffer::CreateFrame(uint16_t end_seq_num) {
+    uint16_t begin_seq_num;
+    if (!FindFrameBegin(end_seq_num, &begin_seq_num)) {
+        // 帧首之前的包已经被ClearTo()释放
+        return nullptr;
+    }
+
+    size_t frame_size = 0;
+    int max_nack_count = -1;
+    for (uint16_t seq_num = begin_seq_num;; ++seq_num) {
+        const size_t index = Index(seq_num);
+        frame_size += Packet(index).size_bytes;
+        max_nack_count = std::max(max_nack_count, Packet(index).times_nacked);
+        SetBit(kFrameCreated, index, true);
+        if (seq_num == end_seq_num)
+            break;
+    }
+
+    return std::unique_ptr<RtpFrameObject>(new RtpFrameObject(shared_from_this(),
+            begin_seq_num, end_seq_num, frame_size, max_nack_count,
+            _clock->TimeInMilliseconds()));
+}
+
+size_t PacketBuffer::ContinuousRunLength(uint16_t seq_num, size_t max_count) const {
+    // 包j可以接在j-1之后: j-1也在缓冲区里, j没有组过帧, 并且j-1不是帧尾或者j是帧首。
+    // 从已确认的包往后, kLinked保证下一个槽位里正好是下一个序号的包。
+    size_t count = 0;
+    while (count < max_count) {
+        const size_t index = Index(seq_num);
+        const size_t shift = index & 63;
+        const size_t bits = std::min<size_t>(64 - shift, _size - (index & (_size - 1)));
+        const SlotBits& slot_bits = Bits(index);
+        uint64_t prev_frame_end = slot_bits.words[kFrameEnd] << 1;
+        if (shift == 0)
+            prev_frame_end |= static_cast<uint64_t>(TestBit(kFrameEnd, Index(seq_num - 1)));
+        uint64_t stop = ~slot_bits.words[kLinked] | slot_bits.words[kFrameCreated] |
+            (prev_frame_end & ~slot_bits.words[kFrameBegin]);
+        stop >>= shift;
+        if (bits < 64)
+            stop &= (uint64_t{1} << bits) - 1;
+        if (stop)
+            return std::min(max_count, count + __builtin_ctzll(stop));
+        count += bits;
+        seq_num += bits;
+    }
+    return max_count;
+}
+
+bool PacketBuffer::FindFrameBegin(uint16_t end_seq_num, uint16_t* begin_seq_num) const {
+    // 向前找第一个帧首或者前一个序号不在缓冲区里的包, 前者就是帧首
+    const size_t max_tested = capacity();
+    uint16_t seq_num = end_seq_num;
+    size_t tested = 0;
+    while (tested < max_tested) {
+        const size_t index = Index(seq_num);
+        const size_t shift = index & 63;
+        const SlotBits& slot_bits = Bits(index);
+        uint64_t candidates = slot_bits.words[kFrameBegin] | ~slot_bits.words[kLinked];
+        candidates &= ~uint64_t{0} >> (63 - shift);
+        if (candidates) {
+            const size_t distance = shift - (63 - __builtin_clzll(candidates));
+            if (tested + distance >= max_tested || !TestBit(kFrameBegin, index - distance))
+                return false;
+            *begin_seq_num = seq_num - distance;
+            return true;
+        }
+        tested += shift + 1;
+        seq_num -= shift + 1;
+    }
+    return false;
+}
+
+bool PacketBuffer::GetPayloadSegments(const RtpFrameObject& frame,
+        std::vector<PayloadSegment>* segments) const {
+    const uint16_t end = frame.last_seq_num() + 1;
+    segments->reserve(static_cast<uint16_t>(end - frame.first_seq_num()));
+    for (uint16_t seq_num = frame.first_seq_num(); seq_num != end; ++seq_num) {
+        const VCMPacket* packet = GetPacket(seq_num);
+        if (!packet)
+            return false;
+        if (packet->size_bytes > 0) {
+            PayloadSegment segment;
+            segment.buffer = packet->payload_buffer;
+            segment.data = packet->data_ptr;
+            segment.size = packet->size_bytes;
+            segments->push_back(std::move(segment));
+        }
+    }
+    return true;
+}
+
+const VCMPacket* PacketBuffer::GetPacket(uint16_t seq_num) const {
+    const size_t index = Index(seq_num);
+    if (!TestBit(kUsed, index) || Packet(index).seq_num != seq_num)
+        return nullptr;
+    return &Packet(index);
+}
+
+void PacketBuffer::ReturnFrame(RtpFrameObject* frame) {
+    const uint16_t end = frame->last_seq_num() + 1;
+    for (uint16_t seq_num = frame->first_seq_num(); seq_num != end; ++seq_num) {
+        const size_t index = Index(seq_num);
+        if (TestBit(kUsed, index) && Packet(index).seq_num == seq_num)
+            ClearSlot(index);
+    }
+}
+
+void PacketBuffer::UpdateLinked(size_t index) {
+    const uint16_t seq_num = Packet(index).seq_num;
+    const uint16_t prev_seq_num = seq_num - 1;
+    const uint16_t next_seq_num = seq_num + 1;
+    const size_t prev_index = Index(prev_seq_num);
+    const size_t next_index = Index(next_seq_num);
+    SetBit(kLinked, index, TestBit(kUsed, prev_index) && Packet(prev_index).seq_num == prev_seq_num);
+    if (TestBit(kUsed, next_index) && Packet(next_index).seq_num == next_seq_num)
+        SetBit(kLinked, next_index, true);
+}
+
+void PacketBuffer::ClearSlot(size_t index) {
+    const uint16_t next_seq_num = Packet(index).seq_num + 1;
+    ReleasePayload(&Packet(index));
+    for (int bit = kUsed; bit < kNumSlotBits; ++bit)
+        SetBit(static_cast<SlotBit>(bit), index, false);
+    // 后一个序号的包可能不在相邻的槽位(已拆分的组), 按序号找
+    const size_t next_index = Index(next_seq_num);
+    if (TestBit(kUsed, next_index) && Packet(next_index).seq_num == next_seq_num)
+        SetBit(kLinked, next_index, false);
+}
+
+void PacketBuffer::ReleasePayload(VCMPacket* packet) {
+    packet->payload_buffer = PayloadBuffer();
+    packet->data_ptr = nullptr;
+}
+
+} // namespace video_coding
+
+} // namespace webrtc
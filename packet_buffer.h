@@ -0,0 +1,198 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file packet_buffer.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _PACKET_BUFFER_H
+#define _PACKET_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "clock.h"
+#include "frame_object.h"
+#include "vcm_packet.h"
+
+namespace webrtc {
+
+namespace video_coding {
+
+class OnReceivedFrameCallback {
+public:
+    virtual ~OnReceivedFrameCallback() {}
+    virtual void OnReceivedFrame(std::unique_ptr<RtpFrameObject> frame) = 0;
+};
+
+// 视频接收端按序号缓存RTP包, 一帧的包都到齐且与前面的帧连续时组成RtpFrameObject回调出去。
+//
+// 包放在2的幂大小的槽位数组中, 下标是seq_num & (size - 1), 放不下时翻倍扩容直到
+// max_buffer_size。每个槽位的状态(有包、帧首、帧尾、与前一个槽位序号相连、连续、
+// 已组帧)各占一位, 每64个槽位一组uint64_t。插入一个包后按字扫描出可以接续的区间,
+// 不再逐个槽位判断。
+//
+// 槽位按64个一组分配, 扩容时不整体搬迁: 新的一半组只在拆分时分配, 每次插入拆分
+// kSplitGroupsPerInsert组(组g中序号含size位的包搬到组g + size / 64的同一位置),
+// 插入的包落在还没拆分的组里又冲突时先拆分这一组, 落在已拆分的组里仍然冲突(2 * size
+// 也放不下)时丢弃这个包, 等这次扩容完成后再开始下一次。拆分过程中已拆分的组按
+// 2 * size取模, 其余按size取模, 任何情况下单次插入最多搬迁两组。
+//
+// Note: This class is not thread-safe.
+class PacketBuffer : public std::enable_shared_from_this<PacketBuffer> {
+public:
+    // Both |start_buffer_size| and |max_buffer_size| must be a power of 2.
+    static std::shared_ptr<PacketBuffer> Create(Clock* clock, size_t start_buffer_size,
+            size_t max_buffer_size, OnReceivedFrameCallback* frame_callback);
+    ~PacketBuffer();
+
+    // Returns true if |packet| is inserted into the packet buffer, false
+    // otherwise. The PacketBuffer will always take ownership of the
+    // |packet.data_ptr| and |packet.payload_buffer| when this function is called.
+    // new[]分配的data_ptr被包装成PayloadBuffer, 之后统一按句柄管理。
+    // 返回false时需要请求关键帧: 包比ClearTo()的位置旧, 扩容过程中放不下(只丢弃
+    // 这个包), 或者扩容到最大仍放不下(此时缓冲区被清空)。
+    bool InsertPacket(VCMPacket* packet);
+    // 释放序号不新于|seq_num|的包, 之后再收到这些包直接丢弃
+    void ClearTo(uint16_t seq_num);
+    void Clear();
+
+    // -1 if no packet has been received.
+    int64_t LastReceivedPacketMs() const { return _last_received_packet_ms; }
+    int64_t LastReceivedKeyframePacketMs() const { return _last_received_keyframe_packet_ms; }
+
+private:
+    friend RtpFrameObject;
+
+    // 每64个槽位一组, 第i位对应槽位64 * group + i
+    enum SlotBit {
+        kUsed = 0,
+        kFrameBegin,
+        kFrameEnd,
+        // 序号比本槽位的包小1的包也在缓冲区里
+        kLinked,
+        // 本槽位之前直到帧首的包都已到齐
+        kContinuous,
+        kFrameCreated,
+        kNumSlotBits,
+    };
+    struct SlotBits {
+        uint64_t words[kNumSlotBits];
+    };
+    struct SlotGroup {
+        SlotBits bits;
+        VCMPacket packets[64];
+    };
+
+    // 每次插入最多拆分的组数, 即最多搬迁64 * kSplitGroupsPerInsert个包
+    static constexpr size_t kSplitGroupsPerInsert = 1;
+
+    PacketBuffer(Clock* clock, size_t start_buffer_size, size_t max_buffer_size,
+            OnReceivedFrameCallback* frame_callback);
+
+    // 让|seq_num|的槽位空出来或者就是|seq_num|自己的包, 必要时拆分或者开始扩容。
+    // 已经是最大容量, 或者落在已拆分的组里仍然冲突时返回false, 后者growing()为true。
+    bool MakeRoomFor(uint16_t seq_num);
+    // Tries to expand the buffer. 不到64个槽位时直接在第0组内完成, 否则开始逐组拆分。
+    bool StartGrowing();
+    bool growing() const { return !_split_groups.empty(); }
+    void SplitGroup(size_t group);
+    // 拆分最多|max_groups|个还没拆分的组
+    void ContinueGrowing(size_t max_groups);
+    // 把包从槽位|from|搬到|to|, 状态位跟着包走
+    void MoveSlot(size_t from, size_t to);
+    // 现在能映射到的槽位数
+    size_t capacity() const { return _size + 64 * _num_split_groups; }
+
+    // Test if all previous packets has arrived for the given sequence number.
+    bool PotentialNewFrame(uint16_t seq_num) const;
+
+    // Test if all packets of a frame has arrived, and if so, creates a frame.
+    // 组好的帧追加到|found_frames|。
+    void FindFrames(uint16_t seq_num, std::vector<std::unique_ptr<RtpFrameObject>>* found_frames);
+    std::unique_ptr<RtpFrameObject> CreateFrame(uint16_t end_seq_num);
+
+    // 从|seq_num|开始(含)连续可以接续的包个数, 最多|max_count|个
+    size_t ContinuousRunLength(uint16_t seq_num, size_t max_count) const;
+    // 从|end_seq_num|向前找帧首, 中间的包必须序号相连; 找不到返回false
+    bool FindFrameBegin(uint16_t end_seq_num, uint16_t* begin_seq_num) const;
+    // 对序号[seq_num, seq_num + count)所在的槽位分段调用f(seq, index, mask), 一段内
+    // 序号连续的包在同一组内也连续, |seq|和|index|是这一段第一个序号和它的槽位,
+    // mask是这一段在组内的位
+    template <typename F>
+    void ForEachSlotRun(uint16_t seq_num, size_t count, F f) const;
+    // 对所有组里有包的槽位调用f(index)
+    template <typename F>
+    void ForEachUsedSlot(F f) const;
+
+    // 取出|frame|的负载分段, 只增加缓冲区的引用计数, 不拷贝
+    bool GetPayloadSegments(const RtpFrameObject& frame,
+            std::vector<PayloadSegment>* segments) const;
+    // Get the packet with sequence number |seq_num|.
+    const VCMPacket* GetPacket(uint16_t seq_num) const;
+    // Mark all slots used by |frame| as not used.
+    void ReturnFrame(RtpFrameObject* frame);
+
+    // 序号所在的槽位: 已拆分的组按2 * _size取模, 其余按_size取模
+    size_t Index(uint16_t seq_num) const {
+        const size_t index = seq_num & (_size - 1);
+        if (growing() && _split_groups[index >> 6])
+            return seq_num & (2 * _size - 1);
+        return index;
+    }
+    VCMPacket& Packet(size_t index) { return _groups[index >> 6]->packets[index & 63]; }
+    const VCMPacket& Packet(size_t index) const { return _groups[index >> 6]->packets[index & 63]; }
+    SlotBits& Bits(size_t index) { return _groups[index >> 6]->bits; }
+    const SlotBits& Bits(size_t index) const { return _groups[index >> 6]->bits; }
+    bool TestBit(SlotBit bit, size_t index) const {
+        return (Bits(index).words[bit] >> (index & 63)) & 1;
+    }
+    void SetBit(SlotBit bit, size_t index, bool value) {
+        uint64_t mask = uint64_t{1} << (index & 63);
+        uint64_t& word = Bits(index).words[bit];
+        word = value ? (word | mask) : (word & ~mask);
+    }
+    // 槽位|index|放入新包后, 更新它和后一个序号的kLinked位
+    void UpdateLinked(size_t index);
+    void ClearSlot(size_t index);
+    // 释放包的负载, 插入时new[]分配的负载已经包装成了PayloadBuffer
+    static void ReleasePayload(VCMPacket* packet);
+
+    Clock* const _clock;
+    const size_t _max_size;
+    // 当前槽位数, 2的幂; 拆分全部完成后翻倍
+    size_t _size;
+    // 按需分配, 只增不减; 预留到max_buffer_size, 扩容时不会搬迁已有的组
+    std::vector<std::unique_ptr<SlotGroup>> _groups;
+    // 扩容过程中每组是否已拆分, 不在扩容时为空
+    std::vector<uint8_t> _split_groups;
+    size_t _num_split_groups;
+    // 下一个要检查的组, 按需拆分的组会被跳过
+    size_t _split_cursor;
+
+    // Indicates if we have received the first packet.
+    bool _first_packet_received;
+    // The fist sequence number currently in the buffer.
+    uint16_t _first_seq_num;
+    // ClearTo()之后为true, 比_first_seq_num旧的包不再插入
+    bool _is_cleared_to_first_seq_num;
+
+    int64_t _last_received_packet_ms;
+    int64_t _last_received_keyframe_packet_ms;
+
+    OnReceivedFrameCallback* const _received_frame_callback;
+};
+
+} // namespace video_coding
+
+} // namespace webrtc
+
+#endif // _PACKET_BUFFER_H
+
+
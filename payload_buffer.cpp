@@ -0,0 +1,146 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file payload_buffer.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "payload_buffer.h"
+
+#include <cassert>
+
+namespace webrtc {
+
+struct PayloadBuffer::Block {
+    int ref_count;
+    // nullptr if |data| was adopted and is freed with delete[].
+    PayloadSlabAllocator* allocator;
+    uint8_t* data;
+    size_t capacity;
+    Block* next_free;
+};
+
+struct PayloadSlabAllocator::Slab {
+    std::unique_ptr<PayloadBuffer::Block[]> blocks;
+    std::unique_ptr<uint8_t[]> memory;
+};
+
+PayloadBuffer::PayloadBuffer(Block* block) : _block(block) {
+    ++_block->ref_count;
+}
+
+PayloadBuffer::PayloadBuffer(const PayloadBuffer& other) : _block(other._block) {
+    if (_block)
+        ++_block->ref_count;
+}
+
+PayloadBuffer& PayloadBuffer::operator=(const PayloadBuffer& other) {
+    // 先增加引用, 自赋值时不会释放
+    Block* block = other._block;
+    if (block)
+        ++block->ref_count;
+    Release();
+    _block = block;
+    return *this;
+}
+
+PayloadBuffer& PayloadBuffer::operator=(PayloadBuffer&& other) {
+    if (this != &other) {
+        Release();
+        _block = other._block;
+        other._block = nullptr;
+    }
+    return *this;
+}
+
+PayloadBuffer PayloadBuffer::Adopt(uint8_t* data, size_t capacity) {
+    Block* block = new Block;
+    block->ref_count = 0;
+    block->allocator = nullptr;
+    block->data = data;
+    block->capacity = capacity;
+    block->next_free = nullptr;
+    return PayloadBuffer(block);
+}
+
+uint8_t* PayloadBuffer::data() const {
+    return _block ? _block->data : nullptr;
+}
+
+size_t PayloadBuffer::capacity() const {
+    return _block ? _block->capacity : 0;
+}
+
+int PayloadBuffer::ref_count() const {
+    return _block ? _block->ref_count : 0;
+}
+
+void PayloadBuffer::Release() {
+    if (!_block)
+        return;
+    if (--_block->ref_count == 0) {
+        if (_block->allocator) {
+            _block->allocator->Free(_block);
+        } else {
+            delete[] _block->data;
+            delete _block;
+        }
+    }
+    _block = nullptr;
+}
+
+constexpr size_t PayloadSlabAllocator::kDefaultBlockSize;
+constexpr size_t PayloadSlabAllocator::kDefaultBlocksPerSlab;
+
+PayloadSlabAllocator::PayloadSlabAllocator(size_t block_size, size_t blocks_per_slab)
+    : _block_size(block_size),
+    _blocks_per_slab(blocks_per_slab),
+    _free_list(nullptr),
+    _num_blocks_in_use(0) {
+    assert(blocks_per_slab > 0);
+}
+
+PayloadSlabAllocator::~PayloadSlabAllocator() {
+    // 还有块没有归还时释放slab, 持有句柄的一方会访问已释放的内存
+    assert(_num_blocks_in_use == 0);
+}
+
+PayloadBuffer PayloadSlabAllocator::Allocate() {
+    if (!_free_list)
+        AddSlab();
+    PayloadBuffer::Block* block = _free_list;
+    _free_list = block->next_free;
+    block->next_free = nullptr;
+    ++_num_blocks_in_use;
+    return PayloadBuffer(block);
+}
+
+void PayloadSlabAllocator::AddSlab() {
+    std::unique_ptr<Slab> slab(new Slab);
+    slab->blocks.reset(new PayloadBuffer::Block[_blocks_per_slab]);
+    slab->memory.reset(new uint8_t[_blocks_per_slab * _block_size]);
+    // 倒序入链, 先分配地址低的块
+    for (size_t i = _blocks_per_slab; i-- > 0;) {
+        PayloadBuffer::Block& block = slab->blocks[i];
+        block.ref_count = 0;
+        block.allocator = this;
+        block.data = slab->memory.get() + i * _block_size;
+        block.capacity = _block_size;
+        block.next_free = _free_list;
+        _free_list = &block;
+    }
+    _slabs.push_back(std::move(slab));
+}
+
+void PayloadSlabAllocator::Free(PayloadBuffer::Block* block) {
+    assert(_num_blocks_in_use > 0);
+    block->next_free = _free_list;
+    _free_list = block;
+    --_num_blocks_in_use;
+}
+
+} // namespace webrtc
+
@@ -0,0 +1,94 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file payload_buffer.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _PAYLOAD_BUFFER_H
+#define _PAYLOAD_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+namespace webrtc {
+
+class PayloadSlabAllocator;
+
+// 引用计数的包缓冲区句柄。socket直接读进PayloadSlabAllocator分配的块, VCMPacket、
+// PacketBuffer和RtpFrameObject之间传递句柄而不是拷贝负载, 最后一个句柄析构时
+// 块还给分配器。
+class PayloadBuffer {
+public:
+    PayloadBuffer() : _block(nullptr) {}
+    PayloadBuffer(const PayloadBuffer& other);
+    PayloadBuffer(PayloadBuffer&& other) : _block(other._block) { other._block = nullptr; }
+    PayloadBuffer& operator=(const PayloadBuffer& other);
+    PayloadBuffer& operator=(PayloadBuffer&& other);
+    ~PayloadBuffer() { Release(); }
+
+    // 接管new[]分配的|data|, 不来自分配器的负载(比如单测)也用同样的方式管理
+    static PayloadBuffer Adopt(uint8_t* data, size_t capacity);
+
+    uint8_t* data() const;
+    size_t capacity() const;
+    bool empty() const { return _block == nullptr; }
+    // 持有同一块的句柄个数
+    int ref_count() const;
+
+private:
+    friend class PayloadSlabAllocator;
+    struct Block;
+
+    explicit PayloadBuffer(Block* block);
+    void Release();
+
+    Block* _block;
+};
+
+// 固定大小的块按slab批量分配, 释放的块放回空闲链表, 稳定运行时收包不分配内存。
+// 分配器必须比它分配的所有PayloadBuffer活得久。
+//
+// Note: This class is not thread-safe.
+class PayloadSlabAllocator {
+public:
+    // 能放下一个以太网MTU的包
+    static constexpr size_t kDefaultBlockSize = 1536;
+    static constexpr size_t kDefaultBlocksPerSlab = 256;
+
+    explicit PayloadSlabAllocator(size_t block_size = kDefaultBlockSize,
+            size_t blocks_per_slab = kDefaultBlocksPerSlab);
+    ~PayloadSlabAllocator();
+
+    PayloadBuffer Allocate();
+
+    size_t block_size() const { return _block_size; }
+    size_t num_slabs() const { return _slabs.size(); }
+    // 已分配还没有归还的块数
+    size_t num_blocks_in_use() const { return _num_blocks_in_use; }
+
+private:
+    friend class PayloadBuffer;
+    struct Slab;
+
+    void AddSlab();
+    void Free(PayloadBuffer::Block* block);
+
+    const size_t _block_size;
+    const size_t _blocks_per_slab;
+    std::vector<std::unique_ptr<Slab>> _slabs;
+    PayloadBuffer::Block* _free_list;
+    size_t _num_blocks_in_use;
+};
+
+} // namespace webrtc
+
+#endif // _PAYLOAD_BUFFER_H
+
+
@@ -0,0 +1,173 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file payload_buffer_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ payload_buffer_unittest.cpp payload_buffer.cpp packet_buffer.cpp frame_object.cpp random.cpp -std=c++11 -O2
+
+#include <string.h>
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+using namespace std;
+
+#include "clock.h"
+#include "packet_buffer.h"
+#include "payload_buffer.h"
+#include "random.h"
+
+using namespace webrtc;
+using namespace webrtc::video_coding;
+
+// RefCountAndReuse
+// 句柄拷贝/移动时引用计数正确, 最后一个句柄释放后块回到空闲链表并被复用
+void TestPayloadBuffer01() {
+    PayloadSlabAllocator allocator(128, 2);
+    assert(allocator.num_slabs() == 0);
+    {
+        PayloadBuffer a = allocator.Allocate();
+        assert(a.capacity() == 128);
+        assert(a.ref_count() == 1);
+        PayloadBuffer b = a;
+        assert(a.ref_count() == 2 && b.data() == a.data());
+        PayloadBuffer c = std::move(b);
+        assert(b.empty() && c.ref_count() == 2);
+        c = c;
+        assert(c.ref_count() == 2);
+
+        PayloadBuffer d = allocator.Allocate();
+        assert(d.data() != a.data());
+        PayloadBuffer e = allocator.Allocate();
+        assert(allocator.num_slabs() == 2);
+        assert(allocator.num_blocks_in_use() == 3);
+
+        uint8_t* first = a.data();
+        a = PayloadBuffer();
+        assert(c.ref_count() == 1);
+        c = d;
+        // 第一块已经归还, 再分配时复用
+        assert(allocator.num_blocks_in_use() == 2);
+        PayloadBuffer f = allocator.Allocate();
+        assert(f.data() == first);
+        assert(allocator.num_slabs() == 2);
+    }
+    assert(allocator.num_blocks_in_use() == 0);
+
+    PayloadBuffer adopted = PayloadBuffer::Adopt(new uint8_t[10](), 10);
+    PayloadBuffer copy = adopted;
+    assert(copy.ref_count() == 2 && copy.capacity() == 10);
+    cout << "ref count and reuse ok" << endl;
+}
+
+class DecodingFrameCallback : public OnReceivedFrameCallback {
+public:
+    explicit DecodingFrameCallback(bool copy_bitstream)
+        : _copy_bitstream(copy_bitstream),
+        _decode_buffer(1 << 20),
+        _num_frames(0),
+        _last_seq_num(0),
+        _checksum(0) {}
+
+    void OnReceivedFrame(std::unique_ptr<RtpFrameObject> frame) override {
+        ++_num_frames;
+        _last_seq_num = frame->last_seq_num();
+        if (_copy_bitstream) {
+            // 解码器要求连续的码流: 拷贝一次
+            frame->CopyBitstream(_decode_buffer.data());
+            _checksum += _decode_buffer[frame->size() - 1];
+        } else {
+            // 解码器按段读取: 不拷贝
+            const PayloadSegment& last = frame->segments().back();
+            _checksum += last.data[last.size - 1];
+        }
+    }
+
+    bool _copy_bitstream;
+    std::vector<uint8_t> _decode_buffer;
+    size_t _num_frames;
+    uint16_t _last_seq_num;
+    uint64_t _checksum;
+};
+
+// 每帧kPacketsPerFrame个包, 收到一帧就ClearTo()。|zero_copy|为false时按原来的方式:
+// socket读到临时缓冲区, 拷贝负载到new[]分配的内存, 组帧后再拷贝成连续码流。
+static int64_t RunReceivePath(const std::vector<uint8_t>& wire, size_t num_packets,
+        bool zero_copy, bool copy_bitstream, uint64_t* checksum) {
+    const size_t kPacketSize = 1200;
+    const size_t kHeaderSize = 12;
+    const size_t kPacketsPerFrame = 10;
+    SimulatedClock clock(0);
+    PayloadSlabAllocator allocator;
+    DecodingFrameCallback callback(copy_bitstream);
+    std::shared_ptr<PacketBuffer> packet_buffer = PacketBuffer::Create(&clock, 512, 2048, &callback);
+    std::vector<uint8_t> socket_buffer(PayloadSlabAllocator::kDefaultBlockSize);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_packets; ++i) {
+        const uint8_t* datagram = &wire[(i & 63) * kPacketSize];
+        VCMPacket packet;
+        packet.seq_num = static_cast<uint16_t>(i);
+        packet.frame_type = kVideoFrameDelta;
+        packet.is_first_packet_in_frame = i % kPacketsPerFrame == 0;
+        packet.marker_bit = i % kPacketsPerFrame == kPacketsPerFrame - 1;
+        packet.size_bytes = kPacketSize - kHeaderSize;
+        if (zero_copy) {
+            // recv()直接写进块
+            packet.payload_buffer = allocator.Allocate();
+            memcpy(packet.payload_buffer.data(), datagram, kPacketSize);
+            packet.data_ptr = packet.payload_buffer.data() + kHeaderSize;
+        } else {
+            memcpy(socket_buffer.data(), datagram, kPacketSize);
+            uint8_t* payload = new uint8_t[packet.size_bytes];
+            memcpy(payload, socket_buffer.data() + kHeaderSize, packet.size_bytes);
+            packet.data_ptr = payload;
+        }
+        size_t num_frames = callback._num_frames;
+        packet_buffer->InsertPacket(&packet);
+        if (callback._num_frames != num_frames)
+            packet_buffer->ClearTo(callback._last_seq_num);
+    }
+    int64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    assert(callback._num_frames == num_packets / kPacketsPerFrame);
+    *checksum = callback._checksum;
+    return elapsed_ns;
+}
+
+// Benchmark
+// 1200字节的包、每帧10个包, 比较收包到解码器输入的每包耗时:
+// 原来的方式(socket缓冲区->new[]->连续码流, 2次拷贝+1次分配)与
+// slab(socket直接读进块, 解码器拷贝一次或者按段读取)
+void TestPayloadBuffer02() {
+    const size_t kNumPackets = 200000;
+    Random random(0x43);
+    std::vector<uint8_t> wire(64 * 1200);
+    for (uint8_t& byte : wire)
+        byte = random.Rand<uint8_t>();
+
+    uint64_t copy_checksum, slab_checksum, segments_checksum;
+    int64_t copy_ns = RunReceivePath(wire, kNumPackets, false, true, &copy_checksum);
+    int64_t slab_ns = RunReceivePath(wire, kNumPackets, true, true, &slab_checksum);
+    int64_t segments_ns = RunReceivePath(wire, kNumPackets, true, false, &segments_checksum);
+    assert(copy_checksum == slab_checksum && slab_checksum == segments_checksum);
+    (void)segments_checksum;
+
+    cout << "copy=" << static_cast<double>(copy_ns) / kNumPackets << "ns/packet"
+        << " slab+CopyBitstream=" << static_cast<double>(slab_ns) / kNumPackets << "ns/packet"
+        << " slab+segments=" << static_cast<double>(segments_ns) / kNumPackets << "ns/packet"
+        << endl;
+}
+
+int main() {
+    TestPayloadBuffer01();
+    TestPayloadBuffer02();
+
+    return 0;
+}
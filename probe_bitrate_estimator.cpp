@@ -0,0 +1,141 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file probe_bitrate_estimator.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "probe_bitrate_estimator.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace webrtc {
+
+// The minumum number of probes we need to receive feedback about in percent
+// in order to have a valid estimate.
+constexpr float kMinReceivedProbesRatio = .80f;
+
+// The minumum number of bytes we need to receive feedback about in percent
+// in order to have a valid estimate.
+constexpr float kMinReceivedBytesRatio = .80f;
+
+// The maximum |receive rate| / |send rate| ratio for a valid estimate.
+constexpr float kMaxValidRatio = 2.0f;
+
+// The minimum |receive rate| / |send rate| ratio assuming that the link is
+// not saturated, i.e. we assume that we will receive at least
+// kMinRatioForUnsaturatedLink * |send rate| if |send rate| is less than the
+// link capacity.
+constexpr float kMinRatioForUnsaturatedLink = 0.9f;
+
+// The target utilization of the link. If we know true link capacity
+// we'd like to send at 95% of that rate.
+constexpr float kTargetUtilizationFraction = 0.95f;
+
+// The maximum time period over which the cluster history is retained.
+// This is also the maximum time period beyond which a probing burst is not
+// expected to last.
+constexpr int kMaxClusterHistoryMs = 1000;
+
+// The maximum time interval between first and the last probe on a cluster
+// on the sender side as well as the receive side.
+constexpr int kMaxProbeIntervalMs = 1000;
+
+ProbeBitrateEstimator::ProbeBitrateEstimator() : _estimated_bitrate_bps(-1) {}
+
+ProbeBitrateEstimator::~ProbeBitrateEstimator() {}
+
+int ProbeBitrateEstimator::HandleProbeAndEstimateBitrate(
+        const ProbePacketFeedback& packet_feedback) {
+    int cluster_id = packet_feedback.probe_cluster_id;
+    assert(cluster_id >= 0);
+
+    EraseOldClusters(packet_feedback.arrival_time_ms - kMaxClusterHistoryMs);
+
+    int payload_size_bits = static_cast<int>(packet_feedback.payload_size * 8);
+    AggregatedCluster* cluster = &_clusters[cluster_id];
+
+    if (packet_feedback.send_time_ms < cluster->first_send_ms) {
+        cluster->first_send_ms = packet_feedback.send_time_ms;
+    }
+    if (packet_feedback.send_time_ms > cluster->last_send_ms) {
+        cluster->last_send_ms = packet_feedback.send_time_ms;
+        cluster->size_last_send = payload_size_bits;
+    }
+    if (packet_feedback.arrival_time_ms < cluster->first_receive_ms) {
+        cluster->first_receive_ms = packet_feedback.arrival_time_ms;
+        cluster->size_first_receive = payload_size_bits;
+    }
+    if (packet_feedback.arrival_time_ms > cluster->last_receive_ms) {
+        cluster->last_receive_ms = packet_feedback.arrival_time_ms;
+    }
+    cluster->size_total += payload_size_bits;
+    cluster->num_probes += 1;
+
+    const int min_probes = packet_feedback.probe_cluster_min_probes * kMinReceivedProbesRatio;
+    const int min_bytes = packet_feedback.probe_cluster_min_bytes * kMinReceivedBytesRatio;
+    if (cluster->num_probes < min_probes || cluster->size_total < min_bytes * 8)
+        return -1;
+
+    float send_interval_ms = cluster->last_send_ms - cluster->first_send_ms;
+    float receive_interval_ms = cluster->last_receive_ms - cluster->first_receive_ms;
+
+    if (send_interval_ms <= 0 || send_interval_ms > kMaxProbeIntervalMs ||
+            receive_interval_ms <= 0 || receive_interval_ms > kMaxProbeIntervalMs) {
+        // RTC_LOG(LS_INFO) << "Probing unsuccessful, invalid send/receive interval";
+        return -1;
+    }
+
+    // 发送码率不计最后一个包, 接收码率不计第一个包: n个包只有n-1个间隔
+    // Since the |send_interval_ms| does not include the time it takes to
+    // actually send the last packet the size of the last sent packet should not
+    // be included when calculating the send bitrate.
+    assert(cluster->size_total > cluster->size_last_send);
+    float send_size = cluster->size_total - cluster->size_last_send;
+    float send_bps = send_size / send_interval_ms * 1000;
+
+    // Since the |receive_interval_ms| does not include the time it takes to
+    // actually receive the first packet the size of the first received packet
+    // should not be included when calculating the receive bitrate.
+    assert(cluster->size_total > cluster->size_first_receive);
+    float receive_size = cluster->size_total - cluster->size_first_receive;
+    float receive_bps = receive_size / receive_interval_ms * 1000;
+
+    float ratio = receive_bps / send_bps;
+    if (ratio > kMaxValidRatio) {
+        // RTC_LOG(LS_INFO) << "Probing unsuccessful, receive/send ratio too high";
+        return -1;
+    }
+
+    float res = std::min(send_bps, receive_bps);
+    // If we're receiving at significantly lower bitrate than we were sending at,
+    // it suggests that we've found the true capacity of the link. In this case,
+    // set the target bitrate slightly lower to not immediately overuse.
+    if (receive_bps < kMinRatioForUnsaturatedLink * send_bps) {
+        res = kTargetUtilizationFraction * receive_bps;
+    }
+    _estimated_bitrate_bps = static_cast<int>(res);
+    return _estimated_bitrate_bps;
+}
+
+int ProbeBitrateEstimator::FetchAndResetLastEstimatedBitrateBps() {
+    int estimated_bitrate_bps = _estimated_bitrate_bps;
+    _estimated_bitrate_bps = -1;
+    return estimated_bitrate_bps;
+}
+
+void ProbeBitrateEstimator::EraseOldClusters(int64_t timestamp_ms) {
+    for (auto it = _clusters.begin(); it != _clusters.end();) {
+        if (it->second.last_receive_ms < timestamp_ms) {
+            it = _clusters.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace webrtc
@@ -0,0 +1,73 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file probe_bitrate_estimator.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _PROBE_BITRATE_ESTIMATOR_H
+#define _PROBE_BITRATE_ESTIMATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+
+namespace webrtc {
+
+// Feedback for one packet sent as part of a probe cluster: its send time,
+// its arrival time at the receiver and the parameters of the cluster it was
+// sent in.
+struct ProbePacketFeedback {
+    int64_t send_time_ms;
+    int64_t arrival_time_ms;
+    size_t payload_size;
+    int probe_cluster_id;
+    int probe_cluster_min_probes;
+    int probe_cluster_min_bytes;
+};
+
+// 探测码率估计: 用一个探测簇的发送间隔和到达间隔分别算出发送码率和接收码率,
+// 接收码率明显低于发送码率说明链路已经饱和, 取接收码率作为链路容量估计
+// Estimates the link capacity from the send and arrival deltas of the
+// packets of a probe cluster.
+class ProbeBitrateEstimator {
+public:
+    ProbeBitrateEstimator();
+    ~ProbeBitrateEstimator();
+
+    // Should be called for every probe packet we receive feedback about.
+    // Returns the estimated bitrate if the probe completes a valid cluster,
+    // or -1 otherwise.
+    int HandleProbeAndEstimateBitrate(const ProbePacketFeedback& packet_feedback);
+
+    // Returns the last estimate and resets it to -1.
+    int FetchAndResetLastEstimatedBitrateBps();
+
+private:
+    struct AggregatedCluster {
+        int num_probes = 0;
+        int64_t first_send_ms = INT64_MAX;
+        int64_t last_send_ms = -1;
+        int64_t first_receive_ms = INT64_MAX;
+        int64_t last_receive_ms = -1;
+        int size_last_send = 0;
+        int size_first_receive = 0;
+        int size_total = 0;
+    };
+
+    // Erases old cluster data that was seen before |timestamp_ms|.
+    void EraseOldClusters(int64_t timestamp_ms);
+
+    std::map<int, AggregatedCluster> _clusters;
+    int _estimated_bitrate_bps;
+};
+
+} // namespace webrtc
+
+#endif // _PROBE_BITRATE_ESTIMATOR_H
+
+
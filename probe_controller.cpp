@@ -0,0 +1,192 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file probe_controller.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "probe_controller.h"
+
+#include <algorithm>
+
+#include "aimd_rate_control.h"
+
+namespace webrtc {
+
+// The minimum number probing packets used.
+constexpr int kMinProbePacketsSent = 5;
+
+// The minimum probing duration in ms.
+constexpr int kMinProbeDurationMs = 15;
+
+// Maximum waiting time from the time of initiating probing to getting
+// the measured results back.
+constexpr int64_t kMaxWaitingTimeForProbingResultMs = 1000;
+
+// Value of |_min_bitrate_to_probe_further_bps| that indicates
+// further probing is disabled.
+constexpr int kExponentialProbingDisabled = 0;
+
+// 起始探测倍数
+constexpr double kFirstExponentialProbeScale = 3.0;
+constexpr double kSecondExponentialProbeScale = 6.0;
+constexpr double kFurtherExponentialProbeScale = 2.0;
+
+// Default probing bitrate limit. Applied only when the application didn't
+// specify max bitrate.
+constexpr int64_t kDefaultMaxProbingBitrateBps = 5000000;
+
+// If the bitrate drops to a factor |kBitrateDropThreshold| or lower
+// and we recover within |kBitrateDropTimeoutMs|, then we'll send
+// a probe at a fraction |kProbeFractionAfterDrop| of the original bitrate.
+constexpr double kBitrateDropThreshold = 0.66;
+constexpr int kBitrateDropTimeoutMs = 5000;
+constexpr double kProbeFractionAfterDrop = 0.85;
+
+// Timeout for probing after a drop, so we don't probe repeatedly.
+constexpr int64_t kMinTimeBetweenDropProbesMs = 5000;
+
+// The expected uncertainty of probe result (as a fraction of the target probe
+// bitrate). Used to avoid probing if the probe bitrate is close to our current
+// estimate.
+constexpr double kProbeUncertainty = 0.05;
+
+// A further probe is sent if the result of the last one reached this
+// percentage of its target.
+constexpr int kRepeatedProbeMinPercentage = 70;
+
+ProbeController::ProbeController(AimdRateControl* rate_control)
+    : _rate_control(rate_control),
+      _state(kInit),
+      _min_bitrate_to_probe_further_bps(kExponentialProbingDisabled),
+      _time_last_probing_initiated_ms(0),
+      _estimated_bitrate_bps(0),
+      _start_bitrate_bps(0),
+      _max_bitrate_bps(0),
+      _time_of_last_large_drop_ms(-1),
+      _bitrate_before_last_large_drop_bps(0),
+      _last_bwe_drop_probing_time_ms(0),
+      _next_probe_cluster_id(1),
+      _rapid_recovery(true) {}
+
+ProbeController::~ProbeController() {}
+
+void ProbeController::SetBitrates(int64_t min_bitrate_bps,
+                                  int64_t start_bitrate_bps,
+                                  int64_t max_bitrate_bps,
+                                  int64_t now_ms) {
+    if (start_bitrate_bps > 0) {
+        _start_bitrate_bps = start_bitrate_bps;
+        _estimated_bitrate_bps = start_bitrate_bps;
+    } else if (_start_bitrate_bps == 0) {
+        _start_bitrate_bps = min_bitrate_bps;
+    }
+    _max_bitrate_bps = max_bitrate_bps;
+
+    if (_state == kInit)
+        InitiateExponentialProbing(now_ms);
+}
+
+void ProbeController::InitiateExponentialProbing(int64_t now_ms) {
+    std::vector<int64_t> probes;
+    probes.push_back(static_cast<int64_t>(kFirstExponentialProbeScale * _start_bitrate_bps));
+    probes.push_back(static_cast<int64_t>(kSecondExponentialProbeScale * _start_bitrate_bps));
+    InitiateProbing(now_ms, probes, true);
+}
+
+void ProbeController::SetEstimatedBitrate(int64_t bitrate_bps, int64_t now_ms) {
+    // 上一次探测结果达到探测码率的70%, 说明链路还有余量, 翻倍继续探测
+    if (_state == kWaitingForProbingResult && _min_bitrate_to_probe_further_bps != kExponentialProbingDisabled &&
+            bitrate_bps > _min_bitrate_to_probe_further_bps) {
+        std::vector<int64_t> probes(1, static_cast<int64_t>(kFurtherExponentialProbeScale * bitrate_bps));
+        InitiateProbing(now_ms, probes, true);
+    }
+
+    if (bitrate_bps < kBitrateDropThreshold * _estimated_bitrate_bps) {
+        _time_of_last_large_drop_ms = now_ms;
+        _bitrate_before_last_large_drop_bps = _estimated_bitrate_bps;
+    }
+
+    _estimated_bitrate_bps = bitrate_bps;
+}
+
+void ProbeController::IncomingProbePacketFeedback(const ProbePacketFeedback& packet_feedback,
+                                                  int64_t now_ms) {
+    int probe_bitrate_bps = _probe_bitrate_estimator.HandleProbeAndEstimateBitrate(packet_feedback);
+    if (probe_bitrate_bps <= 0)
+        return;
+
+    _rate_control->SetEstimate(probe_bitrate_bps, now_ms);
+    SetEstimatedBitrate(_rate_control->LatestEstimate(), now_ms);
+}
+
+void ProbeController::Process(int64_t now_ms) {
+    if (_state == kWaitingForProbingResult &&
+            now_ms - _time_last_probing_initiated_ms > kMaxWaitingTimeForProbingResultMs) {
+        // RTC_LOG(LS_INFO) << "kWaitingForProbingResult: timeout";
+        _state = kProbingComplete;
+        _min_bitrate_to_probe_further_bps = kExponentialProbingDisabled;
+    }
+}
+
+// 短暂过载导致码率大幅下跌后, 过载一结束就按下跌前码率的85%探测一次,
+// 不必等加性增慢慢爬回去
+void ProbeController::RequestProbe(int64_t now_ms) {
+    if (!_rapid_recovery || _state != kProbingComplete || _time_of_last_large_drop_ms < 0)
+        return;
+
+    int64_t suggested_probe_bps = static_cast<int64_t>(
+            kProbeFractionAfterDrop * _bitrate_before_last_large_drop_bps);
+    int64_t min_expected_probe_result_bps = static_cast<int64_t>(
+            (1 - kProbeUncertainty) * suggested_probe_bps);
+    int64_t time_since_drop_ms = now_ms - _time_of_last_large_drop_ms;
+    int64_t time_since_probe_ms = now_ms - _last_bwe_drop_probing_time_ms;
+    if (min_expected_probe_result_bps > _estimated_bitrate_bps &&
+            time_since_drop_ms < kBitrateDropTimeoutMs &&
+            time_since_probe_ms > kMinTimeBetweenDropProbesMs) {
+        _last_bwe_drop_probing_time_ms = now_ms;
+        InitiateProbing(now_ms, std::vector<int64_t>(1, suggested_probe_bps), false);
+    }
+}
+
+std::vector<ProbeClusterConfig> ProbeController::GetAndResetPendingProbes() {
+    std::vector<ProbeClusterConfig> pending_probes;
+    pending_probes.swap(_pending_probes);
+    return pending_probes;
+}
+
+void ProbeController::InitiateProbing(int64_t now_ms,
+                                      const std::vector<int64_t>& bitrates_to_probe,
+                                      bool probe_further) {
+    int64_t max_probe_bitrate_bps =
+        _max_bitrate_bps > 0 ? _max_bitrate_bps : kDefaultMaxProbingBitrateBps;
+
+    for (int64_t bitrate : bitrates_to_probe) {
+        if (bitrate > max_probe_bitrate_bps) {
+            bitrate = max_probe_bitrate_bps;
+            probe_further = false;
+        }
+
+        ProbeClusterConfig config;
+        config.id = _next_probe_cluster_id++;
+        config.at_time_ms = now_ms;
+        config.target_bitrate_bps = static_cast<int>(bitrate);
+        config.target_duration_ms = kMinProbeDurationMs;
+        config.target_probe_count = kMinProbePacketsSent;
+        _pending_probes.push_back(config);
+    }
+    _time_last_probing_initiated_ms = now_ms;
+    if (probe_further) {
+        _state = kWaitingForProbingResult;
+        _min_bitrate_to_probe_further_bps =
+            bitrates_to_probe.back() * kRepeatedProbeMinPercentage / 100;
+    } else {
+        _state = kProbingComplete;
+        _min_bitrate_to_probe_further_bps = kExponentialProbingDisabled;
+    }
+}
+
+} // namespace webrtc
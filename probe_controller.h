@@ -0,0 +1,118 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file probe_controller.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _PROBE_CONTROLLER_H
+#define _PROBE_CONTROLLER_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "probe_bitrate_estimator.h"
+
+namespace webrtc {
+
+class AimdRateControl;
+
+// A burst of packets the pacer should send at |target_bitrate_bps| for at
+// least |target_duration_ms| and |target_probe_count| packets.
+struct ProbeClusterConfig {
+    int id;
+    int64_t at_time_ms;
+    int target_bitrate_bps;
+    int target_duration_ms;
+    int target_probe_count;
+
+    int min_bytes() const {
+        return static_cast<int>(static_cast<int64_t>(target_bitrate_bps) *
+                target_duration_ms / 8000);
+    }
+};
+
+// 启动阶段AIMD从起始码率慢启动(每秒8%), 到高清码率要很久。
+// 探测控制器在启动时按起始码率的3倍和6倍发探测簇, 结果达到探测码率的70%就继续
+// 翻倍探测, 直到触顶或链路饱和; 码率大幅下跌后再按下跌前的85%探测一次, 快速恢复。
+// 探测结果直接写入AimdRateControl::SetEstimate。
+// Schedules probe clusters at startup and after large estimate drops, and
+// pushes the estimated probe results into AimdRateControl::SetEstimate.
+class ProbeController {
+public:
+    explicit ProbeController(AimdRateControl* rate_control);
+    ~ProbeController();
+
+    // Starts exponential probing from |start_bitrate_bps| on the first call.
+    // |max_bitrate_bps| caps the probes; 0 means no cap.
+    void SetBitrates(int64_t min_bitrate_bps,
+                     int64_t start_bitrate_bps,
+                     int64_t max_bitrate_bps,
+                     int64_t now_ms);
+
+    // Should be called with the delay based estimate whenever it changes,
+    // e.g. after every AimdRateControl::Update().
+    void SetEstimatedBitrate(int64_t bitrate_bps, int64_t now_ms);
+
+    // Feeds transport feedback for a packet sent as part of a probe cluster.
+    // A valid probe result is written to the rate control and may trigger a
+    // further probe.
+    void IncomingProbePacketFeedback(const ProbePacketFeedback& packet_feedback,
+                                     int64_t now_ms);
+
+    // Should be called when the delay based detector has recovered from an
+    // over-use. Schedules a probe at 85% of the estimate before the last large
+    // drop, if that drop happened recently and we have not recovered yet.
+    void RequestProbe(int64_t now_ms);
+
+    // Times out exponential probing. Should be called periodically.
+    void Process(int64_t now_ms);
+
+    // Returns the clusters scheduled since the last call.
+    std::vector<ProbeClusterConfig> GetAndResetPendingProbes();
+
+    // Enables or disables the recovery probe after a large drop. Enabled by
+    // default.
+    void EnableRapidRecovery(bool enable) { _rapid_recovery = enable; }
+
+private:
+    enum State {
+        // Initial state where no probing has been triggered yet.
+        kInit,
+        // Waiting for probing results to continue further probing.
+        kWaitingForProbingResult,
+        // Probing is complete.
+        kProbingComplete,
+    };
+
+    void InitiateExponentialProbing(int64_t now_ms);
+    void InitiateProbing(int64_t now_ms,
+                         const std::vector<int64_t>& bitrates_to_probe,
+                         bool probe_further);
+
+    AimdRateControl* _rate_control;
+    ProbeBitrateEstimator _probe_bitrate_estimator;
+    std::vector<ProbeClusterConfig> _pending_probes;
+
+    State _state;
+    int64_t _min_bitrate_to_probe_further_bps;
+    int64_t _time_last_probing_initiated_ms;
+    int64_t _estimated_bitrate_bps;
+    int64_t _start_bitrate_bps;
+    int64_t _max_bitrate_bps;
+    int64_t _time_of_last_large_drop_ms;
+    int64_t _bitrate_before_last_large_drop_bps;
+    int64_t _last_bwe_drop_probing_time_ms;
+    int _next_probe_cluster_id;
+    bool _rapid_recovery;
+};
+
+} // namespace webrtc
+
+#endif // _PROBE_CONTROLLER_H
+
+
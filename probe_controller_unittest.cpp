@@ -0,0 +1,228 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file probe_controller_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ probe_controller_unittest.cpp probe_controller.cpp probe_bitrate_estimator.cpp aimd_rate_control.cpp field_trail.cpp -std=c++11
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "aimd_rate_control.h"
+#include "probe_bitrate_estimator.h"
+#include "probe_controller.h"
+
+namespace webrtc {
+
+constexpr int kProbeClusterId = 1;
+constexpr int kMinProbes = 5;
+constexpr int kMinBytes = 1000;
+
+static ProbePacketFeedback MakeFeedback(int64_t send_time_ms, int64_t arrival_time_ms,
+        size_t payload_size) {
+    ProbePacketFeedback feedback;
+    feedback.send_time_ms = send_time_ms;
+    feedback.arrival_time_ms = arrival_time_ms;
+    feedback.payload_size = payload_size;
+    feedback.probe_cluster_id = kProbeClusterId;
+    feedback.probe_cluster_min_probes = kMinProbes;
+    feedback.probe_cluster_min_bytes = kMinBytes;
+    return feedback;
+}
+
+// ProbeBitrateEstimator
+// 1.链路未饱和: 收发码率相同, 结果为发送码率
+// 2.链路饱和: 接收码率明显低于发送码率, 结果为接收码率的95%
+void TestProbeBitrateEstimator01() {
+    ProbeBitrateEstimator estimator;
+    int bitrate_bps = -1;
+    // 1000字节每10ms = 800kbps
+    for (int i = 0; i < 5; ++i)
+        bitrate_bps = estimator.HandleProbeAndEstimateBitrate(MakeFeedback(i * 10, 100 + i * 10, 1000));
+    cout << "unsaturated probe=" << bitrate_bps << "bps" << endl;
+    assert(bitrate_bps == 800000);
+
+    ProbeBitrateEstimator saturated;
+    // 每10ms发送, 每20ms到达 = 400kbps
+    for (int i = 0; i < 5; ++i)
+        bitrate_bps = saturated.HandleProbeAndEstimateBitrate(MakeFeedback(i * 10, 100 + i * 20, 1000));
+    cout << "saturated probe=" << bitrate_bps << "bps" << endl;
+    assert(bitrate_bps == 380000);
+
+    // 包数不够不出结果
+    ProbeBitrateEstimator too_few;
+    for (int i = 0; i < 3; ++i)
+        bitrate_bps = too_few.HandleProbeAndEstimateBitrate(MakeFeedback(i * 10, 100 + i * 10, 1000));
+    assert(bitrate_bps == -1);
+}
+
+// 仿真: 单瓶颈链路, 单向传播时延50ms, 探测包经过瓶颈排队后到达, 反馈再过50ms回到发送端。
+// 每100ms用一次反馈更新AIMD, 反馈反映的是上一个100ms的链路: 估计超过链路容量即过载,
+// 吞吐量为min(估计, 容量)。过载结束时请求恢复探测。
+class BottleneckSimulation {
+public:
+    BottleneckSimulation(bool enable_probing, bool rapid_recovery)
+        : _probe_controller(&_rate_control),
+          _enable_probing(enable_probing),
+          _link_free_us(0),
+          _pacer_free_us(0) {
+        _probe_controller.EnableRapidRecovery(rapid_recovery);
+    }
+
+    // 运行到|end_ms|, 返回估计首次达到|target_bps|的时刻, 未达到返回-1
+    int64_t RunUntil(int64_t end_ms, int64_t capacity_bps, int64_t target_bps) {
+        int64_t reached_ms = -1;
+        for (; _now_ms < end_ms; _now_ms += 10) {
+            if (_enable_probing) {
+                _probe_controller.Process(_now_ms);
+                for (const ProbeClusterConfig& cluster : _probe_controller.GetAndResetPendingProbes())
+                    SendProbeCluster(cluster, capacity_bps);
+                DeliverFeedback();
+            }
+
+            if (_now_ms % 100 == 0) {
+                const int64_t feedback_capacity_bps =
+                    _last_capacity_bps > 0 ? _last_capacity_bps : capacity_bps;
+                _last_capacity_bps = capacity_bps;
+                uint32_t estimate = _rate_control.LatestEstimate();
+                BandwidthUsage state = estimate > feedback_capacity_bps
+                    ? BandwidthUsage::kBwOverusing : BandwidthUsage::kBwNormal;
+                uint32_t throughput = static_cast<uint32_t>(
+                        std::min<int64_t>(estimate, feedback_capacity_bps));
+                RateControlInput input(state, throughput);
+                _rate_control.Update(&input, _now_ms);
+                if (_enable_probing) {
+                    _probe_controller.SetEstimatedBitrate(_rate_control.LatestEstimate(), _now_ms);
+                    if (_last_state == BandwidthUsage::kBwOverusing && state == BandwidthUsage::kBwNormal)
+                        _probe_controller.RequestProbe(_now_ms);
+                }
+                _last_state = state;
+            }
+
+            if (reached_ms < 0 && _rate_control.LatestEstimate() >= target_bps)
+                reached_ms = _now_ms;
+        }
+        return reached_ms;
+    }
+
+    void Start(int64_t start_bitrate_bps, int64_t max_bitrate_bps) {
+        _now_ms = 0;
+        _rate_control.SetEstimate(start_bitrate_bps, _now_ms);
+        if (_enable_probing)
+            _probe_controller.SetBitrates(0, start_bitrate_bps, max_bitrate_bps, _now_ms);
+    }
+
+    int64_t now_ms() const { return _now_ms; }
+    uint32_t estimate() const { return _rate_control.LatestEstimate(); }
+
+private:
+    static constexpr int64_t kOneWayDelayMs = 50;
+    static constexpr size_t kProbePacketSize = 1200;
+
+    // pacer按探测码率发包, 直到包数和字节数都满足; 多个簇依次发送
+    void SendProbeCluster(const ProbeClusterConfig& cluster, int64_t capacity_bps) {
+        const int64_t send_interval_us = kProbePacketSize * 8 * 1000000 / cluster.target_bitrate_bps;
+        const int64_t transmit_us = kProbePacketSize * 8 * 1000000 / capacity_bps;
+        int64_t send_us = std::max(_now_ms * 1000, _pacer_free_us);
+        int sent_bytes = 0;
+        for (int sent = 0; sent < cluster.target_probe_count || sent_bytes < cluster.min_bytes(); ++sent) {
+            _link_free_us = std::max(_link_free_us, send_us) + transmit_us;
+            ProbePacketFeedback feedback;
+            feedback.send_time_ms = send_us / 1000;
+            feedback.arrival_time_ms = _link_free_us / 1000 + kOneWayDelayMs;
+            feedback.payload_size = kProbePacketSize;
+            feedback.probe_cluster_id = cluster.id;
+            feedback.probe_cluster_min_probes = cluster.target_probe_count;
+            feedback.probe_cluster_min_bytes = cluster.min_bytes();
+            _feedback.push_back(feedback);
+            send_us += send_interval_us;
+            sent_bytes += kProbePacketSize;
+        }
+        _pacer_free_us = send_us;
+    }
+
+    void DeliverFeedback() {
+        size_t delivered = 0;
+        for (const ProbePacketFeedback& feedback : _feedback) {
+            if (feedback.arrival_time_ms + kOneWayDelayMs > _now_ms)
+                break;
+            _probe_controller.IncomingProbePacketFeedback(feedback, _now_ms);
+            ++delivered;
+        }
+        _feedback.erase(_feedback.begin(), _feedback.begin() + delivered);
+    }
+
+    AimdRateControl _rate_control;
+    ProbeController _probe_controller;
+    const bool _enable_probing;
+    std::vector<ProbePacketFeedback> _feedback;
+    int64_t _link_free_us;
+    int64_t _pacer_free_us;
+    int64_t _last_capacity_bps = 0;
+    BandwidthUsage _last_state = BandwidthUsage::kBwNormal;
+    int64_t _now_ms = 0;
+};
+
+// TimeToTargetBitrate
+// 300kbps起步, 4Mbps链路, 估计达到容量80%所需时间
+void TestProbeController01() {
+    constexpr int64_t kCapacityBps = 4000000;
+    constexpr int64_t kStartBitrateBps = 300000;
+    constexpr int64_t kTargetBps = kCapacityBps * 8 / 10;
+
+    BottleneckSimulation with_probing(true, true);
+    with_probing.Start(kStartBitrateBps, 0);
+    int64_t with_probing_ms = with_probing.RunUntil(60000, kCapacityBps, kTargetBps);
+
+    BottleneckSimulation without_probing(false, false);
+    without_probing.Start(kStartBitrateBps, 0);
+    int64_t without_probing_ms = without_probing.RunUntil(60000, kCapacityBps, kTargetBps);
+    cout << "time to " << kTargetBps << "bps: with probing=" << with_probing_ms << "ms"
+         << " without probing=" << without_probing_ms << "ms" << endl;
+    assert(with_probing_ms >= 0 && with_probing_ms < 2000);
+    assert(without_probing_ms < 0 || without_probing_ms > 10 * with_probing_ms);
+}
+
+// RecoveryAfterLargeDrop
+// 4Mbps链路被突发的交叉流量挤占到1Mbps, 100ms后恢复, 估计回到容量80%所需时间
+void TestProbeController02() {
+    constexpr int64_t kCapacityBps = 4000000;
+    constexpr int64_t kDroppedCapacityBps = 1000000;
+    constexpr int64_t kTargetBps = kCapacityBps * 8 / 10;
+
+    int64_t recovery_ms[2];
+    for (int rapid_recovery = 0; rapid_recovery < 2; ++rapid_recovery) {
+        BottleneckSimulation simulation(true, rapid_recovery != 0);
+        simulation.Start(300000, 0);
+        simulation.RunUntil(5000, kCapacityBps, kTargetBps);
+        assert(simulation.estimate() >= kTargetBps);
+        simulation.RunUntil(5100, kDroppedCapacityBps, kTargetBps);
+        const int64_t restored_ms = simulation.now_ms();
+        // 5100ms的反馈反映了挤占, 码率降到1Mbps以下
+        simulation.RunUntil(5110, kCapacityBps, kTargetBps);
+        assert(simulation.estimate() < kDroppedCapacityBps);
+        int64_t reached_ms = simulation.RunUntil(30000, kCapacityBps, kTargetBps);
+        recovery_ms[rapid_recovery] = reached_ms < 0 ? -1 : reached_ms - restored_ms;
+    }
+    cout << "recovery to " << kTargetBps << "bps: with rapid recovery=" << recovery_ms[1] << "ms"
+         << " without=" << recovery_ms[0] << "ms" << endl;
+    assert(recovery_ms[1] >= 0);
+    assert(recovery_ms[0] < 0 || recovery_ms[1] < recovery_ms[0]);
+}
+
+} // namespace webrtc
+
+int main() {
+    webrtc::TestProbeBitrateEstimator01();
+    webrtc::TestProbeController01();
+    webrtc::TestProbeController02();
+
+    return 0;
+}
@@ -56,12 +56,12 @@ void RateStatistics::EraseOld(int64_t now_ms) {
     // New oldest time is older than the current one, no need to cull data.
     if (new_oldest_time <= _oldest_time) {
         // 经过窗口大小时间,窗口满后，才开始擦除数据
-        cout << "[EraseOld failed] _oldest_time=" << _oldest_time <<  " new_oldest_time=" << new_oldest_time << endl;
+        // cout << "[EraseOld failed] _oldest_time=" << _oldest_time <<  " new_oldest_time=" << new_oldest_time << endl;
         return;
     }
 
-    cout << "[EraseOld] _oldest_time=" << _oldest_time << " new_oldest_time=" << new_oldest_time 
-         << " now_ms=" << now_ms << " _current_window_size_ms=" << _current_window_size_ms << endl;
+    // cout << "[EraseOld] _oldest_time=" << _oldest_time << " new_oldest_time=" << new_oldest_time
+    //      << " now_ms=" << now_ms << " _current_window_size_ms=" << _current_window_size_ms << endl;
 
     // 删除[oldest_time,new_oldest_time)区间下的bucket
     // oldest_time 和 old_index 的对应关系？？？
@@ -87,6 +87,23 @@ void RateStatistics::EraseOld(int64_t now_ms) {
 // 计算窗口时间内的码率, 窗口越大采样点越多,计算越精确
 // 前期还未增长到窗口大小(ms),无法计算码率
 void RateStatistics::Update(size_t count, int64_t now_ms) {
+    AddSamples(count, 1, now_ms);
+}
+
+void RateStatistics::Update(const size_t* counts, const int64_t* times_ms, size_t num_samples) {
+    size_t i = 0;
+    while (i < num_samples) {
+        const int64_t now_ms = times_ms[i];
+        size_t count = counts[i];
+        size_t j = i + 1;
+        for (; j < num_samples && times_ms[j] == now_ms; ++j)
+            count += counts[j];
+        AddSamples(count, j - i, now_ms);
+        i = j;
+    }
+}
+
+void RateStatistics::AddSamples(size_t count, size_t num_samples, int64_t now_ms) {
     if (now_ms < _oldest_time) {
         // Too old data is ignored.
         return;
@@ -108,12 +125,20 @@ void RateStatistics::Update(size_t count, int64_t now_ms) {
     if (index >= _max_window_size_ms)
         index -= _max_window_size_ms;
 
-    cout << "[Update] index=" << index << " _oldest_index=" << _oldest_index << " now_offset=" << now_offset
-         << " now_ms=" << now_ms << " _oldest_time=" << _oldest_time << endl;
+    // cout << "[Update] index=" << index << " _oldest_index=" << _oldest_index << " now_offset=" << now_offset
+    //      << " now_ms=" << now_ms << " _oldest_time=" << _oldest_time << endl;
     _buckets[index].sum += count;
-    ++_buckets[index].samples;
+    _buckets[index].samples += num_samples;
     _accumulated_count += count;
-    ++_num_samples;
+    _num_samples += num_samples;
+}
+
+bool RateStatistics::SetWindowSize(int64_t window_size_ms, int64_t now_ms) {
+    if (window_size_ms <= 0 || window_size_ms > _max_window_size_ms)
+        return false;
+    _current_window_size_ms = window_size_ms;
+    EraseOld(now_ms);
+    return true;
 }
 
 uint32_t RateStatistics::Rate(int64_t now_ms) const {
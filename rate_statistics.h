@@ -34,6 +34,10 @@ public:
     // Update rate with a new data point, moving averaging window as needed.
     void Update(size_t count, int64_t now_ms);
 
+    // 批量更新, 结果与依次调用Update()相同。相邻的同一ms的样本先合并, 每个ms只滑动
+    // 一次窗口、写一次bucket。
+    void Update(const size_t* counts, const int64_t* times_ms, size_t num_samples);
+
     // Note that despite this being a const method, it still updates the internal
     // state (moves averaging window), but it doesn't make any alterations that
     // are observable from the other methods, as long as supplied timestamps are
@@ -42,8 +46,14 @@ public:
     // the window as much or more.
     uint32_t Rate(int64_t now_ms) const;
 
+    // Update the size of the averaging window. The maximum allowed value for
+    // window_size_ms is max_window_size_ms as supplied in the constructor.
+    bool SetWindowSize(int64_t window_size_ms, int64_t now_ms);
+
 private:
     void EraseOld(int64_t now_ms);
+    // |num_samples|个样本共|count|, 都在now_ms
+    void AddSamples(size_t count, size_t num_samples, int64_t now_ms);
     bool IsInitialized() const;
 
     // 每ms对应一个bucket
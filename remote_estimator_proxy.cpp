@@ -0,0 +1,239 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file remote_estimator_proxy.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "remote_estimator_proxy.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "safe_minmax.h"
+
+namespace webrtc {
+
+namespace {
+// 预先分配的反馈包个数, 一次Process()需要更多时才会增加
+constexpr size_t kInitialFeedbackPackets = 4;
+} // namespace
+
+constexpr int64_t RemoteEstimatorProxy::kMaxNumberOfPackets;
+constexpr size_t RemoteEstimatorProxy::kMaxUnwrapBatch;
+
+TransportWideFeedbackConfig::TransportWideFeedbackConfig()
+    : use_bandwidth_fraction(true),
+    bandwidth_fraction(0.05),
+    default_interval_ms(100),
+    min_interval_ms(50),
+    max_interval_ms(250),
+    back_window_ms(500) {}
+
+RemoteEstimatorProxy::RemoteEstimatorProxy()
+    : RemoteEstimatorProxy(TransportWideFeedbackConfig()) {}
+
+RemoteEstimatorProxy::RemoteEstimatorProxy(const TransportWideFeedbackConfig& config)
+    : _config(config),
+    _sender_ssrc(0),
+    _media_ssrc(0),
+    _feedback_packet_count(0),
+    _last_process_time_ms(-1),
+    _send_interval_ms(config.default_interval_ms),
+    _arrival_times(kMaxNumberOfPackets, -1),
+    _begin_seq(0),
+    _end_seq(0),
+    _window_start_seq(-1),
+    _num_feedback_packets(0),
+    _batch_sequence_numbers(kMaxNumberOfPackets),
+    _batch_arrival_times_us(kMaxNumberOfPackets) {
+    for (size_t i = 0; i < kInitialFeedbackPackets; ++i)
+        _feedback_packets.emplace_back(new rtcp::TransportFeedback());
+}
+
+RemoteEstimatorProxy::~RemoteEstimatorProxy() {}
+
+void RemoteEstimatorProxy::IncomingPacket(int64_t arrival_time_ms, uint32_t media_ssrc,
+        uint16_t transport_sequence_number) {
+    if (arrival_time_ms < 0 || arrival_time_ms > std::numeric_limits<int64_t>::max() / 1000) {
+        // RTC_LOG(LS_WARNING) << "Arrival time out of bounds: " << arrival_time_ms;
+        return;
+    }
+    _media_ssrc = media_ssrc;
+    OnPacketArrival(_unwrapper.Unwrap(transport_sequence_number), arrival_time_ms);
+}
+
+void RemoteEstimatorProxy::IncomingPackets(const int64_t* arrival_times_ms,
+        const uint32_t* media_ssrcs, const uint16_t* transport_sequence_numbers,
+        size_t num_packets) {
+    uint16_t sequence_numbers[kMaxUnwrapBatch];
+    int64_t arrivals_ms[kMaxUnwrapBatch];
+    int64_t unwrapped[kMaxUnwrapBatch];
+    size_t i = 0;
+    while (i < num_packets) {
+        // 到达时间不合法的包不unwrap, 和逐个调用一样不改变unwrapper的状态
+        size_t n = 0;
+        for (; i < num_packets && n < kMaxUnwrapBatch; ++i) {
+            if (arrival_times_ms[i] < 0 ||
+                    arrival_times_ms[i] > std::numeric_limits<int64_t>::max() / 1000) {
+                continue;
+            }
+            sequence_numbers[n] = transport_sequence_numbers[i];
+            arrivals_ms[n] = arrival_times_ms[i];
+            _media_ssrc = media_ssrcs[i];
+            ++n;
+        }
+        _unwrapper.UnwrapBatch(sequence_numbers, n, unwrapped);
+        for (size_t k = 0; k < n; ++k)
+            OnPacketArrival(unwrapped[k], arrivals_ms[k]);
+    }
+}
+
+void RemoteEstimatorProxy::OnBitrateChanged(int bitrate_bps) {
+    if (!_config.use_bandwidth_fraction)
+        return;
+    // TwccReportSize = Ipv4(20B) + UDP(8B) + SRTP(10B) +
+    // AverageTwccReport(30B)
+    // TwccReport size at 50ms interval is 24 byte.
+    // TwccReport size at 250ms interval is 36 byte.
+    // AverageTwccReport = (TwccReport(50ms) + TwccReport(250ms)) / 2
+    constexpr int kTwccReportSize = 20 + 8 + 10 + 30;
+    const double kMinTwccRate = kTwccReportSize * 8.0 * 1000.0 / _config.max_interval_ms;
+    const double kMaxTwccRate = kTwccReportSize * 8.0 * 1000.0 / _config.min_interval_ms;
+
+    // Let TWCC reports occupy 5% of total bandwidth.
+    _send_interval_ms = static_cast<int>(0.5 + kTwccReportSize * 8.0 * 1000.0 /
+            rtc::SafeClamp(_config.bandwidth_fraction * bitrate_bps, kMinTwccRate, kMaxTwccRate));
+}
+
+int64_t RemoteEstimatorProxy::TimeUntilNextProcess(int64_t now_ms) const {
+    if (_last_process_time_ms < 0)
+        return 0;
+    return std::max<int64_t>(_last_process_time_ms + _send_interval_ms - now_ms, 0);
+}
+
+size_t RemoteEstimatorProxy::Process(int64_t now_ms) {
+    _num_feedback_packets = 0;
+    if (TimeUntilNextProcess(now_ms) > 0)
+        return 0;
+    _last_process_time_ms = now_ms;
+    SendPeriodicFeedbacks();
+    return _num_feedback_packets;
+}
+
+const rtcp::TransportFeedback& RemoteEstimatorProxy::GetFeedbackPacket(size_t index) const {
+    assert(index < _num_feedback_packets);
+    return *_feedback_packets[index];
+}
+
+void RemoteEstimatorProxy::OnPacketArrival(int64_t seq, int64_t arrival_time_ms) {
+    // 比环中最新的包还早kMaxNumberOfPackets以上, 已经无法反馈
+    if (_begin_seq < _end_seq && seq <= _end_seq - kMaxNumberOfPackets)
+        return;
+
+    if (_window_start_seq >= 0 && _window_start_seq >= _end_seq) {
+        // 上一个窗口的包都已经反馈过, 开始新的反馈包时剔除过旧的包
+        // Start new feedback packet, cull old packets.
+        while (_begin_seq < _end_seq && _begin_seq < seq) {
+            int64_t& arrival = ArrivalTime(_begin_seq);
+            if (arrival >= 0 && arrival_time_ms - arrival < _config.back_window_ms)
+                break;
+            arrival = -1;
+            ++_begin_seq;
+        }
+    }
+    if (_window_start_seq < 0 || seq < _window_start_seq)
+        _window_start_seq = seq;
+
+    if (_begin_seq == _end_seq) {
+        _begin_seq = seq;
+        _end_seq = seq + 1;
+    } else if (seq >= _end_seq) {
+        // Limit the range of sequence numbers to send feedback for.
+        int64_t first_to_keep = seq - kMaxNumberOfPackets + 1;
+        if (first_to_keep > _begin_seq) {
+            for (int64_t s = _begin_seq; s < std::min(first_to_keep, _end_seq); ++s)
+                ArrivalTime(s) = -1;
+            _begin_seq = first_to_keep;
+            while (_begin_seq < _end_seq && ArrivalTime(_begin_seq) < 0)
+                ++_begin_seq;
+            if (_begin_seq >= _end_seq)
+                _begin_seq = seq;
+            _window_start_seq = std::max(_window_start_seq, _begin_seq);
+        }
+        _end_seq = seq + 1;
+    } else if (seq >= _begin_seq) {
+        // We are only interested in the first time a packet is received.
+        if (ArrivalTime(seq) >= 0)
+            return;
+    } else {
+        _begin_seq = seq;
+    }
+    ArrivalTime(seq) = arrival_time_ms;
+}
+
+void RemoteEstimatorProxy::SendPeriodicFeedbacks() {
+    // |_window_start_seq| is the first sequence number to include in the
+    // current feedback packet. Some older may still be in the ring, in case a
+    // reordering happens and we need to retransmit them.
+    if (_window_start_seq < 0)
+        return;
+
+    while (true) {
+        int64_t first_received = std::max(_window_start_seq, _begin_seq);
+        while (first_received < _end_seq && ArrivalTime(first_received) < 0)
+            ++first_received;
+        if (first_received >= _end_seq)
+            break;
+
+        if (_num_feedback_packets == _feedback_packets.size())
+            _feedback_packets.emplace_back(new rtcp::TransportFeedback());
+        rtcp::TransportFeedback* feedback_packet = _feedback_packets[_num_feedback_packets++].get();
+        feedback_packet->Reset();
+        _window_start_seq = BuildFeedbackPacket(_window_start_seq, first_received, feedback_packet);
+        // Note: Don't clear the ring after sending, in case the packets need
+        // to be re-sent after a reordering. Removal will be handled by
+        // OnPacketArrival once packets are too old.
+    }
+}
+
+int64_t RemoteEstimatorProxy::BuildFeedbackPacket(int64_t base_sequence_number,
+        int64_t first_received, rtcp::TransportFeedback* feedback_packet) {
+    feedback_packet->SetSenderSsrc(_sender_ssrc);
+    feedback_packet->SetMediaSsrc(_media_ssrc);
+    // Base sequence number is the expected first sequence number. This is known,
+    // but we might not have actually received it, so the base time shall be the
+    // time of the first received packet in the feedback.
+    feedback_packet->SetBase(static_cast<uint16_t>(base_sequence_number & 0xFFFF),
+            ArrivalTime(first_received) * 1000);
+    feedback_packet->SetFeedbackSequenceNumber(_feedback_packet_count++);
+
+    size_t num_received = 0;
+    for (int64_t seq = first_received; seq < _end_seq; ++seq) {
+        int64_t arrival_time_ms = ArrivalTime(seq);
+        if (arrival_time_ms < 0)
+            continue;
+        _batch_sequence_numbers[num_received] = static_cast<uint16_t>(seq & 0xFFFF);
+        _batch_arrival_times_us[num_received] = arrival_time_ms * 1000;
+        ++num_received;
+    }
+    size_t num_added = feedback_packet->AddReceivedPackets(_batch_sequence_numbers.data(),
+            _batch_arrival_times_us.data(), num_received);
+    // If we can't even add the first seq to the feedback packet, we won't be
+    // able to build it at all.
+    assert(num_added > 0);
+    if (num_added == num_received)
+        return _end_seq;
+
+    // Could not add timestamp, feedback packet might be full. Return and
+    // try again with a fresh packet.
+    uint16_t last_added = _batch_sequence_numbers[num_added - 1];
+    return base_sequence_number +
+        static_cast<uint16_t>(last_added - static_cast<uint16_t>(base_sequence_number)) + 1;
+}
+
+} // namespace webrtc
@@ -0,0 +1,112 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file remote_estimator_proxy.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _REMOTE_ESTIMATOR_PROXY_H
+#define _REMOTE_ESTIMATOR_PROXY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "module_common_types_public.h"
+#include "transport_feedback.h"
+
+namespace webrtc {
+
+struct TransportWideFeedbackConfig {
+    TransportWideFeedbackConfig();
+
+    // true: 按OnBitrateChanged()的码率调整发送间隔, 使反馈约占码率的
+    // bandwidth_fraction, 间隔限制在[min_interval_ms, max_interval_ms];
+    // false: 固定按default_interval_ms发送。
+    bool use_bandwidth_fraction;
+    double bandwidth_fraction;
+    int64_t default_interval_ms;
+    int64_t min_interval_ms;
+    int64_t max_interval_ms;
+    // 已反馈过的包保留这么久, 乱序到达时可以连同旧包重新反馈
+    int64_t back_window_ms;
+};
+
+// 接收端的transport-wide cc: 记录每个transport sequence number的到达时间,
+// 定期生成TransportFeedback发回发送端, 由发送端做带宽估计。
+//
+// 到达时间保存在按unwrap后的序号索引的环形数组中(2的幂), 不使用std::map;
+// 反馈包对象预先分配并复用, 稳定运行时生成反馈不分配内存。
+//
+// Note: This class is not thread-safe.
+class RemoteEstimatorProxy {
+public:
+    // 环中最多保存的序号个数, 同时也是一次反馈能覆盖的最大范围。
+    // 范围必须小于0x8000, 否则反馈包中第一个包和base sequence无法比较新旧
+    static constexpr int64_t kMaxNumberOfPackets = 1 << 14;
+    static constexpr size_t kMaxUnwrapBatch = 64;
+
+    RemoteEstimatorProxy();
+    explicit RemoteEstimatorProxy(const TransportWideFeedbackConfig& config);
+    ~RemoteEstimatorProxy();
+
+    void SetSenderSsrc(uint32_t ssrc) { _sender_ssrc = ssrc; }
+    void IncomingPacket(int64_t arrival_time_ms, uint32_t media_ssrc,
+            uint16_t transport_sequence_number);
+    // 批量处理, 结果与依次调用IncomingPacket()相同; 序号按kMaxUnwrapBatch个一段批量unwrap
+    void IncomingPackets(const int64_t* arrival_times_ms, const uint32_t* media_ssrcs,
+            const uint16_t* transport_sequence_numbers, size_t num_packets);
+    void OnBitrateChanged(int bitrate_bps);
+
+    // Returns the time in ms until Process() should be called.
+    int64_t TimeUntilNextProcess(int64_t now_ms) const;
+    // 到了发送时间则为所有未反馈的包生成反馈包(放不下时分成多个), 返回生成的个数。
+    // 反馈包通过GetFeedbackPacket()取出, 在下一次Process()之前有效。
+    size_t Process(int64_t now_ms);
+    const rtcp::TransportFeedback& GetFeedbackPacket(size_t index) const;
+
+    int64_t send_interval_ms() const { return _send_interval_ms; }
+
+private:
+    void OnPacketArrival(int64_t sequence_number, int64_t arrival_time_ms);
+    void SendPeriodicFeedbacks();
+    // Returns the first sequence number not included in |feedback_packet|.
+    int64_t BuildFeedbackPacket(int64_t base_sequence_number,
+            int64_t first_received_sequence_number,
+            rtcp::TransportFeedback* feedback_packet);
+    int64_t& ArrivalTime(int64_t sequence_number) {
+        return _arrival_times[sequence_number & (kMaxNumberOfPackets - 1)];
+    }
+
+    const TransportWideFeedbackConfig _config;
+    SequenceNumberUnwrapper _unwrapper;
+    uint32_t _sender_ssrc;
+    uint32_t _media_ssrc;
+    uint8_t _feedback_packet_count;
+    int64_t _last_process_time_ms;
+    int64_t _send_interval_ms;
+
+    // 序号在[_begin_seq, _end_seq)内的到达时间, -1表示没有收到; 范围外的槽位都是-1
+    std::vector<int64_t> _arrival_times;
+    int64_t _begin_seq;
+    int64_t _end_seq;
+    // 下一个反馈包的第一个序号, -1 if no packet has arrived yet.
+    int64_t _window_start_seq;
+
+    std::vector<std::unique_ptr<rtcp::TransportFeedback>> _feedback_packets;
+    size_t _num_feedback_packets;
+    // 构造反馈包时的批量输入, 预先分配
+    std::vector<uint16_t> _batch_sequence_numbers;
+    std::vector<int64_t> _batch_arrival_times_us;
+};
+
+} // namespace webrtc
+
+#endif // _REMOTE_ESTIMATOR_PROXY_H
+
+
@@ -0,0 +1,229 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file remote_estimator_proxy_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ remote_estimator_proxy_unittest.cpp remote_estimator_proxy.cpp transport_feedback.cpp rtpfb.cpp rtcp_packet.cpp common_header.cpp random.cpp -std=c++11
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "allocation_counter.h"
+#include "random.h"
+#include "remote_estimator_proxy.h"
+
+namespace webrtc {
+
+constexpr uint32_t kMediaSsrc = 456;
+constexpr uint16_t kBaseSeq = 10;
+constexpr int64_t kBaseTimeMs = 123;
+constexpr int64_t kMaxSmallDeltaMs = (0xFF * rtcp::TransportFeedback::kDeltaScaleFactor) / 1000;
+
+static std::vector<uint16_t> SequenceNumbers(const rtcp::TransportFeedback& feedback) {
+    std::vector<uint16_t> sequence_numbers;
+    for (const auto& packet : feedback.GetReceivedPackets())
+        sequence_numbers.push_back(packet.sequence_number());
+    return sequence_numbers;
+}
+
+static std::vector<int64_t> TimestampsMs(const rtcp::TransportFeedback& feedback) {
+    std::vector<int64_t> timestamps;
+    int64_t timestamp_us = feedback.GetBaseTimeUs();
+    for (const auto& packet : feedback.GetReceivedPackets()) {
+        timestamp_us += packet.delta_us();
+        timestamps.push_back(timestamp_us / 1000);
+    }
+    return timestamps;
+}
+
+// SendsSinglePacketFeedback / DuplicatedPackets / FeedbackWithMissingStart
+void TestRemoteEstimatorProxy01() {
+    RemoteEstimatorProxy proxy;
+    // 还没有收到包时不生成反馈
+    assert(proxy.Process(kBaseTimeMs) == 0);
+
+    proxy.IncomingPacket(kBaseTimeMs, kMediaSsrc, kBaseSeq);
+    proxy.IncomingPacket(kBaseTimeMs + 1000, kMediaSsrc, kBaseSeq);
+    assert(proxy.Process(kBaseTimeMs + 100) == 1);
+    const rtcp::TransportFeedback& feedback = proxy.GetFeedbackPacket(0);
+    assert(feedback.media_ssrc() == kMediaSsrc);
+    assert(feedback.GetBaseSequence() == kBaseSeq);
+    assert(feedback.GetPacketStatusCount() == 1);
+    assert(SequenceNumbers(feedback) == std::vector<uint16_t>({kBaseSeq}));
+    assert(TimestampsMs(feedback) == std::vector<int64_t>({kBaseTimeMs}));
+
+    // 没有新的包
+    assert(proxy.Process(kBaseTimeMs + 200) == 0);
+}
+
+// SendsFeedbackWithVaryingDeltas / SendsFragmentedFeedback
+// 1字节, 2字节delta写进同一个反馈包; 超过16位的delta要分成两个反馈包
+void TestRemoteEstimatorProxy02() {
+    RemoteEstimatorProxy proxy;
+    const int64_t kTooLargeDelta = rtcp::TransportFeedback::kDeltaScaleFactor *
+        std::numeric_limits<int16_t>::max() / 1000 + 1;
+
+    proxy.IncomingPacket(kBaseTimeMs, kMediaSsrc, kBaseSeq);
+    proxy.IncomingPacket(kBaseTimeMs + kMaxSmallDeltaMs, kMediaSsrc, kBaseSeq + 1);
+    proxy.IncomingPacket(kBaseTimeMs + kMaxSmallDeltaMs + 1000, kMediaSsrc, kBaseSeq + 2);
+    proxy.IncomingPacket(kBaseTimeMs + kMaxSmallDeltaMs + 1000 + kTooLargeDelta, kMediaSsrc, kBaseSeq + 3);
+
+    assert(proxy.Process(kBaseTimeMs) == 2);
+    const rtcp::TransportFeedback& first = proxy.GetFeedbackPacket(0);
+    assert(first.GetBaseSequence() == kBaseSeq);
+    assert(SequenceNumbers(first) == std::vector<uint16_t>({kBaseSeq, kBaseSeq + 1, kBaseSeq + 2}));
+    assert(TimestampsMs(first) == std::vector<int64_t>({kBaseTimeMs,
+                kBaseTimeMs + kMaxSmallDeltaMs, kBaseTimeMs + kMaxSmallDeltaMs + 1000}));
+    const rtcp::TransportFeedback& second = proxy.GetFeedbackPacket(1);
+    assert(second.GetBaseSequence() == kBaseSeq + 3);
+    assert(SequenceNumbers(second) == std::vector<uint16_t>({kBaseSeq + 3}));
+    assert(TimestampsMs(second) == std::vector<int64_t>({kBaseTimeMs + kMaxSmallDeltaMs + 1000 + kTooLargeDelta}));
+    assert(second.GetFeedbackSequenceNumber() == first.GetFeedbackSequenceNumber() + 1);
+}
+
+// HandlesReorderingAndWrap / ResendsTimestampsOnReordering
+// 乱序到达的包会从它开始重新反馈, 已经反馈过的包也一起重发
+void TestRemoteEstimatorProxy03() {
+    RemoteEstimatorProxy proxy;
+    proxy.IncomingPacket(kBaseTimeMs, kMediaSsrc, 0xFFFE);
+    proxy.IncomingPacket(kBaseTimeMs + 2, kMediaSsrc, 0x0000);
+    assert(proxy.Process(kBaseTimeMs) == 1);
+    assert(proxy.GetFeedbackPacket(0).GetBaseSequence() == 0xFFFE);
+    assert(proxy.GetFeedbackPacket(0).GetPacketStatusCount() == 3);
+    assert(SequenceNumbers(proxy.GetFeedbackPacket(0)) == std::vector<uint16_t>({0xFFFE, 0x0000}));
+
+    proxy.IncomingPacket(kBaseTimeMs + 1, kMediaSsrc, 0xFFFF);
+    assert(proxy.Process(kBaseTimeMs + 100) == 1);
+    const rtcp::TransportFeedback& feedback = proxy.GetFeedbackPacket(0);
+    assert(feedback.GetBaseSequence() == 0xFFFF);
+    assert(SequenceNumbers(feedback) == std::vector<uint16_t>({0xFFFF, 0x0000}));
+    assert(TimestampsMs(feedback) == std::vector<int64_t>({kBaseTimeMs + 1, kBaseTimeMs + 2}));
+}
+
+// RemovesTimestampsOutOfScope
+// 超过back window的旧包在开始新反馈包时被剔除, 之后的乱序包不会再带上它们
+void TestRemoteEstimatorProxy04() {
+    RemoteEstimatorProxy proxy;
+    const int64_t kTimeoutTimeMs = kBaseTimeMs + TransportWideFeedbackConfig().back_window_ms;
+
+    proxy.IncomingPacket(kBaseTimeMs, kMediaSsrc, kBaseSeq + 2);
+    assert(proxy.Process(kBaseTimeMs) == 1);
+    assert(TimestampsMs(proxy.GetFeedbackPacket(0)) == std::vector<int64_t>({kBaseTimeMs}));
+
+    // kBaseSeq + 2 times out here.
+    proxy.IncomingPacket(kTimeoutTimeMs, kMediaSsrc, kBaseSeq + 3);
+    assert(proxy.Process(kTimeoutTimeMs) == 1);
+    assert(SequenceNumbers(proxy.GetFeedbackPacket(0)) == std::vector<uint16_t>({kBaseSeq + 3}));
+
+    // New group, with sequence starting below the first so that they may be
+    // retransmitted.
+    proxy.IncomingPacket(kBaseTimeMs - 1, kMediaSsrc, kBaseSeq);
+    proxy.IncomingPacket(kTimeoutTimeMs - 1, kMediaSsrc, kBaseSeq + 1);
+    assert(proxy.Process(kTimeoutTimeMs + 1000) == 1);
+    const rtcp::TransportFeedback& feedback = proxy.GetFeedbackPacket(0);
+    assert(feedback.GetBaseSequence() == kBaseSeq);
+    assert(SequenceNumbers(feedback) == std::vector<uint16_t>({kBaseSeq, kBaseSeq + 1, kBaseSeq + 3}));
+    assert(TimestampsMs(feedback) == std::vector<int64_t>({kBaseTimeMs - 1, kTimeoutTimeMs - 1, kTimeoutTimeMs}));
+}
+
+// SendInterval
+// 默认100ms; 按码率的5%计算并限制在[50, 250]ms; 关闭按码率调整时保持固定间隔
+void TestRemoteEstimatorProxy05() {
+    RemoteEstimatorProxy proxy;
+    assert(proxy.TimeUntilNextProcess(0) == 0);
+    proxy.Process(0);
+    assert(proxy.TimeUntilNextProcess(0) == 100);
+    assert(proxy.TimeUntilNextProcess(60) == 40);
+
+    proxy.OnBitrateChanged(300000);
+    assert(proxy.send_interval_ms() == 50);
+    proxy.OnBitrateChanged(0);
+    assert(proxy.send_interval_ms() == 250);
+    // TwccReportSize(68B) * 8 * 1000 / (80kbps * 5%) = 136ms
+    proxy.OnBitrateChanged(80000);
+    assert(proxy.send_interval_ms() == 136);
+
+    TransportWideFeedbackConfig config;
+    config.use_bandwidth_fraction = false;
+    config.default_interval_ms = 40;
+    RemoteEstimatorProxy fixed(config);
+    fixed.OnBitrateChanged(80000);
+    assert(fixed.send_interval_ms() == 40);
+}
+
+// 仿真: 码率为bitrate_bps, 1200字节的包, 2%丢包和少量乱序, 运行|duration_ms|,
+// 返回反馈包(含IP/UDP/SRTP开销)占媒体码率的比例
+static double RunFeedbackOverhead(RemoteEstimatorProxy* proxy, int bitrate_bps,
+        int64_t duration_ms, int64_t* now_ms, uint16_t* seq, Random* random) {
+    const int kPacketSize = 1200;
+    const int64_t kOverheadBytes = 20 + 8 + 10;
+    const double packet_interval_ms = kPacketSize * 8 * 1000.0 / bitrate_bps;
+    proxy->OnBitrateChanged(bitrate_bps);
+
+    int64_t feedback_bytes = 0;
+    double next_packet_ms = *now_ms;
+    const int64_t end_ms = *now_ms + duration_ms;
+    for (; *now_ms < end_ms; ++*now_ms) {
+        while (next_packet_ms <= *now_ms) {
+            if (random->Rand(0, 99) >= 2) {
+                // 5%的包晚到几个包的时间
+                uint16_t packet_seq = *seq;
+                if (random->Rand(0, 99) < 5 && packet_seq > 3)
+                    packet_seq -= random->Rand(1, 3);
+                proxy->IncomingPacket(*now_ms, kMediaSsrc, packet_seq);
+            }
+            ++*seq;
+            next_packet_ms += packet_interval_ms;
+        }
+        if (proxy->TimeUntilNextProcess(*now_ms) == 0) {
+            size_t num_packets = proxy->Process(*now_ms);
+            for (size_t i = 0; i < num_packets; ++i)
+                feedback_bytes += proxy->GetFeedbackPacket(i).BlockLength() + kOverheadBytes;
+        }
+    }
+    return feedback_bytes * 8 * 1000.0 / duration_ms / bitrate_bps;
+}
+
+// FeedbackOverhead / SteadyStateNoAllocation
+// 反馈开销不超过媒体码率的5%; 热身之后收包和生成反馈不再分配内存
+void TestRemoteEstimatorProxy06() {
+    const int kBitrates[] = {500000, 1000000, 2500000, 8000000};
+    int64_t now_ms = 1000;
+    uint16_t seq = 0;
+    Random random(0x37);
+    RemoteEstimatorProxy proxy;
+    for (int bitrate_bps : kBitrates) {
+        double overhead;
+        overhead = RunFeedbackOverhead(&proxy, bitrate_bps, 10000, &now_ms, &seq, &random);
+        cout << "bitrate=" << bitrate_bps << "bps interval=" << proxy.send_interval_ms()
+            << "ms feedback overhead=" << overhead * 100 << "%" << endl;
+        assert(overhead < 0.05);
+    }
+
+    size_t num_allocations;
+    RunFeedbackOverhead(&proxy, 8000000, 2000, &now_ms, &seq, &random);
+    size_t before = g_num_allocations;
+    RunFeedbackOverhead(&proxy, 8000000, 10000, &now_ms, &seq, &random);
+    num_allocations = g_num_allocations - before;
+    cout << "allocations in 10s at 8Mbps: " << num_allocations << endl;
+    assert(num_allocations == 0);
+}
+
+} // namespace webrtc
+
+int main() {
+    webrtc::TestRemoteEstimatorProxy01();
+    webrtc::TestRemoteEstimatorProxy02();
+    webrtc::TestRemoteEstimatorProxy03();
+    webrtc::TestRemoteEstimatorProxy04();
+    webrtc::TestRemoteEstimatorProxy05();
+    webrtc::TestRemoteEstimatorProxy06();
+
+    return 0;
+}
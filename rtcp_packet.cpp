@@ -0,0 +1,62 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file rtcp_packet.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "rtcp_packet.h"
+
+#include <cassert>
+
+#include "byte_io.h"
+
+namespace webrtc {
+
+namespace rtcp {
+
+std::vector<uint8_t> RtcpPacket::Build() const {
+    std::vector<uint8_t> packet(BlockLength());
+    size_t length = 0;
+    bool created = Create(packet.data(), &length, packet.size());
+    assert(created && length == packet.size());
+    (void)created;
+    return packet;
+}
+
+size_t RtcpPacket::HeaderLength() const {
+    size_t length_in_bytes = BlockLength();
+    assert(length_in_bytes > 0 && length_in_bytes % 4 == 0);
+    // Length in 32-bit words without common header.
+    return (length_in_bytes - kHeaderLength) / 4;
+}
+
+// From RFC 3550, RTP: A Transport Protocol for Real-Time Applications.
+//
+// RTP header format.
+//   0                   1                   2                   3
+//   0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |V=2|P| RC/FMT  |      PT       |             length            |
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+void RtcpPacket::CreateHeader(size_t count_or_format, uint8_t packet_type,
+        size_t length, bool padding, uint8_t* buffer, size_t* pos) {
+    assert(length <= 0xffffU);
+    assert(count_or_format <= 0x1f);
+    const uint8_t kVersionBits = 2 << 6; // Version 2.
+    const uint8_t kNoPaddingBit = 0 << 5;
+    const uint8_t kPaddingBit = 1 << 5;
+    buffer[*pos + 0] = kVersionBits | (padding ? kPaddingBit : kNoPaddingBit) |
+        static_cast<uint8_t>(count_or_format);
+    buffer[*pos + 1] = packet_type;
+    buffer[*pos + 2] = (length >> 8) & 0xff;
+    buffer[*pos + 3] = length & 0xff;
+    *pos += kHeaderLength;
+}
+
+} // namespace rtcp
+
+} // namespace webrtc
@@ -0,0 +1,90 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file rtcp_packet.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _RTCP_PACKET_H
+#define _RTCP_PACKET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace webrtc {
+
+namespace rtcp {
+
+// Class for building RTCP packets.
+//
+//  Example:
+//  ReportBlock report_block;
+//  report_block.SetMediaSsrc(234);
+//  report_block.SetFractionLost(10);
+//
+//  ReceiverReport rr;
+//  rr.SetSenderSsrc(123);
+//  rr.AddReportBlock(report_block);
+//
+//  Fir fir;
+//  fir.SetSenderSsrc(123);
+//  fir.AddRequestTo(234, 56);
+//
+//  size_t length = 0;                     // Builds an intra frame request
+//  uint8_t packet[kPacketSize];           // with sequence number 56.
+//  fir.Build(packet, &length, kPacketSize);
+//
+//  std::vector<uint8_t> packet = rr.Build();  // Returns a RTCP packet
+//                                             // with RR and FIR.
+//
+// 这里只保留了单个包的序列化, 不支持复合包的分片回调
+class RtcpPacket {
+public:
+    // Size of the rtcp common header.
+    static constexpr size_t kHeaderLength = 4;
+
+    virtual ~RtcpPacket() {}
+
+    void SetSenderSsrc(uint32_t ssrc) { _sender_ssrc = ssrc; }
+    uint32_t sender_ssrc() const { return _sender_ssrc; }
+
+    // Convenience method mostly used for test. Creates packet without
+    // fragmentation using BlockLength() to allocate big enough buffer.
+    std::vector<uint8_t> Build() const;
+
+    // Size of this packet in bytes (including headers).
+    virtual size_t BlockLength() const = 0;
+
+    // Creates packet in the given buffer at the given position.
+    // Returns false if the packet does not fit in |max_length|.
+    virtual bool Create(uint8_t* packet, size_t* index, size_t max_length) const = 0;
+
+protected:
+    RtcpPacket() : _sender_ssrc(0) {}
+
+    static void CreateHeader(size_t count_or_format, // Depends on packet type.
+            uint8_t packet_type,
+            size_t block_length, // Payload size in 32bit words.
+            bool padding,        // True if there are padding bytes.
+            uint8_t* buffer,
+            size_t* pos);
+
+    // Length of the packet body in 32 bit words, without the common header.
+    size_t HeaderLength() const;
+
+private:
+    uint32_t _sender_ssrc;
+};
+
+} // namespace rtcp
+
+} // namespace webrtc
+
+#endif // _RTCP_PACKET_H
+
+
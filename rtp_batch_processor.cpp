@@ -0,0 +1,87 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file rtp_batch_processor.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "rtp_batch_processor.h"
+
+#include <cassert>
+
+namespace webrtc {
+
+constexpr size_t RtpBatchProcessor::kMaxBatchSize;
+constexpr int64_t RtpBatchProcessor::kTimestampGroupLengthMs;
+constexpr int64_t RtpBatchProcessor::kBitrateWindowMs;
+
+RtpBatchProcessor::RtpBatchProcessor(const RtpHeaderExtensionMap& extensions,
+        RemoteEstimatorProxy* proxy)
+    : _extensions(extensions),
+    _proxy(proxy),
+    _inter_arrival(static_cast<uint32_t>((kTimestampGroupLengthMs << RtpPacketView::kInterArrivalShift) / 1000),
+            RtpPacketView::kInterArrivalTimestampToMs, true),
+    _incoming_bitrate(kBitrateWindowMs, RateStatistics::kBpsScale),
+    _total_packets(0),
+    _total_invalid_packets(0),
+    _total_deltas(0),
+    _num_valid(0),
+    _num_timed(0),
+    _num_sequenced(0),
+    _num_deltas(0) {}
+
+size_t RtpBatchProcessor::OnPackets(const uint8_t* const* packets, const size_t* sizes,
+        const int64_t* arrival_times_us, size_t num_packets) {
+    assert(num_packets <= kMaxBatchSize);
+    _num_valid = 0;
+    _num_timed = 0;
+    _num_sequenced = 0;
+    for (size_t i = 0; i < num_packets; ++i) {
+        if (!_view.Parse(packets[i], sizes[i], &_extensions)) {
+            ++_total_invalid_packets;
+            continue;
+        }
+        const int64_t arrival_time_ms = arrival_times_us[i] / 1000;
+        _sizes[_num_valid] = sizes[i];
+        _arrival_times_ms[_num_valid] = arrival_time_ms;
+        ++_num_valid;
+
+        uint32_t send_time_24bits;
+        if (_view.GetAbsoluteSendTime(&send_time_24bits)) {
+            _send_times[_num_timed] = RtpPacketView::AbsSendTimeToInterArrivalTimestamp(send_time_24bits);
+            _timed_arrival_times_ms[_num_timed] = arrival_time_ms;
+            _timed_sizes[_num_timed] = _view.payload_size() + _view.padding_size();
+            ++_num_timed;
+        }
+        uint16_t transport_sequence_number;
+        if (_view.GetTransportSequenceNumber(&transport_sequence_number)) {
+            _media_ssrcs[_num_sequenced] = _view.ssrc();
+            _transport_sequence_numbers[_num_sequenced] = transport_sequence_number;
+            _sequenced_arrival_times_ms[_num_sequenced] = arrival_time_ms;
+            ++_num_sequenced;
+        }
+    }
+    _total_packets += num_packets;
+
+    _incoming_bitrate.Update(_sizes, _arrival_times_ms, _num_valid);
+    // 没有单独的系统时钟, 系统时间就用到达时间
+    _num_deltas = _inter_arrival.ComputeDeltas(_send_times, _timed_arrival_times_ms,
+            _timed_arrival_times_ms, _timed_sizes, _num_timed, _timestamp_deltas,
+            _arrival_time_deltas_ms, _packet_size_deltas, nullptr);
+    _total_deltas += _num_deltas;
+    if (_proxy) {
+        _proxy->IncomingPackets(_sequenced_arrival_times_ms, _media_ssrcs,
+                _transport_sequence_numbers, _num_sequenced);
+    }
+    return _num_valid;
+}
+
+double RtpBatchProcessor::send_delta_ms(size_t index) const {
+    return _timestamp_deltas[index] * RtpPacketView::kInterArrivalTimestampToMs;
+}
+
+} // namespace webrtc
+
@@ -0,0 +1,90 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file rtp_batch_processor.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _RTP_BATCH_PROCESSOR_H
+#define _RTP_BATCH_PROCESSOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "inter_arrival.h"
+#include "rate_statistics.h"
+#include "remote_estimator_proxy.h"
+#include "rtp_header_extension_map.h"
+#include "rtp_packet_view.h"
+
+namespace webrtc {
+
+// 接收端按批处理RTP包: 一批包(通常是UdpBatchReceiver一次Receive()的结果)先全部解析
+// 成按列存放的数组, 再分别整批交给InterArrival(abs-send-time包组)、RateStatistics
+// (接收码率)和RemoteEstimatorProxy(transport-wide序号), 每个模块每批只调用一次。
+// 结果与逐包调用各模块相同。
+//
+// Note: This class is not thread-safe.
+class RtpBatchProcessor {
+public:
+    static constexpr size_t kMaxBatchSize = 64;
+    static constexpr int64_t kTimestampGroupLengthMs = 5;
+    static constexpr int64_t kBitrateWindowMs = 1000;
+
+    // |proxy|可以为nullptr, 此时不生成transport-wide反馈
+    RtpBatchProcessor(const RtpHeaderExtensionMap& extensions, RemoteEstimatorProxy* proxy);
+
+    // |num_packets|不超过kMaxBatchSize, 到达时间是同一个单调时钟的us。
+    // 返回合法的RTP包个数。
+    size_t OnPackets(const uint8_t* const* packets, const size_t* sizes,
+            const int64_t* arrival_times_us, size_t num_packets);
+
+    // 上一次OnPackets()算出的包组deltas, 按InterArrival的定义
+    size_t num_deltas() const { return _num_deltas; }
+    double send_delta_ms(size_t index) const;
+    int64_t recv_delta_ms(size_t index) const { return _arrival_time_deltas_ms[index]; }
+    int size_delta(size_t index) const { return _packet_size_deltas[index]; }
+
+    uint32_t IncomingBitrate(int64_t now_ms) const { return _incoming_bitrate.Rate(now_ms); }
+
+    int64_t total_packets() const { return _total_packets; }
+    int64_t total_invalid_packets() const { return _total_invalid_packets; }
+    int64_t total_deltas() const { return _total_deltas; }
+
+private:
+    const RtpHeaderExtensionMap& _extensions;
+    RemoteEstimatorProxy* const _proxy;
+    RtpPacketView _view;
+    InterArrival _inter_arrival;
+    RateStatistics _incoming_bitrate;
+
+    int64_t _total_packets;
+    int64_t _total_invalid_packets;
+    int64_t _total_deltas;
+
+    // 解析结果, 按列存放。带abs-send-time的包和带transport-wide序号的包各自一组
+    size_t _num_valid;
+    size_t _sizes[kMaxBatchSize];
+    int64_t _arrival_times_ms[kMaxBatchSize];
+    size_t _num_timed;
+    uint32_t _send_times[kMaxBatchSize];
+    int64_t _timed_arrival_times_ms[kMaxBatchSize];
+    size_t _timed_sizes[kMaxBatchSize];
+    size_t _num_sequenced;
+    uint32_t _media_ssrcs[kMaxBatchSize];
+    uint16_t _transport_sequence_numbers[kMaxBatchSize];
+    int64_t _sequenced_arrival_times_ms[kMaxBatchSize];
+
+    size_t _num_deltas;
+    uint32_t _timestamp_deltas[kMaxBatchSize];
+    int64_t _arrival_time_deltas_ms[kMaxBatchSize];
+    int _packet_size_deltas[kMaxBatchSize];
+};
+
+} // namespace webrtc
+
+#endif // _RTP_BATCH_PROCESSOR_H
+
@@ -0,0 +1,57 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file rtp_header_extension_map.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "rtp_header_extension_map.h"
+
+#include <string.h>
+
+namespace webrtc {
+
+constexpr int RtpHeaderExtensionMap::kInvalidId;
+constexpr int RtpHeaderExtensionMap::kMinId;
+constexpr int RtpHeaderExtensionMap::kMaxId;
+constexpr int RtpHeaderExtensionMap::kOneByteHeaderExtensionMaxId;
+
+RtpHeaderExtensionMap::RtpHeaderExtensionMap() {
+    memset(_types, kRtpExtensionNone, sizeof(_types));
+    memset(_ids, kInvalidId, sizeof(_ids));
+}
+
+bool RtpHeaderExtensionMap::Register(int id, RTPExtensionType type) {
+    if (type == kRtpExtensionNone || type >= kRtpExtensionNumberOfExtensions) {
+        // RTC_LOG(LS_WARNING) << "Invalid RTP extension type: " << type;
+        return false;
+    }
+    if (id < kMinId || id > kMaxId) {
+        // RTC_LOG(LS_WARNING) << "Failed to register extension type=" << type
+        //     << " with invalid id=" << id;
+        return false;
+    }
+    if (_ids[type] == id)
+        return true;
+    if (_ids[type] != kInvalidId || _types[id] != kRtpExtensionNone) {
+        // RTC_LOG(LS_WARNING) << "Failed to register extension type=" << type
+        //     << " with id=" << id << ", already registered";
+        return false;
+    }
+    _types[id] = type;
+    _ids[type] = static_cast<uint8_t>(id);
+    return true;
+}
+
+void RtpHeaderExtensionMap::Deregister(RTPExtensionType type) {
+    if (type >= kRtpExtensionNumberOfExtensions || _ids[type] == kInvalidId)
+        return;
+    _types[_ids[type]] = kRtpExtensionNone;
+    _ids[type] = kInvalidId;
+}
+
+} // namespace webrtc
+
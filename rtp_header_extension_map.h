@@ -0,0 +1,56 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file rtp_header_extension_map.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _RTP_HEADER_EXTENSION_MAP_H
+#define _RTP_HEADER_EXTENSION_MAP_H
+
+#include <stdint.h>
+
+namespace webrtc {
+
+enum RTPExtensionType : uint8_t {
+    kRtpExtensionNone = 0,
+    kRtpExtensionTransmissionTimeOffset,
+    kRtpExtensionAbsoluteSendTime,
+    kRtpExtensionTransportSequenceNumber,
+    kRtpExtensionNumberOfExtensions,
+};
+
+// SDP协商出的RTP头扩展id到类型的映射。id是下标直接查表, 解析每个扩展只要一次访存。
+// one-byte头扩展的id是1-14, two-byte头扩展的id是1-255。
+//
+// Note: This class is not thread-safe.
+class RtpHeaderExtensionMap {
+public:
+    static constexpr int kInvalidId = 0;
+    static constexpr int kMinId = 1;
+    static constexpr int kMaxId = 255;
+    static constexpr int kOneByteHeaderExtensionMaxId = 14;
+
+    RtpHeaderExtensionMap();
+
+    // id不合法、id已经注册为其它类型或者类型已经注册为其它id时返回false
+    bool Register(int id, RTPExtensionType type);
+    void Deregister(RTPExtensionType type);
+
+    RTPExtensionType GetType(int id) const { return static_cast<RTPExtensionType>(_types[id & 0xff]); }
+    // 没有注册返回kInvalidId
+    int GetId(RTPExtensionType type) const { return _ids[type]; }
+    bool IsRegistered(RTPExtensionType type) const { return _ids[type] != kInvalidId; }
+
+private:
+    uint8_t _types[kMaxId + 1];
+    uint8_t _ids[kRtpExtensionNumberOfExtensions];
+};
+
+} // namespace webrtc
+
+#endif // _RTP_HEADER_EXTENSION_MAP_H
+
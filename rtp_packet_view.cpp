@@ -0,0 +1,211 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file rtp_packet_view.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "rtp_packet_view.h"
+
+#include <string.h>
+
+#include <cassert>
+
+#include "byte_io.h"
+
+namespace webrtc {
+
+constexpr size_t RtpPacketView::kFixedHeaderSize;
+constexpr uint8_t RtpPacketView::kRtpVersion;
+constexpr uint16_t RtpPacketView::kOneByteExtensionProfileId;
+constexpr uint16_t RtpPacketView::kTwoByteExtensionProfileId;
+constexpr int RtpPacketView::kAbsSendTimeFraction;
+constexpr int RtpPacketView::kAbsSendTimeInterArrivalUpshift;
+constexpr int RtpPacketView::kInterArrivalShift;
+constexpr double RtpPacketView::kInterArrivalTimestampToMs;
+
+RtpPacketView::RtpPacketView()
+    : _data(nullptr),
+    _marker(false),
+    _payload_type(0),
+    _sequence_number(0),
+    _timestamp(0),
+    _ssrc(0),
+    _num_csrcs(0),
+    _headers_size(0),
+    _payload_size(0),
+    _padding_size(0) {
+    memset(_extensions, 0, sizeof(_extensions));
+}
+
+//  0                   1                   2                   3
+//  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |V=2|P|X|  CC   |M|     PT      |       sequence number         |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |                           timestamp                           |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |           synchronization source (SSRC) identifier            |
+// +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+// |            Contributing source (CSRC) identifiers             |
+// |                             ....                              |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |  header eXtension profile id  |       length in 32bits        |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |                          Extensions                           |
+// |                             ....                              |
+// +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+// |                           Payload                             |
+// |             ....              :  padding...                   |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |               padding         | Padding size  |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+bool RtpPacketView::Parse(const uint8_t* buffer, size_t size, const RtpHeaderExtensionMap* extensions) {
+    memset(_extensions, 0, sizeof(_extensions));
+    if (size < kFixedHeaderSize || (buffer[0] >> 6) != kRtpVersion) {
+        // RTC_LOG(LS_WARNING) << "Invalid RTP header";
+        return false;
+    }
+    const bool has_padding = (buffer[0] & 0x20) != 0;
+    const bool has_extension = (buffer[0] & 0x10) != 0;
+    _num_csrcs = buffer[0] & 0x0f;
+    _marker = (buffer[1] & 0x80) != 0;
+    _payload_type = buffer[1] & 0x7f;
+    _sequence_number = ByteReader<uint16_t>::ReadBigEndian(&buffer[2]);
+    _timestamp = ByteReader<uint32_t>::ReadBigEndian(&buffer[4]);
+    _ssrc = ByteReader<uint32_t>::ReadBigEndian(&buffer[8]);
+    _data = buffer;
+
+    // 有扩展时先按扩展块头也在包内检查, 不用单独检查CSRC
+    size_t headers_size = kFixedHeaderSize + _num_csrcs * 4;
+    if (headers_size + (has_extension ? 4 : 0) > size) {
+        // RTC_LOG(LS_WARNING) << "Buffer too small to fit RTP header";
+        return false;
+    }
+    if (has_extension) {
+        const uint16_t profile = ByteReader<uint16_t>::ReadBigEndian(&buffer[headers_size]);
+        const size_t extensions_size = ByteReader<uint16_t>::ReadBigEndian(&buffer[headers_size + 2]) * 4;
+        const size_t extensions_offset = headers_size + 4;
+        headers_size = extensions_offset + extensions_size;
+        if (headers_size > size) {
+            // RTC_LOG(LS_WARNING) << "Buffer too small to fit RTP header extensions";
+            return false;
+        }
+        // 其它profile的扩展不认识, 跳过
+        if (extensions && profile == kOneByteExtensionProfileId)
+            ParseOneByteExtensions(extensions_offset, extensions_size, *extensions);
+        else if (extensions && (profile & 0xfff0) == kTwoByteExtensionProfileId)
+            ParseTwoByteExtensions(extensions_offset, extensions_size, *extensions);
+    }
+
+    _padding_size = 0;
+    if (has_padding) {
+        _padding_size = headers_size < size ? buffer[size - 1] : 0;
+        if (_padding_size == 0 || _padding_size > size - headers_size) {
+            // RTC_LOG(LS_WARNING) << "Invalid RTP padding";
+            memset(_extensions, 0, sizeof(_extensions));
+            return false;
+        }
+    }
+    _headers_size = headers_size;
+    _payload_size = size - headers_size - _padding_size;
+    return true;
+}
+
+uint32_t RtpPacketView::csrc(size_t index) const {
+    assert(index < _num_csrcs);
+    return ByteReader<uint32_t>::ReadBigEndian(&_data[kFixedHeaderSize + index * 4]);
+}
+
+bool RtpPacketView::GetTransmissionTimeOffset(int32_t* rtp_time) const {
+    const uint8_t* data = FindExtension(kRtpExtensionTransmissionTimeOffset, 3);
+    if (!data)
+        return false;
+    *rtp_time = ByteReader<int32_t, 3>::ReadBigEndian(data);
+    return true;
+}
+
+bool RtpPacketView::GetAbsoluteSendTime(uint32_t* time_24bits) const {
+    const uint8_t* data = FindExtension(kRtpExtensionAbsoluteSendTime, 3);
+    if (!data)
+        return false;
+    *time_24bits = ByteReader<uint32_t, 3>::ReadBigEndian(data);
+    return true;
+}
+
+bool RtpPacketView::GetTransportSequenceNumber(uint16_t* transport_sequence_number) const {
+    const uint8_t* data = FindExtension(kRtpExtensionTransportSequenceNumber, 2);
+    if (!data)
+        return false;
+    *transport_sequence_number = ByteReader<uint16_t>::ReadBigEndian(data);
+    return true;
+}
+
+//  0
+//  0 1 2 3 4 5 6 7
+// +-+-+-+-+-+-+-+-+
+// |  ID   |  len  |  数据长度是len + 1, ID为0是填充字节, ID为15停止解析
+// +-+-+-+-+-+-+-+-+
+void RtpPacketView::ParseOneByteExtensions(size_t offset, size_t length,
+        const RtpHeaderExtensionMap& extensions) {
+    const uint8_t* data = _data + offset;
+    size_t i = 0;
+    while (i < length) {
+        const int id = data[i] >> 4;
+        if (id == 0) {
+            ++i;
+            continue;
+        }
+        const size_t size = (data[i] & 0x0f) + 1;
+        if (id == 15 || i + 1 + size > length) {
+            // RTC_LOG(LS_WARNING) << "Malformed one-byte RTP header extension";
+            return;
+        }
+        ExtensionInfo& info = _extensions[extensions.GetType(id)];
+        info.offset = static_cast<uint32_t>(offset + i + 1);
+        info.length = static_cast<uint32_t>(size);
+        i += 1 + size;
+    }
+}
+
+//  0                   1
+//  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |       ID      |     length    |  ID为0是填充字节
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+void RtpPacketView::ParseTwoByteExtensions(size_t offset, size_t length,
+        const RtpHeaderExtensionMap& extensions) {
+    const uint8_t* data = _data + offset;
+    size_t i = 0;
+    while (i < length) {
+        const int id = data[i];
+        if (id == 0) {
+            ++i;
+            continue;
+        }
+        if (i + 2 > length || i + 2 + data[i + 1] > length) {
+            // RTC_LOG(LS_WARNING) << "Malformed two-byte RTP header extension";
+            return;
+        }
+        const size_t size = data[i + 1];
+        ExtensionInfo& info = _extensions[extensions.GetType(id)];
+        info.offset = static_cast<uint32_t>(offset + i + 2);
+        info.length = static_cast<uint32_t>(size);
+        i += 2 + size;
+    }
+}
+
+const uint8_t* RtpPacketView::FindExtension(RTPExtensionType type, size_t length) const {
+    const ExtensionInfo& info = _extensions[type];
+    if (info.offset == 0 || info.length != length) {
+        // RTC_LOG(LS_WARNING) << "Extension type " << type << " not present or has invalid size";
+        return nullptr;
+    }
+    return _data + info.offset;
+}
+
+} // namespace webrtc
+
@@ -0,0 +1,103 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file rtp_packet_view.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _RTP_PACKET_VIEW_H
+#define _RTP_PACKET_VIEW_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtp_header_extension_map.h"
+
+namespace webrtc {
+
+// RTP包头的只读视图, 只解析不拷贝, payload()和扩展都指向原始buffer, 用完之前buffer
+// 必须有效。
+//
+// 固定头、CSRC、扩展块和padding各检查一次长度; 头扩展支持one-byte(0xBEDE)和
+// two-byte(0x100X)两种格式, 每个扩展元素按id查RtpHeaderExtensionMap得到类型, 记下它
+// 在buffer中的位置, 取值时才读。没有注册的id记到kRtpExtensionNone的位置, 不需要分支。
+//
+// Note: This class is not thread-safe.
+class RtpPacketView {
+public:
+    static constexpr size_t kFixedHeaderSize = 12;
+    static constexpr uint8_t kRtpVersion = 2;
+    static constexpr uint16_t kOneByteExtensionProfileId = 0xBEDE;
+    static constexpr uint16_t kTwoByteExtensionProfileId = 0x1000;
+
+    // abs-send-time是24位的6.18定点数(秒), 左移8位作为InterArrival的时间戳, 回绕
+    // 周期还是64s
+    static constexpr int kAbsSendTimeFraction = 18;
+    static constexpr int kAbsSendTimeInterArrivalUpshift = 8;
+    static constexpr int kInterArrivalShift = kAbsSendTimeFraction + kAbsSendTimeInterArrivalUpshift;
+    static constexpr double kInterArrivalTimestampToMs = 1000.0 / (int64_t{1} << kInterArrivalShift);
+
+    RtpPacketView();
+
+    // 不合法的包返回false。扩展元素格式错误时忽略它和之后的扩展, 包本身仍然合法。
+    // |extensions|为nullptr时不解析扩展。
+    bool Parse(const uint8_t* buffer, size_t size, const RtpHeaderExtensionMap* extensions);
+
+    bool marker() const { return _marker; }
+    uint8_t payload_type() const { return _payload_type; }
+    uint16_t sequence_number() const { return _sequence_number; }
+    uint32_t timestamp() const { return _timestamp; }
+    uint32_t ssrc() const { return _ssrc; }
+    size_t num_csrcs() const { return _num_csrcs; }
+    uint32_t csrc(size_t index) const;
+
+    size_t headers_size() const { return _headers_size; }
+    size_t payload_size() const { return _payload_size; }
+    size_t padding_size() const { return _padding_size; }
+    size_t size() const { return _headers_size + _payload_size + _padding_size; }
+    const uint8_t* data() const { return _data; }
+    const uint8_t* payload() const { return _data + _headers_size; }
+
+    // two-byte扩展的元素可以是0长度, 这时也算存在
+    bool HasExtension(RTPExtensionType type) const { return _extensions[type].offset != 0; }
+    // 扩展不存在或者长度不对时返回false
+    bool GetTransmissionTimeOffset(int32_t* rtp_time) const;
+    bool GetAbsoluteSendTime(uint32_t* time_24bits) const;
+    bool GetTransportSequenceNumber(uint16_t* transport_sequence_number) const;
+
+    // abs-send-time换算成InterArrival的时间戳, 配合kInterArrivalTimestampToMs使用
+    static uint32_t AbsSendTimeToInterArrivalTimestamp(uint32_t time_24bits) {
+        return time_24bits << kAbsSendTimeInterArrivalUpshift;
+    }
+
+private:
+    struct ExtensionInfo {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    void ParseOneByteExtensions(size_t offset, size_t length, const RtpHeaderExtensionMap& extensions);
+    void ParseTwoByteExtensions(size_t offset, size_t length, const RtpHeaderExtensionMap& extensions);
+    const uint8_t* FindExtension(RTPExtensionType type, size_t length) const;
+
+    const uint8_t* _data;
+    bool _marker;
+    uint8_t _payload_type;
+    uint16_t _sequence_number;
+    uint32_t _timestamp;
+    uint32_t _ssrc;
+    size_t _num_csrcs;
+    size_t _headers_size;
+    size_t _payload_size;
+    size_t _padding_size;
+    // 下标是RTPExtensionType。扩展数据在固定头之后, offset不会是0, offset为0表示不存在
+    ExtensionInfo _extensions[kRtpExtensionNumberOfExtensions];
+};
+
+} // namespace webrtc
+
+#endif // _RTP_PACKET_VIEW_H
+
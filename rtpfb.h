@@ -0,0 +1,51 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file rtpfb.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _RTPFB_H
+#define _RTPFB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtcp_packet.h"
+
+namespace webrtc {
+
+namespace rtcp {
+
+// RTPFB: Transport layer feedback message.
+// RFC4585, Section 6.2
+class Rtpfb : public RtcpPacket {
+public:
+    static constexpr uint8_t kPacketType = 205;
+
+    Rtpfb() : _media_ssrc(0) {}
+    ~Rtpfb() override {}
+
+    void SetMediaSsrc(uint32_t ssrc) { _media_ssrc = ssrc; }
+    uint32_t media_ssrc() const { return _media_ssrc; }
+
+protected:
+    static constexpr size_t kCommonFeedbackLength = 8;
+
+    void ParseCommonFeedback(const uint8_t* payload);
+    void CreateCommonFeedback(uint8_t* payload) const;
+
+private:
+    uint32_t _media_ssrc;
+};
+
+} // namespace rtcp
+
+} // namespace webrtc
+
+#endif // _RTPFB_H
+
+
@@ -0,0 +1,333 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file send_side_bandwidth_estimation.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "send_side_bandwidth_estimation.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "aimd_rate_control.h"
+#include "field_trail.h"
+
+namespace webrtc {
+
+static const int64_t kBweIncreaseIntervalMs = 1000;
+static const int64_t kBweDecreaseIntervalMs = 300;
+static const int64_t kStartPhaseMs = 2000;
+static const int kLimitNumPackets = 20;
+static const int kDefaultMaxBitrateBps = 1000000000;
+static const int64_t kMaxRtcpFeedbackIntervalMs = 5000;
+static const int64_t kDefaultRttMs = 200;
+static const float kDefaultLowLossThreshold = 0.02f;
+static const float kDefaultHighLossThreshold = 0.1f;
+static const int kDefaultBitrateThresholdBps = 0;
+
+static const char kBweLossExperiment[] = "WebRTC-BweLossExperiment";
+
+// Group format "Enabled-0.02,0.1,0": low loss, high loss, bitrate threshold kbps.
+static bool ReadBweLossExperimentParameters(const field_trial::FieldTrialEntry* trial,
+        float* low_loss_threshold, float* high_loss_threshold, uint32_t* bitrate_threshold_kbps) {
+    if (sscanf(trial->group.c_str(), "Enabled-%f,%f,%u", low_loss_threshold,
+                high_loss_threshold, bitrate_threshold_kbps) == 3) {
+        if (*low_loss_threshold > 0.0f && *low_loss_threshold <= 1.0f &&
+                *high_loss_threshold > 0.0f && *high_loss_threshold <= 1.0f &&
+                *low_loss_threshold <= *high_loss_threshold &&
+                *bitrate_threshold_kbps < std::numeric_limits<int>::max() / 1000) {
+            return true;
+        }
+    }
+    // RTC_LOG(LS_WARNING) << "Failed to parse parameters for BweLossExperiment "
+    //    "experiment from field trial string. Using default.";
+    *low_loss_threshold = kDefaultLowLossThreshold;
+    *high_loss_threshold = kDefaultHighLossThreshold;
+    *bitrate_threshold_kbps = kDefaultBitrateThresholdBps / 1000;
+    return false;
+}
+
+SendSideBandwidthEstimation::SendSideBandwidthEstimation()
+    : SendSideBandwidthEstimation(LossBasedControlConfig()) {}
+
+SendSideBandwidthEstimation::SendSideBandwidthEstimation(
+        const LossBasedControlConfig& loss_based_config)
+    : _min_history_begin(0),
+    _min_history_size(0),
+    _lost_packets_since_last_loss_update(0),
+    _expected_packets_since_last_loss_update(0),
+    _current_bitrate_bps(0),
+    _min_bitrate_configured_bps(congestion_controller::GetMinBitrateBps()),
+    _max_bitrate_configured_bps(kDefaultMaxBitrateBps),
+    _has_decreased_since_last_fraction_loss(false),
+    _last_loss_packet_report_ms(-1),
+    _last_fraction_loss(0),
+    _last_round_trip_time_ms(kDefaultRttMs),
+    _delay_based_limit_bps(0),
+    _time_last_decrease_ms(-1),
+    _first_report_time_ms(-1),
+    _low_loss_threshold(kDefaultLowLossThreshold),
+    _high_loss_threshold(kDefaultHighLossThreshold),
+    _bitrate_threshold_bps(kDefaultBitrateThresholdBps),
+    _loss_based_bandwidth_estimation(loss_based_config)
+{
+    const field_trial::FieldTrialEntry* loss_experiment = field_trial::FindTrial(kBweLossExperiment);
+    if (field_trial::IsEnabled(loss_experiment)) {
+        uint32_t bitrate_threshold_kbps;
+        if (ReadBweLossExperimentParameters(loss_experiment, &_low_loss_threshold,
+                    &_high_loss_threshold, &bitrate_threshold_kbps)) {
+            _bitrate_threshold_bps = bitrate_threshold_kbps * 1000;
+        }
+    }
+}
+
+SendSideBandwidthEstimation::~SendSideBandwidthEstimation() {}
+
+void SendSideBandwidthEstimation::SetBitrates(int send_bitrate_bps, int min_bitrate_bps,
+        int max_bitrate_bps) {
+    SetMinMaxBitrate(min_bitrate_bps, max_bitrate_bps);
+    if (send_bitrate_bps > 0)
+        SetSendBitrate(send_bitrate_bps);
+}
+
+void SendSideBandwidthEstimation::SetSendBitrate(int bitrate_bps) {
+    // Reset to avoid being capped by the estimate.
+    _delay_based_limit_bps = 0;
+    if (_loss_based_bandwidth_estimation.Enabled())
+        _loss_based_bandwidth_estimation.SetInitialBitrate(bitrate_bps);
+    CapBitrateToThresholds(bitrate_bps);
+    // Clear last sent bitrate history so the new value can be used directly
+    // and not capped.
+    ClearMinHistory();
+}
+
+void SendSideBandwidthEstimation::SetMinMaxBitrate(int min_bitrate_bps, int max_bitrate_bps) {
+    _min_bitrate_configured_bps =
+        std::max(min_bitrate_bps, congestion_controller::GetMinBitrateBps());
+    if (max_bitrate_bps > 0) {
+        _max_bitrate_configured_bps = std::max(_min_bitrate_configured_bps, max_bitrate_bps);
+    } else {
+        _max_bitrate_configured_bps = kDefaultMaxBitrateBps;
+    }
+}
+
+void SendSideBandwidthEstimation::UpdateDelayBasedEstimate(uint32_t bitrate_bps) {
+    _delay_based_limit_bps = bitrate_bps;
+    CapBitrateToThresholds(_current_bitrate_bps);
+}
+
+void SendSideBandwidthEstimation::UpdateAcknowledgedBitrate(int acknowledged_bitrate_bps,
+        int64_t now_ms) {
+    if (_loss_based_bandwidth_estimation.Enabled()) {
+        _loss_based_bandwidth_estimation.UpdateAcknowledgedBitrate(
+                acknowledged_bitrate_bps, now_ms);
+    }
+}
+
+void SendSideBandwidthEstimation::UpdatePacketsLost(int packets_lost, int number_of_packets,
+        int64_t now_ms) {
+    if (_first_report_time_ms < 0)
+        _first_report_time_ms = now_ms;
+
+    if (_loss_based_bandwidth_estimation.Enabled())
+        _loss_based_bandwidth_estimation.UpdateLossStatistics(packets_lost, number_of_packets, now_ms);
+
+    // Check sequence number diff and weight loss report
+    if (number_of_packets > 0) {
+        // Accumulate reports.
+        _lost_packets_since_last_loss_update += packets_lost;
+        _expected_packets_since_last_loss_update += number_of_packets;
+
+        // Don't generate a loss rate until it can be based on enough packets.
+        if (_expected_packets_since_last_loss_update < kLimitNumPackets)
+            return;
+
+        _has_decreased_since_last_fraction_loss = false;
+        int64_t lost_q8 = static_cast<int64_t>(_lost_packets_since_last_loss_update) << 8;
+        int64_t expected = _expected_packets_since_last_loss_update;
+        _last_fraction_loss = static_cast<uint8_t>(std::min<int64_t>(lost_q8 / expected, 255));
+
+        // Reset accumulators.
+        _lost_packets_since_last_loss_update = 0;
+        _expected_packets_since_last_loss_update = 0;
+        _last_loss_packet_report_ms = now_ms;
+        UpdateEstimate(now_ms);
+    }
+}
+
+void SendSideBandwidthEstimation::UpdateRtt(int64_t rtt_ms) {
+    // Update RTT if we were able to compute an RTT based on this RTCP.
+    // FlexFEC doesn't send RTCP SR, which means we won't be able to compute RTT.
+    if (rtt_ms > 0)
+        _last_round_trip_time_ms = rtt_ms;
+}
+
+void SendSideBandwidthEstimation::UpdateEstimate(int64_t now_ms) {
+    // We trust the delay-based estimate during the first 2 seconds if we haven't
+    // had any packet loss reported, to allow startup bitrate probing.
+    if (_last_fraction_loss == 0 && IsInStartPhase(now_ms)) {
+        int new_bitrate_bps = _current_bitrate_bps;
+        if (_delay_based_limit_bps > 0)
+            new_bitrate_bps = std::max<int>(_delay_based_limit_bps, new_bitrate_bps);
+        if (_loss_based_bandwidth_estimation.Enabled())
+            _loss_based_bandwidth_estimation.SetInitialBitrate(new_bitrate_bps);
+
+        if (new_bitrate_bps != _current_bitrate_bps) {
+            ClearMinHistory();
+            if (_loss_based_bandwidth_estimation.Enabled()) {
+                PushMinHistory(now_ms, new_bitrate_bps);
+            } else {
+                PushMinHistory(now_ms, _current_bitrate_bps);
+            }
+            CapBitrateToThresholds(new_bitrate_bps);
+            return;
+        }
+    }
+    UpdateMinHistory(now_ms);
+    if (_last_loss_packet_report_ms < 0) {
+        // No feedback received.
+        CapBitrateToThresholds(_current_bitrate_bps);
+        return;
+    }
+
+    if (_loss_based_bandwidth_estimation.Enabled()) {
+        _loss_based_bandwidth_estimation.Update(now_ms, MinHistoryFront(),
+                _last_round_trip_time_ms);
+        int new_bitrate_bps = MaybeRampupOrBackoff(_current_bitrate_bps, now_ms);
+        CapBitrateToThresholds(new_bitrate_bps);
+        return;
+    }
+
+    int new_bitrate_bps = _current_bitrate_bps;
+    int64_t time_since_loss_packet_report_ms = now_ms - _last_loss_packet_report_ms;
+    if (time_since_loss_packet_report_ms < 1.2 * kMaxRtcpFeedbackIntervalMs) {
+        // We only care about loss above a given bitrate threshold.
+        float loss = _last_fraction_loss / 256.0f;
+        // We only make decisions based on loss when the bitrate is above a
+        // threshold. This is a crude way of handling loss which is uncorrelated
+        // to congestion.
+        if (_current_bitrate_bps < _bitrate_threshold_bps || loss <= _low_loss_threshold) {
+            // Loss < 2%: Increase rate by 8% of the min bitrate in the last
+            // kBweIncreaseIntervalMs.
+            // Note that by remembering the bitrate over the last second one can
+            // rampup up one second faster than if only allowed to start ramping
+            // at 8% per second rate now. E.g.:
+            //   If sending a constant 100kbps it can rampup immediately to 108kbps
+            //   whenever a receiver report is received with lower packet loss.
+            //   If instead one would do: current_bitrate_ *= 1.08^(delta time),
+            //   it would take over one second since the lower packet loss to achieve
+            //   108kbps.
+            new_bitrate_bps = static_cast<int>(MinHistoryFront() * 1.08 + 0.5);
+
+            // Add 1 kbps extra, just to make sure that we do not get stuck
+            // (gives a little extra increase at low rates, negligible at higher
+            // rates).
+            new_bitrate_bps += 1000;
+        } else if (_current_bitrate_bps > _bitrate_threshold_bps) {
+            if (loss <= _high_loss_threshold) {
+                // Loss between 2% - 10%: Do nothing.
+            } else {
+                // Loss > 10%: Limit the rate decreases to once a kBweDecreaseIntervalMs
+                // + rtt.
+                if (!_has_decreased_since_last_fraction_loss &&
+                        (_time_last_decrease_ms < 0 || now_ms - _time_last_decrease_ms >=
+                         kBweDecreaseIntervalMs + _last_round_trip_time_ms)) {
+                    _time_last_decrease_ms = now_ms;
+
+                    // Reduce rate:
+                    //   newRate = rate * (1 - 0.5*lossRate);
+                    //   where packetLoss = 256*lossRate;
+                    new_bitrate_bps = static_cast<int>(_current_bitrate_bps *
+                            static_cast<double>(512 - _last_fraction_loss) / 512.0);
+                    _has_decreased_since_last_fraction_loss = true;
+                }
+            }
+        }
+    }
+    CapBitrateToThresholds(new_bitrate_bps);
+}
+
+bool SendSideBandwidthEstimation::IsInStartPhase(int64_t now_ms) const {
+    return _first_report_time_ms < 0 || now_ms - _first_report_time_ms < kStartPhaseMs;
+}
+
+void SendSideBandwidthEstimation::UpdateMinHistory(int64_t now_ms) {
+    // Remove old data points from history.
+    // Since history precision is in ms, add one so it is able to increase
+    // bitrate if it is off by as little as 0.5ms.
+    while (_min_history_size > 0 &&
+            now_ms - _min_bitrate_history[_min_history_begin].time_ms + 1 > kBweIncreaseIntervalMs) {
+        _min_history_begin = (_min_history_begin + 1) % kMinHistoryCapacity;
+        --_min_history_size;
+    }
+
+    // Typical minimum sliding-window algorithm: Pop values higher than current
+    // bitrate before pushing it.
+    while (_min_history_size > 0 &&
+            _current_bitrate_bps <= _min_bitrate_history[(_min_history_begin +
+                _min_history_size - 1) % kMinHistoryCapacity].bitrate_bps) {
+        --_min_history_size;
+    }
+
+    PushMinHistory(now_ms, _current_bitrate_bps);
+}
+
+void SendSideBandwidthEstimation::ClearMinHistory() {
+    _min_history_begin = 0;
+    _min_history_size = 0;
+}
+
+void SendSideBandwidthEstimation::PushMinHistory(int64_t now_ms, int bitrate_bps) {
+    // 队列单调递增, 丢弃最旧(最小)的样本只会让增长略快一点
+    if (_min_history_size == kMinHistoryCapacity) {
+        _min_history_begin = (_min_history_begin + 1) % kMinHistoryCapacity;
+        --_min_history_size;
+    }
+    MinBitrateSample& sample =
+        _min_bitrate_history[(_min_history_begin + _min_history_size) % kMinHistoryCapacity];
+    sample.time_ms = now_ms;
+    sample.bitrate_bps = bitrate_bps;
+    ++_min_history_size;
+}
+
+int SendSideBandwidthEstimation::MinHistoryFront() const {
+    if (_min_history_size == 0)
+        return _current_bitrate_bps;
+    return _min_bitrate_history[_min_history_begin].bitrate_bps;
+}
+
+int SendSideBandwidthEstimation::MaybeRampupOrBackoff(int new_bitrate_bps, int64_t now_ms) {
+    // 按经典规则增长, 由LossBasedBandwidthEstimation的估计限制上限
+    const int64_t time_since_loss_packet_report_ms = now_ms - _last_loss_packet_report_ms;
+    if (time_since_loss_packet_report_ms < 1.2 * kMaxRtcpFeedbackIntervalMs) {
+        new_bitrate_bps = static_cast<int>(MinHistoryFront() * 1.08);
+        new_bitrate_bps += 1000;
+    }
+    return new_bitrate_bps;
+}
+
+void SendSideBandwidthEstimation::CapBitrateToThresholds(int bitrate_bps) {
+    // min(delay, loss)
+    if (_delay_based_limit_bps > 0 && bitrate_bps > static_cast<int64_t>(_delay_based_limit_bps))
+        bitrate_bps = _delay_based_limit_bps;
+    if (_loss_based_bandwidth_estimation.Enabled() &&
+            _loss_based_bandwidth_estimation.GetEstimate() > 0) {
+        bitrate_bps = std::min(bitrate_bps, _loss_based_bandwidth_estimation.GetEstimate());
+    }
+    if (bitrate_bps > _max_bitrate_configured_bps)
+        bitrate_bps = _max_bitrate_configured_bps;
+    if (bitrate_bps < _min_bitrate_configured_bps) {
+        // RTC_LOG(LS_WARNING) << "Estimated available bandwidth " << bitrate_bps
+        //    << " bps is below configured min bitrate " << _min_bitrate_configured_bps << " bps.";
+        bitrate_bps = _min_bitrate_configured_bps;
+    }
+    _current_bitrate_bps = bitrate_bps;
+}
+
+} // namespace webrtc
@@ -0,0 +1,114 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file send_side_bandwidth_estimation.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _SEND_SIDE_BANDWIDTH_ESTIMATION_H
+#define _SEND_SIDE_BANDWIDTH_ESTIMATION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "loss_based_bandwidth_estimation.h"
+
+namespace webrtc {
+
+// 发送端最终码率: 基于丢包的估计与基于延迟的估计(AimdRateControl)取最小值。
+// 浅缓冲/限速(policer)链路上延迟不会上升, 只表现为丢包, 仅靠延迟链路会持续超发。
+// 默认使用GCC草案的丢包规则: 丢包<2%每秒增长8%, 2%~10%保持, >10%按(1-0.5*loss)降低;
+// 开启WebRTC-Bwe-LossBasedControl后额外使用LossBasedBandwidthEstimation限制码率。
+// 所有更新路径不分配内存。
+class SendSideBandwidthEstimation {
+public:
+    SendSideBandwidthEstimation();
+    explicit SendSideBandwidthEstimation(const LossBasedControlConfig& loss_based_config);
+    ~SendSideBandwidthEstimation();
+
+    // |send_bitrate_bps| <= 0 keeps the current bitrate. |max_bitrate_bps| <= 0
+    // means no configured max.
+    void SetBitrates(int send_bitrate_bps, int min_bitrate_bps, int max_bitrate_bps);
+    void SetSendBitrate(int bitrate_bps);
+    void SetMinMaxBitrate(int min_bitrate_bps, int max_bitrate_bps);
+
+    // Call periodically to update estimate.
+    void UpdateEstimate(int64_t now_ms);
+    // Call when a new delay-based estimate is available, e.g.
+    // AimdRateControl::LatestEstimate(). 0 removes the limit.
+    void UpdateDelayBasedEstimate(uint32_t bitrate_bps);
+    // Only used by the loss-based control model.
+    void UpdateAcknowledgedBitrate(int acknowledged_bitrate_bps, int64_t now_ms);
+    // Call when a feedback report with |packets_lost| out of
+    // |number_of_packets| is received.
+    void UpdatePacketsLost(int packets_lost, int number_of_packets, int64_t now_ms);
+    void UpdateRtt(int64_t rtt_ms);
+
+    int target_rate() const { return _current_bitrate_bps; }
+    // Loss fraction in Q8 of the latest report.
+    uint8_t fraction_loss() const { return _last_fraction_loss; }
+    int64_t round_trip_time() const { return _last_round_trip_time_ms; }
+    // Returns 0 if no delay-based estimate has been set.
+    uint32_t delay_based_limit() const { return _delay_based_limit_bps; }
+    int loss_based_estimate() const { return _loss_based_bandwidth_estimation.GetEstimate(); }
+
+private:
+    bool IsInStartPhase(int64_t now_ms) const;
+
+    // Updates history of min bitrates.
+    // After this method returns min_bitrate_history_.front().second contains the
+    // min bitrate used during last kBweIncreaseIntervalMs.
+    void UpdateMinHistory(int64_t now_ms);
+    void ClearMinHistory();
+    void PushMinHistory(int64_t now_ms, int bitrate_bps);
+    int MinHistoryFront() const;
+
+    int MaybeRampupOrBackoff(int new_bitrate_bps, int64_t now_ms);
+
+    // Cap |bitrate| to [min_bitrate_configured_, max_bitrate_configured_] and
+    // set |current_bitrate_| to the capped value.
+    void CapBitrateToThresholds(int bitrate_bps);
+
+    // 最近kBweIncreaseIntervalMs内的最小码率, 单调队列。
+    // 固定容量的环形数组, 满了丢弃最旧的样本, 更新时不分配内存。
+    struct MinBitrateSample {
+        int64_t time_ms;
+        int bitrate_bps;
+    };
+    static constexpr size_t kMinHistoryCapacity = 128;
+    MinBitrateSample _min_bitrate_history[kMinHistoryCapacity];
+    size_t _min_history_begin;
+    size_t _min_history_size;
+
+    // incoming filters
+    int _lost_packets_since_last_loss_update;
+    int _expected_packets_since_last_loss_update;
+
+    int _current_bitrate_bps;
+    int _min_bitrate_configured_bps;
+    int _max_bitrate_configured_bps;
+
+    bool _has_decreased_since_last_fraction_loss;
+    int64_t _last_loss_packet_report_ms;
+    uint8_t _last_fraction_loss;
+    int64_t _last_round_trip_time_ms;
+
+    uint32_t _delay_based_limit_bps;
+    int64_t _time_last_decrease_ms;
+    int64_t _first_report_time_ms;
+
+    // Read once from WebRTC-BweLossExperiment at construction.
+    float _low_loss_threshold;
+    float _high_loss_threshold;
+    int _bitrate_threshold_bps;
+    LossBasedBandwidthEstimation _loss_based_bandwidth_estimation;
+};
+
+} // namespace webrtc
+
+#endif // _SEND_SIDE_BANDWIDTH_ESTIMATION_H
+
+
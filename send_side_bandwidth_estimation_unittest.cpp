@@ -0,0 +1,207 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file send_side_bandwidth_estimation_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ send_side_bandwidth_estimation_unittest.cpp send_side_bandwidth_estimation.cpp loss_based_bandwidth_estimation.cpp aimd_rate_control.cpp field_trail.cpp -std=c++11
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+using namespace std;
+
+#include "allocation_counter.h"
+#include "aimd_rate_control.h"
+#include "send_side_bandwidth_estimation.h"
+
+namespace webrtc {
+
+static LossBasedControlConfig LossBasedConfig(bool enabled) {
+    LossBasedControlConfig config;
+    config.enabled = enabled;
+    return config;
+}
+
+// 每100ms一次反馈, 每次|num_packets|个包
+static int64_t ReportLoss(SendSideBandwidthEstimation* bwe, int64_t now_ms, int64_t duration_ms,
+        int packets_lost, int num_packets) {
+    for (int64_t t = 0; t < duration_ms; t += 100) {
+        now_ms += 100;
+        bwe->UpdatePacketsLost(packets_lost, num_packets, now_ms);
+    }
+    return now_ms;
+}
+
+// LossRules
+// 丢包<2%增长, 2%~10%保持, >10%按(1-0.5*loss)降低
+void TestSendSideBandwidthEstimation01() {
+    SendSideBandwidthEstimation bwe(LossBasedConfig(false));
+    int64_t now_ms = 0;
+    bwe.SetBitrates(1000000, 10000, 0);
+    // 越过起始阶段
+    now_ms = ReportLoss(&bwe, now_ms, 2000, 0, 100);
+    const int start_bps = bwe.target_rate();
+
+    // 1%丢包, 1s后增长约8%
+    now_ms = ReportLoss(&bwe, now_ms, 1000, 1, 100);
+    const int increased_bps = bwe.target_rate();
+    cout << "loss 1%: " << start_bps << " -> " << increased_bps << "bps" << endl;
+    assert(increased_bps > start_bps * 1.07 && increased_bps < start_bps * 1.2);
+
+    // 5%丢包, 保持
+    now_ms = ReportLoss(&bwe, now_ms, 1000, 5, 100);
+    assert(bwe.target_rate() == increased_bps);
+
+    // 20%丢包, 一次降到(512 - 51) / 512, 300ms + rtt内不再降低
+    now_ms = ReportLoss(&bwe, now_ms, 100, 20, 100);
+    const int decreased_bps = bwe.target_rate();
+    cout << "loss 20%: " << increased_bps << " -> " << decreased_bps << "bps" << endl;
+    assert(decreased_bps == static_cast<int>(increased_bps * (512.0 - 51) / 512.0));
+    now_ms = ReportLoss(&bwe, now_ms, 400, 20, 100);
+    assert(bwe.target_rate() == decreased_bps);
+    now_ms = ReportLoss(&bwe, now_ms, 100, 20, 100);
+    assert(bwe.target_rate() < decreased_bps);
+
+    // 包数不足20个时不产生丢包率
+    SendSideBandwidthEstimation few_packets(LossBasedConfig(false));
+    few_packets.SetBitrates(1000000, 10000, 0);
+    few_packets.UpdatePacketsLost(5, 10, 100);
+    assert(few_packets.fraction_loss() == 0);
+    few_packets.UpdatePacketsLost(5, 10, 200);
+    assert(few_packets.fraction_loss() == 128);
+}
+
+// MinOfDelayAndLoss
+// 起始阶段无丢包时跟随延迟估计, 之后码率不超过延迟估计, 延迟估计放开后按8%/s增长
+void TestSendSideBandwidthEstimation02() {
+    SendSideBandwidthEstimation bwe(LossBasedConfig(false));
+    int64_t now_ms = 0;
+    bwe.SetBitrates(300000, 10000, 0);
+    bwe.UpdatePacketsLost(0, 100, now_ms);
+    bwe.UpdateDelayBasedEstimate(2000000);
+    bwe.UpdateEstimate(now_ms);
+    assert(bwe.target_rate() == 2000000);
+
+    now_ms = ReportLoss(&bwe, now_ms, 3000, 0, 100);
+    bwe.UpdateDelayBasedEstimate(500000);
+    assert(bwe.target_rate() == 500000);
+    now_ms = ReportLoss(&bwe, now_ms, 1000, 0, 100);
+    assert(bwe.target_rate() == 500000);
+
+    bwe.UpdateDelayBasedEstimate(5000000);
+    now_ms = ReportLoss(&bwe, now_ms, 1000, 0, 100);
+    cout << "delay limit lifted: 500000 -> " << bwe.target_rate() << "bps" << endl;
+    assert(bwe.target_rate() > 500000 && bwe.target_rate() < 600000);
+}
+
+// 仿真: 1Mbps限速(policer)链路, 超出的部分直接丢弃, 不排队, 延迟不上升。
+// 发送端按目标码率发送, 每100ms一次反馈(100个包), AimdRateControl始终看到Normal,
+// 吞吐量为实际送达的码率。
+struct PolicerResult {
+    double avg_loss;
+    double avg_goodput_bps;
+    int final_target_bps;
+};
+
+static PolicerResult RunPolicerSimulation(bool use_loss, bool loss_based_control) {
+    constexpr int64_t kPolicerBps = 1000000;
+    constexpr int kPacketsPerFeedback = 100;
+    constexpr int64_t kDurationMs = 60000;
+    constexpr int64_t kMeasureFromMs = 20000;
+
+    AimdRateControl rate_control;
+    SendSideBandwidthEstimation bwe(LossBasedConfig(loss_based_control));
+    int64_t now_ms = 0;
+    rate_control.SetEstimate(300000, now_ms);
+    bwe.SetBitrates(300000, 10000, 0);
+
+    double loss_sum = 0;
+    double goodput_sum = 0;
+    int samples = 0;
+    for (now_ms = 100; now_ms <= kDurationMs; now_ms += 100) {
+        const int64_t target_bps = use_loss ? bwe.target_rate() : rate_control.LatestEstimate();
+        const int64_t delivered_bps = std::min(target_bps, kPolicerBps);
+        const int lost = static_cast<int>(kPacketsPerFeedback * (target_bps - delivered_bps) / target_bps);
+
+        RateControlInput input(BandwidthUsage::kBwNormal, static_cast<uint32_t>(delivered_bps));
+        rate_control.Update(&input, now_ms);
+        bwe.UpdateDelayBasedEstimate(rate_control.LatestEstimate());
+        bwe.UpdateAcknowledgedBitrate(static_cast<int>(delivered_bps), now_ms);
+        bwe.UpdatePacketsLost(lost, kPacketsPerFeedback, now_ms);
+
+        if (now_ms >= kMeasureFromMs) {
+            loss_sum += static_cast<double>(lost) / kPacketsPerFeedback;
+            goodput_sum += delivered_bps;
+            ++samples;
+        }
+    }
+    PolicerResult result;
+    result.avg_loss = loss_sum / samples;
+    result.avg_goodput_bps = goodput_sum / samples;
+    result.final_target_bps = use_loss ? bwe.target_rate() : rate_control.LatestEstimate();
+    return result;
+}
+
+// PolicedLink
+// 只用延迟估计时持续超发; 取min(delay, loss)后丢包率受控, 吞吐接近限速
+void TestSendSideBandwidthEstimation03() {
+    PolicerResult delay_only;
+    PolicerResult classic;
+    PolicerResult loss_based;
+    delay_only = RunPolicerSimulation(false, false);
+    classic = RunPolicerSimulation(true, false);
+    loss_based = RunPolicerSimulation(true, true);
+    cout << "delay only: loss=" << delay_only.avg_loss * 100 << "% goodput="
+         << delay_only.avg_goodput_bps << "bps target=" << delay_only.final_target_bps << endl;
+    cout << "min(delay, loss) 2%/10% rules: loss=" << classic.avg_loss * 100 << "% goodput="
+         << classic.avg_goodput_bps << "bps target=" << classic.final_target_bps << endl;
+    cout << "min(delay, loss) loss based control: loss=" << loss_based.avg_loss * 100 << "% goodput="
+         << loss_based.avg_goodput_bps << "bps target=" << loss_based.final_target_bps << endl;
+    assert(delay_only.avg_loss > 0.2);
+    assert(classic.avg_loss < 0.1);
+    assert(classic.avg_goodput_bps > 800000);
+    assert(loss_based.avg_loss < 0.1);
+    assert(loss_based.avg_goodput_bps > 800000);
+}
+
+// AllocationFree
+// 稳定运行后, 延迟估计和丢包估计的更新都不分配内存
+void TestSendSideBandwidthEstimation04() {
+    for (int loss_based_control = 0; loss_based_control < 2; ++loss_based_control) {
+        AimdRateControl rate_control;
+        SendSideBandwidthEstimation bwe(LossBasedConfig(loss_based_control != 0));
+        rate_control.SetEstimate(300000, 0);
+        bwe.SetBitrates(300000, 10000, 0);
+        size_t allocations = g_num_allocations;
+        for (int64_t now_ms = 10; now_ms <= 100000; now_ms += 10) {
+            const int lost = (now_ms / 10) % 7 == 0 ? 3 : 0;
+            BandwidthUsage state = (now_ms / 10) % 50 == 0
+                ? BandwidthUsage::kBwOverusing : BandwidthUsage::kBwNormal;
+            RateControlInput input(state, bwe.target_rate());
+            rate_control.Update(&input, now_ms);
+            bwe.UpdateDelayBasedEstimate(rate_control.LatestEstimate());
+            bwe.UpdateAcknowledgedBitrate(bwe.target_rate(), now_ms);
+            bwe.UpdateRtt(50);
+            bwe.UpdatePacketsLost(lost, 30, now_ms);
+            bwe.UpdateEstimate(now_ms);
+        }
+        allocations = g_num_allocations - allocations;
+        cout << "loss based control=" << loss_based_control << " allocations=" << allocations << endl;
+        assert(allocations == 0);
+    }
+}
+
+} // namespace webrtc
+
+int main() {
+    webrtc::TestSendSideBandwidthEstimation01();
+    webrtc::TestSendSideBandwidthEstimation02();
+    webrtc::TestSendSideBandwidthEstimation03();
+    webrtc::TestSendSideBandwidthEstimation04();
+
+    return 0;
+}
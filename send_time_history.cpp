@@ -0,0 +1,138 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file send_time_history.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "send_time_history.h"
+
+namespace webrtc {
+
+namespace {
+
+size_t RoundUpToPowerOfTwo(size_t n) {
+    size_t power = 1;
+    while (power < n)
+        power <<= 1;
+    return power;
+}
+
+} // namespace
+
+constexpr int PacketFeedback::kNotAProbe;
+constexpr int64_t PacketFeedback::kNotReceived;
+constexpr int64_t PacketFeedback::kNoSendTime;
+constexpr size_t SendTimeHistory::kDefaultCapacity;
+
+PacketFeedback::PacketFeedback(int64_t arrival_time_ms, uint16_t sequence_number)
+    : creation_time_ms(-1),
+    arrival_time_ms(arrival_time_ms),
+    send_time_ms(kNoSendTime),
+    sequence_number(sequence_number),
+    long_sequence_number(0),
+    payload_size(0),
+    probe_cluster_id(kNotAProbe) {}
+
+SendTimeHistory::SendTimeHistory(int64_t packet_age_limit_ms, size_t capacity)
+    : _packet_age_limit_ms(packet_age_limit_ms),
+    _entries(RoundUpToPowerOfTwo(capacity)),
+    _mask(static_cast<int64_t>(_entries.size()) - 1),
+    _begin_seq(0),
+    _end_seq(0),
+    _num_entries(0) {
+    for (Entry& entry : _entries)
+        entry.long_sequence_number = -1;
+}
+
+SendTimeHistory::~SendTimeHistory() {}
+
+void SendTimeHistory::AddAndRemoveOld(const PacketFeedback& packet) {
+    const int64_t now_ms = packet.creation_time_ms;
+    const int64_t capacity = _mask + 1;
+    const int64_t seq = _seq_num_unwrapper.Unwrap(packet.sequence_number);
+
+    // 新包离所有旧包都超过一个环的距离, 直接清空
+    if (seq >= _end_seq + capacity) {
+        for (int64_t s = _begin_seq; s < _end_seq; ++s)
+            Erase(&Slot(s));
+        _begin_seq = _end_seq = seq;
+    }
+    // Remove old ones, and the ones the new packet would overwrite.
+    while (_begin_seq < _end_seq) {
+        Entry& entry = Slot(_begin_seq);
+        if (entry.long_sequence_number == _begin_seq &&
+                now_ms - entry.creation_time_ms <= _packet_age_limit_ms &&
+                _begin_seq > seq - capacity)
+            break;
+        Erase(&entry);
+        ++_begin_seq;
+    }
+
+    if (_begin_seq == _end_seq) {
+        _begin_seq = seq;
+        _end_seq = seq + 1;
+    } else if (seq >= _end_seq) {
+        _end_seq = seq + 1;
+    } else if (seq < _begin_seq) {
+        if (seq <= _end_seq - capacity)
+            return;
+        _begin_seq = seq;
+    }
+
+    Entry& entry = Slot(seq);
+    if (entry.long_sequence_number < 0)
+        ++_num_entries;
+    entry.long_sequence_number = seq;
+    entry.creation_time_ms = packet.creation_time_ms;
+    entry.send_time_ms = packet.send_time_ms;
+    entry.payload_size = static_cast<uint32_t>(packet.payload_size);
+    entry.probe_cluster_id = packet.probe_cluster_id;
+}
+
+bool SendTimeHistory::OnSentPacket(uint16_t sequence_number, int64_t send_time_ms) {
+    Entry* entry = Find(sequence_number);
+    if (!entry)
+        return false;
+    entry->send_time_ms = send_time_ms;
+    return true;
+}
+
+bool SendTimeHistory::GetFeedback(PacketFeedback* packet_feedback, bool remove) {
+    Entry* entry = Find(packet_feedback->sequence_number);
+    if (!entry)
+        return false;
+    packet_feedback->creation_time_ms = entry->creation_time_ms;
+    packet_feedback->send_time_ms = entry->send_time_ms;
+    packet_feedback->long_sequence_number = entry->long_sequence_number;
+    packet_feedback->payload_size = entry->payload_size;
+    packet_feedback->probe_cluster_id = entry->probe_cluster_id;
+    if (remove)
+        Erase(entry);
+    return true;
+}
+
+SendTimeHistory::Entry* SendTimeHistory::Find(uint16_t sequence_number) {
+    if (_begin_seq == _end_seq)
+        return nullptr;
+    // 反馈中的序号按与最新序号的差值unwrap, 不更新unwrapper的状态
+    const int64_t newest_seq = _end_seq - 1;
+    int64_t seq = newest_seq +
+        static_cast<int16_t>(sequence_number - static_cast<uint16_t>(newest_seq));
+    if (seq < _begin_seq || seq > newest_seq)
+        return nullptr;
+    Entry& entry = Slot(seq);
+    return entry.long_sequence_number == seq ? &entry : nullptr;
+}
+
+void SendTimeHistory::Erase(Entry* entry) {
+    if (entry->long_sequence_number < 0)
+        return;
+    entry->long_sequence_number = -1;
+    --_num_entries;
+}
+
+} // namespace webrtc
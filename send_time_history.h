@@ -0,0 +1,105 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file send_time_history.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _SEND_TIME_HISTORY_H
+#define _SEND_TIME_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "module_common_types_public.h"
+
+namespace webrtc {
+
+struct PacketFeedback {
+    static constexpr int kNotAProbe = -1;
+    static constexpr int64_t kNotReceived = -1;
+    static constexpr int64_t kNoSendTime = -1;
+
+    PacketFeedback(int64_t arrival_time_ms, uint16_t sequence_number);
+
+    // Time corresponding to when this object was created.
+    int64_t creation_time_ms;
+    // Time corresponding to when the packet was received. Timestamped with the
+    // receiver's clock. kNotReceived if the packet was lost.
+    int64_t arrival_time_ms;
+    // Time corresponding to when the packet was sent, timestamped with the
+    // sender's clock. kNoSendTime if not sent yet.
+    int64_t send_time_ms;
+    // Packet identifier, incremented with 1 for every packet generated by the
+    // sender.
+    uint16_t sequence_number;
+    // Session unique packet identifier, incremented with 1 for every packet
+    // generated by the sender.
+    int64_t long_sequence_number;
+    // Size of the packet excluding RTP headers.
+    size_t payload_size;
+    int probe_cluster_id;
+};
+
+// 发送端的包历史, 用于把反馈中的序号还原成发送时间和包大小。
+// 按unwrap后的transport sequence number存放在2的幂大小的环形数组中, 查找是一次
+// 下标运算而不是std::map的树查找; 超过packet_age_limit_ms或者超出环容量的旧包被剔除。
+class SendTimeHistory {
+public:
+    static constexpr size_t kDefaultCapacity = 1 << 15;
+
+    // |capacity| is rounded up to a power of two.
+    explicit SendTimeHistory(int64_t packet_age_limit_ms, size_t capacity = kDefaultCapacity);
+    ~SendTimeHistory();
+
+    // Cleanup old entries, then add new packet info with provided parameters.
+    void AddAndRemoveOld(const PacketFeedback& packet);
+
+    // Updates packet info identified by |sequence_number| with |send_time_ms|.
+    // Return false if not found.
+    bool OnSentPacket(uint16_t sequence_number, int64_t send_time_ms);
+
+    // Look up PacketFeedback for a sent packet, based on a sequence number, and
+    // populate all fields except for arrival_time. The packet parameter must
+    // thus be non-null and have the sequence_number field set.
+    bool GetFeedback(PacketFeedback* packet_feedback, bool remove);
+
+    // Number of packets in the history.
+    size_t size() const { return _num_entries; }
+
+private:
+    // 32字节一个槽位, 两个槽位一条cache line
+    struct Entry {
+        int64_t long_sequence_number; // -1 if the slot is empty.
+        int64_t creation_time_ms;
+        int64_t send_time_ms;
+        uint32_t payload_size;
+        int32_t probe_cluster_id;
+    };
+
+    Entry& Slot(int64_t long_sequence_number) {
+        return _entries[long_sequence_number & _mask];
+    }
+    Entry* Find(uint16_t sequence_number);
+    void Erase(Entry* entry);
+
+    const int64_t _packet_age_limit_ms;
+    SequenceNumberUnwrapper _seq_num_unwrapper;
+    std::vector<Entry> _entries;
+    const int64_t _mask;
+    // 历史中的包都在[_begin_seq, _end_seq)内, 范围不超过环的容量
+    int64_t _begin_seq;
+    int64_t _end_seq;
+    size_t _num_entries;
+};
+
+} // namespace webrtc
+
+#endif // _SEND_TIME_HISTORY_H
+
+
@@ -10,13 +10,360 @@
 
 #include "transport_feedback.h"
 
-namespace xxx {
+#include <algorithm>
+#include <cassert>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "byte_io.h"
+#include "module_common_types_public.h"
+
+namespace webrtc {
+
+namespace rtcp {
+
+namespace {
+// Header size:
+// * 4 bytes Common RTCP Packet Header
+// * 8 bytes Common Packet Format for RTCP Feedback Messages
+// * 8 bytes FeedbackPacket header
+constexpr size_t kTransportFeedbackHeaderSizeBytes = 4 + 8 + 8;
+constexpr size_t kChunkSizeBytes = 2;
+// Size constraint imposed by RTCP common header: 16bit size field interpreted
+// as number of four byte words minus the first header word.
+constexpr size_t kMaxSizeBytes = (1 << 16) * 4;
+// Payload size:
+// * 8 bytes Common Packet Format for RTCP Feedback Messages
+// * 8 bytes FeedbackPacket header.
+// * 2 bytes for one chunk.
+constexpr size_t kMinPayloadSizeBytes = 8 + 8 + 2;
+// reference time单位为64ms
+constexpr int kBaseScaleFactor = TransportFeedback::kDeltaScaleFactor * (1 << 8);
+// reference time为24位, 约12.4天回绕一次
+constexpr int64_t kTimeWrapPeriodUs = (1ll << 24) * kBaseScaleFactor;
+
+// chunk中的symbol个数(run length为游程长度), 调用方还需要用status count截断
+inline size_t ChunkCapacity(uint16_t chunk) {
+    if ((chunk & 0x8000) == 0)
+        return chunk & 0x1fff;
+    return (chunk & 0x4000) == 0 ? 14 : 7;
+}
+
+// chunk中第i个symbol, 即recv delta的字节数, 3为非法值
+inline uint8_t ChunkSymbol(uint16_t chunk, size_t i) {
+    if ((chunk & 0x8000) == 0)
+        return (chunk >> 13) & 0x03;
+    if ((chunk & 0x4000) == 0)
+        return (chunk >> (13 - i)) & 0x01;
+    return (chunk >> 2 * (6 - i)) & 0x03;
+}
+
+// 与LastChunk中的容量一致, EncodeChunks批量编码时使用
+constexpr size_t kRunLengthCapacity = 0x1fff;
+constexpr size_t kOneBitCapacity = 14;
+constexpr size_t kTwoBitCapacity = 7;
+constexpr uint8_t kLargeDeltaSize = 2;
+
+// |symbols|开头相同symbol的游程长度, 最多|max_length|; 会读到max_length之后15字节
+inline size_t RunLength(const uint8_t* symbols, size_t max_length) {
+#if defined(__SSE2__)
+    const __m128i first = _mm_set1_epi8(static_cast<char>(symbols[0]));
+    for (size_t length = 0; length < max_length; length += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(symbols + length));
+        uint32_t differ = ~_mm_movemask_epi8(_mm_cmpeq_epi8(block, first)) & 0xffff;
+        if (differ != 0)
+            return std::min<size_t>(max_length, length + __builtin_ctz(differ));
+    }
+    return max_length;
+#else
+    size_t length = 1;
+    while (length < max_length && symbols[length] == symbols[0])
+        ++length;
+    return length;
+#endif
+}
+
+// 前14个symbol中第一个2字节delta的下标, 没有则返回14
+inline size_t FindLargeDelta(const uint8_t* symbols) {
+#if defined(__SSE2__)
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(symbols));
+    uint32_t large = _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(kLargeDeltaSize))) & 0x3fff;
+    return large != 0 ? __builtin_ctz(large) : kOneBitCapacity;
+#else
+    size_t i = 0;
+    while (i < kOneBitCapacity && symbols[i] != kLargeDeltaSize)
+        ++i;
+    return i;
+#endif
+}
+
+// 前14个symbol的one bit status vector, 第i个symbol在第13-i位
+inline uint16_t OneBitSymbols(const uint8_t* symbols) {
+#if defined(__SSE2__)
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(symbols));
+    uint32_t v = _mm_movemask_epi8(_mm_cmpgt_epi8(block, _mm_setzero_si128())) & 0x3fff;
+    // movemask的第i位对应第i个symbol, 翻转成协议的高位在前
+    v = ((v >> 1) & 0x5555) | ((v & 0x5555) << 1);
+    v = ((v >> 2) & 0x3333) | ((v & 0x3333) << 2);
+    v = ((v >> 4) & 0x0f0f) | ((v & 0x0f0f) << 4);
+    v = ((v >> 8) & 0x00ff) | ((v & 0x00ff) << 8);
+    return static_cast<uint16_t>(v >> 2);
+#else
+    uint16_t v = 0;
+    for (size_t i = 0; i < kOneBitCapacity; ++i)
+        v |= symbols[i] << (kOneBitCapacity - 1 - i);
+    return v;
+#endif
+}
+
+//    Message format
+//
+//     0                   1                   2                   3
+//     0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |V=2|P|  FMT=15 |    PT=205     |           length              |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  0 |                     SSRC of packet sender                     |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  4 |                      SSRC of media source                     |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  8 |      base sequence number     |      packet status count      |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// 12 |                 reference time                | fb pkt. count |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// 16 |          packet chunk         |         packet chunk          |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    .                                                               .
+//    .                                                               .
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |         packet chunk          |  recv delta   |  recv delta   |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    .                                                               .
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//    |           recv delta          |  recv delta   | zero padding  |
+//    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+} // namespace
+
+constexpr uint8_t TransportFeedback::kFeedbackMessageType;
+constexpr int TransportFeedback::kDeltaScaleFactor;
+constexpr size_t TransportFeedback::kMaxReportedPackets;
+
+constexpr size_t TransportFeedback::LastChunk::kMaxRunLengthCapacity;
+constexpr size_t TransportFeedback::LastChunk::kMaxOneBitCapacity;
+constexpr size_t TransportFeedback::LastChunk::kMaxTwoBitCapacity;
+constexpr size_t TransportFeedback::LastChunk::kMaxVectorCapacity;
+
+TransportFeedback::LastChunk::LastChunk() {
+    Clear();
+}
+
+bool TransportFeedback::LastChunk::Empty() const {
+    return _size == 0;
+}
+
+void TransportFeedback::LastChunk::Clear() {
+    _size = 0;
+    _all_same = true;
+    _has_large_delta = false;
+}
+
+bool TransportFeedback::LastChunk::CanAdd(DeltaSize delta_size) const {
+    assert(delta_size <= 2);
+    if (_size < kMaxTwoBitCapacity)
+        return true;
+    if (_size < kMaxOneBitCapacity && !_has_large_delta && delta_size != kLarge)
+        return true;
+    if (_size < kMaxRunLengthCapacity && _all_same && _delta_sizes[0] == delta_size)
+        return true;
+    return false;
+}
+
+void TransportFeedback::LastChunk::Add(DeltaSize delta_size) {
+    assert(CanAdd(delta_size));
+    if (_size < kMaxVectorCapacity)
+        _delta_sizes[_size] = delta_size;
+    _size++;
+    _all_same = _all_same && delta_size == _delta_sizes[0];
+    _has_large_delta = _has_large_delta || delta_size == kLarge;
+}
+
+uint16_t TransportFeedback::LastChunk::Emit() {
+    assert(!CanAdd(0) || !CanAdd(1) || !CanAdd(2));
+    if (_all_same) {
+        uint16_t chunk = EncodeRunLength();
+        Clear();
+        return chunk;
+    }
+    if (_size == kMaxOneBitCapacity) {
+        uint16_t chunk = EncodeOneBit();
+        Clear();
+        return chunk;
+    }
+    assert(_size >= kMaxTwoBitCapacity);
+    uint16_t chunk = EncodeTwoBit(kMaxTwoBitCapacity);
+    // Remove |kMaxTwoBitCapacity| encoded delta sizes:
+    // Shift remaining delta sizes and recalculate _all_same && _has_large_delta.
+    _size -= kMaxTwoBitCapacity;
+    _all_same = true;
+    _has_large_delta = false;
+    for (size_t i = 0; i < _size; ++i) {
+        DeltaSize delta_size = _delta_sizes[kMaxTwoBitCapacity + i];
+        _delta_sizes[i] = delta_size;
+        _all_same = _all_same && delta_size == _delta_sizes[0];
+        _has_large_delta = _has_large_delta || delta_size == kLarge;
+    }
+
+    return chunk;
+}
+
+uint16_t TransportFeedback::LastChunk::EncodeLast() const {
+    assert(_size > 0);
+    if (_all_same)
+        return EncodeRunLength();
+    if (_size <= kMaxTwoBitCapacity)
+        return EncodeTwoBit(_size);
+    return EncodeOneBit();
+}
+
+void TransportFeedback::LastChunk::AppendTo(std::vector<DeltaSize>* deltas) const {
+    if (_all_same) {
+        deltas->insert(deltas->end(), _size, _delta_sizes[0]);
+    } else {
+        deltas->insert(deltas->end(), _delta_sizes, _delta_sizes + _size);
+    }
+}
+
+void TransportFeedback::LastChunk::Decode(uint16_t chunk, size_t max_size) {
+    if ((chunk & 0x8000) == 0) {
+        DecodeRunLength(chunk, max_size);
+    } else if ((chunk & 0x4000) == 0) {
+        DecodeOneBit(chunk, max_size);
+    } else {
+        DecodeTwoBit(chunk, max_size);
+    }
+}
+
+//  One Bit Status Vector Chunk
+//
+//  0                   1
+//  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |T|S|       symbol list         |
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//
+//  T = 1
+//  S = 0
+//  Symbol list = 14 entries where 0 = not received, 1 = received 1-byte delta.
+uint16_t TransportFeedback::LastChunk::EncodeOneBit() const {
+    assert(!_has_large_delta);
+    assert(_size <= kMaxOneBitCapacity);
+    uint16_t chunk = 0x8000;
+    for (size_t i = 0; i < _size; ++i)
+        chunk |= _delta_sizes[i] << (kMaxOneBitCapacity - 1 - i);
+    return chunk;
+}
+
+void TransportFeedback::LastChunk::DecodeOneBit(uint16_t chunk, size_t max_size) {
+    assert((chunk & 0xc000) == 0x8000);
+    _size = std::min(kMaxOneBitCapacity, max_size);
+    _has_large_delta = false;
+    _all_same = false;
+    for (size_t i = 0; i < _size; ++i)
+        _delta_sizes[i] = (chunk >> (kMaxOneBitCapacity - 1 - i)) & 0x01;
+}
+
+//  Two Bit Status Vector Chunk
+//
+//  0                   1
+//  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |T|S|       symbol list         |
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//
+//  T = 1
+//  S = 1
+//  symbol list = 7 entries of two bits each.
+uint16_t TransportFeedback::LastChunk::EncodeTwoBit(size_t size) const {
+    assert(size <= _size);
+    uint16_t chunk = 0xc000;
+    for (size_t i = 0; i < size; ++i)
+        chunk |= _delta_sizes[i] << 2 * (kMaxTwoBitCapacity - 1 - i);
+    return chunk;
+}
+
+void TransportFeedback::LastChunk::DecodeTwoBit(uint16_t chunk, size_t max_size) {
+    assert((chunk & 0xc000) == 0xc000);
+    _size = std::min(kMaxTwoBitCapacity, max_size);
+    _has_large_delta = true;
+    _all_same = false;
+    for (size_t i = 0; i < _size; ++i)
+        _delta_sizes[i] = (chunk >> 2 * (kMaxTwoBitCapacity - 1 - i)) & 0x03;
+}
+
+//  Run Length Status Vector Chunk
+//
+//  0                   1
+//  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//  |T| S |       Run Length        |
+//  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//
+//  T = 0
+//  S = symbol
+//  Run Length = Unsigned integer denoting the run length of the symbol
+uint16_t TransportFeedback::LastChunk::EncodeRunLength() const {
+    assert(_all_same);
+    assert(_size <= kMaxRunLengthCapacity);
+    return (_delta_sizes[0] << 13) | static_cast<uint16_t>(_size);
+}
+
+void TransportFeedback::LastChunk::DecodeRunLength(uint16_t chunk, size_t max_count) {
+    assert((chunk & 0x8000) == 0);
+    _size = std::min<size_t>(chunk & 0x1fff, max_count);
+    DeltaSize delta_size = (chunk >> 13) & 0x03;
+    _has_large_delta = delta_size >= kLarge;
+    _all_same = true;
+    // To make it consistent with Add function, populate _delta_sizes beyound 1st.
+    for (size_t i = 0; i < std::min<size_t>(_size, kMaxVectorCapacity); ++i)
+        _delta_sizes[i] = delta_size;
+}
+
+TransportFeedback::TransportFeedback()
+    : _base_seq_no(0),
+    _num_seq_no(0),
+    _base_time_ticks(0),
+    _feedback_seq(0),
+    _last_timestamp_us(0),
+    _size_bytes(kTransportFeedbackHeaderSizeBytes) {}
+
+TransportFeedback::~TransportFeedback() {}
+
+void TransportFeedback::SetBase(uint16_t base_sequence, int64_t ref_timestamp_us) {
+    assert(_num_seq_no == 0);
+    assert(ref_timestamp_us >= 0);
+    _base_seq_no = base_sequence;
+    _base_time_ticks = (ref_timestamp_us % kTimeWrapPeriodUs) / kBaseScaleFactor;
+    _last_timestamp_us = GetBaseTimeUs();
+}
+
+void TransportFeedback::SetFeedbackSequenceNumber(uint8_t feedback_sequence) {
+    _feedback_seq = feedback_sequence;
+}
+
+void TransportFeedback::Reset() {
+    _base_seq_no = 0;
+    _base_time_ticks = 0;
+    _feedback_seq = 0;
+    Clear();
+}
 
 bool TransportFeedback::AddReceivedPacket(uint16_t sequence_number, int64_t timestamp_us) {
-    // 看不懂 ???
-    // Convert to ticks and round
-    int64_t delta_full = (timestamp_us - _last_timestamp_us) % kTimeWrapPeriodUs
-    if (delta_full > kTimeWrapPeriodUs / 2) 
+    // 相对上一个包的到达时间差, 以250us为单位四舍五入
+    // Convert to ticks and round.
+    int64_t delta_full = (timestamp_us - _last_timestamp_us) % kTimeWrapPeriodUs;
+    if (delta_full > kTimeWrapPeriodUs / 2)
         delta_full -= kTimeWrapPeriodUs;
     delta_full += delta_full < 0 ? -(kDeltaScaleFactor / 2) : kDeltaScaleFactor / 2;
     delta_full /= kDeltaScaleFactor;
@@ -28,7 +375,7 @@ bool TransportFeedback::AddReceivedPacket(uint16_t sequence_number, int64_t time
         return false;
     }
 
-    uint16_t next_seq_no = base_seq_no_ + num_seq_no_;
+    uint16_t next_seq_no = _base_seq_no + _num_seq_no;
     if (sequence_number != next_seq_no) {
         uint16_t last_seq_no = next_seq_no - 1;
         if (!IsNewerSequenceNumber(sequence_number, last_seq_no))
@@ -44,12 +391,454 @@ bool TransportFeedback::AddReceivedPacket(uint16_t sequence_number, int64_t time
     if (!AddDeltaSize(delta_size))
         return false;
 
-    packets_.emplace_back(sequence_number, delta);
-    last_timestamp_us_ += delta * kDeltaScaleFactor;
-    size_bytes_ += delta_size;
+    _packets.emplace_back(sequence_number, delta);
+    _last_timestamp_us += delta * kDeltaScaleFactor;
+    _size_bytes += delta_size;
     return true;
 }
 
-} // namespace xxx
+size_t TransportFeedback::AddReceivedPackets(const uint16_t* sequence_numbers,
+        const int64_t* timestamps_us, size_t num_packets) {
+    // LastChunk中还没编码的symbol展开后和新的symbol一起选择chunk
+    _bulk_delta_sizes.clear();
+    _last_chunk.AppendTo(&_bulk_delta_sizes);
+    size_t delta_bytes = _size_bytes - kTransportFeedbackHeaderSizeBytes - kChunkSizeBytes *
+        (_encoded_chunks.size() + (_last_chunk.Empty() ? 0 : 1));
+
+    size_t num_added = 0;
+    for (; num_added < num_packets; ++num_added) {
+        const uint16_t sequence_number = sequence_numbers[num_added];
+        // 与AddReceivedPacket相同的取整, 只有跨越回绕周期时才需要取模
+        int64_t delta_full = timestamps_us[num_added] - _last_timestamp_us;
+        if (delta_full <= -kTimeWrapPeriodUs || delta_full >= kTimeWrapPeriodUs)
+            delta_full %= kTimeWrapPeriodUs;
+        if (delta_full > kTimeWrapPeriodUs / 2)
+            delta_full -= kTimeWrapPeriodUs;
+        delta_full += delta_full < 0 ? -(kDeltaScaleFactor / 2) : kDeltaScaleFactor / 2;
+        delta_full /= kDeltaScaleFactor;
+
+        int16_t delta = static_cast<int16_t>(delta_full);
+        if (delta != delta_full)
+            break;
+
+        uint16_t next_seq_no = _base_seq_no + _num_seq_no;
+        if (sequence_number != next_seq_no) {
+            uint16_t last_seq_no = next_seq_no - 1;
+            if (!IsNewerSequenceNumber(sequence_number, last_seq_no))
+                break;
+            // 和逐个AddDeltaSize(0)一样, 超过kMaxReportedPackets之前的丢包仍然保留
+            size_t num_lost = std::min<size_t>(static_cast<uint16_t>(sequence_number - next_seq_no),
+                    kMaxReportedPackets - _num_seq_no);
+            _bulk_delta_sizes.insert(_bulk_delta_sizes.end(), num_lost, 0);
+            _num_seq_no += num_lost;
+        }
+        if (_num_seq_no == kMaxReportedPackets)
+            break;
+
+        DeltaSize delta_size = (delta >= 0 && delta <= 0xff) ? 1 : 2;
+        _bulk_delta_sizes.push_back(delta_size);
+        ++_num_seq_no;
+        _packets.emplace_back(sequence_number, delta);
+        _last_timestamp_us += delta * kDeltaScaleFactor;
+        delta_bytes += delta_size;
+    }
+
+    const size_t num_delta_sizes = _bulk_delta_sizes.size();
+    _bulk_delta_sizes.resize(num_delta_sizes + 15);
+    _last_chunk.Clear();
+    size_t encoded = EncodeChunks(_bulk_delta_sizes.data(), num_delta_sizes, &_encoded_chunks);
+    // 剩下的symbol可能和后续的包合并成一个chunk, 交给LastChunk。
+    // 通常剩下的是延续到末尾的游程, 直接按run length chunk解码即可
+    if (encoded < num_delta_sizes && RunLength(&_bulk_delta_sizes[encoded],
+                num_delta_sizes - encoded) == num_delta_sizes - encoded) {
+        const size_t run = num_delta_sizes - encoded;
+        _last_chunk.Decode((_bulk_delta_sizes[encoded] << 13) | static_cast<uint16_t>(run), run);
+        encoded = num_delta_sizes;
+    }
+    for (size_t i = encoded; i < num_delta_sizes; ++i) {
+        DeltaSize delta_size = _bulk_delta_sizes[i];
+        if (!_last_chunk.CanAdd(delta_size))
+            _encoded_chunks.push_back(_last_chunk.Emit());
+        _last_chunk.Add(delta_size);
+    }
+    _size_bytes = kTransportFeedbackHeaderSizeBytes + delta_bytes + kChunkSizeBytes *
+        (_encoded_chunks.size() + (_last_chunk.Empty() ? 0 : 1));
+    return num_added;
+}
+
+// LastChunk逐个添加时, 从空chunk开始的选择只取决于接下来的symbol:
+// - 游程>=14, 或者游程>=7且游程本身或其后的symbol是2字节delta: run length chunk
+// - 否则前14个symbol都没有2字节delta: one bit chunk(14个)
+// - 否则: two bit chunk(7个)
+// 并且每次输出chunk之后剩下的symbol与重新从空chunk添加等价, 因此可以按位置
+// 独立地选择, 不必逐个symbol维护LastChunk的状态。
+size_t TransportFeedback::EncodeChunks(const DeltaSize* delta_sizes, size_t size,
+        std::vector<uint16_t>* chunks) {
+    size_t pos = 0;
+    // 剩余不足15个symbol, 或游程一直延续到末尾时, 后续的symbol还可能改变选择
+    while (size - pos > kOneBitCapacity) {
+        const DeltaSize* symbols = delta_sizes + pos;
+        size_t run = RunLength(symbols, std::min(size - pos, kRunLengthCapacity));
+        if (run == size - pos)
+            break;
+
+        if (run >= kOneBitCapacity || (run >= kTwoBitCapacity &&
+                    (symbols[0] == kLargeDeltaSize || symbols[run] == kLargeDeltaSize))) {
+            chunks->push_back((symbols[0] << 13) | static_cast<uint16_t>(run));
+            pos += run;
+        } else if (FindLargeDelta(symbols) == kOneBitCapacity) {
+            chunks->push_back(0x8000 | OneBitSymbols(symbols));
+            pos += kOneBitCapacity;
+        } else {
+            uint16_t chunk = 0xc000;
+            for (size_t i = 0; i < kTwoBitCapacity; ++i)
+                chunk |= symbols[i] << 2 * (kTwoBitCapacity - 1 - i);
+            chunks->push_back(chunk);
+            pos += kTwoBitCapacity;
+        }
+    }
+    return pos;
+}
+
+const std::vector<TransportFeedback::ReceivedPacket>&
+TransportFeedback::GetReceivedPackets() const {
+    return _packets;
+}
+
+uint16_t TransportFeedback::GetBaseSequence() const {
+    return _base_seq_no;
+}
+
+int64_t TransportFeedback::GetBaseTimeUs() const {
+    return static_cast<int64_t>(_base_time_ticks) * kBaseScaleFactor;
+}
+
+bool TransportFeedback::Parse(const CommonHeader& packet) {
+    assert(packet.type() == kPacketType);
+    assert(packet.fmt() == kFeedbackMessageType);
+
+    if (packet.payload_size_bytes() < kMinPayloadSizeBytes) {
+        // RTC_LOG(LS_WARNING) << "Buffer too small (" << packet.payload_size_bytes()
+        //     << " bytes) to fit a FeedbackPacket. Minimum size = " << kMinPayloadSizeBytes;
+        return false;
+    }
+
+    const uint8_t* const payload = packet.payload();
+    ParseCommonFeedback(payload);
+
+    _base_seq_no = ByteReader<uint16_t>::ReadBigEndian(&payload[8]);
+    uint16_t status_count = ByteReader<uint16_t>::ReadBigEndian(&payload[10]);
+    _base_time_ticks = ByteReader<int32_t, 3>::ReadBigEndian(&payload[12]);
+    _feedback_seq = payload[15];
+    Clear();
+    size_t index = 16;
+    const size_t end_index = packet.payload_size_bytes();
+
+    if (status_count == 0) {
+        // RTC_LOG(LS_WARNING) << "Empty feedback messages not allowed.";
+        return false;
+    }
+
+    std::vector<uint8_t> delta_sizes;
+    delta_sizes.reserve(status_count);
+    while (delta_sizes.size() < status_count) {
+        if (index + kChunkSizeBytes > end_index) {
+            // RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
+            Clear();
+            return false;
+        }
+
+        uint16_t chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[index]);
+        index += kChunkSizeBytes;
+        _encoded_chunks.push_back(chunk);
+        _last_chunk.Decode(chunk, status_count - delta_sizes.size());
+        _last_chunk.AppendTo(&delta_sizes);
+    }
+    // Last chunk is stored in the |_last_chunk|.
+    _encoded_chunks.pop_back();
+    assert(delta_sizes.size() == status_count);
+    _num_seq_no = status_count;
+
+    uint16_t seq_no = _base_seq_no;
+    for (size_t delta_size : delta_sizes) {
+        if (index + delta_size > end_index) {
+            // RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
+            Clear();
+            return false;
+        }
+        switch (delta_size) {
+            case 0:
+                break;
+            case 1: {
+                int16_t delta = payload[index];
+                _packets.emplace_back(seq_no, delta);
+                _last_timestamp_us += delta * kDeltaScaleFactor;
+                index += delta_size;
+                break;
+            }
+            case 2: {
+                int16_t delta = ByteReader<int16_t>::ReadBigEndian(&payload[index]);
+                _packets.emplace_back(seq_no, delta);
+                _last_timestamp_us += delta * kDeltaScaleFactor;
+                index += delta_size;
+                break;
+            }
+            case 3:
+                Clear();
+                // RTC_LOG(LS_WARNING) << "Invalid delta_size for seq_no " << seq_no;
+                return false;
+            default:
+                assert(false);
+                break;
+        }
+        ++seq_no;
+    }
+    _size_bytes = RtcpPacket::kHeaderLength + index;
+    assert(index <= end_index);
+    return true;
+}
+
+std::unique_ptr<TransportFeedback> TransportFeedback::ParseFrom(const uint8_t* buffer,
+        size_t length) {
+    CommonHeader header;
+    if (!header.Parse(buffer, length))
+        return nullptr;
+    if (header.type() != kPacketType || header.fmt() != kFeedbackMessageType)
+        return nullptr;
+    std::unique_ptr<TransportFeedback> parsed(new TransportFeedback);
+    if (!parsed->Parse(header))
+        return nullptr;
+    return parsed;
+}
+
+size_t TransportFeedback::BlockLength() const {
+    // Round _size_bytes up to multiple of 32bits.
+    return (_size_bytes + 3) & (~static_cast<size_t>(3));
+}
+
+size_t TransportFeedback::PaddingLength() const {
+    return BlockLength() - _size_bytes;
+}
+
+// Serialize packet.
+bool TransportFeedback::Create(uint8_t* packet, size_t* position, size_t max_length) const {
+    if (_num_seq_no == 0)
+        return false;
+    if (*position + BlockLength() > max_length)
+        return false;
+
+    const size_t position_end = *position + BlockLength();
+    const size_t padding_length = PaddingLength();
+    bool has_padding = padding_length > 0;
+    CreateHeader(kFeedbackMessageType, kPacketType, HeaderLength(), has_padding,
+            packet, position);
+    CreateCommonFeedback(packet + *position);
+    *position += kCommonFeedbackLength;
+
+    ByteWriter<uint16_t>::WriteBigEndian(&packet[*position], _base_seq_no);
+    *position += 2;
+
+    ByteWriter<uint16_t>::WriteBigEndian(&packet[*position], _num_seq_no);
+    *position += 2;
+
+    ByteWriter<int32_t, 3>::WriteBigEndian(&packet[*position], _base_time_ticks);
+    *position += 3;
+
+    packet[(*position)++] = _feedback_seq;
+
+    for (uint16_t chunk : _encoded_chunks) {
+        ByteWriter<uint16_t>::WriteBigEndian(&packet[*position], chunk);
+        *position += 2;
+    }
+    if (!_last_chunk.Empty()) {
+        uint16_t chunk = _last_chunk.EncodeLast();
+        ByteWriter<uint16_t>::WriteBigEndian(&packet[*position], chunk);
+        *position += 2;
+    }
+
+    for (const auto& received_packet : _packets) {
+        int16_t delta = received_packet.delta_ticks();
+        if (delta >= 0 && delta <= 0xFF) {
+            packet[(*position)++] = delta;
+        } else {
+            ByteWriter<int16_t>::WriteBigEndian(&packet[*position], delta);
+            *position += 2;
+        }
+    }
+
+    if (padding_length > 0) {
+        for (size_t i = 0; i < padding_length - 1; ++i) {
+            packet[(*position)++] = 0;
+        }
+        packet[(*position)++] = padding_length;
+    }
+    assert(*position == position_end);
+    (void)position_end;
+    return true;
+}
+
+void TransportFeedback::Clear() {
+    _num_seq_no = 0;
+    _last_timestamp_us = GetBaseTimeUs();
+    _packets.clear();
+    _encoded_chunks.clear();
+    _last_chunk.Clear();
+    _size_bytes = kTransportFeedbackHeaderSizeBytes;
+}
+
+bool TransportFeedback::AddDeltaSize(DeltaSize delta_size) {
+    if (_num_seq_no == kMaxReportedPackets)
+        return false;
+    size_t add_chunk_size = _last_chunk.Empty() ? kChunkSizeBytes : 0;
+    if (_size_bytes + delta_size + add_chunk_size > kMaxSizeBytes)
+        return false;
+
+    if (_last_chunk.CanAdd(delta_size)) {
+        _size_bytes += add_chunk_size;
+        _last_chunk.Add(delta_size);
+        ++_num_seq_no;
+        return true;
+    }
+    if (_size_bytes + delta_size + kChunkSizeBytes > kMaxSizeBytes)
+        return false;
+
+    _encoded_chunks.push_back(_last_chunk.Emit());
+    _size_bytes += kChunkSizeBytes;
+    _last_chunk.Add(delta_size);
+    ++_num_seq_no;
+    return true;
+}
+
+TransportFeedbackView::TransportFeedbackView()
+    : _sender_ssrc(0),
+    _media_ssrc(0),
+    _base_seq_no(0),
+    _status_count(0),
+    _base_time_ticks(0),
+    _feedback_seq(0),
+    _num_received(0),
+    _chunks(nullptr),
+    _deltas(nullptr) {}
+
+// 与TransportFeedback::Parse的校验规则一致, 但只遍历一次chunk统计recv delta的
+// 总字节数, 不展开成delta_sizes数组。
+bool TransportFeedbackView::Parse(const uint8_t* buffer, size_t size) {
+    *this = TransportFeedbackView();
+
+    CommonHeader header;
+    if (!header.Parse(buffer, size))
+        return false;
+    if (header.type() != Rtpfb::kPacketType ||
+            header.fmt() != TransportFeedback::kFeedbackMessageType)
+        return false;
+    if (header.payload_size_bytes() < kMinPayloadSizeBytes)
+        return false;
+
+    const uint8_t* const payload = header.payload();
+    const size_t end_index = header.payload_size_bytes();
+    uint16_t status_count = ByteReader<uint16_t>::ReadBigEndian(&payload[10]);
+    if (status_count == 0)
+        return false;
+
+    size_t index = 16;
+    size_t remaining = status_count;
+    size_t delta_bytes = 0;
+    size_t num_received = 0;
+    while (remaining > 0) {
+        if (index + kChunkSizeBytes > end_index)
+            return false;
+        uint16_t chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[index]);
+        index += kChunkSizeBytes;
+        size_t n = std::min(ChunkCapacity(chunk), remaining);
+        if ((chunk & 0x8000) == 0) {
+            uint8_t symbol = ChunkSymbol(chunk, 0);
+            if (symbol == 3 && n > 0)
+                return false;
+            delta_bytes += symbol * n;
+            num_received += symbol != 0 ? n : 0;
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                uint8_t symbol = ChunkSymbol(chunk, i);
+                if (symbol == 3)
+                    return false;
+                delta_bytes += symbol;
+                num_received += symbol != 0;
+            }
+        }
+        remaining -= n;
+    }
+    if (index + delta_bytes > end_index)
+        return false;
+
+    _sender_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[0]);
+    _media_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[4]);
+    _base_seq_no = ByteReader<uint16_t>::ReadBigEndian(&payload[8]);
+    _status_count = status_count;
+    _base_time_ticks = ByteReader<int32_t, 3>::ReadBigEndian(&payload[12]);
+    _feedback_seq = payload[15];
+    _num_received = num_received;
+    _chunks = payload + 16;
+    _deltas = payload + index;
+    return true;
+}
+
+int64_t TransportFeedbackView::base_time_us() const {
+    return static_cast<int64_t>(_base_time_ticks) * kBaseScaleFactor;
+}
+
+TransportFeedbackView::Iterator::Iterator(const TransportFeedbackView& view)
+    : _chunk(view._chunks),
+    _delta(view._deltas),
+    _seq(view._base_seq_no),
+    _remaining(view._status_count),
+    _chunk_value(0),
+    _chunk_left(0),
+    _chunk_pos(0) {}
+
+void TransportFeedbackView::Iterator::LoadChunk() {
+    // Parse()已经保证剩余的chunk足够覆盖_remaining个symbol
+    do {
+        _chunk_value = ByteReader<uint16_t>::ReadBigEndian(_chunk);
+        _chunk += kChunkSizeBytes;
+        _chunk_left = std::min(ChunkCapacity(_chunk_value), _remaining);
+    } while (_chunk_left == 0);
+    _chunk_pos = 0;
+}
+
+bool TransportFeedbackView::Iterator::Next(uint16_t* sequence_number, int16_t* delta_ticks) {
+    while (_remaining > 0) {
+        if (_chunk_left == 0)
+            LoadChunk();
+
+        // 连续丢包的run length chunk整体跳过
+        if ((_chunk_value & 0xe000) == 0) {
+            _seq += _chunk_left;
+            _remaining -= _chunk_left;
+            _chunk_left = 0;
+            continue;
+        }
+
+        uint8_t symbol = ChunkSymbol(_chunk_value, _chunk_pos);
+        ++_chunk_pos;
+        --_chunk_left;
+        --_remaining;
+        uint16_t seq = _seq++;
+        if (symbol == 0)
+            continue;
+
+        *sequence_number = seq;
+        if (symbol == 1) {
+            *delta_ticks = _delta[0];
+            _delta += 1;
+        } else {
+            *delta_ticks = ByteReader<int16_t>::ReadBigEndian(_delta);
+            _delta += 2;
+        }
+        return true;
+    }
+    return false;
+}
 
+} // namespace rtcp
 
+} // namespace webrtc
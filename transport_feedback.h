@@ -11,15 +11,33 @@
 #ifndef _TRANSPORT_FEEDBACK_H
 #define _TRANSPORT_FEEDBACK_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "common_header.h"
+#include "rtpfb.h"
+
 namespace webrtc {
 
 namespace rtcp {
 
+// transport-wide-cc-extensions-01 反馈包
+// https://tools.ietf.org/html/draft-holmer-rmcat-transport-wide-cc-extensions-01
 class TransportFeedback : public Rtpfb {
 public:
+    // TODO(sprang): IANA reg?
+    static constexpr uint8_t kFeedbackMessageType = 15;
+    // Convert to multiples of 0.25ms.
+    static constexpr int kDeltaScaleFactor = 250;
+    // Maximum number of packets (including missing) TransportFeedback can report.
+    static constexpr size_t kMaxReportedPackets = 0xffff;
+
     class ReceivedPacket {
         public:
-            ReceivedPacket(uint16_t sequence_number, int16_t delta_ticks) 
+            ReceivedPacket(uint16_t sequence_number, int16_t delta_ticks)
                 : _sequence_number(sequence_number), _delta_ticks(delta_ticks) {}
             ReceivedPacket(const ReceivedPacket&) = default;
             ReceivedPacket& operator=(const ReceivedPacket&) = default;
@@ -32,6 +50,182 @@ public:
             uint16_t _sequence_number;
             int16_t _delta_ticks;
     };
+
+    TransportFeedback();
+    ~TransportFeedback() override;
+
+    void SetBase(uint16_t base_sequence,     // Seq# of first packet in this msg.
+            int64_t ref_timestamp_us);        // Reference timestamp for this msg.
+    void SetFeedbackSequenceNumber(uint8_t feedback_sequence);
+    // 清空已添加的包, 之后可以重新SetBase; 保留内部vector的容量, 便于复用同一个对象
+    void Reset();
+    // NOTE: This method requires increasing sequence numbers (excepting wraps).
+    bool AddReceivedPacket(uint16_t sequence_number, int64_t timestamp_us);
+    // 批量添加, 结果与逐个调用AddReceivedPacket逐字节一致, 在第一个添加失败的包处停止。
+    // chunk的选择一次看一段symbol(有SSE2时16个一起比较), 而不是每个symbol走一遍LastChunk。
+    // Returns the number of packets added.
+    size_t AddReceivedPackets(const uint16_t* sequence_numbers,
+            const int64_t* timestamps_us, size_t num_packets);
+    const std::vector<ReceivedPacket>& GetReceivedPackets() const;
+
+    uint16_t GetBaseSequence() const;
+    // Returns number of packets (including missing) this feedback describes.
+    uint16_t GetPacketStatusCount() const { return _num_seq_no; }
+    uint8_t GetFeedbackSequenceNumber() const { return _feedback_seq; }
+
+    // 单位us, 精度64ms
+    int64_t GetBaseTimeUs() const;
+
+    // 解析会把所有包拷贝进_packets, 收包路径上请使用TransportFeedbackView
+    bool Parse(const CommonHeader& packet);
+    static std::unique_ptr<TransportFeedback> ParseFrom(const uint8_t* buffer, size_t length);
+
+    size_t BlockLength() const override;
+    size_t PaddingLength() const;
+
+    bool Create(uint8_t* packet, size_t* position, size_t max_length) const override;
+
+private:
+    // Size in bytes of a delta time in rtcp packet.
+    // Valid values are 0 (packet wasn't received), 1 or 2.
+    using DeltaSize = uint8_t;
+    // Keeps DeltaSizes that haven't been encoded into chunks yet.
+    class LastChunk {
+    public:
+        using DeltaSize = TransportFeedback::DeltaSize;
+
+        LastChunk();
+
+        bool Empty() const;
+        void Clear();
+        // Return if delta sizes still can be encoded into single chunk with added
+        // |delta_size|.
+        bool CanAdd(DeltaSize delta_size) const;
+        // Add |delta_size|, assumes |CanAdd(delta_size)|,
+        void Add(DeltaSize delta_size);
+
+        // Encode chunk as large as possible removing encoded delta sizes.
+        // Assume CanAdd() == false for some valid delta_size.
+        uint16_t Emit();
+        // Encode all stored delta_sizes into single chunk, pad with 0s if needed.
+        uint16_t EncodeLast() const;
+
+        // Decode up to |max_size| delta sizes from |chunk|.
+        void Decode(uint16_t chunk, size_t max_size);
+        // Appends content of the Lastchunk to |deltas|.
+        void AppendTo(std::vector<DeltaSize>* deltas) const;
+
+    private:
+        static constexpr size_t kMaxRunLengthCapacity = 0x1fff;
+        static constexpr size_t kMaxOneBitCapacity = 14;
+        static constexpr size_t kMaxTwoBitCapacity = 7;
+        static constexpr size_t kMaxVectorCapacity = kMaxOneBitCapacity;
+        static constexpr DeltaSize kLarge = 2;
+
+        uint16_t EncodeOneBit() const;
+        void DecodeOneBit(uint16_t chunk, size_t max_size);
+
+        uint16_t EncodeTwoBit(size_t size) const;
+        void DecodeTwoBit(uint16_t chunk, size_t max_size);
+
+        uint16_t EncodeRunLength() const;
+        void DecodeRunLength(uint16_t chunk, size_t max_size);
+
+        DeltaSize _delta_sizes[kMaxVectorCapacity];
+        size_t _size;
+        bool _all_same;
+        bool _has_large_delta;
+    };
+
+    // Reset packet to consistent empty state.
+    void Clear();
+
+    bool AddDeltaSize(DeltaSize delta_size);
+
+    // Emits the chunks of |delta_sizes| that LastChunk would emit when adding
+    // them one by one to an empty chunk, and returns how many delta sizes were
+    // consumed. The rest may still be merged with later delta sizes.
+    // |delta_sizes| must stay readable for 15 bytes past |size|.
+    static size_t EncodeChunks(const DeltaSize* delta_sizes, size_t size,
+            std::vector<uint16_t>* chunks);
+
+    uint16_t _base_seq_no;
+    uint16_t _num_seq_no;
+    int32_t _base_time_ticks;
+    uint8_t _feedback_seq;
+
+    int64_t _last_timestamp_us;
+    std::vector<ReceivedPacket> _packets;
+    // All but last encoded packet chunks.
+    std::vector<uint16_t> _encoded_chunks;
+    LastChunk _last_chunk;
+    size_t _size_bytes;
+    // AddReceivedPackets的临时buffer, 复用避免每次分配
+    std::vector<DeltaSize> _bulk_delta_sizes;
+};
+
+// 零拷贝解析: 只校验并记录接收buffer中chunk和recv delta的位置, 不分配内存,
+// 通过Iterator按顺序取出收到的包(seq, delta)。buffer的生命周期必须长于view。
+//
+//  TransportFeedbackView view;
+//  if (view.Parse(buffer, size)) {
+//      TransportFeedbackView::Iterator it = view.begin();
+//      uint16_t seq; int16_t delta_ticks;
+//      while (it.Next(&seq, &delta_ticks)) { ... }
+//  }
+class TransportFeedbackView {
+public:
+    class Iterator {
+    public:
+        // Moves to the next received packet, lost packets are skipped.
+        // Returns false when there are no more received packets.
+        bool Next(uint16_t* sequence_number, int16_t* delta_ticks);
+
+    private:
+        friend class TransportFeedbackView;
+        Iterator(const TransportFeedbackView& view);
+
+        // Loads the next chunk that holds at least one symbol.
+        void LoadChunk();
+
+        const uint8_t* _chunk;
+        const uint8_t* _delta;
+        uint16_t _seq;
+        // Symbols not yet visited, over all chunks.
+        size_t _remaining;
+        uint16_t _chunk_value;
+        // Symbols left in |_chunk_value| and index of the next one.
+        size_t _chunk_left;
+        size_t _chunk_pos;
+    };
+
+    TransportFeedbackView();
+
+    // Returns false if |buffer| does not hold a valid transport feedback packet,
+    // the view is left empty in that case.
+    bool Parse(const uint8_t* buffer, size_t size);
+
+    Iterator begin() const { return Iterator(*this); }
+
+    uint32_t sender_ssrc() const { return _sender_ssrc; }
+    uint32_t media_ssrc() const { return _media_ssrc; }
+    uint16_t base_sequence() const { return _base_seq_no; }
+    uint16_t packet_status_count() const { return _status_count; }
+    uint8_t feedback_sequence() const { return _feedback_seq; }
+    int64_t base_time_us() const;
+    // Number of packets reported as received.
+    size_t num_received() const { return _num_received; }
+
+private:
+    uint32_t _sender_ssrc;
+    uint32_t _media_ssrc;
+    uint16_t _base_seq_no;
+    uint16_t _status_count;
+    int32_t _base_time_ticks;
+    uint8_t _feedback_seq;
+    size_t _num_received;
+    const uint8_t* _chunks;
+    const uint8_t* _deltas;
 };
 
 } // namespace rtcp
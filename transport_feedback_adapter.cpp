@@ -0,0 +1,238 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file transport_feedback_adapter.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "transport_feedback_adapter.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+
+namespace webrtc {
+
+namespace {
+// base time是24位, 单位64ms
+constexpr int64_t kBaseTimestampScaleFactor = rtcp::TransportFeedback::kDeltaScaleFactor * (1 << 8);
+constexpr int64_t kBaseTimestampRangeSizeUs = kBaseTimestampScaleFactor * (1 << 24);
+} // namespace
+
+constexpr int64_t TransportFeedbackAdapter::kSendTimeHistoryWindowMs;
+constexpr size_t TransportFeedbackAdapter::kRtpSequenceMapSize;
+
+TransportFeedbackAdapter::TransportFeedbackAdapter()
+    : _send_time_history(kSendTimeHistoryWindowMs),
+    _has_last_timestamp(false),
+    _last_timestamp_us(0),
+    _current_offset_ms(0),
+    _has_last_report_timestamp(false),
+    _last_report_timestamp_compact_ntp(0),
+    _report_timestamp_unwrapped(0),
+    _report_time_base_us(0),
+    _num_results(0),
+    _failed_lookups(0) {}
+
+TransportFeedbackAdapter::~TransportFeedbackAdapter() {}
+
+void TransportFeedbackAdapter::AddPacket(uint16_t sequence_number, size_t payload_size,
+        int probe_cluster_id, int64_t creation_time_ms) {
+    PacketFeedback packet(PacketFeedback::kNotReceived, sequence_number);
+    packet.creation_time_ms = creation_time_ms;
+    packet.payload_size = payload_size;
+    packet.probe_cluster_id = probe_cluster_id;
+    _send_time_history.AddAndRemoveOld(packet);
+}
+
+void TransportFeedbackAdapter::AddPacket(uint32_t ssrc, uint16_t rtp_sequence_number,
+        uint16_t sequence_number, size_t payload_size, int probe_cluster_id,
+        int64_t creation_time_ms) {
+    AddPacket(sequence_number, payload_size, probe_cluster_id, creation_time_ms);
+    RtpSequenceMap* map = FindRtpSequenceMap(ssrc);
+    if (!map) {
+        RtpSequenceMap new_map;
+        new_map.ssrc = ssrc;
+        new_map.entries.resize(kRtpSequenceMapSize);
+        for (RtpSequenceMap::Entry& entry : new_map.entries)
+            entry.rtp_sequence_number = -1;
+        _rtp_sequence_maps.push_back(std::move(new_map));
+        map = &_rtp_sequence_maps.back();
+    }
+    RtpSequenceMap::Entry& entry = map->entries[rtp_sequence_number & (kRtpSequenceMapSize - 1)];
+    entry.rtp_sequence_number = rtp_sequence_number;
+    entry.sequence_number = sequence_number;
+}
+
+bool TransportFeedbackAdapter::OnSentPacket(uint16_t sequence_number, int64_t send_time_ms) {
+    return _send_time_history.OnSentPacket(sequence_number, send_time_ms);
+}
+
+size_t TransportFeedbackAdapter::OnTransportFeedback(const rtcp::TransportFeedback& feedback,
+        int64_t now_ms) {
+    UpdateTimeOffset(feedback.GetBaseTimeUs(), now_ms);
+    BeginFeedback(feedback.GetPacketStatusCount());
+    int64_t offset_us = 0;
+    uint16_t seq_num = feedback.GetBaseSequence();
+    for (const auto& packet : feedback.GetReceivedPackets()) {
+        // Insert into the vector those unreceived packets which precede this
+        // iteration's received packet.
+        for (; seq_num != packet.sequence_number(); ++seq_num)
+            AddLostPacket(seq_num, EcnMarking::kNotEct);
+        // Handle this iteration's received packet.
+        offset_us += packet.delta_us();
+        AddReceivedPacket(packet.sequence_number(), _current_offset_ms + offset_us / 1000,
+                EcnMarking::kNotEct);
+        ++seq_num;
+    }
+    return _num_results;
+}
+
+size_t TransportFeedbackAdapter::OnTransportFeedback(const rtcp::TransportFeedbackView& feedback,
+        int64_t now_ms) {
+    UpdateTimeOffset(feedback.base_time_us(), now_ms);
+    BeginFeedback(feedback.packet_status_count());
+    int64_t offset_us = 0;
+    uint16_t seq_num = feedback.base_sequence();
+    rtcp::TransportFeedbackView::Iterator it = feedback.begin();
+    uint16_t sequence_number;
+    int16_t delta_ticks;
+    while (it.Next(&sequence_number, &delta_ticks)) {
+        for (; seq_num != sequence_number; ++seq_num)
+            AddLostPacket(seq_num, EcnMarking::kNotEct);
+        offset_us += delta_ticks * rtcp::TransportFeedback::kDeltaScaleFactor;
+        AddReceivedPacket(sequence_number, _current_offset_ms + offset_us / 1000,
+                EcnMarking::kNotEct);
+        ++seq_num;
+    }
+    return _num_results;
+}
+
+size_t TransportFeedbackAdapter::OnCongestionControlFeedback(
+        const rtcp::CongestionControlFeedback& feedback, int64_t now_ms) {
+    // Report timestamp按32位的差值unwrap, 16.16秒, 约18小时回绕一次
+    const uint32_t report_timestamp = feedback.report_timestamp_compact_ntp();
+    if (!_has_last_report_timestamp) {
+        _report_time_base_us = now_ms * 1000;
+        _report_timestamp_unwrapped = 0;
+        _has_last_report_timestamp = true;
+    } else {
+        _report_timestamp_unwrapped +=
+            static_cast<int32_t>(report_timestamp - _last_report_timestamp_compact_ntp);
+    }
+    _last_report_timestamp_compact_ntp = report_timestamp;
+    const int64_t report_time_us = _report_time_base_us +
+        _report_timestamp_unwrapped * 15625 / 1024;
+
+    BeginFeedback(feedback.packets().size());
+    RtpSequenceMap* map = nullptr;
+    for (const rtcp::CongestionControlFeedback::PacketInfo& info : feedback.packets()) {
+        if (!map || map->ssrc != info.ssrc)
+            map = FindRtpSequenceMap(info.ssrc);
+        const RtpSequenceMap::Entry* entry = map ?
+            &map->entries[info.sequence_number & (kRtpSequenceMapSize - 1)] : nullptr;
+        if (!entry || entry->rtp_sequence_number != info.sequence_number) {
+            ++_failed_lookups;
+            continue;
+        }
+        if (info.arrival_time_offset_us == rtcp::CongestionControlFeedback::kNotReceived) {
+            AddLostPacket(entry->sequence_number, info.ecn);
+        } else if (info.arrival_time_offset_us < 0) {
+            // kArrivalTimeUnknown: 收到了但没有到达时间, 不算丢包, 也不参与时延计算
+            RemoveReceivedPacket(entry->sequence_number);
+        } else {
+            AddReceivedPacket(entry->sequence_number,
+                    (report_time_us - info.arrival_time_offset_us) / 1000, info.ecn);
+        }
+    }
+
+    // 每个SSRC块内按RTP序号排列, 多个SSRC时需要合并成transport sequence number的顺序
+    if (_num_results > 1) {
+        PacketResult* results = _packet_results.data();
+        const uint16_t first = results[0].sequence_number;
+        auto transport_order = [first](const PacketResult& a, const PacketResult& b) {
+            return static_cast<int16_t>(a.sequence_number - first) <
+                static_cast<int16_t>(b.sequence_number - first);
+        };
+        if (!std::is_sorted(results, results + _num_results, transport_order))
+            std::sort(results, results + _num_results, transport_order);
+    }
+    return _num_results;
+}
+
+void TransportFeedbackAdapter::UpdateTimeOffset(int64_t base_time_us, int64_t now_ms) {
+    if (!_has_last_timestamp) {
+        _current_offset_ms = now_ms;
+        _has_last_timestamp = true;
+    } else {
+        int64_t delta = base_time_us - _last_timestamp_us;
+        // Detect and compensate for wrap-arounds in base time.
+        if (llabs(delta - kBaseTimestampRangeSizeUs) < llabs(delta)) {
+            delta -= kBaseTimestampRangeSizeUs; // Wrap backwards.
+        } else if (llabs(delta + kBaseTimestampRangeSizeUs) < llabs(delta)) {
+            delta += kBaseTimestampRangeSizeUs; // Wrap forwards.
+        }
+        _current_offset_ms += delta / 1000;
+    }
+    _last_timestamp_us = base_time_us;
+}
+
+void TransportFeedbackAdapter::BeginFeedback(size_t num_packets) {
+    // 只在反馈覆盖的包数超过以往时扩容
+    if (_packet_results.size() < num_packets)
+        _packet_results.resize(num_packets);
+    _num_results = 0;
+}
+
+TransportFeedbackAdapter::RtpSequenceMap* TransportFeedbackAdapter::FindRtpSequenceMap(
+        uint32_t ssrc) {
+    for (RtpSequenceMap& map : _rtp_sequence_maps) {
+        if (map.ssrc == ssrc)
+            return &map;
+    }
+    return nullptr;
+}
+
+void TransportFeedbackAdapter::AddLostPacket(uint16_t sequence_number, EcnMarking ecn) {
+    PacketFeedback packet(PacketFeedback::kNotReceived, sequence_number);
+    // Note: Element not removed from history because it might be reported
+    // as received by another feedback.
+    if (!_send_time_history.GetFeedback(&packet, false)) {
+        ++_failed_lookups;
+        return;
+    }
+    PacketResult& result = _packet_results[_num_results++];
+    result.send_time_ms = packet.send_time_ms;
+    result.receive_time_ms = -1;
+    result.payload_size = static_cast<uint32_t>(packet.payload_size);
+    result.sequence_number = sequence_number;
+    result.probe_cluster_id = static_cast<int16_t>(packet.probe_cluster_id);
+    result.ecn = ecn;
+}
+
+void TransportFeedbackAdapter::RemoveReceivedPacket(uint16_t sequence_number) {
+    PacketFeedback packet(PacketFeedback::kNotReceived, sequence_number);
+    if (!_send_time_history.GetFeedback(&packet, true))
+        ++_failed_lookups;
+}
+
+void TransportFeedbackAdapter::AddReceivedPacket(uint16_t sequence_number,
+        int64_t arrival_time_ms, EcnMarking ecn) {
+    PacketFeedback packet(arrival_time_ms, sequence_number);
+    if (!_send_time_history.GetFeedback(&packet, true)) {
+        ++_failed_lookups;
+        return;
+    }
+    PacketResult& result = _packet_results[_num_results++];
+    result.send_time_ms = packet.send_time_ms;
+    result.receive_time_ms = arrival_time_ms;
+    result.payload_size = static_cast<uint32_t>(packet.payload_size);
+    result.sequence_number = sequence_number;
+    result.probe_cluster_id = static_cast<int16_t>(packet.probe_cluster_id);
+    result.ecn = ecn;
+}
+
+} // namespace webrtc
@@ -0,0 +1,116 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file transport_feedback_adapter.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _TRANSPORT_FEEDBACK_ADAPTER_H
+#define _TRANSPORT_FEEDBACK_ADAPTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "congestion_control_feedback.h"
+#include "send_time_history.h"
+#include "transport_feedback.h"
+
+namespace webrtc {
+
+// 反馈中一个包的结果, 按transport sequence number顺序连续存放, 交给InterArrival、
+// AcknowledgedBitrateEstimator和ProbeBitrateEstimator使用。
+// transport-cc和RFC 8888两种反馈都转换成这个格式。
+struct PacketResult {
+    int64_t send_time_ms;
+    // -1 if the packet was lost.
+    int64_t receive_time_ms;
+    uint32_t payload_size;
+    uint16_t sequence_number;
+    // PacketFeedback::kNotAProbe if not a probe.
+    int16_t probe_cluster_id;
+    // transport-cc不携带ECN, 总是kNotEct
+    EcnMarking ecn;
+};
+
+// 发送端: 记录发出的包, 收到反馈后按序号在SendTimeHistory中找回发送时间和大小,
+// 输出PacketResult数组。输出数组复用, 稳定运行时处理反馈不分配内存。
+//
+// Note: This class is not thread-safe.
+class TransportFeedbackAdapter {
+public:
+    static constexpr int64_t kSendTimeHistoryWindowMs = 60000;
+
+    TransportFeedbackAdapter();
+    ~TransportFeedbackAdapter();
+
+    void AddPacket(uint16_t sequence_number, size_t payload_size, int probe_cluster_id,
+            int64_t creation_time_ms);
+    // 同时记录RTP的SSRC和序号, 用于处理按RTP序号反馈的RFC 8888报告
+    void AddPacket(uint32_t ssrc, uint16_t rtp_sequence_number, uint16_t sequence_number,
+            size_t payload_size, int probe_cluster_id, int64_t creation_time_ms);
+    bool OnSentPacket(uint16_t sequence_number, int64_t send_time_ms);
+
+    // 处理一个反馈包, 返回结果的个数, 结果通过packet_results()取出, 在下一次调用前有效。
+    // 丢失的包(在最后一个收到的包之前)也包括在内, receive_time_ms为-1;
+    // 历史中找不到的包不输出。
+    size_t OnTransportFeedback(const rtcp::TransportFeedback& feedback, int64_t now_ms);
+    // Same as above, reading the packet without materializing it.
+    size_t OnTransportFeedback(const rtcp::TransportFeedbackView& feedback, int64_t now_ms);
+    // RFC 8888报告: 按SSRC和RTP序号找到transport sequence number, 输出同样的
+    // PacketResult数组, 多个SSRC的结果合并后按transport sequence number排序。
+    // 收到了但没有到达时间的包只从历史中删除, 不输出。
+    size_t OnCongestionControlFeedback(const rtcp::CongestionControlFeedback& feedback,
+            int64_t now_ms);
+
+    const PacketResult* packet_results() const { return _packet_results.data(); }
+    // 累计在历史中找不到的包的个数
+    size_t failed_lookups() const { return _failed_lookups; }
+
+private:
+    // 一个SSRC的RTP序号到transport sequence number的映射, 按RTP序号索引的环
+    struct RtpSequenceMap {
+        struct Entry {
+            int32_t rtp_sequence_number; // -1 if the slot is empty.
+            uint16_t sequence_number;
+        };
+        uint32_t ssrc;
+        std::vector<Entry> entries;
+    };
+    static constexpr size_t kRtpSequenceMapSize = 1 << 13;
+
+    void UpdateTimeOffset(int64_t base_time_us, int64_t now_ms);
+    void BeginFeedback(size_t num_packets);
+    RtpSequenceMap* FindRtpSequenceMap(uint32_t ssrc);
+    void AddLostPacket(uint16_t sequence_number, EcnMarking ecn);
+    void AddReceivedPacket(uint16_t sequence_number, int64_t arrival_time_ms, EcnMarking ecn);
+    // 收到的包没有到达时间时只从历史中删除, 不输出结果
+    void RemoveReceivedPacket(uint16_t sequence_number);
+
+    SendTimeHistory _send_time_history;
+    // Add timestamp deltas to a local time base selected on first packet arrival.
+    bool _has_last_timestamp;
+    int64_t _last_timestamp_us;
+    int64_t _current_offset_ms;
+    // RFC 8888 report timestamp(16.16秒)unwrap后的值, 第一个报告对应本地的
+    // _report_time_base_us
+    bool _has_last_report_timestamp;
+    uint32_t _last_report_timestamp_compact_ntp;
+    int64_t _report_timestamp_unwrapped;
+    int64_t _report_time_base_us;
+    std::vector<RtpSequenceMap> _rtp_sequence_maps;
+
+    std::vector<PacketResult> _packet_results;
+    size_t _num_results;
+    size_t _failed_lookups;
+};
+
+} // namespace webrtc
+
+#endif // _TRANSPORT_FEEDBACK_ADAPTER_H
+
+
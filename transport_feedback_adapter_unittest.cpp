@@ -0,0 +1,453 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file transport_feedback_adapter_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ transport_feedback_adapter_unittest.cpp transport_feedback_adapter.cpp congestion_control_feedback.cpp send_time_history.cpp transport_feedback.cpp rtpfb.cpp rtcp_packet.cpp common_header.cpp random.cpp -std=c++11 -O2
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <vector>
+using namespace std;
+
+#include "random.h"
+#include "transport_feedback_adapter.h"
+
+namespace webrtc {
+
+constexpr int64_t kDefaultHistoryLengthMs = 1000;
+
+// 原来基于std::map的实现, 作为对照。
+// 查找时和SendTimeHistory一样按与最新序号的差值unwrap, 基准只比较数据结构本身
+class MapSendTimeHistory {
+public:
+    explicit MapSendTimeHistory(int64_t packet_age_limit_ms)
+        : _packet_age_limit_ms(packet_age_limit_ms) {}
+
+    void AddAndRemoveOld(const PacketFeedback& packet) {
+        while (!_history.empty() && packet.creation_time_ms -
+                _history.begin()->second.creation_time_ms > _packet_age_limit_ms) {
+            _history.erase(_history.begin());
+        }
+        int64_t unwrapped_seq_num = _seq_num_unwrapper.Unwrap(packet.sequence_number);
+        PacketFeedback packet_copy = packet;
+        packet_copy.long_sequence_number = unwrapped_seq_num;
+        _history.insert(std::make_pair(unwrapped_seq_num, packet_copy));
+    }
+
+    bool OnSentPacket(uint16_t sequence_number, int64_t send_time_ms) {
+        auto it = Find(sequence_number);
+        if (it == _history.end())
+            return false;
+        it->second.send_time_ms = send_time_ms;
+        return true;
+    }
+
+    bool GetFeedback(PacketFeedback* packet_feedback, bool remove) {
+        auto it = Find(packet_feedback->sequence_number);
+        if (it == _history.end())
+            return false;
+        int64_t arrival_time_ms = packet_feedback->arrival_time_ms;
+        *packet_feedback = it->second;
+        packet_feedback->arrival_time_ms = arrival_time_ms;
+        if (remove)
+            _history.erase(it);
+        return true;
+    }
+
+    size_t size() const { return _history.size(); }
+
+private:
+    std::map<int64_t, PacketFeedback>::iterator Find(uint16_t sequence_number) {
+        if (_history.empty())
+            return _history.end();
+        int64_t newest_seq = _history.rbegin()->first;
+        return _history.find(newest_seq +
+                static_cast<int16_t>(sequence_number - static_cast<uint16_t>(newest_seq)));
+    }
+
+    const int64_t _packet_age_limit_ms;
+    SequenceNumberUnwrapper _seq_num_unwrapper;
+    std::map<int64_t, PacketFeedback> _history;
+};
+
+static PacketFeedback MakePacket(uint16_t sequence_number, int64_t creation_time_ms,
+        size_t payload_size, int probe_cluster_id) {
+    PacketFeedback packet(PacketFeedback::kNotReceived, sequence_number);
+    packet.creation_time_ms = creation_time_ms;
+    packet.payload_size = payload_size;
+    packet.probe_cluster_id = probe_cluster_id;
+    return packet;
+}
+
+// AddRemoveOne / PopulatesExpectedFields / AddThenRemoveOutOfOrder
+// 加入的包可以按任意顺序取出, 取出后删除; 各字段原样返回
+void TestSendTimeHistory01() {
+    SendTimeHistory history(kDefaultHistoryLengthMs);
+    const uint16_t kSeqNo = 10;
+    history.AddAndRemoveOld(MakePacket(kSeqNo, 0, 1200, 3));
+    assert(history.OnSentPacket(kSeqNo, 1));
+    assert(!history.OnSentPacket(kSeqNo + 1, 1));
+
+    PacketFeedback received(123, kSeqNo);
+    assert(history.GetFeedback(&received, false));
+    assert(received.arrival_time_ms == 123);
+    assert(received.creation_time_ms == 0);
+    assert(received.send_time_ms == 1);
+    assert(received.payload_size == 1200);
+    assert(received.probe_cluster_id == 3);
+    assert(history.GetFeedback(&received, true));
+    assert(!history.GetFeedback(&received, true));
+    assert(history.size() == 0);
+
+    // 乱序取出
+    const uint16_t kSeqNums[] = {20, 21, 22, 23, 24};
+    for (size_t i = 0; i < 5; ++i) {
+        history.AddAndRemoveOld(MakePacket(kSeqNums[i], 10 + i, 100 + i, PacketFeedback::kNotAProbe));
+        history.OnSentPacket(kSeqNums[i], 20 + i);
+    }
+    const size_t kOrder[] = {3, 0, 4, 2, 1};
+    for (size_t i : kOrder) {
+        PacketFeedback packet(0, kSeqNums[i]);
+        assert(history.GetFeedback(&packet, true));
+        assert(packet.send_time_ms == static_cast<int64_t>(20 + i));
+        assert(packet.payload_size == 100 + i);
+        assert(packet.long_sequence_number == kSeqNums[i]);
+    }
+    assert(history.size() == 0);
+}
+
+// HistorySize / HistorySizeWithWraparound / RingCapacity
+// 超过packet_age_limit_ms的包被剔除, 序号回绕不影响剔除; 超出环容量时剔除最旧的包
+void TestSendTimeHistory02() {
+    SendTimeHistory history(kDefaultHistoryLengthMs);
+    const uint16_t kSeqNo = 0xFFFE;
+    history.AddAndRemoveOld(MakePacket(kSeqNo, 0, 100, PacketFeedback::kNotAProbe));
+    history.AddAndRemoveOld(MakePacket(kSeqNo + 1, kDefaultHistoryLengthMs, 100, PacketFeedback::kNotAProbe));
+    PacketFeedback packet(0, kSeqNo);
+    assert(history.GetFeedback(&packet, false));
+    // 回绕后加入的包把0xFFFE挤出历史
+    history.AddAndRemoveOld(MakePacket(0, kDefaultHistoryLengthMs + 1, 100, PacketFeedback::kNotAProbe));
+    assert(!history.GetFeedback(&packet, false));
+    packet.sequence_number = kSeqNo + 1;
+    assert(history.GetFeedback(&packet, false));
+    packet.sequence_number = 0;
+    assert(history.GetFeedback(&packet, false));
+    assert(packet.long_sequence_number == 0x10000);
+    assert(history.size() == 2);
+
+    SendTimeHistory small(kDefaultHistoryLengthMs, 100);
+    for (uint16_t seq = 0; seq < 200; ++seq)
+        small.AddAndRemoveOld(MakePacket(seq, 0, 100, PacketFeedback::kNotAProbe));
+    // 容量向上取整到128
+    assert(small.size() == 128);
+    packet.sequence_number = 71;
+    assert(!small.GetFeedback(&packet, false));
+    packet.sequence_number = 72;
+    assert(small.GetFeedback(&packet, false));
+    packet.sequence_number = 199;
+    assert(small.GetFeedback(&packet, false));
+}
+
+// RandomOperations
+// 随机的发送/反馈/丢包/乱序, 环形实现和std::map实现的结果完全一致
+void TestSendTimeHistory03() {
+    Random random(0x38);
+    SendTimeHistory history(kDefaultHistoryLengthMs);
+    MapSendTimeHistory reference(kDefaultHistoryLengthMs);
+    uint16_t next_seq = 0xFF00;
+    int64_t now_ms = 0;
+    std::vector<uint16_t> outstanding;
+    for (int i = 0; i < 200000; ++i) {
+        int op = random.Rand(0, 9);
+        if (op < 5) {
+            PacketFeedback packet = MakePacket(next_seq, now_ms, random.Rand(100, 1200),
+                    random.Rand(0, 9) == 0 ? random.Rand(0, 5) : PacketFeedback::kNotAProbe);
+            history.AddAndRemoveOld(packet);
+            reference.AddAndRemoveOld(packet);
+            outstanding.push_back(next_seq++);
+            if (random.Rand(0, 3) == 0)
+                now_ms += random.Rand(0, 20);
+        } else if (op < 7 && !outstanding.empty()) {
+            uint16_t seq = outstanding[random.Rand<uint32_t>() % outstanding.size()];
+            assert(history.OnSentPacket(seq, now_ms) == reference.OnSentPacket(seq, now_ms));
+        } else if (!outstanding.empty()) {
+            // 反馈最近发出的包, 偶尔是很久以前的包
+            size_t back = random.Rand(0, 3) == 0 ? random.Rand<uint32_t>() % outstanding.size() :
+                random.Rand<uint32_t>() % std::min<size_t>(outstanding.size(), 64);
+            uint16_t seq = outstanding[outstanding.size() - 1 - back];
+            bool remove = random.Rand(0, 1) == 0;
+            PacketFeedback a(now_ms, seq);
+            PacketFeedback b(now_ms, seq);
+            bool found = history.GetFeedback(&a, remove);
+            assert(found == reference.GetFeedback(&b, remove));
+            if (found) {
+                assert(a.arrival_time_ms == b.arrival_time_ms);
+                assert(a.creation_time_ms == b.creation_time_ms);
+                assert(a.send_time_ms == b.send_time_ms);
+                assert(a.long_sequence_number == b.long_sequence_number);
+                assert(a.payload_size == b.payload_size);
+                assert(a.probe_cluster_id == b.probe_cluster_id);
+            }
+        }
+        if (outstanding.size() > 20000)
+            outstanding.erase(outstanding.begin(), outstanding.begin() + 10000);
+        assert(history.size() == reference.size());
+    }
+}
+
+// 按seqs/arrival_times_ms(-1表示丢失)构造反馈包并序列化
+static std::vector<uint8_t> BuildFeedback(const std::vector<uint16_t>& seqs,
+        const std::vector<int64_t>& arrival_times_ms) {
+    rtcp::TransportFeedback feedback;
+    bool base_set = false;
+    for (size_t i = 0; i < seqs.size(); ++i) {
+        if (arrival_times_ms[i] < 0)
+            continue;
+        if (!base_set) {
+            feedback.SetBase(seqs[0], arrival_times_ms[i] * 1000);
+            base_set = true;
+        }
+        bool added = feedback.AddReceivedPacket(seqs[i], arrival_times_ms[i] * 1000);
+        assert(added);
+    }
+    return feedback.Build();
+}
+
+// AdaptsFeedbackAndPopulatesSendTimes / HandlesMissingPackets / ViewMatchesParsed
+// 反馈中的包按序号输出发送时间、到达时间和大小, 丢失的包receive_time_ms为-1;
+// 解析成TransportFeedback和直接读TransportFeedbackView得到的结果相同
+void TestTransportFeedbackAdapter01() {
+    const int64_t kNowMs = 1000;
+    std::vector<uint16_t> seqs = {0xFFFE, 0xFFFF, 0, 1, 2, 3};
+    std::vector<int64_t> arrival_times_ms = {640, -1, 700, -1, 710, 720};
+
+    TransportFeedbackAdapter parsed_adapter;
+    TransportFeedbackAdapter view_adapter;
+    for (size_t i = 0; i < seqs.size(); ++i) {
+        int probe_cluster_id = i == 2 ? 1 : PacketFeedback::kNotAProbe;
+        parsed_adapter.AddPacket(seqs[i], 1000 + i, probe_cluster_id, 10 + i);
+        view_adapter.AddPacket(seqs[i], 1000 + i, probe_cluster_id, 10 + i);
+        parsed_adapter.OnSentPacket(seqs[i], 20 + i);
+        view_adapter.OnSentPacket(seqs[i], 20 + i);
+    }
+
+    std::vector<uint8_t> buffer = BuildFeedback(seqs, arrival_times_ms);
+    std::unique_ptr<rtcp::TransportFeedback> feedback =
+        rtcp::TransportFeedback::ParseFrom(buffer.data(), buffer.size());
+    assert(feedback);
+    rtcp::TransportFeedbackView view;
+    assert(view.Parse(buffer.data(), buffer.size()));
+
+    size_t num_parsed = parsed_adapter.OnTransportFeedback(*feedback, kNowMs);
+    size_t num_view = view_adapter.OnTransportFeedback(view, kNowMs);
+    assert(num_parsed == seqs.size());
+    assert(num_view == seqs.size());
+    // 第一个反馈的base time(第一个收到的包, 64ms的整数倍)对应本地的kNowMs
+    for (size_t i = 0; i < seqs.size(); ++i) {
+        const PacketResult& a = parsed_adapter.packet_results()[i];
+        const PacketResult& b = view_adapter.packet_results()[i];
+        assert(a.sequence_number == seqs[i]);
+        assert(a.send_time_ms == static_cast<int64_t>(20 + i));
+        assert(a.payload_size == 1000 + i);
+        assert(a.probe_cluster_id == (i == 2 ? 1 : PacketFeedback::kNotAProbe));
+        assert(a.receive_time_ms ==
+                (arrival_times_ms[i] < 0 ? -1 : kNowMs + arrival_times_ms[i] - arrival_times_ms[0]));
+        assert(a.send_time_ms == b.send_time_ms && a.receive_time_ms == b.receive_time_ms &&
+                a.payload_size == b.payload_size && a.sequence_number == b.sequence_number &&
+                a.probe_cluster_id == b.probe_cluster_id);
+    }
+
+    // 收到的包已经从历史中删除, 再次反馈找不到; 丢失的包仍然保留
+    assert(parsed_adapter.OnTransportFeedback(*feedback, kNowMs) == 2);
+    assert(parsed_adapter.failed_lookups() == 4);
+    assert(parsed_adapter.packet_results()[0].sequence_number == 0xFFFF);
+    assert(parsed_adapter.packet_results()[1].sequence_number == 1);
+}
+
+// TimestampDeltas / BaseTimeWrap
+// 连续的反馈按base time的差累加本地时间, base time回绕时补偿
+void TestTransportFeedbackAdapter02() {
+    const int64_t kBaseTimeRangeMs = (int64_t{1} << 24) * 64;
+    TransportFeedbackAdapter adapter;
+    for (uint16_t seq = 0; seq < 3; ++seq) {
+        adapter.AddPacket(seq, 100, PacketFeedback::kNotAProbe, seq);
+        adapter.OnSentPacket(seq, seq);
+    }
+
+    // 接收端时钟刚好在base time回绕之前
+    const int64_t kFirstArrivalMs = kBaseTimeRangeMs - 64;
+    std::vector<uint8_t> first = BuildFeedback({0}, {kFirstArrivalMs});
+    std::vector<uint8_t> second = BuildFeedback({1}, {kFirstArrivalMs + 64});
+    std::vector<uint8_t> third = BuildFeedback({2}, {kFirstArrivalMs + 128});
+    rtcp::TransportFeedbackView view;
+    assert(view.Parse(first.data(), first.size()));
+    assert(adapter.OnTransportFeedback(view, 5000) == 1);
+    assert(adapter.packet_results()[0].receive_time_ms == 5000);
+    assert(view.Parse(second.data(), second.size()));
+    assert(adapter.OnTransportFeedback(view, 9999) == 1);
+    assert(adapter.packet_results()[0].receive_time_ms == 5064);
+    assert(view.Parse(third.data(), third.size()));
+    assert(adapter.OnTransportFeedback(view, 9999) == 1);
+    assert(adapter.packet_results()[0].receive_time_ms == 5128);
+}
+
+// 发送端的一次仿真: |num_streams|个流各10k packets/s, 每100ms一个反馈, 1%丢包。
+// 反馈包预先生成, 计时只包括发送历史的记录和反馈的查找
+struct StreamWorkload {
+    std::vector<uint16_t> seqs;
+    std::vector<int64_t> send_times_ms;
+    std::vector<std::vector<uint8_t>> feedbacks;
+    // 每个反馈覆盖的最后一个包的下标(不含)
+    std::vector<size_t> feedback_end;
+};
+
+static StreamWorkload MakeWorkload(int64_t duration_ms, Random* random) {
+    const int kPacketsPerMs = 10;
+    const int64_t kFeedbackIntervalMs = 100;
+    const int64_t kOneWayDelayMs = 30;
+    StreamWorkload workload;
+    uint16_t seq = static_cast<uint16_t>(random->Rand<uint32_t>());
+    std::vector<uint16_t> feedback_seqs;
+    std::vector<int64_t> feedback_arrivals;
+    for (int64_t now_ms = 0; now_ms < duration_ms; ++now_ms) {
+        for (int i = 0; i < kPacketsPerMs; ++i) {
+            workload.seqs.push_back(seq);
+            workload.send_times_ms.push_back(now_ms);
+            feedback_seqs.push_back(seq++);
+            feedback_arrivals.push_back(random->Rand(0, 99) == 0 ? -1 : now_ms + kOneWayDelayMs);
+        }
+        if ((now_ms + 1) % kFeedbackIntervalMs == 0) {
+            workload.feedbacks.push_back(BuildFeedback(feedback_seqs, feedback_arrivals));
+            workload.feedback_end.push_back(workload.seqs.size());
+            feedback_seqs.clear();
+            feedback_arrivals.clear();
+        }
+    }
+    return workload;
+}
+
+template <typename History>
+static int64_t RunHistory(const std::vector<StreamWorkload>& workloads, int64_t* checksum) {
+    std::vector<History> histories(workloads.size(), History(TransportFeedbackAdapter::kSendTimeHistoryWindowMs));
+    std::vector<size_t> next_packet(workloads.size(), 0);
+    rtcp::TransportFeedbackView view;
+    auto start = std::chrono::steady_clock::now();
+    const size_t num_feedbacks = workloads[0].feedbacks.size();
+    for (size_t f = 0; f < num_feedbacks; ++f) {
+        // 每个流发出一个反馈间隔的包, 然后处理上一个间隔的反馈
+        for (size_t s = 0; s < workloads.size(); ++s) {
+            const StreamWorkload& workload = workloads[s];
+            for (size_t& i = next_packet[s]; i < workload.feedback_end[f]; ++i) {
+                PacketFeedback packet = MakePacket(workload.seqs[i], workload.send_times_ms[i],
+                        1200, PacketFeedback::kNotAProbe);
+                histories[s].AddAndRemoveOld(packet);
+                histories[s].OnSentPacket(workload.seqs[i], workload.send_times_ms[i]);
+            }
+            if (f == 0)
+                continue;
+            const std::vector<uint8_t>& buffer = workload.feedbacks[f - 1];
+            view.Parse(buffer.data(), buffer.size());
+            rtcp::TransportFeedbackView::Iterator it = view.begin();
+            uint16_t seq;
+            int16_t delta_ticks;
+            while (it.Next(&seq, &delta_ticks)) {
+                PacketFeedback packet(delta_ticks, seq);
+                if (histories[s].GetFeedback(&packet, true))
+                    *checksum += packet.send_time_ms;
+            }
+        }
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+static int64_t RunAdapter(const std::vector<StreamWorkload>& workloads, bool use_view,
+        int64_t* checksum) {
+    std::vector<TransportFeedbackAdapter> adapters(workloads.size());
+    std::vector<size_t> next_packet(workloads.size(), 0);
+    rtcp::TransportFeedbackView view;
+    auto start = std::chrono::steady_clock::now();
+    const size_t num_feedbacks = workloads[0].feedbacks.size();
+    for (size_t f = 0; f < num_feedbacks; ++f) {
+        for (size_t s = 0; s < workloads.size(); ++s) {
+            const StreamWorkload& workload = workloads[s];
+            for (size_t& i = next_packet[s]; i < workload.feedback_end[f]; ++i) {
+                adapters[s].AddPacket(workload.seqs[i], 1200, PacketFeedback::kNotAProbe,
+                        workload.send_times_ms[i]);
+                adapters[s].OnSentPacket(workload.seqs[i], workload.send_times_ms[i]);
+            }
+            if (f == 0)
+                continue;
+            const std::vector<uint8_t>& buffer = workload.feedbacks[f - 1];
+            size_t num_results;
+            if (use_view) {
+                view.Parse(buffer.data(), buffer.size());
+                num_results = adapters[s].OnTransportFeedback(view, workload.send_times_ms[0]);
+            } else {
+                std::unique_ptr<rtcp::TransportFeedback> feedback =
+                    rtcp::TransportFeedback::ParseFrom(buffer.data(), buffer.size());
+                num_results = adapters[s].OnTransportFeedback(*feedback, workload.send_times_ms[0]);
+            }
+            const PacketResult* results = adapters[s].packet_results();
+            for (size_t i = 0; i < num_results; ++i) {
+                if (results[i].receive_time_ms >= 0)
+                    *checksum += results[i].send_time_ms;
+            }
+        }
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+// Benchmark
+// 每个流10k packets/s, 仿真10s: 比较环形历史和std::map的查找, 以及完整的反馈处理
+void TestTransportFeedbackAdapter03() {
+    const int64_t kDurationMs = 10000;
+    const size_t kNumStreams[] = {1, 16};
+    Random random(0x138);
+    for (size_t num_streams : kNumStreams) {
+        std::vector<StreamWorkload> workloads;
+        for (size_t s = 0; s < num_streams; ++s)
+            workloads.push_back(MakeWorkload(kDurationMs, &random));
+        const double num_packets = static_cast<double>(workloads[0].seqs.size() * num_streams);
+
+        int64_t ring_checksum = 0;
+        int64_t map_checksum = 0;
+        int64_t parsed_checksum = 0;
+        int64_t view_checksum = 0;
+        int64_t ring_ns, map_ns, parsed_ns, view_ns;
+        map_ns = RunHistory<MapSendTimeHistory>(workloads, &map_checksum);
+        ring_ns = RunHistory<SendTimeHistory>(workloads, &ring_checksum);
+        parsed_ns = RunAdapter(workloads, false, &parsed_checksum);
+        view_ns = RunAdapter(workloads, true, &view_checksum);
+        assert(ring_checksum == map_checksum);
+        assert(parsed_checksum == ring_checksum);
+        assert(view_checksum == ring_checksum);
+
+        cout << "streams=" << num_streams << " @10k packets/s"
+            << " history: map=" << map_ns / num_packets << "ns/packet"
+            << " ring=" << ring_ns / num_packets << "ns/packet"
+            << " | adapter: parsed=" << parsed_ns / num_packets << "ns/packet"
+            << " view=" << view_ns / num_packets << "ns/packet" << endl;
+    }
+}
+
+} // namespace webrtc
+
+int main() {
+    webrtc::TestSendTimeHistory01();
+    webrtc::TestSendTimeHistory02();
+    webrtc::TestSendTimeHistory03();
+    webrtc::TestTransportFeedbackAdapter01();
+    webrtc::TestTransportFeedbackAdapter02();
+    webrtc::TestTransportFeedbackAdapter03();
+
+    return 0;
+}
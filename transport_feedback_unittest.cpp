@@ -7,52 +7,409 @@
 * @brief 
 *****************************************************************/
 
-#include <memory>
+// g++ transport_feedback_unittest.cpp transport_feedback.cpp rtpfb.cpp rtcp_packet.cpp common_header.cpp random.cpp -std=c++11
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
 #include <limits>
+#include <memory>
+#include <vector>
+using namespace std;
 
-#include "zybrtc/modules/rtp_rtcp/rtcp_packet/transport_feedback.h"
+#include "random.h"
+#include "transport_feedback.h"
 
-using namespace zybrtc;
+using namespace webrtc;
 using namespace rtcp;
 
-/*
-g++ transport_feedback_unittest.cpp -std=c++11 -I/home/yujitai/dev/zrtc/voip/libzybrtc/output/include -I/home/yujitai/dev/zrtc/voip/libzybrtc/output/include/zybrtc -I/home/yujitai/dev/zrtc/voip/librtcbase/output/include -L/home/yujitai/dev/zrtc/voip/libzybrtc/output/include /home/yujitai/dev/zrtc/voip/libzybrtc/output/lib/libzybrtc.a /home/yujitai/dev/zrtc/voip/librtcbase/output/lib/librtcbase.a -lpthread -lrt -g
-*/
+typedef std::vector<std::pair<uint16_t, int16_t>> PacketList;
+
+static PacketList ReceivedPackets(const TransportFeedback& feedback) {
+    PacketList packets;
+    for (const auto& packet : feedback.GetReceivedPackets())
+        packets.emplace_back(packet.sequence_number(), packet.delta_ticks());
+    return packets;
+}
+
+static PacketList ViewPackets(const TransportFeedbackView& view) {
+    PacketList packets;
+    TransportFeedbackView::Iterator it = view.begin();
+    uint16_t seq;
+    int16_t delta_ticks;
+    while (it.Next(&seq, &delta_ticks))
+        packets.emplace_back(seq, delta_ticks);
+    return packets;
+}
 
 // TransportFeedback_Limits
 void TestTransportFeedback01() {
     // Sequence number wrap above 0x8000.
     std::unique_ptr<TransportFeedback> packet(new TransportFeedback());
-    packet->set_base(0, 0);
-    cout << packet->add_received_packet(0x0, 0) << endl;
-    cout << packet->add_received_packet(0x8000, 1000) << endl;
+    packet->SetBase(0, 0);
+    assert(packet->AddReceivedPacket(0x0, 0));
+    assert(packet->AddReceivedPacket(0x8000, 1000));
 
     packet.reset(new TransportFeedback());
-    packet->set_base(0, 0);
-    cout << packet->add_received_packet(0x0, 0) << endl;
+    packet->SetBase(0, 0);
+    assert(packet->AddReceivedPacket(0x0, 0));
     // 保证添加的包是最新的包
-    cout << packet->add_received_packet(0x8000+1, 1000) << endl;
+    assert(!packet->AddReceivedPacket(0x8000 + 1, 1000));
 
-    // packet status count 最大 65535?
+    // packet status count 最大 65535
     // Packet status count max 0xFFFF.
     packet.reset(new TransportFeedback());
-    packet->set_base(0, 0);
-    cout << packet->add_received_packet(0x0, 0) << endl;
-    cout << packet->add_received_packet(0x8000, 1000) << endl;
-    cout << packet->add_received_packet(0xFFFE, 2000) << endl;
-    cout << packet->add_received_packet(0xFFFF, 3000) << endl;
+    packet->SetBase(0, 0);
+    assert(packet->AddReceivedPacket(0x0, 0));
+    assert(packet->AddReceivedPacket(0x8000, 1000));
+    assert(packet->AddReceivedPacket(0xFFFE, 2000));
+    assert(!packet->AddReceivedPacket(0xFFFF, 3000));
 
     // Too large delta.
     packet.reset(new TransportFeedback());
-    packet->set_base(0, 0);
+    packet->SetBase(0, 0);
     // recv delta 最大为 16bits signed*250us [-8192.0, 8191.75]ms
-    int64_t kMaxPositiveTimeDelta = std::numeric_limits<int16_t>::max() * TransportFeedback::k_delta_scale_factor;
-    cout << packet->add_received_packet(1, kMaxPositiveTimeDelta+TransportFeedback::k_delta_scale_factor) << endl;
-    cout << packet->add_received_packet(1, kMaxPositiveTimeDelta) << endl;
+    int64_t kMaxPositiveTimeDelta = std::numeric_limits<int16_t>::max() *
+        TransportFeedback::kDeltaScaleFactor;
+    assert(!packet->AddReceivedPacket(1, kMaxPositiveTimeDelta + TransportFeedback::kDeltaScaleFactor));
+    assert(packet->AddReceivedPacket(1, kMaxPositiveTimeDelta));
+
+    // Too large negative delta.
+    packet.reset(new TransportFeedback());
+    packet->SetBase(0, 0);
+    int64_t kMaxNegativeTimeDelta = std::numeric_limits<int16_t>::min() *
+        TransportFeedback::kDeltaScaleFactor;
+    assert(!packet->AddReceivedPacket(1, kMaxNegativeTimeDelta - TransportFeedback::kDeltaScaleFactor));
+    assert(packet->AddReceivedPacket(1, kMaxNegativeTimeDelta));
+}
+
+// MixedChunks
+// 丢包游程 + 1字节delta + 2字节delta(乱序到达): 两种解析结果一致, 长度和padding正确
+void TestTransportFeedback02() {
+    TransportFeedback feedback;
+    feedback.SetSenderSsrc(0x11223344);
+    feedback.SetMediaSsrc(0x55667788);
+    feedback.SetBase(100, 64000 * 3);
+    feedback.SetFeedbackSequenceNumber(7);
+    assert(feedback.AddReceivedPacket(100, 64000 * 3));
+    assert(feedback.AddReceivedPacket(101, 64000 * 3 + 1000));
+    // 102~199丢失, 200乱序到达(负delta)
+    assert(feedback.AddReceivedPacket(200, 64000 * 3 - 1000));
+    assert(feedback.AddReceivedPacket(201, 64000 * 3 + 70000));
+
+    // 20字节头 + 3个chunk(1bit, 丢包run length, 2字节run length) + 1+1+2+2字节delta = 32
+    std::vector<uint8_t> buffer = feedback.Build();
+    assert(buffer.size() == 32);
+    assert(feedback.PaddingLength() == 0);
+
+    std::unique_ptr<TransportFeedback> parsed =
+        TransportFeedback::ParseFrom(buffer.data(), buffer.size());
+    assert(parsed);
+    assert(parsed->sender_ssrc() == 0x11223344);
+    assert(parsed->media_ssrc() == 0x55667788);
+    assert(parsed->GetBaseSequence() == 100);
+    assert(parsed->GetPacketStatusCount() == 102);
+    assert(parsed->GetFeedbackSequenceNumber() == 7);
+    assert(parsed->GetBaseTimeUs() == 64000 * 3);
+    assert(ReceivedPackets(*parsed) == ReceivedPackets(feedback));
+
+    TransportFeedbackView view;
+    assert(view.Parse(buffer.data(), buffer.size()));
+    assert(view.sender_ssrc() == 0x11223344);
+    assert(view.media_ssrc() == 0x55667788);
+    assert(view.base_sequence() == 100);
+    assert(view.packet_status_count() == 102);
+    assert(view.feedback_sequence() == 7);
+    assert(view.base_time_us() == 64000 * 3);
+    assert(view.num_received() == 4);
+    assert(ViewPackets(view) == ReceivedPackets(feedback));
+
+    // 20字节头 + 1个chunk + 3字节delta, 需要3字节padding
+    TransportFeedback padded;
+    padded.SetBase(0, 0);
+    assert(padded.AddReceivedPacket(0, 0));
+    assert(padded.AddReceivedPacket(1, 1000));
+    assert(padded.AddReceivedPacket(2, 2000));
+    assert(padded.PaddingLength() == 3);
+    buffer = padded.Build();
+    assert(buffer.size() == 28);
+    assert(buffer[0] & 0x20);
+    assert(view.Parse(buffer.data(), buffer.size()));
+    assert(ViewPackets(view) == ReceivedPackets(padded));
+}
+
+// 随机生成一个反馈包: 以1字节delta为主, 夹杂零散丢包/长丢包游程/乱序和大间隔,
+// 直到包满或者随机到的delta超出16位。
+static void RandomFeedback(Random* random, TransportFeedback* feedback) {
+    uint16_t seq = random->Rand<uint16_t>();
+    int64_t now_us = random->Rand(0, 1 << 30) * int64_t{1000};
+    feedback->SetSenderSsrc(random->Rand<uint32_t>());
+    feedback->SetMediaSsrc(random->Rand<uint32_t>());
+    feedback->SetBase(seq, now_us);
+    feedback->SetFeedbackSequenceNumber(random->Rand<uint8_t>());
+    // 空的反馈包不能序列化, 第一个包总是能加进去
+    bool added = feedback->AddReceivedPacket(seq++, now_us);
+    assert(added);
+    (void)added;
+
+    int num_packets = random->Rand(1, 10) == 1 ? random->Rand(1, 20000) : random->Rand(1, 300);
+    for (int i = 0; i < num_packets; ++i) {
+        int r = random->Rand(0, 99);
+        if (r < 70) {
+            now_us += random->Rand(0, 20000);
+        } else if (r < 90) {
+            now_us += random->Rand(0, 100000);
+        } else if (r < 98) {
+            now_us -= random->Rand(0, 5000000);
+        } else {
+            now_us += random->Rand(0, 9000000);
+        }
+        if (!feedback->AddReceivedPacket(seq, now_us))
+            break;
+
+        r = random->Rand(0, 99);
+        if (r < 80) {
+            seq += 1;
+        } else if (r < 97) {
+            seq += random->Rand(2, 20);
+        } else {
+            seq += random->Rand(20, 2000);
+        }
+    }
+}
+
+// RoundTripFuzz
+// 随机构造的反馈包序列化后, TransportFeedback::ParseFrom和TransportFeedbackView解析出的
+// (seq, delta)与构造时一致, 再次序列化得到完全相同的字节
+void TestTransportFeedback03() {
+    const int kIterations = 1000;
+    Random random(0x35);
+    size_t total_packets = 0;
+    size_t total_bytes = 0;
+    for (int i = 0; i < kIterations; ++i) {
+        TransportFeedback feedback;
+        RandomFeedback(&random, &feedback);
+        PacketList expected = ReceivedPackets(feedback);
+        std::vector<uint8_t> buffer = feedback.Build();
+        assert(buffer.size() % 4 == 0);
+
+        std::unique_ptr<TransportFeedback> parsed =
+            TransportFeedback::ParseFrom(buffer.data(), buffer.size());
+        assert(parsed);
+        assert(parsed->sender_ssrc() == feedback.sender_ssrc());
+        assert(parsed->media_ssrc() == feedback.media_ssrc());
+        assert(parsed->GetBaseSequence() == feedback.GetBaseSequence());
+        assert(parsed->GetPacketStatusCount() == feedback.GetPacketStatusCount());
+        assert(parsed->GetFeedbackSequenceNumber() == feedback.GetFeedbackSequenceNumber());
+        assert(ReceivedPackets(*parsed) == expected);
+        assert(parsed->Build() == buffer);
+
+        TransportFeedbackView view;
+        assert(view.Parse(buffer.data(), buffer.size()));
+        assert(view.sender_ssrc() == feedback.sender_ssrc());
+        assert(view.media_ssrc() == feedback.media_ssrc());
+        assert(view.base_sequence() == feedback.GetBaseSequence());
+        assert(view.packet_status_count() == feedback.GetPacketStatusCount());
+        assert(view.feedback_sequence() == feedback.GetFeedbackSequenceNumber());
+        assert(view.base_time_us() == parsed->GetBaseTimeUs());
+        assert(view.num_received() == expected.size());
+        assert(ViewPackets(view) == expected);
+
+        total_packets += feedback.GetPacketStatusCount();
+        total_bytes += buffer.size();
+    }
+    cout << "round trip: " << kIterations << " packets, " << total_packets
+        << " sequence numbers, " << total_bytes << " bytes" << endl;
+}
+
+// MutationFuzz
+// 随机改写/截断合法反馈包的字节: 两种解析都不能越界, 且对是否合法及解析结果的判断一致
+void TestTransportFeedback04() {
+    const int kIterations = 5000;
+    Random random(0x3535);
+    int num_valid = 0;
+    for (int i = 0; i < kIterations; ++i) {
+        TransportFeedback feedback;
+        RandomFeedback(&random, &feedback);
+        std::vector<uint8_t> buffer = feedback.Build();
+
+        int num_flips = random.Rand(1, 4);
+        for (int j = 0; j < num_flips; ++j) {
+            // 偏向改写头部和chunk
+            size_t limit = random.Rand(0, 1) ? std::min<size_t>(buffer.size(), 40) : buffer.size();
+            buffer[random.Rand(0, limit - 1)] = random.Rand<uint8_t>();
+        }
+        if (random.Rand(0, 3) == 0)
+            buffer.resize(random.Rand(0, buffer.size()));
+        // 拷贝到恰好大小的堆内存, 越界读可以被AddressSanitizer发现
+        std::unique_ptr<uint8_t[]> exact(new uint8_t[buffer.size()]);
+        std::copy(buffer.begin(), buffer.end(), exact.get());
+
+        std::unique_ptr<TransportFeedback> parsed =
+            TransportFeedback::ParseFrom(exact.get(), buffer.size());
+        TransportFeedbackView view;
+        bool view_ok = view.Parse(exact.get(), buffer.size());
+        assert(view_ok == (parsed != nullptr));
+        if (!view_ok)
+            continue;
+        ++num_valid;
+        assert(view.base_sequence() == parsed->GetBaseSequence());
+        assert(view.packet_status_count() == parsed->GetPacketStatusCount());
+        assert(view.num_received() == parsed->GetReceivedPackets().size());
+        assert(ViewPackets(view) == ReceivedPackets(*parsed));
+    }
+    cout << "mutation: " << num_valid << "/" << kIterations << " mutated packets still valid" << endl;
+}
+
+// 随机的一段到达记录: 每段流的丢包率, 长丢包游程和乱序(2字节delta)的比例都不同,
+// 这样run length / one bit / two bit三种chunk以及它们的各种边界都能覆盖到
+struct Arrivals {
+    uint16_t base_seq;
+    int64_t base_time_us;
+    std::vector<uint16_t> seqs;
+    std::vector<int64_t> times_us;
+};
+
+static void RandomArrivals(Random* random, size_t num_packets, Arrivals* arrivals) {
+    const int loss_percent = random->Rand(0, 3) == 0 ? 0 : random->Rand(0, 40);
+    const int burst_percent = random->Rand(0, 2);
+    const int large_percent = random->Rand(0, 3) == 0 ? 0 : random->Rand(0, 40);
+    uint16_t seq = random->Rand<uint16_t>();
+    int64_t now_us = random->Rand(0, 1 << 30) * int64_t{1000};
+    arrivals->base_seq = seq;
+    arrivals->base_time_us = now_us;
+    arrivals->seqs.clear();
+    arrivals->times_us.clear();
+    for (size_t i = 0; i < num_packets; ++i) {
+        arrivals->seqs.push_back(seq);
+        arrivals->times_us.push_back(now_us);
+        if (random->Rand(0, 99) < large_percent) {
+            now_us += random->Rand(0, 1) ? -random->Rand(0, 100000) : random->Rand(64000, 200000);
+        } else {
+            now_us += random->Rand(0, 10000);
+        }
+        if (random->Rand(0, 999) < 2)
+            now_us += 9000000; // delta超出16位
+        if (random->Rand(0, 99) < burst_percent) {
+            seq += random->Rand(15, 10000);
+        } else if (random->Rand(0, 99) < loss_percent) {
+            seq += random->Rand(2, 4);
+        } else {
+            seq += 1;
+        }
+    }
+}
+
+// BulkMatchesScalar
+// AddReceivedPackets(任意分批, 并与AddReceivedPacket交替调用)得到的反馈包与逐个
+// AddReceivedPacket逐字节一致, 包括中途因delta过大或超过0xFFFF个包而停止的情况
+void TestTransportFeedback05() {
+    const int kIterations = 3000;
+    Random random(0x36);
+    size_t total_bytes = 0;
+    Arrivals arrivals;
+    for (int i = 0; i < kIterations; ++i) {
+        size_t num_packets = random.Rand(0, 20) == 0 ? random.Rand(1, 70000) : random.Rand(1, 500);
+        RandomArrivals(&random, num_packets, &arrivals);
+
+        TransportFeedback scalar;
+        scalar.SetBase(arrivals.base_seq, arrivals.base_time_us);
+        size_t num_scalar = 0;
+        while (num_scalar < num_packets &&
+                scalar.AddReceivedPacket(arrivals.seqs[num_scalar], arrivals.times_us[num_scalar]))
+            ++num_scalar;
+
+        TransportFeedback bulk;
+        bulk.SetBase(arrivals.base_seq, arrivals.base_time_us);
+        size_t num_bulk = 0;
+        while (num_bulk < num_packets) {
+            if (random.Rand(0, 4) == 0) {
+                if (!bulk.AddReceivedPacket(arrivals.seqs[num_bulk], arrivals.times_us[num_bulk]))
+                    break;
+                ++num_bulk;
+                continue;
+            }
+            size_t batch = std::min<size_t>(num_packets - num_bulk, random.Rand(1, 3000));
+            size_t added = bulk.AddReceivedPackets(&arrivals.seqs[num_bulk], &arrivals.times_us[num_bulk], batch);
+            num_bulk += added;
+            if (added < batch)
+                break;
+        }
+
+        assert(num_bulk == num_scalar);
+        assert(bulk.GetPacketStatusCount() == scalar.GetPacketStatusCount());
+        assert(bulk.BlockLength() == scalar.BlockLength());
+        if (num_scalar == 0)
+            continue;
+        std::vector<uint8_t> buffer = scalar.Build();
+        assert(bulk.Build() == buffer);
+        total_bytes += buffer.size();
+    }
+    cout << "bulk matches scalar: " << kIterations << " packets, " << total_bytes << " bytes" << endl;
+}
+
+// BulkEncodingThroughput
+// 每个反馈包100/1000个包, 丢包0%/2%/20%(20%时部分乱序), 比较逐个添加和批量添加
+void TestTransportFeedback06() {
+    const size_t kTotalPackets = 2000000;
+    const size_t kPacketsPerFeedback[] = {100, 1000};
+    const int kLossPercents[] = {0, 2, 20};
+
+    for (size_t per_feedback : kPacketsPerFeedback) {
+        for (int loss_percent : kLossPercents) {
+            Random random(0x3636);
+            std::vector<uint16_t> seqs(per_feedback);
+            std::vector<int64_t> times_us(per_feedback);
+            uint16_t seq = 0;
+            int64_t now_us = 1000000;
+            for (size_t i = 0; i < per_feedback; ++i) {
+                seqs[i] = seq;
+                times_us[i] = now_us;
+                seq += random.Rand(0, 99) < loss_percent ? 2 : 1;
+                now_us += random.Rand(0, 99) < loss_percent / 4 ? -1000 : random.Rand(0, 2000);
+            }
+
+            const size_t num_feedbacks = kTotalPackets / per_feedback;
+            TransportFeedback feedback;
+            size_t checksum = 0;
+            int64_t scalar_ns;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t f = 0; f < num_feedbacks; ++f) {
+                feedback = TransportFeedback();
+                feedback.SetBase(seqs[0], times_us[0]);
+                for (size_t i = 0; i < per_feedback; ++i)
+                    feedback.AddReceivedPacket(seqs[i], times_us[i]);
+                checksum += feedback.BlockLength();
+            }
+            scalar_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+
+            int64_t bulk_ns;
+            start = std::chrono::steady_clock::now();
+            for (size_t f = 0; f < num_feedbacks; ++f) {
+                feedback = TransportFeedback();
+                feedback.SetBase(seqs[0], times_us[0]);
+                feedback.AddReceivedPackets(seqs.data(), times_us.data(), per_feedback);
+                checksum -= feedback.BlockLength();
+            }
+            bulk_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+            assert(checksum == 0);
+
+            cout << "packets/feedback=" << per_feedback << " loss=" << loss_percent << "%"
+                << " scalar=" << static_cast<double>(scalar_ns) / kTotalPackets << "ns/packet"
+                << " bulk=" << static_cast<double>(bulk_ns) / kTotalPackets << "ns/packet" << endl;
+        }
+    }
 }
 
 int main() {
     TestTransportFeedback01();
+    TestTransportFeedback02();
+    TestTransportFeedback03();
+    TestTransportFeedback04();
+    TestTransportFeedback05();
+    TestTransportFeedback06();
 
     return 0;
 }
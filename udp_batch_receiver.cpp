@@ -0,0 +1,173 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file udp_batch_receiver.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#include "udp_batch_receiver.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+namespace webrtc {
+
+namespace {
+
+constexpr size_t kControlSize = CMSG_SPACE(sizeof(struct timespec));
+
+int64_t TimespecToUs(const struct timespec& ts) {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+} // namespace
+
+constexpr size_t UdpBatchReceiver::kMaxBatchSize;
+constexpr size_t UdpBatchReceiver::kMaxPacketSize;
+
+UdpBatchReceiver::UdpBatchReceiver()
+    : _fd(-1),
+    _timeout_ms(-1),
+    _buffer(kMaxBatchSize * kMaxPacketSize),
+    _control(kMaxBatchSize * kControlSize),
+    _iovecs(kMaxBatchSize),
+    _messages(kMaxBatchSize),
+    _num_packets(0) {
+    for (size_t i = 0; i < kMaxBatchSize; ++i) {
+        _iovecs[i].iov_base = &_buffer[i * kMaxPacketSize];
+        _iovecs[i].iov_len = kMaxPacketSize;
+    }
+}
+
+UdpBatchReceiver::~UdpBatchReceiver() {
+    Close();
+}
+
+bool UdpBatchReceiver::Bind(const char* ip, uint16_t port, int receive_buffer_size) {
+    Close();
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip, &addr.sin_addr) != 1) {
+        // RTC_LOG(LS_WARNING) << "Invalid address " << ip;
+        return false;
+    }
+
+    _fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (_fd < 0)
+        return false;
+    const int enable = 1;
+    if (setsockopt(_fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) < 0) {
+        // 没有内核时间戳时用收包时间
+        // RTC_LOG(LS_WARNING) << "SO_TIMESTAMPNS not supported: " << strerror(errno);
+    }
+    if (receive_buffer_size > 0 &&
+            setsockopt(_fd, SOL_SOCKET, SO_RCVBUF, &receive_buffer_size, sizeof(receive_buffer_size)) < 0) {
+        // RTC_LOG(LS_WARNING) << "Failed to set SO_RCVBUF: " << strerror(errno);
+    }
+    if (bind(_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        // RTC_LOG(LS_WARNING) << "bind() failed: " << strerror(errno);
+        Close();
+        return false;
+    }
+    _timeout_ms = -1;
+    return true;
+}
+
+void UdpBatchReceiver::Close() {
+    if (_fd >= 0)
+        close(_fd);
+    _fd = -1;
+    _num_packets = 0;
+}
+
+uint16_t UdpBatchReceiver::local_port() const {
+    struct sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    if (_fd < 0 || getsockname(_fd, reinterpret_cast<struct sockaddr*>(&addr), &length) < 0)
+        return 0;
+    return ntohs(addr.sin_port);
+}
+
+int UdpBatchReceiver::Receive(int timeout_ms, size_t max_packets) {
+    _num_packets = 0;
+    if (_fd < 0)
+        return -1;
+    // 超时用SO_RCVTIMEO实现, 只在变化时设置, 每批只有一次recvmmsg()
+    if (timeout_ms != _timeout_ms) {
+        struct timeval tv;
+        tv.tv_sec = timeout_ms / 1000;
+        tv.tv_usec = (timeout_ms % 1000) * 1000;
+        if (timeout_ms == 0)
+            tv.tv_usec = 1;
+        if (setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0)
+            return -1;
+        _timeout_ms = timeout_ms;
+    }
+
+    const size_t batch_size = std::min(std::max<size_t>(max_packets, 1), kMaxBatchSize);
+    for (size_t i = 0; i < batch_size; ++i) {
+        struct msghdr& header = _messages[i].msg_hdr;
+        header.msg_name = nullptr;
+        header.msg_namelen = 0;
+        header.msg_iov = &_iovecs[i];
+        header.msg_iovlen = 1;
+        header.msg_control = &_control[i * kControlSize];
+        header.msg_controllen = kControlSize;
+        header.msg_flags = 0;
+    }
+    // MSG_WAITFORONE: 阻塞到第一个包, 之后不再等待
+    const int received = recvmmsg(_fd, _messages.data(), static_cast<unsigned int>(batch_size),
+            MSG_WAITFORONE, nullptr);
+    if (received < 0)
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ? 0 : -1;
+
+    struct timespec now_realtime;
+    struct timespec now_monotonic;
+    clock_gettime(CLOCK_REALTIME, &now_realtime);
+    clock_gettime(CLOCK_MONOTONIC, &now_monotonic);
+    const int64_t now_us = TimespecToUs(now_monotonic);
+    const int64_t realtime_to_monotonic_us = now_us - TimespecToUs(now_realtime);
+
+    for (int i = 0; i < received; ++i) {
+        struct msghdr& header = _messages[i].msg_hdr;
+        if (header.msg_flags & MSG_TRUNC) {
+            // RTC_LOG(LS_WARNING) << "Dropping truncated packet";
+            continue;
+        }
+        int64_t arrival_time_us = now_us;
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg; cmsg = CMSG_NXTHDR(&header, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                struct timespec ts;
+                memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                // 时钟被调整时换算结果可能晚于现在
+                arrival_time_us = std::min(TimespecToUs(ts) + realtime_to_monotonic_us, now_us);
+                break;
+            }
+        }
+        _packets[_num_packets] = static_cast<const uint8_t*>(_iovecs[i].iov_base);
+        _sizes[_num_packets] = _messages[i].msg_len;
+        _arrival_times_us[_num_packets] = arrival_time_us;
+        ++_num_packets;
+    }
+    return static_cast<int>(_num_packets);
+}
+
+int64_t UdpBatchReceiver::MonotonicTimeUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return TimespecToUs(ts);
+}
+
+} // namespace webrtc
+
@@ -0,0 +1,85 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file udp_batch_receiver.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _UDP_BATCH_RECEIVER_H
+#define _UDP_BATCH_RECEIVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <vector>
+
+namespace webrtc {
+
+// Linux下批量收UDP包: 一次recvmmsg()读最多kMaxBatchSize个包到预先分配的缓冲区, 并取出
+// 内核记录的到达时间(SO_TIMESTAMPNS)。内核时间戳是CLOCK_REALTIME, 每批按一次采样的
+// 差值换算到CLOCK_MONOTONIC; 没有时间戳的包用收包时的CLOCK_MONOTONIC。
+//
+// 缓冲区在构造时一次分配, Receive()不分配内存。data()等指向内部缓冲区, 在下一次
+// Receive()之前有效。
+//
+// Note: This class is not thread-safe.
+class UdpBatchReceiver {
+public:
+    static constexpr size_t kMaxBatchSize = 64;
+    static constexpr size_t kMaxPacketSize = 2048;
+
+    UdpBatchReceiver();
+    ~UdpBatchReceiver();
+
+    UdpBatchReceiver(const UdpBatchReceiver&) = delete;
+    UdpBatchReceiver& operator=(const UdpBatchReceiver&) = delete;
+
+    // 绑定IPv4地址, |port|为0时由系统分配。打开SO_TIMESTAMPNS, 设置接收缓冲区大小
+    // (|receive_buffer_size|为0时不设置)。失败返回false。
+    bool Bind(const char* ip, uint16_t port, int receive_buffer_size = 0);
+    void Close();
+    int fd() const { return _fd; }
+    // Bind()之后实际绑定的端口
+    uint16_t local_port() const;
+
+    // 最多等待|timeout_ms|直到收到第一个包, 然后读出所有已经到达的包, 最多|max_packets|
+    // 个(不超过kMaxBatchSize)。返回收到的包数, 超时返回0, 出错返回-1。超过kMaxPacketSize
+    // 被截断的包丢弃。
+    int Receive(int timeout_ms, size_t max_packets = kMaxBatchSize);
+
+    size_t num_packets() const { return _num_packets; }
+    const uint8_t* data(size_t index) const { return _packets[index]; }
+    size_t size(size_t index) const { return _sizes[index]; }
+    // 按列存放, 便于整批交给OnPackets()这类接口
+    const uint8_t* const* packets() const { return _packets; }
+    const size_t* sizes() const { return _sizes; }
+    // CLOCK_MONOTONIC的微秒
+    const int64_t* arrival_times_us() const { return _arrival_times_us; }
+
+    // 当前的CLOCK_MONOTONIC(us)
+    static int64_t MonotonicTimeUs();
+
+private:
+    int _fd;
+    int _timeout_ms;
+    std::vector<uint8_t> _buffer;
+    std::vector<uint8_t> _control;
+    std::vector<struct iovec> _iovecs;
+    std::vector<struct mmsghdr> _messages;
+
+    size_t _num_packets;
+    const uint8_t* _packets[kMaxBatchSize];
+    size_t _sizes[kMaxBatchSize];
+    int64_t _arrival_times_us[kMaxBatchSize];
+};
+
+} // namespace webrtc
+
+#endif // _UDP_BATCH_RECEIVER_H
+
@@ -0,0 +1,425 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file udp_batch_receiver_unittest.cpp
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+// g++ udp_batch_receiver_unittest.cpp udp_batch_receiver.cpp rtp_batch_processor.cpp rtp_packet_view.cpp rtp_header_extension_map.cpp inter_arrival.cpp rate_statistics.cpp remote_estimator_proxy.cpp transport_feedback.cpp rtpfb.cpp rtcp_packet.cpp common_header.cpp -std=c++11 -O2 -lpthread
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#include "byte_io.h"
+#include "inter_arrival.h"
+#include "rate_statistics.h"
+#include "remote_estimator_proxy.h"
+#include "rtp_batch_processor.h"
+#include "rtp_header_extension_map.h"
+#include "rtp_packet_view.h"
+#include "udp_batch_receiver.h"
+
+using namespace webrtc;
+
+constexpr int kAbsSendTimeId = 3;
+constexpr int kTransportSequenceNumberId = 5;
+constexpr uint32_t kMediaSsrc = 0x12345678;
+
+static RtpHeaderExtensionMap MakeExtensionMap() {
+    RtpHeaderExtensionMap extensions;
+    assert(extensions.Register(kAbsSendTimeId, kRtpExtensionAbsoluteSendTime));
+    assert(extensions.Register(kTransportSequenceNumberId, kRtpExtensionTransportSequenceNumber));
+    return extensions;
+}
+
+// 写一个带abs-send-time和transport-wide序号的RTP包(one-byte扩展), 返回包长
+static size_t WriteRtpPacket(uint8_t* buffer, uint16_t sequence_number, uint32_t abs_send_time,
+        uint16_t transport_sequence_number, size_t payload_size) {
+    buffer[0] = 0x90;
+    buffer[1] = 96;
+    ByteWriter<uint16_t>::WriteBigEndian(&buffer[2], sequence_number);
+    ByteWriter<uint32_t>::WriteBigEndian(&buffer[4], sequence_number * 3000u);
+    ByteWriter<uint32_t>::WriteBigEndian(&buffer[8], kMediaSsrc);
+    ByteWriter<uint16_t>::WriteBigEndian(&buffer[12], RtpPacketView::kOneByteExtensionProfileId);
+    ByteWriter<uint16_t>::WriteBigEndian(&buffer[14], 2);
+    buffer[16] = static_cast<uint8_t>((kAbsSendTimeId << 4) | 2);
+    ByteWriter<uint32_t, 3>::WriteBigEndian(&buffer[17], abs_send_time & 0xFFFFFF);
+    buffer[20] = static_cast<uint8_t>((kTransportSequenceNumberId << 4) | 1);
+    ByteWriter<uint16_t>::WriteBigEndian(&buffer[21], transport_sequence_number);
+    buffer[23] = 0;
+    memset(&buffer[24], 0xAB, payload_size);
+    return 24 + payload_size;
+}
+
+// ms换算成abs-send-time(6.18定点秒)
+static uint32_t AbsSendTime(int64_t send_time_ms) {
+    return static_cast<uint32_t>(((send_time_ms << RtpPacketView::kAbsSendTimeFraction) + 500) / 1000) & 0xFFFFFF;
+}
+
+static int ConnectedSender(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    assert(fd >= 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+static int64_t ThreadCpuTimeUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+// 从序号|first_seq|开始连续发|num_packets|个RTP包, 每次sendmmsg发64个, 返回发出的个数
+static int SendRtpBurst(int fd, int first_seq, int num_packets) {
+    static uint8_t buffers[64][1500];
+    struct iovec iovecs[64];
+    struct mmsghdr messages[64];
+    memset(messages, 0, sizeof(messages));
+    int sent = 0;
+    while (sent < num_packets) {
+        const int n = std::min(64, num_packets - sent);
+        for (int i = 0; i < n; ++i) {
+            const int seq = first_seq + sent + i;
+            iovecs[i].iov_base = buffers[i];
+            iovecs[i].iov_len = WriteRtpPacket(buffers[i], static_cast<uint16_t>(seq), AbsSendTime(seq / 4),
+                    static_cast<uint16_t>(seq), 1000);
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        const int result = sendmmsg(fd, messages, n, 0);
+        if (result <= 0)
+            break;
+        sent += result;
+    }
+    return sent;
+}
+
+// 每|send_interval_us|发|burst|个包, 共|num_packets|个
+static void SendRtpPackets(uint16_t port, int num_packets, int burst, int64_t send_interval_us,
+        std::atomic<int>* num_sent) {
+    const int fd = ConnectedSender(port);
+    int sent = 0;
+    while (sent < num_packets) {
+        const int n = SendRtpBurst(fd, sent, std::min(burst, num_packets - sent));
+        if (n == 0)
+            break;
+        sent += n;
+        usleep(static_cast<useconds_t>(send_interval_us));
+    }
+    num_sent->store(sent);
+    close(fd);
+}
+
+// Loopback
+// 本机收发: 内容和长度正确, 到达时间在发送和接收之间; 没有包时按超时返回0; 超过
+// kMaxPacketSize的包被丢弃
+void TestUdpBatchReceiver01() {
+    UdpBatchReceiver receiver;
+    assert(!receiver.Bind("not an address", 0));
+    assert(receiver.Bind("127.0.0.1", 0));
+    assert(receiver.local_port() != 0);
+    assert(receiver.Receive(10) == 0);
+
+    const int fd = ConnectedSender(receiver.local_port());
+    const int64_t send_time_us = UdpBatchReceiver::MonotonicTimeUs();
+    std::vector<uint8_t> big(UdpBatchReceiver::kMaxPacketSize + 100, 0xEE);
+    for (int i = 0; i < 10; ++i) {
+        uint8_t buffer[200];
+        memset(buffer, i, sizeof(buffer));
+        assert(send(fd, buffer, 100 + i, 0) == 100 + i);
+        if (i == 4)
+            assert(send(fd, big.data(), big.size(), 0) == static_cast<ssize_t>(big.size()));
+    }
+
+    int received = 0;
+    while (received < 10) {
+        const int n = receiver.Receive(1000);
+        assert(n > 0);
+        assert(receiver.num_packets() == static_cast<size_t>(n));
+        const int64_t now_us = UdpBatchReceiver::MonotonicTimeUs();
+        for (int k = 0; k < n; ++k, ++received) {
+            assert(receiver.size(k) == static_cast<size_t>(100 + received));
+            for (size_t j = 0; j < receiver.size(k); ++j)
+                assert(receiver.data(k)[j] == received);
+            // 换算误差在几us以内
+            assert(receiver.arrival_times_us()[k] >= send_time_us - 1000);
+            assert(receiver.arrival_times_us()[k] <= now_us);
+        }
+    }
+    assert(receiver.Receive(10) == 0);
+
+    // 每次最多取一个包
+    for (int i = 0; i < 3; ++i)
+        assert(send(fd, &i, sizeof(i), 0) == static_cast<ssize_t>(sizeof(i)));
+    for (int i = 0; i < 3; ++i) {
+        assert(receiver.Receive(1000, 1) == 1);
+        int value;
+        memcpy(&value, receiver.data(0), sizeof(value));
+        assert(value == i);
+    }
+    close(fd);
+    receiver.Close();
+    assert(receiver.Receive(10) == -1);
+    cout << "TestUdpBatchReceiver01 passed" << endl;
+}
+
+// BatchEqualsPerPacket
+// 同一段输入(有乱序、丢包、缺扩展、非法包、序号回绕), 批量接口的结果与逐包调用
+// InterArrival/RateStatistics/RemoteEstimatorProxy完全相同, 反馈包逐字节相同
+void TestUdpBatchReceiver02() {
+    const RtpHeaderExtensionMap extensions = MakeExtensionMap();
+    constexpr int kNumPackets = 5000;
+    std::vector<std::vector<uint8_t>> packets(kNumPackets);
+    std::vector<int64_t> arrival_times_us(kNumPackets);
+    int64_t arrival_time_us = 1000000;
+    for (int i = 0; i < kNumPackets; ++i) {
+        std::vector<uint8_t>& packet = packets[i];
+        packet.resize(1500);
+        // 每10个包交换一对, 模拟乱序; transport-wide序号每100个跳一个, 模拟丢包
+        const int seq = (i % 10 == 3) ? i + 1 : (i % 10 == 4) ? i - 1 : i;
+        size_t size = WriteRtpPacket(packet.data(), static_cast<uint16_t>(seq), AbsSendTime(seq * 2),
+                static_cast<uint16_t>(0xF000 + seq + seq / 100), 200 + (i * 37) % 1000);
+        if (i % 97 == 0)
+            size = 8;   // 非法包
+        if (i % 53 == 0)
+            packet[0] = 0x80;   // 没有扩展
+        packet.resize(size);
+        arrival_time_us += (i % 7 == 0) ? 0 : 300 + (i * 131) % 2500;
+        arrival_times_us[i] = arrival_time_us;
+    }
+
+    RemoteEstimatorProxy batch_proxy;
+    RtpBatchProcessor processor(extensions, &batch_proxy);
+    std::vector<double> batch_send_deltas;
+    std::vector<int64_t> batch_recv_deltas;
+    std::vector<int> batch_size_deltas;
+    for (int begin = 0, batch = 1; begin < kNumPackets; begin += batch, batch = batch % 58 + 7) {
+        const int n = std::min(batch, kNumPackets - begin);
+        const uint8_t* data[64];
+        size_t sizes[64];
+        for (int k = 0; k < n; ++k) {
+            data[k] = packets[begin + k].data();
+            sizes[k] = packets[begin + k].size();
+        }
+        processor.OnPackets(data, sizes, &arrival_times_us[begin], n);
+        for (size_t k = 0; k < processor.num_deltas(); ++k) {
+            batch_send_deltas.push_back(processor.send_delta_ms(k));
+            batch_recv_deltas.push_back(processor.recv_delta_ms(k));
+            batch_size_deltas.push_back(processor.size_delta(k));
+        }
+    }
+
+    // 逐包
+    RemoteEstimatorProxy proxy;
+    InterArrival inter_arrival(static_cast<uint32_t>((RtpBatchProcessor::kTimestampGroupLengthMs
+                    << RtpPacketView::kInterArrivalShift) / 1000),
+            RtpPacketView::kInterArrivalTimestampToMs, true);
+    RateStatistics incoming_bitrate(RtpBatchProcessor::kBitrateWindowMs, RateStatistics::kBpsScale);
+    std::vector<double> send_deltas;
+    std::vector<int64_t> recv_deltas;
+    std::vector<int> size_deltas;
+    int invalid = 0;
+    for (int i = 0; i < kNumPackets; ++i) {
+        RtpPacketView view;
+        if (!view.Parse(packets[i].data(), packets[i].size(), &extensions)) {
+            ++invalid;
+            continue;
+        }
+        const int64_t arrival_time_ms = arrival_times_us[i] / 1000;
+        incoming_bitrate.Update(packets[i].size(), arrival_time_ms);
+        uint32_t abs_send_time;
+        if (view.GetAbsoluteSendTime(&abs_send_time)) {
+            uint32_t timestamp_delta;
+            int64_t arrival_time_delta_ms;
+            int size_delta;
+            if (inter_arrival.ComputeDeltas(RtpPacketView::AbsSendTimeToInterArrivalTimestamp(abs_send_time),
+                        arrival_time_ms, arrival_time_ms, view.payload_size() + view.padding_size(),
+                        &timestamp_delta, &arrival_time_delta_ms, &size_delta)) {
+                send_deltas.push_back(timestamp_delta * RtpPacketView::kInterArrivalTimestampToMs);
+                recv_deltas.push_back(arrival_time_delta_ms);
+                size_deltas.push_back(size_delta);
+            }
+        }
+        uint16_t transport_sequence_number;
+        if (view.GetTransportSequenceNumber(&transport_sequence_number))
+            proxy.IncomingPacket(arrival_time_ms, view.ssrc(), transport_sequence_number);
+    }
+
+    assert(processor.total_packets() == kNumPackets);
+    assert(processor.total_invalid_packets() == invalid);
+    assert(!send_deltas.empty());
+    assert(processor.total_deltas() == static_cast<int64_t>(send_deltas.size()));
+    assert(batch_send_deltas == send_deltas);
+    assert(batch_recv_deltas == recv_deltas);
+    assert(batch_size_deltas == size_deltas);
+
+    const int64_t now_ms = arrival_time_us / 1000;
+    assert(incoming_bitrate.Rate(now_ms) > 0);
+    assert(processor.IncomingBitrate(now_ms) == incoming_bitrate.Rate(now_ms));
+
+    const size_t num_feedbacks = proxy.Process(now_ms);
+    assert(num_feedbacks > 0);
+    assert(batch_proxy.Process(now_ms) == num_feedbacks);
+    for (size_t i = 0; i < num_feedbacks; ++i)
+        assert(batch_proxy.GetFeedbackPacket(i).Build() == proxy.GetFeedbackPacket(i).Build());
+
+    // RateStatistics单独检查: 同一ms的多个样本合并
+    RateStatistics single(1000, RateStatistics::kBpsScale);
+    RateStatistics batched(1000, RateStatistics::kBpsScale);
+    size_t counts[8] = {100, 200, 300, 400, 500, 600, 700, 800};
+    int64_t times_ms[8] = {0, 0, 0, 5, 5, 999, 1000, 1500};
+    for (int i = 0; i < 8; ++i)
+        single.Update(counts[i], times_ms[i]);
+    batched.Update(counts, times_ms, 8);
+    for (int64_t t = 1500; t < 3000; t += 100)
+        assert(single.Rate(t) == batched.Rate(t));
+    cout << "TestUdpBatchReceiver02 passed" << endl;
+}
+
+// Pipeline
+// 本机发送20000个RTP包(每1ms一批16个), 接收线程批量收包、处理、定时生成反馈: 没有
+// 丢包时反馈覆盖全部包, 接收码率与发送码率一致
+void TestUdpBatchReceiver03() {
+    const RtpHeaderExtensionMap extensions = MakeExtensionMap();
+    UdpBatchReceiver receiver;
+    assert(receiver.Bind("127.0.0.1", 0, 4 << 20));
+    RemoteEstimatorProxy proxy;
+    RtpBatchProcessor processor(extensions, &proxy);
+
+    constexpr int kNumPackets = 20000;
+    std::atomic<int> num_sent(-1);
+    std::thread sender(SendRtpPackets, receiver.local_port(), kNumPackets, 16, 1000, &num_sent);
+
+    int64_t received = 0;
+    int64_t num_batches = 0;
+    size_t num_feedback_packets = 0;
+    size_t num_acked = 0;
+    int64_t first_arrival_ms = -1;
+    int64_t last_arrival_ms = -1;
+    while (received < kNumPackets) {
+        const int n = receiver.Receive(500);
+        if (n < 0)
+            break;
+        if (n == 0) {
+            if (num_sent.load() >= 0)
+                break;  // 发送结束, 剩下的丢了
+            continue;
+        }
+        processor.OnPackets(receiver.packets(), receiver.sizes(), receiver.arrival_times_us(), n);
+        received += n;
+        ++num_batches;
+        last_arrival_ms = receiver.arrival_times_us()[n - 1] / 1000;
+        if (first_arrival_ms < 0)
+            first_arrival_ms = receiver.arrival_times_us()[0] / 1000;
+        const int64_t now_ms = UdpBatchReceiver::MonotonicTimeUs() / 1000;
+        if (proxy.TimeUntilNextProcess(now_ms) <= 0) {
+            const size_t num = proxy.Process(now_ms);
+            num_feedback_packets += num;
+            for (size_t i = 0; i < num; ++i)
+                num_acked += proxy.GetFeedbackPacket(i).GetReceivedPackets().size();
+        }
+    }
+    const int64_t now_ms = UdpBatchReceiver::MonotonicTimeUs() / 1000 + proxy.send_interval_ms();
+    const size_t num = proxy.Process(now_ms);
+    num_feedback_packets += num;
+    for (size_t i = 0; i < num; ++i)
+        num_acked += proxy.GetFeedbackPacket(i).GetReceivedPackets().size();
+    sender.join();
+
+    const double seconds = (last_arrival_ms - first_arrival_ms) / 1000.0;
+    const uint32_t bitrate_bps = processor.IncomingBitrate(last_arrival_ms);
+    cout << "sent=" << num_sent.load() << " received=" << received << " batches=" << num_batches
+        << " packets/batch=" << static_cast<double>(received) / num_batches
+        << " feedbacks=" << num_feedback_packets << " acked=" << num_acked
+        << " deltas=" << processor.total_deltas() << " duration=" << seconds << "s"
+        << " bitrate=" << bitrate_bps / 1000 << "kbps" << endl;
+    assert(num_sent.load() == kNumPackets);
+    // 本机不应该丢包
+    assert(received == kNumPackets);
+    assert(processor.total_invalid_packets() == 0);
+    assert(num_acked == static_cast<size_t>(received));
+    assert(processor.total_deltas() > 0);
+    // 平均每个包1024字节
+    const double expected_bps = received * 1024 * 8 / seconds;
+    assert(bitrate_bps > 0.5 * expected_bps && bitrate_bps < 2 * expected_bps);
+    cout << "TestUdpBatchReceiver03 passed" << endl;
+}
+
+// 每轮先发|burst|个包积压在接收缓冲区里, 再收包、处理直到收完, 只统计处理的CPU时间。
+// 返回每CPU秒处理的包数
+static double ReceiveThroughput(size_t max_packets, int num_rounds, int burst, double* packets_per_batch) {
+    const RtpHeaderExtensionMap extensions = MakeExtensionMap();
+    UdpBatchReceiver receiver;
+    assert(receiver.Bind("127.0.0.1", 0, 8 << 20));
+    RemoteEstimatorProxy proxy;
+    RtpBatchProcessor processor(extensions, &proxy);
+    const int fd = ConnectedSender(receiver.local_port());
+
+    int64_t received = 0;
+    int64_t num_batches = 0;
+    int64_t elapsed_us = 0;
+    for (int round = 0; round < num_rounds; ++round) {
+        const int sent = SendRtpBurst(fd, round * burst, burst);
+        assert(sent == burst);
+        const int64_t begin_us = ThreadCpuTimeUs();
+        int n;
+        while ((n = receiver.Receive(0, max_packets)) > 0) {
+            processor.OnPackets(receiver.packets(), receiver.sizes(), receiver.arrival_times_us(), n);
+            received += n;
+            ++num_batches;
+            const int64_t now_ms = receiver.arrival_times_us()[n - 1] / 1000;
+            if (proxy.TimeUntilNextProcess(now_ms) <= 0)
+                proxy.Process(now_ms);
+        }
+        elapsed_us += ThreadCpuTimeUs() - begin_us;
+        assert(n == 0);
+    }
+    close(fd);
+    // 接收缓冲区放不下时会丢一些
+    assert(received > static_cast<int64_t>(num_rounds) * burst / 2);
+    *packets_per_batch = static_cast<double>(received) / num_batches;
+    return received * 1e6 / std::max<int64_t>(elapsed_us, 1);
+}
+
+// Benchmark
+// recvmmsg每次取1个包和最多64个包时, 收包+解析+BWE每CPU秒处理的包数
+void TestUdpBatchReceiver04() {
+    constexpr int kNumRounds = 200;
+    constexpr int kBurst = 1000;
+    double single_batch = 0;
+    double multi_batch = 0;
+    const double single = ReceiveThroughput(1, kNumRounds, kBurst, &single_batch);
+    const double multi = ReceiveThroughput(UdpBatchReceiver::kMaxBatchSize, kNumRounds, kBurst, &multi_batch);
+    cout << "max_packets=1: " << single / 1e3 << "k packets/cpu-s (" << single_batch << " packets/batch)" << endl;
+    cout << "max_packets=" << UdpBatchReceiver::kMaxBatchSize << ": " << multi / 1e3
+        << "k packets/cpu-s (" << multi_batch << " packets/batch), x" << multi / single << endl;
+    cout << "TestUdpBatchReceiver04 passed" << endl;
+}
+
+int main() {
+    TestUdpBatchReceiver01();
+    TestUdpBatchReceiver02();
+    TestUdpBatchReceiver03();
+    TestUdpBatchReceiver04();
+    return 0;
+}
+
@@ -0,0 +1,74 @@
+/*****************************************************************
+* Copyright (C) 2020 Zuoyebang.com, Inc. All Rights Reserved.
+* 
+* @file vcm_packet.h
+* @author yujitai(yujitai@zuoyebang.com)
+* @date 2026/10/19
+* @brief 
+*****************************************************************/
+
+
+#ifndef _VCM_PACKET_H
+#define _VCM_PACKET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "payload_buffer.h"
+
+namespace webrtc {
+
+enum VideoCodecType {
+    kVideoCodecGeneric = 0,
+    kVideoCodecVP8,
+    kVideoCodecVP9,
+    kVideoCodecH264,
+};
+
+enum FrameType {
+    kEmptyFrame = 0,
+    kAudioFrameSpeech = 1,
+    kAudioFrameCN = 2,
+    kVideoFrameKey = 3,
+    kVideoFrameDelta = 4,
+};
+
+// 交给PacketBuffer组帧的一个视频RTP包
+struct VCMPacket {
+    VCMPacket()
+        : payload_type(0),
+        timestamp(0),
+        ntp_time_ms(0),
+        seq_num(0),
+        data_ptr(nullptr),
+        size_bytes(0),
+        marker_bit(false),
+        times_nacked(-1),
+        frame_type(kEmptyFrame),
+        codec(kVideoCodecGeneric),
+        is_first_packet_in_frame(false) {}
+
+    uint8_t payload_type;
+    uint32_t timestamp;
+    // NTP time of the capture time in local timebase in milliseconds.
+    int64_t ntp_time_ms;
+    uint16_t seq_num;
+    // RTP负载。payload_buffer不为空时data_ptr指向它内部(socket直接读进来的缓冲区),
+    // 否则data_ptr是new[]分配的。插入PacketBuffer后所有权都交给PacketBuffer。
+    const uint8_t* data_ptr;
+    size_t size_bytes;
+    PayloadBuffer payload_buffer;
+    bool marker_bit;
+    int times_nacked;
+
+    FrameType frame_type;
+    VideoCodecType codec;
+
+    bool is_first_packet_in_frame;
+};
+
+} // namespace webrtc
+
+#endif // _VCM_PACKET_H
+
+
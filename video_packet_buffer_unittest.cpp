@@ -7,37 +7,43 @@
 * @brief 
 *****************************************************************/
 
-// g++ video_packet_buffer_unittest.cpp -I googletest/mybuild/include/ -std=c++11 -I /home/yujitai/dev/zrtc/smt-server/libzybrtc/output/include -I /home/yujitai/dev/zrtc/voip/librtcbase/output/include -I /home/yujitai/dev/zrtc/smt-server/libzybrtc/output/include/zybrtc
+// g++ video_packet_buffer_unittest.cpp packet_buffer.cpp frame_object.cpp payload_buffer.cpp random.cpp -std=c++11 -lgtest -lpthread
 
 #include <gtest/gtest.h>
-#include <zybrtc/modules/video_coding/frame_object.h>
-#include <zybrtc/modules/video_coding/packet_buffer.h>
-#include <rtcbase/random.h>
-#include <zybrtc/system_wrappers/include/clock.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
 #include <memory>
+#include <vector>
 #include <iostream>
+
+#include "clock.h"
+#include "frame_object.h"
+#include "packet_buffer.h"
+#include "payload_buffer.h"
+#include "random.h"
 using namespace std;
 
-using namespace zybrtc;
+using namespace webrtc;
 using namespace video_coding;
-using namespace rtcbase;
 
 enum IsKeyFrame { kKeyFrame, kDeltaFrame };
 enum IsFirst { kFirst, kNotFirst };
 enum IsLast { kLast, kNotLast };
 
 class TestPacketBuffer : public ::testing::Test,
-                         public zybrtc::video_coding::OnReceivedFrameCallback 
+                         public OnReceivedFrameCallback 
 {
 protected:
     explicit TestPacketBuffer()
         : _rand(0x7732213),
         _clock(new SimulatedClock(0)),
-        _packet_buffer(PacketBuffer::create(_clock.get(), kStartSize, kMaxSize, this)) {}
+        _packet_buffer(PacketBuffer::Create(_clock.get(), kStartSize, kMaxSize, this)) {}
 
-    uint16_t Rand() { return _rand.rand<uint16_t>(); }
+    uint16_t Rand() { return _rand.Rand<uint16_t>(); }
 
-    void on_received_frame(std::unique_ptr<zybrtc::video_coding::RtpFrameObject> frame) override {
+    void OnReceivedFrame(std::unique_ptr<RtpFrameObject> frame) override {
         uint16_t first_seq_num = frame->first_seq_num();
         if (_frames_from_callback.find(first_seq_num) !=
                 _frames_from_callback.end()) {
@@ -52,18 +58,18 @@ protected:
     }
 
     bool Insert(uint16_t seq_num, IsKeyFrame keyframe, IsFirst first, IsLast last, int data_size = 0, uint8_t* data = nullptr, uint32_t timestamp = 123u) {
-        zybrtc::VCMPacket packet;
-        // packet.codec = k_video_codec_generic;
-        packet.codec = k_video_codec_generic;
+        VCMPacket packet;
+        // packet.codec = kVideoCodecGeneric;
+        packet.codec = kVideoCodecGeneric;
         packet.timestamp = timestamp;
         packet.seq_num = seq_num;
-        packet.frame_type = keyframe == kKeyFrame ? k_video_frame_key : k_video_frame_delta;
+        packet.frame_type = keyframe == kKeyFrame ? kVideoFrameKey : kVideoFrameDelta;
         packet.is_first_packet_in_frame = first == kFirst;
         packet.marker_bit = last == kLast;
         packet.size_bytes = data_size;
         packet.data_ptr = data;
 
-        return _packet_buffer->insert_packet(&packet);
+        return _packet_buffer->InsertPacket(&packet);
     }
 
     void CheckFrame(uint16_t first_seq_num) {
@@ -91,7 +97,7 @@ protected:
     std::map<uint16_t, std::unique_ptr<RtpFrameObject>> _frames_from_callback;
 };
 
-#if 0
+#if 1
 TEST_F(TestPacketBuffer, InsertOnePacket) {
     const uint16_t seq_num = Rand();
     EXPECT_TRUE(Insert(seq_num, kKeyFrame, kFirst, kLast));
@@ -127,7 +133,7 @@ TEST_F(TestPacketBuffer, SeqNumWrapTwoFrames) {
 }
 #endif
 
-#if 0
+#if 1
 TEST_F(TestPacketBuffer, InsertOldPackets) {
     const uint16_t seq_num = Rand();
 
@@ -144,7 +150,7 @@ TEST_F(TestPacketBuffer, InsertOldPackets) {
     ASSERT_TRUE(Insert(seq_num, kKeyFrame, kFirst, kNotLast));
     EXPECT_TRUE(Insert(seq_num + 2, kDeltaFrame, kFirst, kLast));
 
-    _packet_buffer->clear_to(seq_num + 2);
+    _packet_buffer->ClearTo(seq_num + 2);
     EXPECT_FALSE(Insert(seq_num + 2, kDeltaFrame, kFirst, kLast));
     EXPECT_TRUE(Insert(seq_num + 3, kDeltaFrame, kFirst, kLast));
     ASSERT_EQ(2UL, _frames_from_callback.size());
@@ -154,28 +160,28 @@ TEST_F(TestPacketBuffer, NackCount) {
     const uint16_t seq_num = Rand();
 
     VCMPacket packet;
-    packet.codec = k_video_codec_generic;
+    packet.codec = kVideoCodecGeneric;
     packet.seq_num = seq_num;
-    packet.frame_type = k_video_frame_key;
+    packet.frame_type = kVideoFrameKey;
     packet.is_first_packet_in_frame = true;
     packet.marker_bit = false;
     packet.times_nacked = 0;
 
-    _packet_buffer->insert_packet(&packet);
+    _packet_buffer->InsertPacket(&packet);
 
     packet.seq_num++;
     packet.is_first_packet_in_frame = false;
     packet.times_nacked = 1;
-    _packet_buffer->insert_packet(&packet);
+    _packet_buffer->InsertPacket(&packet);
 
     packet.seq_num++;
     packet.times_nacked = 3;
-    _packet_buffer->insert_packet(&packet);
+    _packet_buffer->InsertPacket(&packet);
 
     packet.seq_num++;
     packet.marker_bit = true;
     packet.times_nacked = 1;
-    _packet_buffer->insert_packet(&packet);
+    _packet_buffer->InsertPacket(&packet);
 
     ASSERT_EQ(1UL, _frames_from_callback.size());
     RtpFrameObject* frame = _frames_from_callback.begin()->second.get();
@@ -199,7 +205,7 @@ TEST_F(TestPacketBuffer, FrameSize) {
 }
 #endif
 
-#if 0
+#if 1
 TEST_F(TestPacketBuffer, ThreePacketReorderingOneFrame) {
     const uint16_t seq_num = Rand();
 
@@ -224,7 +230,7 @@ TEST_F(TestPacketBuffer, yujitaitest) {
 }
 */
 
-#if 0
+#if 1
 // 帧乱序
 TEST_F(TestPacketBuffer, FramesReordered) {
     const uint16_t seq_num = Rand();
@@ -243,41 +249,389 @@ TEST_F(TestPacketBuffer, FramesReordered) {
 }
 #endif
 
+// 负载来自slab分配器时, 帧的分段直接指向收包的块, 没有拷贝; 帧和包都释放后块全部归还
+TEST_F(TestPacketBuffer, ZeroCopySegments) {
+    const uint16_t seq_num = Rand();
+    PayloadSlabAllocator allocator(256, 4);
+    {
+        std::vector<PayloadBuffer> buffers;
+        for (int i = 0; i < 6; ++i) {
+            // 模拟socket读入: 12字节RTP头 + 负载
+            PayloadBuffer buffer = allocator.Allocate();
+            for (int b = 0; b < 12 + i; ++b)
+                buffer.data()[b] = static_cast<uint8_t>(i);
+
+            VCMPacket packet;
+            packet.codec = kVideoCodecGeneric;
+            packet.seq_num = seq_num + i;
+            packet.frame_type = kVideoFrameKey;
+            packet.is_first_packet_in_frame = i == 0;
+            packet.marker_bit = i == 5;
+            packet.payload_buffer = buffer;
+            packet.data_ptr = buffer.data() + 12;
+            packet.size_bytes = i;
+            EXPECT_TRUE(_packet_buffer->InsertPacket(&packet));
+            EXPECT_TRUE(packet.payload_buffer.empty());
+            buffers.push_back(buffer);
+        }
+        EXPECT_EQ(6UL, allocator.num_blocks_in_use());
+        EXPECT_EQ(2UL, allocator.num_slabs());
+
+        ASSERT_EQ(1UL, _frames_from_callback.size());
+        const RtpFrameObject& frame = *_frames_from_callback.begin()->second;
+        EXPECT_EQ(15UL, frame.size());
+        // 0字节的包没有分段
+        ASSERT_EQ(5UL, frame.segments().size());
+        for (size_t i = 0; i < frame.segments().size(); ++i) {
+            const PayloadSegment& segment = frame.segments()[i];
+            EXPECT_EQ(buffers[i + 1].data() + 12, segment.data);
+            EXPECT_EQ(i + 1, segment.size);
+            // 本地、PacketBuffer的槽位、帧的分段各一个引用
+            EXPECT_EQ(3, buffers[i + 1].ref_count());
+        }
+        std::vector<uint8_t> bitstream(frame.size());
+        frame.CopyBitstream(bitstream.data());
+        EXPECT_EQ(std::vector<uint8_t>({1, 2, 2, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 5}), bitstream);
+    }
+    // 局部的句柄已释放, 帧对象还持有分段
+    EXPECT_EQ(6UL, allocator.num_blocks_in_use());
+    _frames_from_callback.clear();
+    EXPECT_EQ(0UL, allocator.num_blocks_in_use());
+
+    // 块复用, 不再分配新的slab
+    PayloadBuffer buffer = allocator.Allocate();
+    EXPECT_EQ(2UL, allocator.num_slabs());
+}
+
+// 帧由1~30个包组成(跨越64个槽位的字边界), 在100个包的窗口内乱序、1%丢包, 从
+// |start_size|个槽位扩容到|max_size|, 序号从回绕附近开始。每收到一帧就ClearTo()到它之前kClearDelay个包,
+// 模拟帧缓冲解码后清理。一帧的包全部插入成功、且被清理之前已经完整时必须恰好回调
+// 一次, 码流与发送的一致; 否则不能回调。
+class RecordingFrameCallback : public OnReceivedFrameCallback {
+public:
+    void OnReceivedFrame(std::unique_ptr<RtpFrameObject> frame) override {
+        _frames.push_back(std::move(frame));
+    }
+
+    std::vector<std::unique_ptr<RtpFrameObject>> _frames;
+};
+
+static void RunRandomReordering(uint32_t seed, size_t start_size, size_t max_size) {
+    // 包按发送顺序编号, 序号是kFirstSeqNum + index
+    struct SentFrame {
+        size_t first_index;
+        size_t last_index;
+        std::vector<uint8_t> bitstream;
+        size_t num_inserted;
+        bool cleared;
+        int num_received;
+    };
+    const int kNumFrames = 3000;
+    const uint16_t kFirstSeqNum = 0xFF00;
+    const size_t kReorderWindow = 100;
+    const size_t kClearDelay = 300;
+
+    Random random(seed);
+    SimulatedClock clock(0);
+    RecordingFrameCallback callback;
+    std::shared_ptr<PacketBuffer> packet_buffer =
+        PacketBuffer::Create(&clock, start_size, max_size, &callback);
+
+    std::vector<SentFrame> frames(kNumFrames);
+    std::vector<VCMPacket> packets;
+    std::vector<int> frame_of_packet;
+    std::vector<size_t> payload_offset;
+    std::map<uint16_t, int> frame_by_first_seq_num;
+    for (int f = 0; f < kNumFrames; ++f) {
+        SentFrame& frame = frames[f];
+        const int num_packets = random.Rand(1, 30);
+        frame.first_index = packets.size();
+        frame.last_index = packets.size() + num_packets - 1;
+        frame.num_inserted = 0;
+        frame.cleared = false;
+        frame.num_received = 0;
+        frame_by_first_seq_num[static_cast<uint16_t>(kFirstSeqNum + frame.first_index)] = f;
+        for (int i = 0; i < num_packets; ++i) {
+            VCMPacket packet;
+            packet.codec = kVideoCodecGeneric;
+            packet.timestamp = f * 3000;
+            packet.seq_num = static_cast<uint16_t>(kFirstSeqNum + packets.size());
+            packet.frame_type = f % 100 == 0 ? kVideoFrameKey : kVideoFrameDelta;
+            packet.is_first_packet_in_frame = i == 0;
+            packet.marker_bit = i == num_packets - 1;
+            packet.times_nacked = random.Rand(0, 2);
+            packet.size_bytes = random.Rand(0, 20);
+            payload_offset.push_back(frame.bitstream.size());
+            for (size_t b = 0; b < packet.size_bytes; ++b)
+                frame.bitstream.push_back(random.Rand<uint8_t>());
+            packets.push_back(packet);
+            frame_of_packet.push_back(f);
+        }
+    }
+    // 总数不到65536, 帧首序号不重复
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), frame_by_first_seq_num.size());
+
+    // 每个包最多推迟kReorderWindow个位置
+    std::vector<std::pair<size_t, size_t>> order;
+    for (size_t i = 0; i < packets.size(); ++i)
+        order.push_back(std::make_pair(i + random.Rand(0, kReorderWindow), i));
+    std::sort(order.begin(), order.end());
+
+    size_t num_frames_received = 0;
+    size_t cleared_through = 0;
+    int next_frame_to_clear = 0;
+    for (const std::pair<size_t, size_t>& entry : order) {
+        const size_t i = entry.second;
+        if (random.Rand(0, 99) == 0)
+            continue;
+        SentFrame& frame = frames[frame_of_packet[i]];
+        VCMPacket packet = packets[i];
+        uint8_t* data = new uint8_t[packet.size_bytes];
+        if (packet.size_bytes > 0)
+            memcpy(data, frame.bitstream.data() + payload_offset[i], packet.size_bytes);
+        packet.data_ptr = data;
+        if (packet_buffer->InsertPacket(&packet))
+            ++frame.num_inserted;
+        EXPECT_EQ(nullptr, packet.data_ptr);
+
+        for (std::unique_ptr<RtpFrameObject>& received : callback._frames) {
+            auto it = frame_by_first_seq_num.find(received->first_seq_num());
+            ASSERT_TRUE(it != frame_by_first_seq_num.end());
+            SentFrame& sent = frames[it->second];
+            EXPECT_FALSE(sent.cleared);
+            EXPECT_EQ(sent.last_index - sent.first_index + 1, sent.num_inserted);
+            EXPECT_EQ(static_cast<uint16_t>(kFirstSeqNum + sent.last_index), received->last_seq_num());
+            ASSERT_EQ(sent.bitstream.size(), received->size());
+            std::vector<uint8_t> bitstream(received->size());
+            received->CopyBitstream(bitstream.data());
+            EXPECT_TRUE(bitstream == sent.bitstream);
+            ++sent.num_received;
+            ++num_frames_received;
+
+            if (sent.last_index >= kClearDelay && sent.last_index - kClearDelay > cleared_through) {
+                cleared_through = sent.last_index - kClearDelay;
+                packet_buffer->ClearTo(static_cast<uint16_t>(kFirstSeqNum + cleared_through));
+                for (; next_frame_to_clear < kNumFrames &&
+                        frames[next_frame_to_clear].first_index <= cleared_through; ++next_frame_to_clear) {
+                    if (frames[next_frame_to_clear].num_received == 0)
+                        frames[next_frame_to_clear].cleared = true;
+                }
+            }
+        }
+        callback._frames.clear();
+    }
+
+    size_t num_expected_frames = 0;
+    for (const SentFrame& frame : frames) {
+        bool expected = frame.num_inserted == frame.last_index - frame.first_index + 1 &&
+            !frame.cleared;
+        num_expected_frames += expected;
+        EXPECT_EQ(expected ? 1 : 0, frame.num_received);
+    }
+    EXPECT_EQ(num_expected_frames, num_frames_received);
+    EXPECT_GT(num_expected_frames, static_cast<size_t>(kNumFrames / 2));
+    cout << "frames=" << kNumFrames << " received=" << num_frames_received << endl;
+}
+
+TEST(TestPacketBufferBitmap, RandomReordering) {
+    RunRandomReordering(0x42, 16, 2048);
+}
+
+// 扩容到64个槽位以上时按组逐步迁移, 迁移过程中继续乱序插入和ClearTo()
+TEST(TestPacketBufferBitmap, RandomReorderingIncrementalGrowth) {
+    RunRandomReordering(0x4401, 64, 4096);
+    RunRandomReordering(0x4402, 128, 8192);
+}
+
+// 拆分过程中插入的包落在已拆分的组里仍然冲突: 丢弃这个包, 这次扩容完成后再收到时开始下一次
+TEST(TestPacketBufferBitmap, CollisionWhileGrowing) {
+    SimulatedClock clock(0);
+    RecordingFrameCallback callback;
+    std::shared_ptr<PacketBuffer> packet_buffer = PacketBuffer::Create(&clock, 256, 1024, &callback);
+    auto insert = [&packet_buffer](uint16_t seq_num, bool first, bool last) {
+        VCMPacket packet;
+        packet.seq_num = seq_num;
+        packet.frame_type = kVideoFrameDelta;
+        packet.is_first_packet_in_frame = first;
+        packet.marker_bit = last;
+        packet.size_bytes = 1;
+        packet.data_ptr = new uint8_t[1]{static_cast<uint8_t>(seq_num)};
+        return packet_buffer->InsertPacket(&packet);
+    };
+
+    EXPECT_TRUE(insert(0, true, false));
+    // 与0冲突, 开始扩容到512, 按需拆分第0组
+    EXPECT_TRUE(insert(256, true, false));
+    // 插入前拆分第1组; 第0组已拆分仍与0冲突, 丢弃
+    EXPECT_FALSE(insert(512, true, true));
+    // 拆分第2, 3组, 完成扩容到512, 已有的包不受影响
+    EXPECT_TRUE(insert(1, false, true));
+    EXPECT_TRUE(insert(257, false, true));
+    // 重传的512与0冲突, 开始扩容到1024
+    EXPECT_TRUE(insert(512, true, true));
+    EXPECT_TRUE(insert(511, true, true));
+
+    ASSERT_EQ(4UL, callback._frames.size());
+    const uint16_t kFirst[] = {0, 256, 512, 511};
+    const uint16_t kLast[] = {1, 257, 512, 511};
+    for (size_t i = 0; i < callback._frames.size(); ++i) {
+        EXPECT_EQ(kFirst[i], callback._frames[i]->first_seq_num());
+        EXPECT_EQ(kLast[i], callback._frames[i]->last_seq_num());
+        std::vector<uint8_t> bitstream(callback._frames[i]->size());
+        callback._frames[i]->CopyBitstream(bitstream.data());
+        EXPECT_EQ(static_cast<uint8_t>(kLast[i]), bitstream.back());
+    }
+}
+
+static void PrintPercentiles(const char* name, std::vector<int64_t>* latencies_ns) {
+    std::sort(latencies_ns->begin(), latencies_ns->end());
+    auto percentile = [latencies_ns](double p) {
+        return (*latencies_ns)[static_cast<size_t>(p * (latencies_ns->size() - 1))];
+    };
+    cout << name << ": inserts=" << latencies_ns->size()
+        << " p50=" << percentile(0.5) << "ns"
+        << " p99=" << percentile(0.99) << "ns"
+        << " p99.9=" << percentile(0.999) << "ns"
+        << " p99.99=" << percentile(0.9999) << "ns"
+        << " max=" << latencies_ns->back() << "ns" << endl;
+}
+
+// 每次从512个槽位的新缓冲区开始(新的流或者关键帧请求之后), 先收一个kKeyframePackets个包
+// 的关键帧, 再收kDeltaFrames个每帧kDeltaPackets个包的P帧, 统计每次InsertPacket()的耗时
+// 分位数。关键帧的包在组帧之前都留在缓冲区里, 突发期间要从512扩容到4096。组帧的那次
+// 插入包含取分段和回调, 单独统计。
+TEST(TestPacketBufferBenchmark, InsertLatencyUnderKeyframeBursts) {
+    const int kNumBursts = 200;
+    const size_t kKeyframePackets = 3000;
+    const size_t kDeltaFrames = 30;
+    const size_t kDeltaPackets = 10;
+    const size_t kPacketSize = 1200;
+
+    SimulatedClock clock(0);
+    RecordingFrameCallback callback;
+    PayloadSlabAllocator allocator;
+    std::vector<int64_t> insert_ns;
+    std::vector<int64_t> assemble_ns;
+    insert_ns.reserve(kNumBursts * (kKeyframePackets + kDeltaFrames * kDeltaPackets));
+    uint16_t seq_num = 0;
+    for (int burst = 0; burst < kNumBursts; ++burst) {
+        std::shared_ptr<PacketBuffer> packet_buffer = PacketBuffer::Create(&clock, 512, 4096, &callback);
+        for (size_t f = 0; f <= kDeltaFrames; ++f) {
+            const size_t num_packets = f == 0 ? kKeyframePackets : kDeltaPackets;
+            for (size_t i = 0; i < num_packets; ++i) {
+                VCMPacket packet;
+                packet.seq_num = seq_num++;
+                packet.frame_type = f == 0 ? kVideoFrameKey : kVideoFrameDelta;
+                packet.is_first_packet_in_frame = i == 0;
+                packet.marker_bit = i == num_packets - 1;
+                packet.payload_buffer = allocator.Allocate();
+                packet.data_ptr = packet.payload_buffer.data();
+                packet.size_bytes = kPacketSize;
+
+                auto start = std::chrono::steady_clock::now();
+                bool inserted = packet_buffer->InsertPacket(&packet);
+                int64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+                ASSERT_TRUE(inserted);
+                (callback._frames.empty() ? insert_ns : assemble_ns).push_back(elapsed_ns);
+            }
+            ASSERT_EQ(1UL, callback._frames.size());
+            packet_buffer->ClearTo(callback._frames.back()->last_seq_num());
+            callback._frames.clear();
+        }
+    }
+    EXPECT_EQ(static_cast<size_t>(kNumBursts * (kDeltaFrames + 1)), assemble_ns.size());
+
+    PrintPercentiles("insert", &insert_ns);
+    PrintPercentiles("insert+assemble", &assemble_ns);
+}
+
+// 扩容过程中插入的包落在已拆分的组里仍然冲突(序号跳变超过两倍容量)。每次从512个槽位
+// 的新缓冲区开始, 先收512个包, 第513个包开始扩容并拆分第0组, 接着插入与第0组的包冲突
+// 的包, 这次插入单独统计。
+TEST(TestPacketBufferBenchmark, InsertLatencyOnCollisionWhileGrowing) {
+    const int kNumRounds = 2000;
+    const size_t kStartSize = 512;
+    const size_t kPacketSize = 1200;
+
+    SimulatedClock clock(0);
+    RecordingFrameCallback callback;
+    PayloadSlabAllocator allocator;
+    std::vector<int64_t> insert_ns;
+    std::vector<int64_t> collision_ns;
+    insert_ns.reserve(kNumRounds * (kStartSize + 1));
+    collision_ns.reserve(kNumRounds);
+    for (int round = 0; round < kNumRounds; ++round) {
+        std::shared_ptr<PacketBuffer> packet_buffer =
+            PacketBuffer::Create(&clock, kStartSize, 4096, &callback);
+        auto insert = [&packet_buffer, &allocator](uint16_t seq_num, int64_t* elapsed_ns) {
+            VCMPacket packet;
+            packet.seq_num = seq_num;
+            packet.frame_type = kVideoFrameKey;
+            packet.is_first_packet_in_frame = false;
+            packet.marker_bit = false;
+            packet.payload_buffer = allocator.Allocate();
+            packet.data_ptr = packet.payload_buffer.data();
+            packet.size_bytes = kPacketSize;
+
+            auto start = std::chrono::steady_clock::now();
+            bool inserted = packet_buffer->InsertPacket(&packet);
+            *elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+            return inserted;
+        };
+        // 2 * kStartSize的整数倍, 冲突的包落在第0组
+        const uint16_t base = static_cast<uint16_t>(round * 4 * kStartSize);
+        int64_t elapsed_ns;
+        for (size_t i = 0; i <= kStartSize; ++i) {
+            ASSERT_TRUE(insert(static_cast<uint16_t>(base + i), &elapsed_ns));
+            insert_ns.push_back(elapsed_ns);
+        }
+        ASSERT_FALSE(insert(static_cast<uint16_t>(base + 2 * kStartSize), &elapsed_ns));
+        collision_ns.push_back(elapsed_ns);
+        ASSERT_TRUE(callback._frames.empty());
+    }
+
+    PrintPercentiles("insert", &insert_ns);
+    PrintPercentiles("collision while growing", &collision_ns);
+}
+
 #if 1
-class ReceivedFrameCallback : public zybrtc::video_coding::OnReceivedFrameCallback {
+class ReceivedFrameCallback : public OnReceivedFrameCallback {
 public:
-    void on_received_frame(std::unique_ptr<zybrtc::video_coding::RtpFrameObject> frame) override {}
+    void OnReceivedFrame(std::unique_ptr<RtpFrameObject> frame) override {}
 };
 
 void test01() {
     const uint16_t seq_num = 1;
 
     ReceivedFrameCallback callback;
+    SimulatedClock clock(0);
     std::shared_ptr<PacketBuffer> _packet_buffer = 
-        PacketBuffer::create(new SimulatedClock(0), 16, 64, &callback);
+        PacketBuffer::Create(&clock, 16, 64, &callback);
 
     VCMPacket packet;
-    // packet.codec = k_video_codec_generic;
-    packet.codec = k_video_codec_h264;
+    // packet.codec = kVideoCodecGeneric;
+    packet.codec = kVideoCodecH264;
     packet.seq_num = seq_num;
-    packet.frame_type = k_video_frame_delta;
+    packet.frame_type = kVideoFrameDelta;
     packet.is_first_packet_in_frame = true;
     packet.marker_bit = true;
-    _packet_buffer->insert_packet(&packet);
+    _packet_buffer->InsertPacket(&packet);
 
     packet.seq_num = seq_num+2;
     // packet.is_first_packet_in_frame = false;
-    _packet_buffer->insert_packet(&packet);
+    _packet_buffer->InsertPacket(&packet);
 
     packet.seq_num = seq_num+1;
-    _packet_buffer->insert_packet(&packet);
+    _packet_buffer->InsertPacket(&packet);
 }
 #endif
 
 int main(int argc,char *argv[])
 {
     test01();
-    // testing::InitGoogleTest(&argc,argv);
-    // return RUN_ALL_TESTS();
+    testing::InitGoogleTest(&argc,argv);
+    return RUN_ALL_TESTS();
 }
 